@@ -0,0 +1,194 @@
+#include "ActivityModel.hpp"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace tracker {
+
+namespace {
+
+constexpr double kSecondsPerHour = 3600.0;
+constexpr double kGoldenFraction = 0.6180339887498949;
+
+/// Min-heap order for std::push_heap/pop_heap
+template <typename T>
+bool later(const T& a, const T& b) {
+    return a.dueSeconds > b.dueSeconds;
+}
+
+} // namespace
+
+std::unique_ptr<ActivityModel> ActivityModel::create(const ActivityConfig& config, std::size_t vehicles,
+                                                     std::uint64_t seed, std::string& error) {
+    if (config.cohorts.empty()) {
+        error = "no cohorts";
+        return nullptr;
+    }
+    if (config.cohorts.size() > std::numeric_limits<std::uint8_t>::max()) {
+        error = "too many cohorts";
+        return nullptr;
+    }
+    if (!(config.timeScale > 0.0) || !std::isfinite(config.timeScale)) {
+        error = "time_scale must be positive";
+        return nullptr;
+    }
+    if (!(config.startHour >= 0.0 && config.startHour < 24.0)) {
+        error = "start_hour must be in 0..24";
+        return nullptr;
+    }
+    if (vehicles > std::numeric_limits<std::uint32_t>::max()) {
+        error = "too many vehicles";
+        return nullptr;
+    }
+
+    std::unique_ptr<ActivityModel> model(new ActivityModel());
+    model->config_ = config;
+    model->engine_.seed(seed);
+
+    double totalShare = 0.0;
+    for (const auto& cohort : config.cohorts) {
+        auto fail = [&](const std::string& reason) {
+            error = "cohort '" + cohort.name + "': " + reason;
+            return nullptr;
+        };
+        if (!(cohort.share > 0.0)) return fail("share must be positive");
+        if (cohort.hourlyTrips.size() != kHours) return fail("hourly_trips needs 24 values");
+        if (!(cohort.tripMinutes > 0.0)) return fail("trip_minutes must be positive");
+        if (cohort.tripMinutesStddev < 0.0) return fail("trip_minutes_stddev must not be negative");
+
+        Curve curve;
+        for (std::size_t hour = 0; hour < kHours; ++hour) {
+            double trips = cohort.hourlyTrips[hour];
+            if (!(trips >= 0.0) || !std::isfinite(trips)) return fail("hourly_trips must not be negative");
+            curve.ratePerSecond[hour] = trips / kSecondsPerHour;
+            curve.cumulative[hour + 1] = curve.cumulative[hour] + trips;
+        }
+        model->curves_.push_back(curve);
+        totalShare += cohort.share;
+    }
+
+    // Interleave cohorts along the vehicle index (golden-ratio sequence) so
+    // every index range gets the configured mix
+    std::vector<double> upperBound;
+    double cumulativeShare = 0.0;
+    for (const auto& cohort : config.cohorts) {
+        cumulativeShare += cohort.share / totalShare;
+        upperBound.push_back(cumulativeShare);
+    }
+    model->vehicleCohort_.resize(vehicles);
+    for (std::size_t vehicle = 0; vehicle < vehicles; ++vehicle) {
+        double position = std::fmod((static_cast<double>(vehicle) + 0.5) * kGoldenFraction, 1.0);
+        auto cohort = static_cast<std::size_t>(
+            std::upper_bound(upperBound.begin(), upperBound.end(), position) - upperBound.begin());
+        cohort = std::min(cohort, upperBound.size() - 1);
+        model->vehicleCohort_[vehicle] = static_cast<std::uint8_t>(cohort);
+        ++model->curves_[cohort].vehicles;
+    }
+
+    model->now_ = config.startHour * kSecondsPerHour;
+    model->heap_.reserve(vehicles);
+    for (std::size_t vehicle = 0; vehicle < vehicles; ++vehicle) {
+        double start = model->nextStart(model->curves_[model->vehicleCohort_[vehicle]], model->now_);
+        if (start >= 0.0) {
+            model->heap_.push_back({start, static_cast<std::uint32_t>(vehicle)});
+        }
+    }
+    std::make_heap(model->heap_.begin(), model->heap_.end(), later<Pending>);
+    return model;
+}
+
+void ActivityModel::advanceTo(double simSeconds, std::vector<Trip>& due) {
+    due.clear();
+    now_ = std::max(now_, simSeconds);
+
+    while (!heap_.empty() && heap_.front().dueSeconds <= now_) {
+        std::pop_heap(heap_.begin(), heap_.end(), later<Pending>);
+        auto& pending = heap_.back();
+
+        const auto& cohort = config_.cohorts[vehicleCohort_[pending.vehicle]];
+        double minutes = std::max(1.0, cohort.tripMinutes + cohort.tripMinutesStddev * drawNormal());
+        Trip trip{pending.vehicle, pending.dueSeconds, minutes * 60.0};
+        due.push_back(trip);
+        ++tripsStarted_;
+
+        // A parked vehicle's next start: the process resumes when this trip ends
+        pending.dueSeconds = nextStart(curves_[vehicleCohort_[pending.vehicle]],
+                                       trip.startSeconds + trip.durationSeconds);
+        std::push_heap(heap_.begin(), heap_.end(), later<Pending>);
+    }
+}
+
+double ActivityModel::expectedTrips(std::size_t hour) const {
+    double trips = 0.0;
+    for (const auto& curve : curves_) {
+        trips += curve.ratePerSecond[hour % kHours] * kSecondsPerHour * static_cast<double>(curve.vehicles);
+    }
+    return trips;
+}
+
+double ActivityModel::nextStart(const Curve& curve, double from) {
+    const double perDay = curve.cumulative[kHours];
+    if (perDay <= 0.0) {
+        return -1.0;
+    }
+
+    // Λ(from): whole days plus the partial day up to `from`
+    double day = std::floor(from / kSecondsPerDay);
+    double intoDay = from - day * kSecondsPerDay;
+    auto hour = std::min(static_cast<std::size_t>(intoDay / kSecondsPerHour), kHours - 1);
+    double lambda = day * perDay + curve.cumulative[hour]
+                  + curve.ratePerSecond[hour] * (intoDay - static_cast<double>(hour) * kSecondsPerHour);
+
+    // Invert Λ at Λ(from) + E: the hour whose cumulative range contains the target
+    double target = lambda + drawExponential();
+    double targetDay = std::floor(target / perDay);
+    double remainder = target - targetDay * perDay;
+    auto slot = static_cast<std::size_t>(
+        std::upper_bound(curve.cumulative.begin(), curve.cumulative.end(), remainder) - curve.cumulative.begin());
+    hour = std::min(slot == 0 ? 0 : slot - 1, kHours - 1);
+    while (curve.ratePerSecond[hour] <= 0.0) {
+        // Rounding landed on a quiet hour: start with the next active one
+        if (++hour == kHours) {
+            hour = 0;
+            targetDay += 1.0;
+        }
+        remainder = curve.cumulative[hour];
+    }
+
+    double start = targetDay * kSecondsPerDay + static_cast<double>(hour) * kSecondsPerHour
+                 + std::max(0.0, remainder - curve.cumulative[hour]) / curve.ratePerSecond[hour];
+    return std::max(start, from);
+}
+
+double ActivityModel::drawExponential() {
+    if (nextExponential_ == kBatch) {
+        refill();
+    }
+    return exponentials_[nextExponential_++];
+}
+
+double ActivityModel::drawNormal() {
+    if (nextNormal_ == kBatch) {
+        refill();
+    }
+    return normals_[nextNormal_++];
+}
+
+void ActivityModel::refill() {
+    if (nextExponential_ == kBatch) {
+        std::exponential_distribution<double> exponential(1.0);
+        for (auto& value : exponentials_) {
+            value = exponential(engine_);
+        }
+        nextExponential_ = 0;
+    }
+    if (nextNormal_ == kBatch) {
+        std::normal_distribution<double> normal(0.0, 1.0);
+        for (auto& value : normals_) {
+            value = normal(engine_);
+        }
+        nextNormal_ = 0;
+    }
+}
+
+} // namespace tracker
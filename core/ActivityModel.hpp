@@ -0,0 +1,140 @@
+/**
+ * @file ActivityModel.hpp
+ * @brief Time-of-day trip starts for a fleet (inhomogeneous Poisson process)
+ *
+ * Vehicles belong to cohorts (delivery vans, commuters, ...). Each cohort has
+ * an hourly rate curve: trip starts per vehicle per hour for every hour of the
+ * day, repeating daily. A vehicle's trip starts are a Poisson process with
+ * that time-varying rate.
+ *
+ * Arrivals are generated by inversion rather than thinning: the cumulative
+ * rate Λ(t) of a piecewise-constant curve is piecewise linear, so the next
+ * start after t is Λ⁻¹(Λ(t) + E) with E ~ Exp(1), found with one binary
+ * search over the 25 hour boundaries. Every draw produces a trip; nothing is
+ * rejected in quiet hours.
+ *
+ * Exponential and normal variates come from a private engine in batches
+ * (refilled kBatch at a time) instead of one virtual IRng call per draw.
+ *
+ * Pending starts live in one binary min-heap with a single entry per vehicle,
+ * so memory stays at 16 bytes per vehicle however long the simulated day runs
+ * and advancing only touches vehicles whose start is due.
+ *
+ * @note Times are simulated seconds since midnight of day 0
+ * @note Not thread-safe; advance from the ticking thread
+ */
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace tracker {
+
+/**
+ * @brief One group of vehicles sharing a rate curve (unvalidated)
+ */
+struct ActivityCohort {
+    std::string name;
+    double share = 1.0;                     ///< Relative fleet share (normalized over cohorts)
+    std::vector<double> hourlyTrips;        ///< Trip starts per vehicle per hour, hours 0..23
+    double tripMinutes = 25.0;              ///< Mean trip duration
+    double tripMinutesStddev = 10.0;        ///< Trip duration spread (clamped to >= 1 minute)
+};
+
+/**
+ * @brief Fleet activity settings ([activity] and [[activity.cohorts]])
+ */
+struct ActivityConfig {
+    std::vector<ActivityCohort> cohorts;    ///< Empty = no scheduled trips
+    double startHour = 0.0;                 ///< Simulated time of day when the run starts
+    double timeScale = 1.0;                 ///< Simulated seconds per wall-clock second
+
+    bool enabled() const { return !cohorts.empty(); }
+};
+
+class ActivityModel {
+public:
+    static constexpr std::size_t kHours = 24;
+    static constexpr std::size_t kBatch = 1024;
+    static constexpr double kSecondsPerDay = 86400.0;
+
+    /// A trip start that became due
+    struct Trip {
+        std::uint32_t vehicle;
+        double startSeconds;                ///< Scheduled simulated start
+        double durationSeconds;             ///< Simulated trip length
+    };
+
+    /**
+     * @brief Validate cohorts and schedule every vehicle's first trip
+     * @param config Cohorts and clock settings
+     * @param vehicles Fleet size
+     * @param seed Engine seed (same seed, same day)
+     * @param error Reason on failure
+     * @return Model positioned at config.startHour, or nullptr if a cohort is invalid
+     */
+    static std::unique_ptr<ActivityModel> create(const ActivityConfig& config, std::size_t vehicles,
+                                                 std::uint64_t seed, std::string& error);
+
+    /**
+     * @brief Collect every trip starting up to a simulated time
+     * @param simSeconds Simulated time (monotonic)
+     * @param due Cleared, then filled with due trips in start order
+     */
+    void advanceTo(double simSeconds, std::vector<Trip>& due);
+
+    /** @brief Cohort index of a vehicle (interleaved by share) */
+    std::size_t cohortOf(std::uint32_t vehicle) const { return vehicleCohort_[vehicle]; }
+
+    /** @brief Expected fleet-wide trip starts in one hour of the day */
+    double expectedTrips(std::size_t hour) const;
+
+    const ActivityConfig& config() const { return config_; }
+    double now() const { return now_; }
+    std::uint64_t tripsStarted() const { return tripsStarted_; }
+    std::size_t pendingVehicles() const { return heap_.size(); }
+
+private:
+    /// Compiled rate curve of one cohort
+    struct Curve {
+        std::array<double, kHours> ratePerSecond{};
+        std::array<double, kHours + 1> cumulative{};    ///< Λ at each hour boundary of a day
+        std::size_t vehicles = 0;
+    };
+
+    /// Heap entry: a vehicle's next trip start
+    struct Pending {
+        double dueSeconds;
+        std::uint32_t vehicle;
+    };
+
+    ActivityModel() = default;
+
+    /** @brief First start after `from` for a cohort, or a negative value if it never travels */
+    double nextStart(const Curve& curve, double from);
+
+    double drawExponential();
+    double drawNormal();
+    void refill();
+
+    ActivityConfig config_;
+    std::vector<Curve> curves_;
+    std::vector<std::uint8_t> vehicleCohort_;
+    std::vector<Pending> heap_;             ///< Min-heap on dueSeconds
+    double now_ = 0.0;
+    std::uint64_t tripsStarted_ = 0;
+
+    std::mt19937_64 engine_;
+    std::array<double, kBatch> exponentials_{};
+    std::array<double, kBatch> normals_{};
+    std::size_t nextExponential_ = kBatch;
+    std::size_t nextNormal_ = kBatch;
+};
+
+} // namespace tracker
@@ -1,32 +1,34 @@
 #include "Battery.hpp"
-#include <algorithm>
 
 namespace tracker {
 
-Battery::Battery(std::shared_ptr<IRng> rng) : rng_(rng) {}
+Battery::Battery(std::shared_ptr<IRng> rng)
+    : rng_(rng), bank_(std::make_shared<BatteryBank>()) {
+    index_ = bank_->add(100.0);
+}
 
-void Battery::tick(double deltaSeconds, bool isDriving) {
-    double drainRate = isDriving ? DRIVING_DRAIN_PER_HOUR : IDLE_DRAIN_PER_HOUR;
-    double baseDrain = (drainRate / 3600.0) * deltaSeconds;
-    
-    double jitter = rng_->uniform(-0.1, 0.1);
-    double actualDrain = baseDrain * (1.0 + jitter);
+void Battery::tick(double deltaSeconds, bool isDriving, bool ignitionOn) {
+    bank_->setLoad(index_, isDriving, ignitionOn);
     
-    percentage_ = std::clamp(percentage_ - actualDrain, 0.0, 100.0);
+    if (!sharedBank_) {
+        bank_->refreshNoise(*rng_);
+        bank_->tick(deltaSeconds);
+    }
+}
+
+void Battery::attach(std::shared_ptr<BatteryBank> bank) {
+    std::size_t index = bank->add(getPercentage(), getTemperature());
+    bank_ = bank;
+    index_ = index;
+    sharedBank_ = true;
 }
 
 BatteryInfo Battery::getInfo() const {
+    // Pure read: jitter was drawn once for this tick by refreshNoise()
     BatteryInfo info;
-    info.percentage = percentage_;
-    
-    double voltageRange = MAX_VOLTAGE - MIN_VOLTAGE;
-    info.voltage = MIN_VOLTAGE + (percentage_ / 100.0) * voltageRange;
-    
-    double jitter = rng_->uniform(-0.05, 0.05);
-    info.voltage += jitter;
-    info.voltage = std::clamp(info.voltage, MIN_VOLTAGE, MAX_VOLTAGE);
-    
+    info.percentage = bank_->percentage(index_);
+    info.voltage = bank_->voltage(index_);
     return info;
 }
 
-} // namespace tracker
\ No newline at end of file
+} // namespace tracker
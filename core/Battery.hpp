@@ -2,6 +2,8 @@
 
 #include "Event.hpp"
 #include "IRng.hpp"
+#include "BatteryModel.hpp"
+#include <algorithm>
 #include <memory>
 
 namespace tracker {
@@ -10,21 +12,25 @@ class Battery {
 public:
     explicit Battery(std::shared_ptr<IRng> rng);
     
-    void tick(double deltaSeconds, bool isDriving);
+    // Standalone batteries advance their own cell; attached ones only select the
+    // load and leave the batched update to the bank owner (see Fleet::tick).
+    void tick(double deltaSeconds, bool isDriving, bool ignitionOn = false);
+    
+    // Move this battery into a shared bank, keeping its charge and temperature
+    void attach(std::shared_ptr<BatteryBank> bank);
     
     BatteryInfo getInfo() const;
-    double getPercentage() const { return percentage_; }
+    double getPercentage() const { return bank_->percentage(index_); }
+    double getTemperature() const { return bank_->temperature(index_); }
     
-    void setPercentage(double pct) { percentage_ = std::clamp(pct, 0.0, 100.0); }
+    void setPercentage(double pct) { bank_->setPercentage(index_, std::clamp(pct, 0.0, 100.0)); }
+    void setTemperature(double celsius) { bank_->setTemperature(index_, celsius); }
     
 private:
     std::shared_ptr<IRng> rng_;
-    double percentage_ = 100.0;
-    
-    static constexpr double IDLE_DRAIN_PER_HOUR = 0.5;
-    static constexpr double DRIVING_DRAIN_PER_HOUR = 2.0;
-    static constexpr double MIN_VOLTAGE = 3.2;
-    static constexpr double MAX_VOLTAGE = 4.2;
+    std::shared_ptr<BatteryBank> bank_;
+    std::size_t index_ = 0;
+    bool sharedBank_ = false;
 };
 
-} // namespace tracker
\ No newline at end of file
+} // namespace tracker
@@ -0,0 +1,96 @@
+#include "BatteryModel.hpp"
+#include <algorithm>
+
+namespace tracker {
+
+namespace {
+    constexpr float kReferenceTempC = 25.0f;
+    constexpr float kColdResistancePerDegree = 0.03f;   // +3 % resistance per °C below 25
+    constexpr float kColdCapacityPerDegree = 0.01f;     // -1 % usable capacity per °C below 25
+    constexpr float kMinCapacityScale = 0.5f;
+    constexpr float kMinTerminalVolts = 2.5f;
+    constexpr float kMaxTerminalVolts = 4.4f;
+}
+
+BatteryBank::BatteryBank(BatteryParams params) : params_(params) {}
+
+std::size_t BatteryBank::add(double percentage, double temperatureC) {
+    soc_.push_back(static_cast<float>(std::clamp(percentage, 0.0, 100.0) / 100.0));
+    temperatureC_.push_back(static_cast<float>(temperatureC));
+    loadMa_.push_back(static_cast<float>(params_.idleLoadMa));
+    supplyMa_.push_back(0.0f);
+    currentA_.push_back(static_cast<float>(-params_.idleLoadMa / 1000.0));
+    noise_.push_back(0.0f);
+    voltage_.push_back(0.0f);
+
+    // Valid voltage before the first tick
+    std::size_t index = soc_.size() - 1;
+    evaluateVoltage(&soc_[index], &currentA_[index], &temperatureC_[index], &noise_[index],
+                    &voltage_[index], 1, static_cast<float>(params_.internalResistanceOhm));
+    return index;
+}
+
+void BatteryBank::setLoad(std::size_t index, bool isDriving, bool ignitionOn) {
+    loadMa_[index] = static_cast<float>(isDriving ? params_.drivingLoadMa : params_.idleLoadMa);
+    supplyMa_[index] = ignitionOn ? static_cast<float>(params_.chargeCurrentMa) : 0.0f;
+}
+
+void BatteryBank::setPercentage(std::size_t index, double percentage) {
+    soc_[index] = static_cast<float>(std::clamp(percentage, 0.0, 100.0) / 100.0);
+    evaluateVoltage(&soc_[index], &currentA_[index], &temperatureC_[index], &noise_[index],
+                    &voltage_[index], 1, static_cast<float>(params_.internalResistanceOhm));
+}
+
+void BatteryBank::setTemperature(std::size_t index, double temperatureC) {
+    temperatureC_[index] = static_cast<float>(temperatureC);
+}
+
+void BatteryBank::refreshNoise(IRng& rng) {
+    for (auto& n : noise_) {
+        n = static_cast<float>(rng.uniform(-params_.noiseVolts, params_.noiseVolts));
+    }
+}
+
+void BatteryBank::tick(double deltaSeconds) {
+    const std::size_t count = soc_.size();
+    const float hours = static_cast<float>(deltaSeconds / 3600.0);
+    const float capacityMah = static_cast<float>(params_.capacityMah);
+    const float taperStart = static_cast<float>(params_.taperStartPct / 100.0);
+    const float taperSpan = 1.0f - taperStart;
+
+    // Coulomb counting: net current into each cell
+    for (std::size_t i = 0; i < count; ++i) {
+        float taper = std::clamp((1.0f - soc_[i]) / taperSpan, 0.0f, 1.0f);
+        float netMa = supplyMa_[i] * taper - loadMa_[i];
+
+        float cold = std::max(0.0f, kReferenceTempC - temperatureC_[i]);
+        float usableMah = capacityMah * std::max(kMinCapacityScale, 1.0f - kColdCapacityPerDegree * cold);
+
+        soc_[i] = std::clamp(soc_[i] + netMa * hours / usableMah, 0.0f, 1.0f);
+        currentA_[i] = netMa * 0.001f;
+    }
+
+    evaluateVoltage(soc_.data(), currentA_.data(), temperatureC_.data(), noise_.data(),
+                    voltage_.data(), count, static_cast<float>(params_.internalResistanceOhm));
+}
+
+void BatteryBank::evaluateVoltage(const float* soc, const float* currentA,
+                                  const float* temperatureC, const float* noise,
+                                  float* voltage, std::size_t count, float resistanceOhm) {
+    constexpr float scale = static_cast<float>(kOcvPoints - 1);
+
+    for (std::size_t i = 0; i < count; ++i) {
+        float x = soc[i] * scale;
+        std::size_t index = std::min(static_cast<std::size_t>(x), kOcvPoints - 2);
+        float frac = x - static_cast<float>(index);
+        float ocv = kOcvTable[index] + (kOcvTable[index + 1] - kOcvTable[index]) * frac;
+
+        float delta = temperatureC[i] - kReferenceTempC;
+        float resistance = resistanceOhm * (1.0f + kColdResistancePerDegree * std::max(0.0f, -delta));
+
+        float v = ocv + kOcvTempCoeff * delta + currentA[i] * resistance + noise[i];
+        voltage[i] = std::clamp(v, kMinTerminalVolts, kMaxTerminalVolts);
+    }
+}
+
+} // namespace tracker
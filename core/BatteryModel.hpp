@@ -0,0 +1,124 @@
+/**
+ * @file BatteryModel.hpp
+ * @brief Li-ion battery model evaluated as a batched kernel over many cells
+ *
+ * Each cell is tracked by coulomb counting (state of charge from net current)
+ * and reports a terminal voltage of
+ *
+ *     V = OCV(soc) + kOcvTempCoeff * (T - 25) + I * R(T) + noise
+ *
+ * where OCV is a Li-ion open-circuit-voltage lookup table, I is the net
+ * current (positive while charging from the vehicle), R(T) is the internal
+ * resistance rising as the cell gets colder, and noise is ADC jitter drawn once
+ * per tick. Cold cells also deliver less usable capacity.
+ *
+ * BatteryBank stores cells as structure-of-arrays so one tick() updates a
+ * whole fleet with a branch-free LUT interpolation loop.
+ *
+ * @note Getters never draw random numbers; jitter is refreshed by refreshNoise()
+ * @note No allocation in tick() or refreshNoise()
+ */
+
+#pragma once
+
+#include "IRng.hpp"
+#include <array>
+#include <cstddef>
+#include <vector>
+
+namespace tracker {
+
+/**
+ * @brief Electrical parameters shared by all cells in a bank
+ *
+ * Defaults model a 2000 mAh tracker backup cell: 10 mA idle (~0.5 %/h),
+ * 40 mA while driving (~2 %/h, GNSS and modem active) and 500 mA from the
+ * vehicle supply while ignition is on.
+ */
+struct BatteryParams {
+    double capacityMah = 2000.0;            ///< Rated capacity at 25 °C
+    double internalResistanceOhm = 0.15;    ///< Internal resistance at 25 °C
+    double idleLoadMa = 10.0;               ///< Tracker draw when parked/idle
+    double drivingLoadMa = 40.0;            ///< Tracker draw while driving
+    double chargeCurrentMa = 500.0;         ///< Vehicle charge current (ignition on)
+    double taperStartPct = 80.0;            ///< Constant-voltage taper starts here
+    double noiseVolts = 0.01;               ///< ADC jitter amplitude (uniform ±)
+};
+
+/**
+ * @brief Structure-of-arrays battery cells updated by one batched kernel
+ */
+class BatteryBank {
+public:
+    /// OCV table resolution: points at 0, 5, ..., 100 % SoC
+    static constexpr std::size_t kOcvPoints = 21;
+
+    /// Li-ion open-circuit voltage at 25 °C, 5 % SoC steps
+    static constexpr std::array<float, kOcvPoints> kOcvTable = {
+        3.00f, 3.30f, 3.45f, 3.53f, 3.59f, 3.63f, 3.66f, 3.69f, 3.71f, 3.73f, 3.75f,
+        3.77f, 3.80f, 3.83f, 3.87f, 3.92f, 3.97f, 4.02f, 4.08f, 4.14f, 4.20f
+    };
+
+    /// OCV temperature coefficient (V/°C)
+    static constexpr float kOcvTempCoeff = 0.0005f;
+
+    explicit BatteryBank(BatteryParams params = {});
+
+    /**
+     * @brief Add a cell
+     * @param percentage Initial state of charge (0-100)
+     * @param temperatureC Cell temperature
+     * @return Cell index
+     */
+    std::size_t add(double percentage, double temperatureC = 25.0);
+
+    std::size_t size() const { return soc_.size(); }
+    const BatteryParams& params() const { return params_; }
+
+    /** @brief Select the load for the next tick (driving raises draw, ignition charges) */
+    void setLoad(std::size_t index, bool isDriving, bool ignitionOn);
+
+    void setPercentage(std::size_t index, double percentage);
+    void setTemperature(std::size_t index, double temperatureC);
+
+    double percentage(std::size_t index) const { return soc_[index] * 100.0; }
+    double voltage(std::size_t index) const { return voltage_[index]; }
+    double temperature(std::size_t index) const { return temperatureC_[index]; }
+
+    /** @brief Draw one ADC noise sample per cell for the next voltage evaluation */
+    void refreshNoise(IRng& rng);
+
+    /**
+     * @brief Advance all cells by dt: coulomb counting, then terminal voltage
+     * @param deltaSeconds Elapsed time
+     */
+    void tick(double deltaSeconds);
+
+    /**
+     * @brief Batched terminal-voltage kernel (LUT interpolation, no branches)
+     * @param soc State of charge per cell (0-1)
+     * @param currentA Net current per cell, positive when charging
+     * @param temperatureC Temperature per cell
+     * @param noise Precomputed jitter per cell (volts)
+     * @param voltage Output terminal voltage per cell
+     * @param count Number of cells
+     * @param resistanceOhm Internal resistance at 25 °C
+     */
+    static void evaluateVoltage(const float* soc, const float* currentA,
+                                const float* temperatureC, const float* noise,
+                                float* voltage, std::size_t count, float resistanceOhm);
+
+private:
+    BatteryParams params_;
+
+    // Per-cell columns (index = cell)
+    std::vector<float> soc_;            ///< State of charge (0-1)
+    std::vector<float> temperatureC_;   ///< Cell temperature
+    std::vector<float> loadMa_;         ///< Tracker draw for the current state
+    std::vector<float> supplyMa_;       ///< Vehicle supply (0 when ignition off)
+    std::vector<float> currentA_;       ///< Net current from last tick (+ = charging)
+    std::vector<float> noise_;          ///< Jitter for next evaluation
+    std::vector<float> voltage_;        ///< Terminal voltage from last evaluation
+};
+
+} // namespace tracker
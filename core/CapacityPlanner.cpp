@@ -0,0 +1,242 @@
+#include "CapacityPlanner.hpp"
+#include "Catalog.hpp"
+#include "Fleet.hpp"
+#include "IClock.hpp"
+#include "JsonCodec.hpp"
+#include <algorithm>
+#include <cmath>
+#include <iterator>
+#include <utility>
+
+namespace tracker {
+
+namespace {
+    constexpr double kSecondsPerDay = 86400.0;
+    constexpr double kMeteringBlockBytes = 4096.0;  // D2C messages are metered in 4 KB blocks
+
+    // Simulator::startDriving picks 45 +/- 15 km/h
+    constexpr double kMinTripSpeedKph = 30.0;
+    constexpr double kMaxTripSpeedKph = 60.0;
+
+    /// Published per-unit IoT Hub limits (throttles are max(floor, perUnit * units))
+    struct HubTier {
+        const char* name;
+        double messagesPerUnitPerDay;
+        double sendsFloor, sendsPerUnit;        // Device-to-cloud sends/s
+        double twinFloor, twinPerUnit;          // Twin reads/s
+        double connectsFloor, connectsPerUnit;  // Device connections/s
+        int maxUnits;
+        double relativeCost;                    // Unit list price relative to S1
+    };
+
+    constexpr HubTier kHubTiers[] = {
+        {"S1", 400000.0,    100.0, 12.0,   10.0, 1.0,  100.0, 12.0,   200, 1.0},
+        {"S2", 6000000.0,   100.0, 120.0,  10.0, 1.0,  100.0, 120.0,  200, 10.0},
+        {"S3", 300000000.0, 0.0,   6000.0, 0.0,  50.0, 0.0,   6000.0, 10,  100.0},
+    };
+
+    int unitsForRate(double rate, double floor, double perUnit) {
+        if (rate <= floor) return 1;
+        return static_cast<int>(std::ceil(rate / perUnit));
+    }
+
+    /// Busiest 1 s bucket of a periodic activity fired once per period by every device
+    double periodicPeak(double devices, double periodSeconds, bool spread, double jitter, double z) {
+        if (!spread) {
+            // All devices share phase 0; jitter smears the burst over jitter * period
+            return devices / std::max(1.0, jitter * periodSeconds);
+        }
+        double p = std::min(1.0, 1.0 / periodSeconds);
+        return devices * p + z * std::sqrt(devices * p * (1.0 - p));
+    }
+
+    std::size_t encodedSize(Event event, EventType type) {
+        event.eventType = type;
+        return JsonCodec::serialize(event).size();
+    }
+}
+
+const CapacityPlanner::TierPlan* CapacityPlanner::Plan::recommended() const {
+    const TierPlan* best = nullptr;
+    double bestCost = 0.0;
+    for (std::size_t i = 0; i < tiers.size(); ++i) {
+        if (!tiers[i].fits()) continue;
+        double cost = tiers[i].units * kHubTiers[i].relativeCost;
+        if (!best || cost < bestCost) {
+            best = &tiers[i];
+            bestCost = cost;
+        }
+    }
+    return best;
+}
+
+std::size_t CapacityPlanner::countFenceTransitions(const SimulatorConfig& config) {
+    if (config.route.empty() || config.geofences.empty()) {
+        return 0;
+    }
+
+    // The device parks at the route end; the next trip restarts at its beginning
+    auto catalog = Catalog::build(config.startLocation, config.route, config.geofences);
+    std::vector<std::uint32_t> end = catalog->routeStartFences;
+    for (const auto& crossing : catalog->routeCrossings) {
+        auto it = std::lower_bound(end.begin(), end.end(), crossing.fence);
+        if (crossing.enter) {
+            end.insert(it, crossing.fence);
+        } else {
+            end.erase(it);
+        }
+    }
+
+    std::vector<std::uint32_t> returning;
+    std::set_symmetric_difference(end.begin(), end.end(), catalog->routeStartFences.begin(),
+                                  catalog->routeStartFences.end(), std::back_inserter(returning));
+    return catalog->routeCrossings.size() + returning.size();
+}
+
+double CapacityPlanner::expectedMaxZ(double samples) {
+    if (samples < 2.0) return 0.0;
+    double a = std::sqrt(2.0 * std::log(samples));
+    double location = a - (std::log(std::log(samples)) + std::log(4.0 * 3.14159265358979323846)) / (2.0 * a);
+    return location + 0.5772156649 / a;  // Gumbel mean = location + Euler-Mascheroni * scale
+}
+
+std::size_t CapacityPlanner::mqttPublishBytes(std::size_t topicBytes, std::size_t payloadBytes) {
+    std::size_t remaining = 2 + topicBytes + 2 + payloadBytes;  // Topic length, topic, packet id, payload
+    std::size_t lengthBytes = 1;
+    for (std::size_t limit = 128; remaining >= limit && lengthBytes < 4; limit <<= 7) {
+        ++lengthBytes;
+    }
+    constexpr std::size_t kPubAckBytes = 4;
+    return 1 + lengthBytes + remaining + kPubAckBytes;
+}
+
+CapacityPlanner::Plan CapacityPlanner::plan(const SimulatorConfig& config, const Inputs& inputs) {
+    Plan plan;
+    plan.deviceCount = std::max<std::size_t>(1, inputs.deviceCount);
+    plan.phaseSpreading = config.phaseSpreading;
+    const double devices = static_cast<double>(plan.deviceCount);
+    const double batch = static_cast<double>(std::max<std::size_t>(1, inputs.batchMessages));
+    const double z = expectedMaxZ(kSecondsPerDay);
+
+    // Longest derived identity gives an upper bound on per-event bytes
+    SimulatorConfig last = Fleet::deriveDeviceConfig(config, plan.deviceCount - 1, plan.deviceCount);
+    std::string hubDeviceId = config.hasDpsConfig() ? last.imei : last.deviceId;
+
+    Event sample;
+    sample.deviceId = hubDeviceId;
+    sample.timestamp = SystemClock().iso8601();
+    sample.sequence = 100000;
+    sample.location = LocalFrame(config.startLocation.lat, config.startLocation.lon)
+                          .unproject({123.4f, -56.7f}, config.startLocation);
+    sample.speedKph = 45.0 + 1.0 / 3.0;
+    sample.heading = 360.0 / 7.0;
+    sample.battery = {200.0 / 3.0, 3.9 + 1.0 / 9.0};
+    sample.network = {-72, "LTE"};
+
+    // Custom fields at their initial values (constants, walk and counter starts)
+    std::vector<std::uint64_t> fieldRecord;
+    if (config.fieldSchema) {
+        fieldRecord.resize(config.fieldSchema->recordWords());
+        config.fieldSchema->initialize(reinterpret_cast<std::uint8_t*>(fieldRecord.data()));
+        sample.fieldSchema = config.fieldSchema.get();
+        sample.fieldRecord = reinterpret_cast<const std::uint8_t*>(fieldRecord.data());
+    }
+
+    plan.heartbeatBytes = encodedSize(sample, EventType::Heartbeat);
+
+    // Trip: ignition on + motion start (+ overspeed), motion stop at route end, ignition off
+    double overspeed = std::clamp((kMaxTripSpeedKph - config.speedLimitKph) / (kMaxTripSpeedKph - kMinTripSpeedKph), 0.0, 1.0);
+    plan.fenceTransitionsPerTrip = static_cast<double>(countFenceTransitions(config));
+    plan.eventsPerTrip = 4.0 + overspeed + plan.fenceTransitionsPerTrip;
+
+    double tripBytes = static_cast<double>(encodedSize(sample, EventType::IgnitionOn) +
+                                           encodedSize(sample, EventType::MotionStart) +
+                                           encodedSize(sample, EventType::MotionStop) +
+                                           encodedSize(sample, EventType::IgnitionOff));
+    if (overspeed > 0.0) {
+        Event speeding = sample;
+        speeding.extras = {{"limit", std::to_string(static_cast<int>(config.speedLimitKph))}, {"measured", "59"}};
+        tripBytes += overspeed * static_cast<double>(encodedSize(speeding, EventType::SpeedOverLimit));
+    }
+    if (plan.fenceTransitionsPerTrip > 0.0) {
+        std::string longestId;
+        for (const auto& fence : config.geofences) {
+            if (fence.id.size() > longestId.size()) longestId = fence.id;
+        }
+        Event fenceEvent = sample;
+        fenceEvent.extras = {{"geofenceId", longestId}};
+        tripBytes += plan.fenceTransitionsPerTrip * static_cast<double>(encodedSize(fenceEvent, EventType::GeofenceEnter));
+    }
+
+    // Per-device daily events and bytes
+    const double heartbeatSeconds = std::max(1, config.heartbeatSeconds);
+    const double heartbeatsPerDay = kSecondsPerDay / heartbeatSeconds;
+    const double tripsPerDay = std::max(0.0, inputs.tripsPerDay);
+    plan.eventsPerDeviceDay = heartbeatsPerDay + tripsPerDay * plan.eventsPerTrip;
+    double eventBytesPerDay = heartbeatsPerDay * static_cast<double>(plan.heartbeatBytes) + tripsPerDay * tripBytes;
+    plan.meanEventBytes = plan.eventsPerDeviceDay > 0.0 ? eventBytesPerDay / plan.eventsPerDeviceDay : 0.0;
+
+    double jsonBytes = batch * plan.meanEventBytes + (batch > 1.0 ? batch + 1.0 : 0.0);  // Commas and brackets
+    plan.payloadBytesPerPublish = jsonBytes * std::max(0.0, inputs.compressionRatio);
+    std::string topic = "devices/" + hubDeviceId + "/messages/events/";
+    plan.wireBytesPerPublish = static_cast<double>(
+        mqttPublishBytes(topic.size(), static_cast<std::size_t>(std::ceil(plan.payloadBytesPerPublish))));
+    plan.meteredPerPublish = std::max(1, static_cast<int>(std::ceil(plan.payloadBytesPerPublish / kMeteringBlockBytes)));
+
+    // Fleet event rate: periodic heartbeats plus Poisson trips with clustered starts
+    double tripsPerSecond = devices * tripsPerDay / kSecondsPerDay;
+    double tripEventsPerSecond = tripsPerSecond * plan.eventsPerTrip;
+    double startCluster = (1.0 - overspeed) * 4.0 + overspeed * 9.0;  // E[k^2] of the 2-3 start events
+    double tripVariance = tripsPerSecond * (startCluster + 2.0 + plan.fenceTransitionsPerTrip);
+
+    double heartbeatsPerSecond = devices / heartbeatSeconds;
+    plan.averagePublishesPerSecond = (heartbeatsPerSecond + tripEventsPerSecond) / batch;
+    if (config.phaseSpreading) {
+        double p = std::min(1.0, 1.0 / heartbeatSeconds);
+        double variance = devices * p * (1.0 - p) + tripVariance;
+        plan.peakPublishesPerSecond = plan.averagePublishesPerSecond + z * std::sqrt(variance / batch);
+    } else {
+        double heartbeatBurst = periodicPeak(devices, heartbeatSeconds, false, config.periodicJitter, z);
+        plan.peakPublishesPerSecond = (heartbeatBurst + tripEventsPerSecond) / batch + z * std::sqrt(tripVariance / batch);
+    }
+
+    if (config.twinRefreshSeconds > 0) {
+        double period = config.twinRefreshSeconds;
+        plan.twinReadsPerSecond = devices / period;
+        plan.peakTwinReadsPerSecond = periodicPeak(devices, period, config.phaseSpreading, config.periodicJitter, z);
+    }
+    if (!config.hasDpsConfig() || config.hasDpsSymmetricKey()) {
+        double period = std::max(1, config.sasTokenTtlSeconds * 6 / 10);
+        plan.reconnectsPerSecond = devices / period;
+        plan.peakReconnectsPerSecond = periodicPeak(devices, period, config.phaseSpreading, config.periodicJitter, z);
+    }
+
+    double publishesPerDay = plan.averagePublishesPerSecond * kSecondsPerDay;
+    plan.meteredMessagesPerDay = publishesPerDay * plan.meteredPerPublish + plan.twinReadsPerSecond * kSecondsPerDay;
+    plan.payloadBytesPerDay = publishesPerDay * plan.payloadBytesPerPublish;
+    plan.wireBytesPerDay = publishesPerDay * plan.wireBytesPerPublish;
+
+    for (const auto& tier : kHubTiers) {
+        TierPlan tierPlan;
+        tierPlan.name = tier.name;
+        tierPlan.maxUnits = tier.maxUnits;
+
+        std::pair<int, const char*> limits[] = {
+            {std::max(1, static_cast<int>(std::ceil(plan.meteredMessagesPerDay / tier.messagesPerUnitPerDay))), "daily message quota"},
+            {unitsForRate(plan.peakPublishesPerSecond, tier.sendsFloor, tier.sendsPerUnit), "device-to-cloud send throttle"},
+            {unitsForRate(plan.peakTwinReadsPerSecond, tier.twinFloor, tier.twinPerUnit), "twin read throttle"},
+            {unitsForRate(plan.peakReconnectsPerSecond, tier.connectsFloor, tier.connectsPerUnit), "connection throttle"},
+        };
+        for (const auto& [units, reason] : limits) {
+            if (units > tierPlan.units) {
+                tierPlan.units = units;
+                tierPlan.limitedBy = reason;
+            }
+        }
+        plan.tiers.push_back(tierPlan);
+    }
+
+    return plan;
+}
+
+} // namespace tracker
@@ -0,0 +1,103 @@
+/**
+ * @file CapacityPlanner.hpp
+ * @brief Analytical message-rate, bandwidth and IoT Hub sizing for a fleet config
+ *
+ * Answers "what will N devices with this config cost the hub?" without
+ * connecting or simulating. Per-device event rates come from the config
+ * (heartbeat, twin refresh, token renewal) and a trip model: each trip emits
+ * ignition/motion events plus the geofence transitions in the catalog's
+ * route crossing schedule. Payload sizes are
+ * measured by encoding representative events with JsonCodec.
+ *
+ * Peaks use a normal approximation over one day of 1 s buckets: independent
+ * phase-spread devices make each bucket a sum of many rare firings, so the
+ * busiest second is the mean plus the expected Gaussian maximum over 86 400
+ * samples. Without phase spreading every periodic activity fires in the same
+ * second (spread only by jitter). Cost is one catalog build, independent of
+ * the device count.
+ *
+ * @note Hub limits are the published per-unit quotas and throttles; check the
+ *       current IoT Hub documentation before purchasing units
+ * @note Trips are Poisson arrivals at a configurable daily rate; the simulator
+ *       itself only drives when told to
+ */
+
+#pragma once
+
+#include "Simulator.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace tracker {
+
+class CapacityPlanner {
+public:
+    /** @brief Workload assumptions not contained in the config */
+    struct Inputs {
+        std::size_t deviceCount = 1;
+        double tripsPerDay = 2.0;           ///< Drive sessions per device per day
+        std::size_t batchMessages = 1;      ///< Events per publish (JSON array when > 1)
+        double compressionRatio = 1.0;      ///< Encoded payload size / JSON size
+    };
+
+    /** @brief Sizing of one IoT Hub tier */
+    struct TierPlan {
+        std::string name;
+        int units = 0;                      ///< Units needed to satisfy every limit
+        int maxUnits = 0;                   ///< Most units a hub of this tier can have
+        std::string limitedBy;              ///< Limit that determined the unit count
+        bool fits() const { return units <= maxUnits; }
+    };
+
+    /** @brief Planner result (rates are fleet-wide) */
+    struct Plan {
+        std::size_t deviceCount = 0;
+        bool phaseSpreading = true;
+
+        // Per-device model
+        double eventsPerTrip = 0.0;         ///< Ignition/motion/overspeed plus fence transitions
+        double fenceTransitionsPerTrip = 0.0;
+        double eventsPerDeviceDay = 0.0;    ///< Telemetry events (heartbeats and trips)
+
+        // Payload model
+        std::size_t heartbeatBytes = 0;     ///< Encoded heartbeat JSON
+        double meanEventBytes = 0.0;        ///< Traffic-weighted encoded event size
+        double payloadBytesPerPublish = 0.0;///< After batching and compression
+        double wireBytesPerPublish = 0.0;   ///< Plus MQTT PUBLISH/PUBACK framing (no TLS)
+        int meteredPerPublish = 1;          ///< 4 KB metering blocks per publish
+
+        // Fleet rates
+        double averagePublishesPerSecond = 0.0;
+        double peakPublishesPerSecond = 0.0;///< Busiest second of a day
+        double twinReadsPerSecond = 0.0;
+        double peakTwinReadsPerSecond = 0.0;
+        double reconnectsPerSecond = 0.0;   ///< SAS token renewals
+        double peakReconnectsPerSecond = 0.0;
+        double meteredMessagesPerDay = 0.0; ///< Telemetry blocks plus twin reads
+        double payloadBytesPerDay = 0.0;
+        double wireBytesPerDay = 0.0;
+
+        std::vector<TierPlan> tiers;        ///< S1, S2, S3
+        const TierPlan* recommended() const;
+    };
+
+    /**
+     * @brief Model the load of inputs.deviceCount devices derived from config
+     * @param config Base configuration (as passed to Fleet::configure)
+     * @param inputs Trip rate, batching and compression assumptions
+     */
+    static Plan plan(const SimulatorConfig& config, const Inputs& inputs);
+
+    /** @brief Geofence transitions on one traversal of the route and back to its start */
+    static std::size_t countFenceTransitions(const SimulatorConfig& config);
+
+    /** @brief Expected maximum of n standard normal samples (Gumbel approximation) */
+    static double expectedMaxZ(double samples);
+
+    /** @brief MQTT PUBLISH (QoS 1) plus PUBACK bytes for a topic and payload */
+    static std::size_t mqttPublishBytes(std::size_t topicBytes, std::size_t payloadBytes);
+};
+
+} // namespace tracker
@@ -0,0 +1,222 @@
+#include "Catalog.hpp"
+#include <algorithm>
+#include <cmath>
+
+namespace tracker {
+
+namespace {
+
+/**
+ * Solve every segment against the fences bucketed along it. Membership is
+ * carried across segments so a crossing is only emitted when it changes
+ * whether the route is inside a fence; tangent touches are ignored.
+ */
+void buildRouteCrossings(Catalog& catalog) {
+    const auto& route = catalog.enuRoute;
+    const auto& fences = catalog.enuFences;
+
+    std::vector<std::uint8_t> inside(fences.size(), 0);
+    if (!route.empty()) {
+        LocalFrame::insideFences(route.front(), fences.data(), fences.size(), inside.data());
+        for (std::uint32_t f = 0; f < fences.size(); ++f) {
+            if (inside[f]) catalog.routeStartFences.push_back(f);
+        }
+    }
+    if (route.size() < 2 || fences.empty()) {
+        for (std::size_t i = 1; i < route.size(); ++i) {
+            catalog.routeLengthMeters += LocalFrame::distanceMeters(route[i - 1], route[i]);
+        }
+        return;
+    }
+
+    const double segments = static_cast<double>(route.size() - 1);
+    std::vector<std::uint32_t> candidates;
+    std::vector<RouteCrossing> segmentCrossings;
+
+    for (std::size_t k = 0; k + 1 < route.size(); ++k) {
+        const double ax = route[k].east, ay = route[k].north;
+        const double dx = route[k + 1].east - ax, dy = route[k + 1].north - ay;
+        const double lengthSq = dx * dx + dy * dy;
+        const double length = std::sqrt(lengthSq);
+
+        segmentCrossings.clear();
+        if (lengthSq > 0.0) {
+            catalog.fenceIndex.collect(route[k], route[k + 1], candidates);
+            for (auto f : candidates) {
+                // |a + t*d - c|^2 = r^2
+                const double fx = ax - fences[f].east, fy = ay - fences[f].north;
+                const double b = fx * dx + fy * dy;
+                const double c = fx * fx + fy * fy - fences[f].radiusSq;
+                const double disc = b * b - lengthSq * c;
+                if (disc <= 0.0) continue;
+
+                const double root = std::sqrt(disc);
+                const double t0 = (-b - root) / lengthSq;
+                const double t1 = (-b + root) / lengthSq;
+                if (t0 >= 0.0 && t0 <= 1.0) segmentCrossings.push_back({t0, 0.0, f, true});
+                if (t1 >= 0.0 && t1 <= 1.0) segmentCrossings.push_back({t1, 0.0, f, false});
+            }
+            std::sort(segmentCrossings.begin(), segmentCrossings.end(),
+                      [](const RouteCrossing& a, const RouteCrossing& b) {
+                          return a.progress != b.progress ? a.progress < b.progress : a.fence < b.fence;
+                      });
+        }
+
+        for (auto crossing : segmentCrossings) {
+            if (static_cast<bool>(inside[crossing.fence]) == crossing.enter) continue;
+            inside[crossing.fence] = crossing.enter;
+            double t = crossing.progress;
+            crossing.progress = (static_cast<double>(k) + t) / segments;
+            crossing.arcMeters = catalog.routeLengthMeters + t * length;
+            catalog.routeCrossings.push_back(crossing);
+        }
+        catalog.routeLengthMeters += length;
+    }
+}
+
+} // namespace
+
+void FenceGrid::build(const std::vector<EnuFence>& fences, float cellMeters) {
+    cellStart_.clear();
+    cellFences_.clear();
+    cellIds_.clear();
+    maxCellSize_ = 0;
+    cols_ = rows_ = 0;
+    if (fences.empty()) {
+        return;
+    }
+
+    // Bounds of all fence bounding squares
+    float minEast = fences[0].east, maxEast = fences[0].east;
+    float minNorth = fences[0].north, maxNorth = fences[0].north;
+    for (const auto& fence : fences) {
+        float r = std::sqrt(fence.radiusSq);
+        minEast = std::min(minEast, fence.east - r);
+        maxEast = std::max(maxEast, fence.east + r);
+        minNorth = std::min(minNorth, fence.north - r);
+        maxNorth = std::max(maxNorth, fence.north + r);
+    }
+
+    float extent = std::max(maxEast - minEast, maxNorth - minNorth);
+    cellMeters_ = std::max(cellMeters, extent / static_cast<float>(kMaxCellsPerAxis));
+    minEast_ = minEast;
+    minNorth_ = minNorth;
+    cols_ = static_cast<std::size_t>((maxEast - minEast) / cellMeters_) + 1;
+    rows_ = static_cast<std::size_t>((maxNorth - minNorth) / cellMeters_) + 1;
+
+    auto cellRange = [&](const EnuFence& fence, std::size_t& c0, std::size_t& c1,
+                         std::size_t& r0, std::size_t& r1) {
+        float r = std::sqrt(fence.radiusSq);
+        c0 = static_cast<std::size_t>((fence.east - r - minEast_) / cellMeters_);
+        c1 = std::min(cols_ - 1, static_cast<std::size_t>((fence.east + r - minEast_) / cellMeters_));
+        r0 = static_cast<std::size_t>((fence.north - r - minNorth_) / cellMeters_);
+        r1 = std::min(rows_ - 1, static_cast<std::size_t>((fence.north + r - minNorth_) / cellMeters_));
+    };
+
+    // Two passes (count, then fill) give a compact CSR layout
+    std::vector<std::uint32_t> counts(cols_ * rows_, 0);
+    for (const auto& fence : fences) {
+        std::size_t c0, c1, r0, r1;
+        cellRange(fence, c0, c1, r0, r1);
+        for (std::size_t row = r0; row <= r1; ++row) {
+            for (std::size_t col = c0; col <= c1; ++col) {
+                ++counts[row * cols_ + col];
+            }
+        }
+    }
+
+    cellStart_.assign(cols_ * rows_ + 1, 0);
+    for (std::size_t i = 0; i < counts.size(); ++i) {
+        cellStart_[i + 1] = cellStart_[i] + counts[i];
+        maxCellSize_ = std::max<std::size_t>(maxCellSize_, counts[i]);
+    }
+
+    cellFences_.resize(cellStart_.back());
+    cellIds_.resize(cellStart_.back());
+    std::vector<std::uint32_t> cursor(cellStart_.begin(), cellStart_.end() - 1);
+    for (std::size_t i = 0; i < fences.size(); ++i) {
+        std::size_t c0, c1, r0, r1;
+        cellRange(fences[i], c0, c1, r0, r1);
+        for (std::size_t row = r0; row <= r1; ++row) {
+            for (std::size_t col = c0; col <= c1; ++col) {
+                std::uint32_t slot = cursor[row * cols_ + col]++;
+                cellFences_[slot] = fences[i];
+                cellIds_[slot] = static_cast<std::uint32_t>(i);
+            }
+        }
+    }
+}
+
+FenceGrid::Candidates FenceGrid::query(EnuPoint point) const {
+    if (cols_ == 0) {
+        return {};
+    }
+
+    float x = (point.east - minEast_) / cellMeters_;
+    float y = (point.north - minNorth_) / cellMeters_;
+    if (!(x >= 0.0f && y >= 0.0f)) {
+        return {};  // Outside the grid (also rejects NaN)
+    }
+
+    auto col = static_cast<std::size_t>(x);
+    auto row = static_cast<std::size_t>(y);
+    if (col >= cols_ || row >= rows_) {
+        return {};
+    }
+
+    std::size_t cell = row * cols_ + col;
+    std::uint32_t begin = cellStart_[cell];
+    return {cellFences_.data() + begin, cellIds_.data() + begin, cellStart_[cell + 1] - begin};
+}
+
+void FenceGrid::collect(EnuPoint a, EnuPoint b, std::vector<std::uint32_t>& ids) const {
+    ids.clear();
+    if (cols_ == 0) {
+        return;
+    }
+
+    float x0 = (std::min(a.east, b.east) - minEast_) / cellMeters_;
+    float x1 = (std::max(a.east, b.east) - minEast_) / cellMeters_;
+    float y0 = (std::min(a.north, b.north) - minNorth_) / cellMeters_;
+    float y1 = (std::max(a.north, b.north) - minNorth_) / cellMeters_;
+    if (!(x1 >= 0.0f && y1 >= 0.0f) || x0 >= static_cast<float>(cols_) || y0 >= static_cast<float>(rows_)) {
+        return;   // Box misses the grid (also rejects NaN)
+    }
+
+    auto c0 = static_cast<std::size_t>(std::max(x0, 0.0f));
+    auto c1 = std::min(cols_ - 1, static_cast<std::size_t>(x1));
+    auto r0 = static_cast<std::size_t>(std::max(y0, 0.0f));
+    auto r1 = std::min(rows_ - 1, static_cast<std::size_t>(y1));
+    for (std::size_t row = r0; row <= r1; ++row) {
+        for (std::size_t col = c0; col <= c1; ++col) {
+            std::size_t cell = row * cols_ + col;
+            ids.insert(ids.end(), cellIds_.begin() + cellStart_[cell], cellIds_.begin() + cellStart_[cell + 1]);
+        }
+    }
+    std::sort(ids.begin(), ids.end());
+    ids.erase(std::unique(ids.begin(), ids.end()), ids.end());
+}
+
+std::unique_ptr<Catalog> Catalog::build(const Location& origin,
+                                        std::vector<RoutePoint> route,
+                                        std::vector<Geofence> geofences,
+                                        std::uint64_t version) {
+    auto catalog = std::make_unique<Catalog>();
+    catalog->version = version;
+    catalog->frame = LocalFrame(origin.lat, origin.lon);
+    catalog->route = std::move(route);
+    catalog->geofences = std::move(geofences);
+
+    catalog->enuRoute = catalog->frame.projectRoute(catalog->route);
+    catalog->enuFences.reserve(catalog->geofences.size());
+    catalog->fenceById.reserve(catalog->geofences.size());
+    for (std::size_t i = 0; i < catalog->geofences.size(); ++i) {
+        catalog->enuFences.push_back(catalog->frame.projectFence(catalog->geofences[i]));
+        catalog->fenceById.emplace(catalog->geofences[i].id, static_cast<std::uint32_t>(i));
+    }
+    catalog->fenceIndex.build(catalog->enuFences);
+    buildRouteCrossings(*catalog);
+    return catalog;
+}
+
+} // namespace tracker
@@ -0,0 +1,123 @@
+/**
+ * @file Catalog.hpp
+ * @brief Immutable route and geofence catalog with a uniform-grid fence index
+ *
+ * A Catalog is built once (projection into the regional ENU frame, grid
+ * bucketing) and never modified afterwards, so any number of devices can read
+ * it concurrently. Reloads build a new Catalog and publish it through
+ * CatalogStore.
+ *
+ * FenceGrid buckets fences by the grid cells their bounding squares touch and
+ * stores each cell's fences contiguously, so a containment test is one cell
+ * lookup followed by LocalFrame::insideFences() over a short array.
+ *
+ * The route's fence crossings are also solved once per catalog: each route
+ * segment is intersected with the fences bucketed along it, giving a sorted
+ * enter/exit schedule that route-following devices replay with a cursor
+ * instead of testing containment every tick.
+ *
+ * @note Fences are identified across catalog versions by Geofence::id
+ */
+
+#pragma once
+
+#include "Geo.hpp"
+#include "LocalFrame.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace tracker {
+
+/**
+ * @brief Uniform grid over ENU fences (cell -> contiguous fence copies)
+ */
+class FenceGrid {
+public:
+    /// Default cell edge; fences larger than a cell are stored in every cell they touch
+    static constexpr float kDefaultCellMeters = 500.0f;
+
+    /// Upper bound on cells per axis (cell size grows for very large regions)
+    static constexpr std::size_t kMaxCellsPerAxis = 1024;
+
+    /// Fences that may contain a point
+    struct Candidates {
+        const EnuFence* fences = nullptr;   ///< Contiguous fence geometry
+        const std::uint32_t* ids = nullptr; ///< Catalog fence index per entry (ascending)
+        std::size_t count = 0;
+    };
+
+    /**
+     * @brief Build the grid
+     * @param fences Fences in catalog order (index = fence id in Candidates)
+     * @param cellMeters Requested cell edge
+     */
+    void build(const std::vector<EnuFence>& fences, float cellMeters = kDefaultCellMeters);
+
+    /** @brief Fences whose bounding square covers the point's cell */
+    Candidates query(EnuPoint point) const;
+
+    /**
+     * @brief Fences bucketed in any cell the segment's bounding box touches
+     * @param ids Catalog fence indices, sorted and unique (replaced)
+     */
+    void collect(EnuPoint a, EnuPoint b, std::vector<std::uint32_t>& ids) const;
+
+    /** @brief Largest number of fences in one cell (sizes per-query scratch) */
+    std::size_t maxCellSize() const { return maxCellSize_; }
+
+private:
+    float cellMeters_ = kDefaultCellMeters;
+    float minEast_ = 0.0f;
+    float minNorth_ = 0.0f;
+    std::size_t cols_ = 0;
+    std::size_t rows_ = 0;
+    std::size_t maxCellSize_ = 0;
+    std::vector<std::uint32_t> cellStart_;  ///< CSR offsets, cols_ * rows_ + 1
+    std::vector<EnuFence> cellFences_;      ///< Fence copies grouped by cell
+    std::vector<std::uint32_t> cellIds_;    ///< Catalog index of each copy
+};
+
+/**
+ * @brief Geofence boundary crossing along the route
+ */
+struct RouteCrossing {
+    double progress = 0.0;      ///< Route progress at the crossing (LocalFrame::interpolateRoute units)
+    double arcMeters = 0.0;     ///< Distance along the route
+    std::uint32_t fence = 0;    ///< Catalog fence index
+    bool enter = false;         ///< Enter (true) or exit (false)
+};
+
+/**
+ * @brief One immutable version of the route and geofence tables
+ */
+struct Catalog {
+    std::uint64_t version = 0;              ///< Monotonic per store (0 = device-local)
+    LocalFrame frame;                       ///< Frame all ENU data is projected into
+    std::vector<RoutePoint> route;          ///< Route waypoints (WGS84)
+    std::vector<EnuPoint> enuRoute;         ///< Route projected into frame
+    std::vector<Geofence> geofences;        ///< Geofences (WGS84, ids for events)
+    std::vector<EnuFence> enuFences;        ///< Geofences projected into frame
+    FenceGrid fenceIndex;                   ///< Spatial index over enuFences
+    std::unordered_map<std::string, std::uint32_t> fenceById;  ///< Geofence id -> index
+    std::vector<std::uint32_t> routeStartFences;   ///< Fences containing the route start (ascending)
+    std::vector<RouteCrossing> routeCrossings;     ///< Every crossing along enuRoute, by progress
+    double routeLengthMeters = 0.0;
+
+    /**
+     * @brief Project and index a route and fence set
+     * @param origin Frame origin (the fleet's start location)
+     * @param route Route waypoints
+     * @param geofences Circular geofences
+     * @param version Catalog version
+     */
+    static std::unique_ptr<Catalog> build(const Location& origin,
+                                          std::vector<RoutePoint> route,
+                                          std::vector<Geofence> geofences,
+                                          std::uint64_t version = 0);
+};
+
+} // namespace tracker
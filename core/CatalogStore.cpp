@@ -0,0 +1,90 @@
+#include "CatalogStore.hpp"
+#include <algorithm>
+
+namespace tracker {
+
+CatalogStore::ReadGuard::ReadGuard(CatalogStore& store, std::size_t reader)
+    : store_(store), reader_(reader), catalog_(nullptr) {
+    if (reader_ >= kMaxReaders) {
+        fallback_ = std::unique_lock<std::mutex>(store_.writerMutex_);
+        catalog_ = store_.current_.load(std::memory_order_acquire);
+        return;
+    }
+
+    // Announce the epoch before loading the pointer (both seq_cst): a writer that
+    // retires the catalog we load tags it with an epoch >= the one announced here
+    auto& slot = store_.readers_[reader_].epoch;
+    slot.store(store_.epoch_.load(std::memory_order_seq_cst), std::memory_order_seq_cst);
+    catalog_ = store_.current_.load(std::memory_order_seq_cst);
+}
+
+CatalogStore::ReadGuard::~ReadGuard() {
+    if (reader_ < kMaxReaders) {
+        store_.readers_[reader_].epoch.store(kIdle, std::memory_order_release);
+    }
+}
+
+CatalogStore::CatalogStore(std::unique_ptr<Catalog> initial) {
+    initial->version = 1;
+    version_.store(1, std::memory_order_relaxed);
+    current_.store(initial.release(), std::memory_order_release);
+}
+
+CatalogStore::~CatalogStore() {
+    delete current_.load(std::memory_order_acquire);
+    for (auto& [epoch, catalog] : retired_) {
+        delete catalog;
+    }
+}
+
+std::size_t CatalogStore::registerReader() {
+    std::lock_guard<std::mutex> lock(writerMutex_);
+    std::size_t reader = readerCount_.load(std::memory_order_relaxed);
+    if (reader >= kMaxReaders) {
+        return kNoReader;
+    }
+    readerCount_.store(reader + 1, std::memory_order_release);
+    return reader;
+}
+
+std::uint64_t CatalogStore::publish(std::unique_ptr<Catalog> next) {
+    std::lock_guard<std::mutex> lock(writerMutex_);
+
+    std::uint64_t version = version_.load(std::memory_order_relaxed) + 1;
+    next->version = version;
+
+    const Catalog* previous = current_.exchange(next.release(), std::memory_order_seq_cst);
+    std::uint64_t retiredAt = epoch_.fetch_add(1, std::memory_order_seq_cst);
+    retired_.emplace_back(retiredAt, previous);
+    version_.store(version, std::memory_order_release);
+    return version;
+}
+
+std::size_t CatalogStore::reclaim() {
+    std::lock_guard<std::mutex> lock(writerMutex_);
+
+    std::uint64_t oldestActive = kIdle;
+    std::size_t readers = readerCount_.load(std::memory_order_acquire);
+    for (std::size_t i = 0; i < readers; ++i) {
+        oldestActive = std::min(oldestActive, readers_[i].epoch.load(std::memory_order_seq_cst));
+    }
+
+    // A catalog retired at epoch e is unreachable once no reader announced <= e
+    auto unreachable = [&](const auto& entry) { return entry.first < oldestActive; };
+    std::size_t freed = 0;
+    for (auto& entry : retired_) {
+        if (unreachable(entry)) {
+            delete entry.second;
+            ++freed;
+        }
+    }
+    retired_.erase(std::remove_if(retired_.begin(), retired_.end(), unreachable), retired_.end());
+    return freed;
+}
+
+std::size_t CatalogStore::retiredCount() const {
+    std::lock_guard<std::mutex> lock(writerMutex_);
+    return retired_.size();
+}
+
+} // namespace tracker
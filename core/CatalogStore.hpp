@@ -0,0 +1,108 @@
+/**
+ * @file CatalogStore.hpp
+ * @brief RCU-style publication of Catalog versions with epoch-based reclamation
+ *
+ * Readers (fleet tick threads) enter a read-side section by announcing the
+ * current global epoch in their own slot and loading the catalog pointer; no
+ * lock, no reference count. The writer (reload thread) swaps the pointer,
+ * tags the old catalog with the epoch at which it was retired and frees it
+ * only once every active reader has announced a later epoch.
+ *
+ * Readers must not keep a Catalog pointer outside a ReadGuard; copy what must
+ * persist (ids, frame) instead.
+ *
+ * @note Readers beyond kMaxReaders fall back to the writer mutex (correct, not lock-free)
+ */
+
+#pragma once
+
+#include "Catalog.hpp"
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+namespace tracker {
+
+class CatalogStore {
+public:
+    /// Reader slots available for lock-free access
+    static constexpr std::size_t kMaxReaders = 64;
+
+    /// Returned by registerReader() when all slots are taken
+    static constexpr std::size_t kNoReader = kMaxReaders;
+
+    /**
+     * @brief RAII read-side section (one per reader slot at a time)
+     */
+    class ReadGuard {
+    public:
+        ReadGuard(CatalogStore& store, std::size_t reader);
+        ~ReadGuard();
+
+        ReadGuard(const ReadGuard&) = delete;
+        ReadGuard& operator=(const ReadGuard&) = delete;
+
+        /** @brief Catalog valid until the guard is destroyed */
+        const Catalog* get() const { return catalog_; }
+        const Catalog* operator->() const { return catalog_; }
+
+    private:
+        CatalogStore& store_;
+        std::size_t reader_;
+        const Catalog* catalog_;
+        std::unique_lock<std::mutex> fallback_;
+    };
+
+    /**
+     * @brief Create a store publishing an initial catalog
+     * @param initial First catalog (its version is set to 1)
+     */
+    explicit CatalogStore(std::unique_ptr<Catalog> initial);
+    ~CatalogStore();
+
+    CatalogStore(const CatalogStore&) = delete;
+    CatalogStore& operator=(const CatalogStore&) = delete;
+
+    /** @brief Claim a reader slot (once per reading thread) */
+    std::size_t registerReader();
+
+    /**
+     * @brief Publish a new catalog and retire the previous one
+     * @param next Replacement (its version is assigned here)
+     * @return Version of the published catalog
+     */
+    std::uint64_t publish(std::unique_ptr<Catalog> next);
+
+    /** @brief Free retired catalogs no reader can still see; returns count freed */
+    std::size_t reclaim();
+
+    /** @brief Version of the current catalog */
+    std::uint64_t version() const { return version_.load(std::memory_order_acquire); }
+
+    /** @brief Retired catalogs awaiting reclamation */
+    std::size_t retiredCount() const;
+
+private:
+    static constexpr std::uint64_t kIdle = std::numeric_limits<std::uint64_t>::max();
+
+    struct alignas(64) ReaderSlot {
+        std::atomic<std::uint64_t> epoch{kIdle};   ///< Epoch announced by an active reader
+    };
+
+    std::atomic<const Catalog*> current_;
+    std::atomic<std::uint64_t> epoch_{1};           ///< Global epoch, advanced per publish
+    std::atomic<std::uint64_t> version_{0};
+    std::array<ReaderSlot, kMaxReaders> readers_;
+    std::atomic<std::size_t> readerCount_{0};
+
+    mutable std::mutex writerMutex_;                ///< Serializes publish/reclaim (and fallback readers)
+    std::vector<std::pair<std::uint64_t, const Catalog*>> retired_;  ///< (retire epoch, catalog)
+};
+
+} // namespace tracker
@@ -1,4 +1,6 @@
 #include "DpsConnectionManager.hpp"
+#include "Probes.hpp"
+#include "../crypto/SasToken.hpp"
 #include "../net/mqtt/PahoMqttClient.hpp"
 #include <iostream>
 #include <filesystem>
@@ -18,7 +20,7 @@ void DpsConnectionManager::connectToIotHub(const DeviceConfig& config, Connectio
         return;
     }
     
-    if (!validateCertificatePaths(config)) {
+    if (config.symmetricKeyBase64.empty() && !validateCertificatePaths(config)) {
         if (callback) {
             callback(false, "Invalid certificate paths");
         }
@@ -27,9 +29,10 @@ void DpsConnectionManager::connectToIotHub(const DeviceConfig& config, Connectio
     
     config_ = config;
     connectionCallback_ = callback;
-    state_ = ConnectionState::Provisioning;
+    setState(ConnectionState::Provisioning);
     
     dpsProvisioning_ = std::make_unique<DpsProvisioning>(provisioningClient_);
+    dpsProvisioning_->setStartupTimeline(startup_);
     
     DpsConfig dpsConfig;
     dpsConfig.idScope = config_.idScope;
@@ -38,6 +41,7 @@ void DpsConnectionManager::connectToIotHub(const DeviceConfig& config, Connectio
     dpsConfig.tlsConfig.keyPath = config_.deviceKeyPath;
     dpsConfig.tlsConfig.caPath = config_.rootCaPath;
     dpsConfig.tlsConfig.verifyServer = config_.verifyServerCert;
+    dpsConfig.symmetricKeyBase64 = config_.symmetricKeyBase64;
     
     std::cout << "[DPS Connection Manager] Starting DPS provisioning for device: " << config_.imei << std::endl;
     
@@ -57,7 +61,7 @@ void DpsConnectionManager::disconnect() {
         hubClient_->disconnect();
     }
     
-    state_ = ConnectionState::Disconnected;
+    setState(ConnectionState::Disconnected);
     assignedHub_.clear();
     deviceId_.clear();
 }
@@ -124,7 +128,10 @@ void DpsConnectionManager::onProvisioningComplete(const ProvisioningResult& resu
         
         std::cout << "[DPS Connection Manager] Provisioning successful. Connecting to IoT Hub: " << assignedHub_ << std::endl;
         
-        state_ = ConnectionState::ConnectingToHub;
+        setState(ConnectionState::ConnectingToHub);
+        if (startup_) {
+            startup_->begin(StartupPhase::HubConnect);
+        }
         
         hubClient_->setConnectionCallback([this](bool connected, const std::string& reason) {
             onHubConnected(connected, reason);
@@ -136,24 +143,16 @@ void DpsConnectionManager::onProvisioningComplete(const ProvisioningResult& resu
             });
         }
         
-        std::string username = assignedHub_ + "/" + deviceId_ + "/?api-version=2021-04-12";
-        
-        TlsConfig tlsConfig;
-        tlsConfig.certPath = config_.deviceCertPath;
-        tlsConfig.keyPath = config_.deviceKeyPath;
-        tlsConfig.caPath = config_.rootCaPath;
-        tlsConfig.verifyServer = config_.verifyServerCert;
-        
-        bool connectionStarted = hubClient_->connectWithTls(assignedHub_, 8883, deviceId_, username, tlsConfig);
+        bool connectionStarted = connectHubClient();
         
         if (!connectionStarted) {
-            state_ = ConnectionState::Failed;
+            setState(ConnectionState::Failed);
             if (connectionCallback_) {
                 connectionCallback_(false, "Failed to initiate connection to IoT Hub");
             }
         }
     } else {
-        state_ = ConnectionState::Failed;
+        setState(ConnectionState::Failed);
         if (connectionCallback_) {
             connectionCallback_(false, "DPS provisioning failed: " + result.errorMessage);
         }
@@ -162,18 +161,60 @@ void DpsConnectionManager::onProvisioningComplete(const ProvisioningResult& resu
     dpsProvisioning_.reset();
 }
 
+bool DpsConnectionManager::renewHubCredentials() {
+    if (config_.symmetricKeyBase64.empty() || assignedHub_.empty() || state_ != ConnectionState::Connected) {
+        return false;
+    }
+    
+    std::cout << "[DPS Connection Manager] Renewing IoT Hub SAS token for device: " << deviceId_ << std::endl;
+    setState(ConnectionState::ConnectingToHub);
+    if (!connectHubClient()) {
+        setState(ConnectionState::Failed);
+        if (connectionCallback_) {
+            connectionCallback_(false, "Failed to reconnect to IoT Hub");
+        }
+        return false;
+    }
+    return true;
+}
+
+bool DpsConnectionManager::connectHubClient() {
+    std::string username = assignedHub_ + "/" + deviceId_ + "/?api-version=2021-04-12";
+    
+    if (!config_.symmetricKeyBase64.empty()) {
+        // The derived device key is also the hub identity's key
+        SasToken::Config sasConfig;
+        sasConfig.host = assignedHub_;
+        sasConfig.deviceId = deviceId_;
+        sasConfig.deviceKeyBase64 = config_.symmetricKeyBase64;
+        sasConfig.expirySeconds = static_cast<std::uint64_t>(config_.sasTokenTtl.count());
+        return hubClient_->connect(assignedHub_, 8883, deviceId_, username, SasToken::generate(sasConfig));
+    }
+    
+    TlsConfig tlsConfig;
+    tlsConfig.certPath = config_.deviceCertPath;
+    tlsConfig.keyPath = config_.deviceKeyPath;
+    tlsConfig.caPath = config_.rootCaPath;
+    tlsConfig.verifyServer = config_.verifyServerCert;
+    
+    return hubClient_->connectWithTls(assignedHub_, 8883, deviceId_, username, tlsConfig);
+}
+
 void DpsConnectionManager::onHubConnected(bool connected, const std::string& reason) {
     if (connected) {
-        state_ = ConnectionState::Connected;
+        setState(ConnectionState::Connected);
         std::cout << "[DPS Connection Manager] Successfully connected to IoT Hub: " << assignedHub_ << std::endl;
         
+        if (startup_) {
+            startup_->transition(StartupPhase::HubConnect, StartupPhase::Subscribe);
+        }
         hubClient_->subscribe(buildDeviceCommandTopic(), 1);
         
         if (connectionCallback_) {
             connectionCallback_(true, "Connected to IoT Hub via DPS");
         }
     } else {
-        state_ = ConnectionState::Failed;
+        setState(ConnectionState::Failed);
         if (connectionCallback_) {
             connectionCallback_(false, "Failed to connect to IoT Hub: " + reason);
         }
@@ -215,4 +256,9 @@ std::string DpsConnectionManager::buildDeviceCommandTopic() const {
     return "devices/" + deviceId_ + "/messages/devicebound/#";
 }
 
+void DpsConnectionManager::setState(ConnectionState next) {
+    TRACKER_PROBE3(dps_state, 1, static_cast<int>(state_), static_cast<int>(next));
+    state_ = next;
+}
+
 } // namespace tracker
\ No newline at end of file
@@ -52,6 +52,8 @@ struct DeviceConfig {
     std::string deviceChainPath;         ///< Path to certificate chain (.pem)
     std::string rootCaPath;              ///< Path to root CA certificate (.pem)
     bool verifyServerCert = true;        ///< Enable server certificate validation
+    std::string symmetricKeyBase64;      ///< Device key for symmetric-key attestation (replaces certificates)
+    std::chrono::seconds sasTokenTtl{3600}; ///< IoT Hub SAS token validity (symmetric key only)
     std::chrono::seconds timeout{120};   ///< Timeout for provisioning process
     
     /**
@@ -59,8 +61,11 @@ struct DeviceConfig {
      * @return true if configuration is complete, false otherwise
      */
     bool isValid() const {
-        return !imei.empty() && !idScope.empty() && 
-               !deviceCertPath.empty() && !deviceKeyPath.empty() && !rootCaPath.empty();
+        if (imei.empty() || idScope.empty()) {
+            return false;
+        }
+        return !symmetricKeyBase64.empty() ||
+               (!deviceCertPath.empty() && !deviceKeyPath.empty() && !rootCaPath.empty());
     }
 };
 
@@ -120,6 +125,13 @@ public:
      */
     void disconnect();
     
+    /**
+     * @brief Reconnect to the assigned IoT Hub with a fresh SAS token
+     * @return true if the reconnection was initiated
+     * @note Symmetric-key devices only; skips DPS since the assignment is still valid
+     */
+    bool renewHubCredentials();
+    
     /**
      * @brief Check if currently connected to IoT Hub
      * @return true if connected and ready for telemetry, false otherwise
@@ -195,6 +207,13 @@ public:
      */
     std::shared_ptr<IMqttClient> getHubClient() const { return hubClient_; }
     
+    /**
+     * @brief Stamp provisioning and hub connect phases on a cold-start timeline
+     * @param timeline Device timeline, or nullptr to stop profiling
+     * @note Call before connectToIotHub(); the timeline must outlive the manager
+     */
+    void setStartupTimeline(StartupTimeline* timeline) { startup_ = timeline; }
+    
 private:
     /// Connection state machine for DPS and IoT Hub workflow
     enum class ConnectionState {
@@ -219,6 +238,7 @@ private:
     
     std::string assignedHub_;                          ///< IoT Hub hostname from DPS
     std::string deviceId_;                             ///< Device ID from DPS
+    StartupTimeline* startup_ = nullptr;               ///< Optional cold-start profiling
     
     /**
      * @brief Handle completion of DPS provisioning process
@@ -246,6 +266,16 @@ private:
      */
     bool validateCertificatePaths(const DeviceConfig& config) const;
     
+    /**
+     * @brief Connect the hub client to the assigned IoT Hub
+     * @return true if the connection was initiated
+     * @note Uses a SAS token for symmetric-key devices, the certificates otherwise
+     */
+    bool connectHubClient();
+    
+    /** @brief Transition the connection state machine (traced as tracker:dps_state) */
+    void setState(ConnectionState next);
+    
     /**
      * @brief Build device-to-cloud MQTT topic for telemetry
      * @return Full MQTT topic path for publishing telemetry
@@ -1,4 +1,6 @@
 #include "DpsProvisioning.hpp"
+#include "Probes.hpp"
+#include "../crypto/SasToken.hpp"
 #include <iostream>
 #include <sstream>
 #include <iomanip>
@@ -25,7 +27,7 @@ DpsProvisioning::DpsProvisioning(std::shared_ptr<IMqttClient> mqttClient)
 void DpsProvisioning::startProvisioning(const DpsConfig& config, ProvisioningCallback callback) {
     config_ = config;
     callback_ = callback;
-    state_ = State::ConnectingToDps;
+    setState(State::ConnectingToDps);
     startTime_ = std::chrono::steady_clock::now();
     lastPoll_ = startTime_;
     
@@ -37,13 +39,37 @@ void DpsProvisioning::startProvisioning(const DpsConfig& config, ProvisioningCal
     std::cout << "[DPS] ID Scope: " << config_.idScope << std::endl;
     std::cout << "[DPS] Endpoint: " << config_.globalEndpoint << ":" << config_.port << std::endl;
     
-    bool connected = mqttClient_->connectWithTls(
-        config_.globalEndpoint,
-        config_.port,
-        config_.registrationId,
-        username,
-        config_.tlsConfig
-    );
+    bool connected = false;
+    if (!config_.symmetricKeyBase64.empty()) {
+        // Symmetric-key attestation: the SAS token is the MQTT password
+        auto expiry = std::chrono::duration_cast<std::chrono::seconds>(
+            std::chrono::system_clock::now().time_since_epoch() + kSasTokenTtl).count();
+        std::string password = SasToken::generateDps(config_.idScope, config_.registrationId,
+                                                     config_.symmetricKeyBase64,
+                                                     static_cast<std::uint64_t>(expiry));
+        if (startup_) {
+            startup_->transition(StartupPhase::Credentials, StartupPhase::DpsConnect);
+        }
+        connected = mqttClient_->connect(
+            config_.globalEndpoint,
+            config_.port,
+            config_.registrationId,
+            username,
+            password
+        );
+    } else {
+        // Certificate and key files are read by the TLS stack during the handshake
+        if (startup_) {
+            startup_->transition(StartupPhase::Credentials, StartupPhase::DpsConnect);
+        }
+        connected = mqttClient_->connectWithTls(
+            config_.globalEndpoint,
+            config_.port,
+            config_.registrationId,
+            username,
+            config_.tlsConfig
+        );
+    }
     
     if (!connected) {
         ProvisioningResult result;
@@ -78,7 +104,7 @@ void DpsProvisioning::processEvents() {
 void DpsProvisioning::cancel() {
     if (state_ != State::Idle && state_ != State::Completed && state_ != State::Failed) {
         mqttClient_->disconnect();
-        state_ = State::Failed;
+        setState(State::Failed);
     }
 }
 
@@ -88,6 +114,9 @@ void DpsProvisioning::onDpsConnected(bool connected, const std::string& reason)
     }
     
     if (connected) {
+        if (startup_) {
+            startup_->transition(StartupPhase::DpsConnect, StartupPhase::Register);
+        }
         mqttClient_->subscribe("$dps/registrations/res/#", 1);
         
         std::ostringstream registrationPayload;
@@ -97,7 +126,7 @@ void DpsProvisioning::onDpsConnected(bool connected, const std::string& reason)
         bool published = mqttClient_->publish(topic, registrationPayload.str(), 1);
         
         if (published) {
-            state_ = State::SendingRegistration;
+            setState(State::SendingRegistration);
             std::cout << "[DPS] Sent registration request for device: " << config_.registrationId << std::endl;
         } else {
             ProvisioningResult result;
@@ -127,9 +156,16 @@ void DpsProvisioning::onDpsMessage(const MqttMessage& message) {
 void DpsProvisioning::handleRegistrationResponse(const std::string& payload) {
     std::string status = extractJsonValue(payload, "status");
     
+    if (startup_) {
+        startup_->end(StartupPhase::Register);
+    }
+    
     if (status == "assigning") {
+        if (startup_) {
+            startup_->begin(StartupPhase::PollWait);
+        }
         operationId_ = extractJsonValue(payload, "operationId");
-        state_ = State::WaitingForAssignment;
+        setState(State::WaitingForAssignment);
         std::cout << "[DPS] Device assignment in progress, operation ID: " << operationId_ << std::endl;
     } else if (status == "assigned") {
         handleAssignmentResponse(payload);
@@ -149,6 +185,9 @@ void DpsProvisioning::handleAssignmentResponse(const std::string& payload) {
         std::string deviceId = extractJsonValue(payload, "deviceId");
         
         if (!assignedHub.empty() && !deviceId.empty()) {
+            if (startup_) {
+                startup_->end(StartupPhase::PollWait);
+            }
             ProvisioningResult result;
             result.success = true;
             result.assignedHub = assignedHub;
@@ -181,7 +220,7 @@ void DpsProvisioning::pollAssignmentStatus() {
 }
 
 void DpsProvisioning::completeProvisioning(const ProvisioningResult& result) {
-    state_ = result.success ? State::Completed : State::Failed;
+    setState(result.success ? State::Completed : State::Failed);
     mqttClient_->disconnect();
     
     if (callback_) {
@@ -222,4 +261,9 @@ std::string DpsProvisioning::buildPollingTopic() const {
     return "$dps/registrations/GET/iotdps-get-operationstatus/?$rid=2&operationId=" + operationId_;
 }
 
+void DpsProvisioning::setState(State next) {
+    TRACKER_PROBE3(dps_state, 0, static_cast<int>(state_), static_cast<int>(next));
+    state_ = next;
+}
+
 } // namespace tracker
\ No newline at end of file
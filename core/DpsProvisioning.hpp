@@ -7,7 +7,8 @@
  * with minimal dependencies and robust error handling.
  * 
  * DPS Workflow:
- * 1. Connect to DPS endpoint with X.509 client certificate
+ * 1. Connect to DPS endpoint with X.509 client certificate or a SAS token
+ *    signed with the device's symmetric key
  * 2. Send registration request with device IMEI
  * 3. Poll assignment status until hub is assigned
  * 4. Return assigned hub details for IoT Hub connection
@@ -24,6 +25,7 @@
 #pragma once
 
 #include "IMqttClient.hpp"
+#include "StartupProfiler.hpp"
 #include <string>
 #include <functional>
 #include <memory>
@@ -48,6 +50,7 @@ struct DpsConfig {
     std::string globalEndpoint = "global.azure-devices-provisioning.net"; ///< DPS endpoint
     std::uint16_t port = 8883;             ///< MQTT over TLS port
     TlsConfig tlsConfig;                    ///< X.509 certificate configuration
+    std::string symmetricKeyBase64;         ///< Device key for symmetric-key attestation (X.509 if empty)
     std::chrono::seconds timeout{120};     ///< Maximum time for provisioning process
 };
 
@@ -125,6 +128,12 @@ public:
      */
     void cancel();
     
+    /**
+     * @brief Stamp DPS startup phases (connect, register, poll wait) on a timeline
+     * @param timeline Device timeline, or nullptr to stop profiling
+     */
+    void setStartupTimeline(StartupTimeline* timeline) { startup_ = timeline; }
+    
 private:
     /// DPS provisioning state machine states
     enum class State {
@@ -139,6 +148,9 @@ private:
     /// DPS API version for MQTT communication
     static constexpr const char* kDpsApiVersion = "2019-03-31";
     
+    /// Validity of the registration SAS token (symmetric-key attestation)
+    static constexpr std::chrono::seconds kSasTokenTtl{3600};
+    
     /// Polling interval for assignment status (seconds)
     static constexpr std::chrono::seconds kPollingInterval{2};
     
@@ -149,6 +161,7 @@ private:
     std::string operationId_;                   ///< DPS operation ID for polling
     std::chrono::steady_clock::time_point startTime_; ///< Provisioning start time
     std::chrono::steady_clock::time_point lastPoll_;  ///< Last polling attempt time
+    StartupTimeline* startup_ = nullptr;        ///< Optional cold-start profiling
     
     /**
      * @brief Handle MQTT connection status changes
@@ -202,6 +215,9 @@ private:
      */
     bool isTimedOut() const;
     
+    /** @brief Transition the provisioning state machine (traced as tracker:dps_state) */
+    void setState(State next);
+    
     /**
      * @brief Build DPS registration topic for MQTT communication
      * @return MQTT topic for registration request
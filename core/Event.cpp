@@ -1,4 +1,5 @@
 #include "Event.hpp"
+#include <chrono>
 #include <unordered_map>
 
 namespace tracker {
@@ -37,4 +38,9 @@ EventType stringToEventType(const std::string& str) {
     return (it != stringMap.end()) ? it->second : EventType::Heartbeat;
 }
 
+int64_t traceClockUs() {
+    return std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
 } // namespace tracker
\ No newline at end of file
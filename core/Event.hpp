@@ -1,11 +1,14 @@
 #pragma once
 
+#include <cstdint>
 #include <string>
 #include <optional>
 #include <unordered_map>
 
 namespace tracker {
 
+class FieldSchema;
+
 enum class EventType {
     Heartbeat,
     IgnitionOn,
@@ -35,6 +38,23 @@ struct NetworkInfo {
     std::string rat = "LTE";
 };
 
+/**
+ * @brief End-to-end latency stamps carried in the payload
+ *
+ * Serialized as a compact "trace" object only when runId is set. Times are
+ * wall-clock microseconds (traceClockUs) so a consumer on another host can
+ * compare them with its receive time.
+ */
+struct TraceInfo {
+    std::string runId;              ///< Simulation run the event belongs to
+    int64_t generatedUs = 0;        ///< Event created
+    int64_t filteredUs = 0;         ///< Passed the reporting-policy filter
+    int64_t encodedUs = 0;          ///< Serialized
+    int64_t receivedUs = 0;         ///< Written to a capture (sim-cli --record); 0 on the wire
+
+    bool enabled() const { return !runId.empty(); }
+};
+
 struct Event {
     std::string deviceId;
     std::string timestamp;
@@ -48,9 +68,18 @@ struct Event {
     NetworkInfo network;
     
     std::unordered_map<std::string, std::string> extras;
+
+    TraceInfo trace;
+
+    /// Custom fields: flat record laid out by fieldSchema (non-owning, valid while the event is emitted)
+    const FieldSchema* fieldSchema = nullptr;
+    const uint8_t* fieldRecord = nullptr;
 };
 
 std::string eventTypeToString(EventType type);
 EventType stringToEventType(const std::string& str);
 
+/** @brief Wall-clock microseconds since the Unix epoch, the time base of TraceInfo */
+int64_t traceClockUs();
+
 } // namespace tracker
\ No newline at end of file
@@ -0,0 +1,114 @@
+#include "EventMerge.hpp"
+#include <algorithm>
+#include <limits>
+#include <thread>
+
+namespace tracker {
+
+namespace {
+constexpr std::uint64_t kClosed = std::numeric_limits<std::uint64_t>::max();
+}
+
+EventMerge::EventMerge(std::size_t lanes, std::size_t laneCapacity) {
+    lanes = std::max<std::size_t>(lanes, 1);
+    lanes_.reserve(lanes);
+    for (std::size_t i = 0; i < lanes; ++i) {
+        lanes_.push_back(std::make_unique<Lane>(laneCapacity));
+    }
+    heads_.resize(lanes);
+    tree_.resize(lanes);
+    winners_.resize(2 * lanes);
+}
+
+void EventMerge::append(std::size_t lane, const MergeKey& key, std::string payload) {
+    Record record{key, std::move(payload)};
+    auto& ring = lanes_[lane]->ring;
+    while (!ring.tryPush(std::move(record))) {
+        std::this_thread::yield();   // Lookahead bound reached: wait for the consumer
+    }
+}
+
+void EventMerge::advance(std::size_t lane, std::uint64_t time) {
+    lanes_[lane]->watermark.store(time, std::memory_order_release);
+}
+
+void EventMerge::close(std::size_t lane) {
+    advance(lane, kClosed);
+}
+
+EventMerge::Head EventMerge::headOf(std::size_t lane) {
+    auto& state = *lanes_[lane];
+    // Watermark first: records appended before it was raised are then visible below
+    std::uint64_t watermark = state.watermark.load(std::memory_order_acquire);
+    if (const Record* record = state.ring.front()) {
+        return {record->key, true};
+    }
+    return {{watermark, 0, 0}, false};
+}
+
+bool EventMerge::beats(std::size_t a, std::size_t b) const {
+    const Head& x = heads_[a];
+    const Head& y = heads_[b];
+    if (x.key < y.key) return true;
+    if (y.key < x.key) return false;
+    if (x.record != y.record) return !x.record;   // A bound holds back equal keys
+    return a < b;
+}
+
+void EventMerge::build() {
+    std::size_t k = lanes_.size();
+    for (std::size_t lane = 0; lane < k; ++lane) {
+        heads_[lane] = headOf(lane);
+        winners_[k + lane] = lane;
+    }
+    for (std::size_t node = k - 1; node >= 1; --node) {
+        std::size_t left = winners_[2 * node];
+        std::size_t right = winners_[2 * node + 1];
+        bool leftWins = beats(left, right);
+        winners_[node] = leftWins ? left : right;
+        tree_[node] = leftWins ? right : left;
+    }
+    tree_[0] = k > 1 ? winners_[1] : 0;
+}
+
+void EventMerge::replay(std::size_t lane) {
+    std::size_t winner = lane;
+    for (std::size_t node = (lane + lanes_.size()) / 2; node >= 1; node /= 2) {
+        if (beats(tree_[node], winner)) {
+            std::swap(tree_[node], winner);
+        }
+    }
+    tree_[0] = winner;
+}
+
+std::size_t EventMerge::drain(const Sink& sink) {
+    // Watermarks of empty lanes move without any record arriving, so start from fresh heads
+    build();
+    std::size_t emitted = 0;
+    while (true) {
+        std::size_t lane = tree_[0];
+        if (!heads_[lane].record) {
+            break;   // The smallest bound is a lane that may still produce something earlier
+        }
+        auto& ring = lanes_[lane]->ring;
+        Record* record = ring.front();
+        sink(record->key, record->payload);
+        ring.pop();
+        ++emitted;
+        heads_[lane] = headOf(lane);
+        replay(lane);
+    }
+    return emitted;
+}
+
+bool EventMerge::finished() {
+    for (std::size_t lane = 0; lane < lanes_.size(); ++lane) {
+        auto head = headOf(lane);
+        if (head.record || head.key.time != kClosed) {
+            return false;
+        }
+    }
+    return true;
+}
+
+} // namespace tracker
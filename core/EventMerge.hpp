@@ -0,0 +1,118 @@
+/**
+ * @file EventMerge.hpp
+ * @brief Deterministic k-way merge of per-worker event streams
+ *
+ * Each producer (a fleet tick worker) appends to its own lane, a bounded
+ * SPSC ring, in key order: simulation time (fleet tick), then device index,
+ * then sequence. One consumer merges the lanes with a loser tree and hands
+ * records to a sink in global key order, so the output does not depend on
+ * how devices were split across workers or how the threads interleaved.
+ *
+ * A record can be emitted once no lane can still produce a smaller key.
+ * A lane with queued records is bounded by its first record. An empty lane
+ * is bounded by its watermark: the producer's promise, through advance(),
+ * that later keys have at least that time. Merging is incremental: drain()
+ * emits what is settled and returns. Lookahead is bounded by the lane
+ * capacity, because a producer whose lane is full waits for the consumer.
+ *
+ * @note One producer thread per lane and one consumer thread; no shared lock
+ * @note Keys within a lane must not decrease, or the output is not sorted
+ */
+
+#pragma once
+
+#include "domain/SpscRing.hpp"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <tuple>
+#include <vector>
+
+namespace tracker {
+
+struct MergeKey {
+    std::uint64_t time = 0;        ///< Simulation time (fleet tick)
+    std::uint32_t device = 0;      ///< Device index in the fleet
+    std::uint64_t sequence = 0;    ///< Per-device event sequence
+
+    bool operator<(const MergeKey& other) const {
+        return std::tie(time, device, sequence) < std::tie(other.time, other.device, other.sequence);
+    }
+    bool operator==(const MergeKey& other) const {
+        return time == other.time && device == other.device && sequence == other.sequence;
+    }
+};
+
+class EventMerge {
+public:
+    static constexpr std::size_t kDefaultLaneCapacity = 4096;
+
+    /// Receives records in key order; the payload may be moved from
+    using Sink = std::function<void(const MergeKey& key, std::string& payload)>;
+
+    /**
+     * @param lanes Number of producers
+     * @param laneCapacity Records buffered per lane before its producer waits
+     */
+    explicit EventMerge(std::size_t lanes, std::size_t laneCapacity = kDefaultLaneCapacity);
+
+    EventMerge(const EventMerge&) = delete;
+    EventMerge& operator=(const EventMerge&) = delete;
+
+    // --- Producer side (the lane's thread only) ---
+
+    /** @brief Queue a record, waiting while the lane is full */
+    void append(std::size_t lane, const MergeKey& key, std::string payload);
+
+    /** @brief Promise that the lane's later keys have time >= time */
+    void advance(std::size_t lane, std::uint64_t time);
+
+    /** @brief No more records on this lane */
+    void close(std::size_t lane);
+
+    // --- Consumer side ---
+
+    /**
+     * @brief Emit every record that no lane can still precede
+     * @return Records emitted by this call
+     */
+    std::size_t drain(const Sink& sink);
+
+    /** @brief All lanes closed and emptied */
+    bool finished();
+
+    std::size_t lanes() const { return lanes_.size(); }
+
+private:
+    struct Record {
+        MergeKey key;
+        std::string payload;
+    };
+
+    struct Lane {
+        explicit Lane(std::size_t capacity) : ring(capacity) {}
+        domain::SpscRing<Record> ring;
+        std::atomic<std::uint64_t> watermark{0};
+    };
+
+    /// A lane's bound: its first record, or (watermark, 0, 0) when empty
+    struct Head {
+        MergeKey key;
+        bool record = false;
+    };
+
+    Head headOf(std::size_t lane);
+    bool beats(std::size_t a, std::size_t b) const;
+    void build();
+    void replay(std::size_t lane);
+
+    std::vector<std::unique_ptr<Lane>> lanes_;
+    std::vector<Head> heads_;
+    std::vector<std::size_t> tree_;   ///< [0] winner, [1..k-1] loser at each internal node
+    std::vector<std::size_t> winners_;   ///< Scratch for build()
+};
+
+} // namespace tracker
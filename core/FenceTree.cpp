@@ -0,0 +1,373 @@
+#include "FenceTree.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <functional>
+#include <limits>
+#include <thread>
+
+namespace tracker {
+
+namespace {
+
+constexpr char kMagic[8] = {'T', 'R', 'K', 'F', 'T', 'R', 'E', 'E'};
+constexpr std::uint32_t kByteOrder = 0x01020304;
+constexpr double kEarthRadiusMeters = 6371000.0;   // Same sphere as Geo and LocalFrame
+constexpr double kPi = 3.14159265358979323846;
+constexpr double kMetersPerDegree = kEarthRadiusMeters * kPi / 180.0;
+constexpr std::size_t kMinItemsPerThread = 1 << 16;
+
+struct Box {
+    float minLat = std::numeric_limits<float>::max();
+    float minLon = std::numeric_limits<float>::max();
+    float maxLat = std::numeric_limits<float>::lowest();
+    float maxLon = std::numeric_limits<float>::lowest();
+
+    void add(const Box& other) {
+        minLat = std::min(minLat, other.minLat);
+        minLon = std::min(minLon, other.minLon);
+        maxLat = std::max(maxLat, other.maxLat);
+        maxLon = std::max(maxLon, other.maxLon);
+    }
+};
+
+float roundDown(double value) {
+    return std::nextafter(static_cast<float>(value), std::numeric_limits<float>::lowest());
+}
+
+float roundUp(double value) {
+    return std::nextafter(static_cast<float>(value), std::numeric_limits<float>::max());
+}
+
+/// Bounding box of a circular fence in degrees, rounded outward to float
+Box fenceBox(const FenceRecord& fence) {
+    double dLat = fence.radiusMeters / kMetersPerDegree;
+    double cosLat = std::max(std::cos(fence.lat * kPi / 180.0), 1e-6);
+    double dLon = std::min(180.0, dLat / cosLat);
+    return {roundDown(fence.lat - dLat), roundDown(fence.lon - dLon),
+            roundUp(fence.lat + dLat), roundUp(fence.lon + dLon)};
+}
+
+/// Position of (x, y) along a Hilbert curve over a 65536 x 65536 grid
+std::uint32_t hilbertKey(std::uint32_t x, std::uint32_t y) {
+    std::uint32_t key = 0;
+    for (std::uint32_t s = 1u << 15; s > 0; s >>= 1) {
+        std::uint32_t rx = (x & s) ? 1 : 0;
+        std::uint32_t ry = (y & s) ? 1 : 0;
+        key += s * s * ((3 * rx) ^ ry);
+        if (ry == 0) {
+            if (rx == 1) {
+                x = 0xFFFF - x;
+                y = 0xFFFF - y;
+            }
+            std::swap(x, y);
+        }
+    }
+    return key;
+}
+
+/// Split [0, count) into one contiguous range per thread and run them in parallel
+void parallelFor(unsigned threads, std::size_t count,
+                 const std::function<void(std::size_t begin, std::size_t end)>& work) {
+    threads = static_cast<unsigned>(std::clamp<std::size_t>(count / kMinItemsPerThread, 1, threads));
+    std::vector<std::thread> workers;
+    for (unsigned i = 1; i < threads; ++i) {
+        workers.emplace_back(work, count * i / threads, count * (i + 1) / threads);
+    }
+    work(0, count / threads);
+    for (auto& worker : workers) worker.join();
+}
+
+/// Sort chunks in parallel, then merge neighbours pairwise (also in parallel)
+void parallelSort(std::vector<std::uint64_t>& keys, unsigned threads) {
+    threads = static_cast<unsigned>(std::clamp<std::size_t>(keys.size() / kMinItemsPerThread, 1, threads));
+    std::vector<std::size_t> bounds;
+    for (unsigned i = 0; i <= threads; ++i) {
+        bounds.push_back(keys.size() * i / threads);
+    }
+    auto runAll = [](std::vector<std::function<void()>>& jobs) {
+        std::vector<std::thread> workers;
+        for (std::size_t i = 1; i < jobs.size(); ++i) workers.emplace_back(jobs[i]);
+        if (!jobs.empty()) jobs[0]();
+        for (auto& worker : workers) worker.join();
+    };
+
+    std::vector<std::function<void()>> jobs;
+    for (unsigned i = 0; i < threads; ++i) {
+        jobs.push_back([&, i] { std::sort(keys.begin() + bounds[i], keys.begin() + bounds[i + 1]); });
+    }
+    runAll(jobs);
+
+    for (std::size_t width = 1; width < threads; width *= 2) {
+        jobs.clear();
+        for (std::size_t i = 0; i + width < threads; i += 2 * width) {
+            auto first = bounds[i], middle = bounds[i + width], last = bounds[std::min<std::size_t>(i + 2 * width, threads)];
+            jobs.push_back([&keys, first, middle, last] {
+                std::inplace_merge(keys.begin() + first, keys.begin() + middle, keys.begin() + last);
+            });
+        }
+        runAll(jobs);
+    }
+}
+
+template <typename Entry>
+Entry* entries(char* page) {
+    return reinterpret_cast<Entry*>(page + sizeof(FenceTree::PageHeader));
+}
+
+template <typename Entry>
+const Entry* entries(const char* page) {
+    return reinterpret_cast<const Entry*>(page + sizeof(FenceTree::PageHeader));
+}
+
+} // namespace
+
+std::vector<char> FenceTree::build(const std::vector<FenceRecord>& fences, const BuildOptions& options,
+                                   std::string& error) {
+    const std::size_t count = fences.size();
+    if (count == 0) {
+        error = "no fences";
+        return {};
+    }
+    if (count >= std::numeric_limits<std::uint32_t>::max()) {
+        error = "too many fences";
+        return {};
+    }
+    for (std::size_t i = 0; i < count; ++i) {
+        const auto& fence = fences[i];
+        if (!(fence.lat >= -90.0 && fence.lat <= 90.0) || !(fence.lon >= -180.0 && fence.lon <= 180.0)) {
+            error = "fence '" + fence.id + "': coordinates out of range";
+            return {};
+        }
+        if (!(fence.radiusMeters > 0.0f) || !std::isfinite(fence.radiusMeters)) {
+            error = "fence '" + fence.id + "': radius must be positive";
+            return {};
+        }
+    }
+    unsigned threads = options.threads ? options.threads : std::max(1u, std::thread::hardware_concurrency());
+
+    // Hilbert keys of the centres over the data's own extent
+    double minLat = 90.0, maxLat = -90.0, minLon = 180.0, maxLon = -180.0;
+    for (const auto& fence : fences) {
+        minLat = std::min(minLat, fence.lat);
+        maxLat = std::max(maxLat, fence.lat);
+        minLon = std::min(minLon, fence.lon);
+        maxLon = std::max(maxLon, fence.lon);
+    }
+    double latScale = maxLat > minLat ? 65535.0 / (maxLat - minLat) : 0.0;
+    double lonScale = maxLon > minLon ? 65535.0 / (maxLon - minLon) : 0.0;
+
+    std::vector<std::uint64_t> order(count);
+    parallelFor(threads, count, [&](std::size_t begin, std::size_t end) {
+        for (std::size_t i = begin; i < end; ++i) {
+            auto x = static_cast<std::uint32_t>((fences[i].lon - minLon) * lonScale);
+            auto y = static_cast<std::uint32_t>((fences[i].lat - minLat) * latScale);
+            order[i] = (static_cast<std::uint64_t>(hilbertKey(x, y)) << 32) | i;
+        }
+    });
+    parallelSort(order, threads);
+
+    // Page layout: leaves, then each internal level up to a single root
+    std::vector<std::size_t> levelPages{(count + kLeafCapacity - 1) / kLeafCapacity};
+    while (levelPages.back() > 1) {
+        levelPages.push_back((levelPages.back() + kNodeCapacity - 1) / kNodeCapacity);
+    }
+    std::vector<std::size_t> levelFirst;
+    std::size_t pageCount = 1;
+    for (auto pages : levelPages) {
+        levelFirst.push_back(pageCount);
+        pageCount += pages;
+    }
+    if (pageCount >= std::numeric_limits<std::uint32_t>::max()) {
+        error = "too many pages";
+        return {};
+    }
+
+    std::vector<std::uint64_t> idOffsets(count + 1, 0);
+    for (std::size_t i = 0; i < count; ++i) {
+        idOffsets[i + 1] = idOffsets[i] + fences[static_cast<std::uint32_t>(order[i])].id.size();
+    }
+    const std::size_t idOffsetsAt = pageCount * kPageSize;
+    const std::size_t idBytesAt = idOffsetsAt + idOffsets.size() * sizeof(std::uint64_t);
+    std::vector<char> image(idBytesAt + idOffsets.back(), 0);
+
+    // Leaves and their boxes (pages are independent, so threads fill disjoint ranges)
+    std::vector<Box> boxes(levelPages[0]);
+    parallelFor(threads, levelPages[0], [&](std::size_t begin, std::size_t end) {
+        for (std::size_t leaf = begin; leaf < end; ++leaf) {
+            char* page = image.data() + (levelFirst[0] + leaf) * kPageSize;
+            std::size_t first = leaf * kLeafCapacity;
+            std::size_t n = std::min(kLeafCapacity, count - first);
+            auto* header = reinterpret_cast<PageHeader*>(page);
+            header->count = static_cast<std::uint32_t>(n);
+            header->level = 0;
+            auto* out = entries<LeafEntry>(page);
+            for (std::size_t j = 0; j < n; ++j) {
+                const auto& fence = fences[static_cast<std::uint32_t>(order[first + j])];
+                out[j] = {fence.lat, fence.lon, fence.radiusMeters, static_cast<std::uint32_t>(first + j)};
+                boxes[leaf].add(fenceBox(fence));
+            }
+        }
+    });
+
+    for (std::size_t level = 1; level < levelPages.size(); ++level) {
+        std::vector<Box> parents(levelPages[level]);
+        std::size_t children = levelPages[level - 1];
+        parallelFor(threads, levelPages[level], [&](std::size_t begin, std::size_t end) {
+            for (std::size_t node = begin; node < end; ++node) {
+                char* page = image.data() + (levelFirst[level] + node) * kPageSize;
+                std::size_t first = node * kNodeCapacity;
+                std::size_t n = std::min(kNodeCapacity, children - first);
+                auto* header = reinterpret_cast<PageHeader*>(page);
+                header->count = static_cast<std::uint32_t>(n);
+                header->level = static_cast<std::uint32_t>(level);
+                auto* out = entries<NodeEntry>(page);
+                for (std::size_t j = 0; j < n; ++j) {
+                    const auto& box = boxes[first + j];
+                    out[j] = {box.minLat, box.minLon, box.maxLat, box.maxLon,
+                              static_cast<std::uint32_t>(levelFirst[level - 1] + first + j)};
+                    parents[node].add(box);
+                }
+            }
+        });
+        boxes.swap(parents);
+    }
+
+    std::memcpy(image.data() + idOffsetsAt, idOffsets.data(), idOffsets.size() * sizeof(std::uint64_t));
+    parallelFor(threads, count, [&](std::size_t begin, std::size_t end) {
+        for (std::size_t i = begin; i < end; ++i) {
+            const auto& id = fences[static_cast<std::uint32_t>(order[i])].id;
+            std::memcpy(image.data() + idBytesAt + idOffsets[i], id.data(), id.size());
+        }
+    });
+
+    FileHeader header{};
+    std::memcpy(header.magic, kMagic, sizeof(kMagic));
+    header.byteOrder = kByteOrder;
+    header.formatVersion = kFormatVersion;
+    header.pageSize = static_cast<std::uint32_t>(kPageSize);
+    header.levels = static_cast<std::uint32_t>(levelPages.size());
+    header.fenceCount = count;
+    header.rootPage = static_cast<std::uint32_t>(pageCount - 1);
+    header.leafPages = static_cast<std::uint32_t>(levelPages[0]);
+    header.pageCount = static_cast<std::uint32_t>(pageCount);
+    header.idOffsetsAt = idOffsetsAt;
+    header.idBytesAt = idBytesAt;
+    header.idBytesSize = idOffsets.back();
+    header.bounds = {boxes[0].minLat, boxes[0].minLon, boxes[0].maxLat, boxes[0].maxLon};
+    std::memcpy(image.data(), &header, sizeof(header));
+    return image;
+}
+
+std::unique_ptr<FenceTree> FenceTree::open(std::shared_ptr<const void> storage, const char* data,
+                                           std::size_t size, std::string& error) {
+    if (!data || size < kPageSize || reinterpret_cast<std::uintptr_t>(data) % alignof(std::uint64_t) != 0) {
+        error = "not a fence index (too small or misaligned)";
+        return nullptr;
+    }
+    const auto* header = reinterpret_cast<const FileHeader*>(data);
+    if (std::memcmp(header->magic, kMagic, sizeof(kMagic)) != 0) {
+        error = "not a fence index (bad magic)";
+        return nullptr;
+    }
+    if (header->byteOrder != kByteOrder || header->formatVersion != kFormatVersion ||
+        header->pageSize != kPageSize) {
+        error = "unsupported fence index format (byte order, version or page size)";
+        return nullptr;
+    }
+
+    // Every table must lie inside the image; page contents are checked as they are read.
+    // Header fields are untrusted, so bounds are compared by subtraction and never summed
+    const std::uint64_t pagesEnd = static_cast<std::uint64_t>(header->pageCount) * kPageSize;
+    const std::uint64_t offsetsAt = header->idOffsetsAt;
+    const std::uint64_t bytesAt = header->idBytesAt;
+    bool pagesValid = header->fenceCount != 0 && header->levels != 0 && header->leafPages != 0 &&
+                      header->rootPage != 0 && header->rootPage < header->pageCount &&
+                      header->leafPages < header->pageCount && pagesEnd <= offsetsAt;
+    bool offsetsValid = offsetsAt <= size && offsetsAt % sizeof(std::uint64_t) == 0 &&
+                        (size - offsetsAt) / sizeof(std::uint64_t) > header->fenceCount;   // fenceCount + 1 entries
+    // With offsetsValid the table end below is at most size, so it cannot wrap
+    bool bytesValid = offsetsValid && bytesAt <= size && bytesAt >= offsetsAt &&
+                      bytesAt - offsetsAt >= (header->fenceCount + 1) * sizeof(std::uint64_t) &&
+                      header->idBytesSize <= size - bytesAt;
+    if (!pagesValid || !offsetsValid || !bytesValid) {
+        error = "truncated or corrupt fence index";
+        return nullptr;
+    }
+
+    std::unique_ptr<FenceTree> tree(new FenceTree());
+    tree->storage_ = std::move(storage);
+    tree->data_ = data;
+    tree->size_ = size;
+    tree->header_ = header;
+    tree->idOffsets_ = reinterpret_cast<const std::uint64_t*>(data + header->idOffsetsAt);
+    tree->idBytes_ = data + header->idBytesAt;
+    return tree;
+}
+
+FenceTree::Lookup FenceTree::query(double lat, double lon, std::vector<std::uint32_t>& inside,
+                                   std::size_t maxPages) const {
+    inside.clear();
+    Lookup lookup;
+    maxPages = std::min(maxPages, kMaxQueryPages);
+    const double eastScale = kMetersPerDegree * std::cos(lat * kPi / 180.0);
+
+    // Depth-first over matching boxes. Children are pushed in reverse, so leaves
+    // (and with them fence numbers) come out in ascending order.
+    std::array<std::uint32_t, kMaxQueryPages> stack;
+    std::size_t depth = 0;
+    stack[depth++] = header_->rootPage;
+    while (depth > 0) {
+        if (lookup.pages == maxPages) {
+            lookup.complete = false;
+            break;
+        }
+        const char* node = page(stack[--depth]);
+        ++lookup.pages;
+        const auto& header = *reinterpret_cast<const PageHeader*>(node);
+
+        if (header.level == 0) {
+            const auto* fences = entries<LeafEntry>(node);
+            std::size_t n = std::min<std::size_t>(header.count, kLeafCapacity);
+            for (std::size_t i = 0; i < n; ++i) {
+                double north = (lat - fences[i].lat) * kMetersPerDegree;
+                double east = (lon - fences[i].lon) * eastScale;
+                double radius = fences[i].radiusMeters;
+                if (north * north + east * east <= radius * radius) {
+                    inside.push_back(fences[i].fence);
+                }
+            }
+            continue;
+        }
+
+        const auto* children = entries<NodeEntry>(node);
+        std::size_t n = std::min<std::size_t>(header.count, kNodeCapacity);
+        for (std::size_t i = n; i-- > 0;) {
+            const auto& child = children[i];
+            if (lat < child.minLat || lat > child.maxLat || lon < child.minLon || lon > child.maxLon ||
+                child.child == 0 || child.child >= header_->pageCount) {
+                continue;
+            }
+            if (depth == stack.size()) {
+                lookup.complete = false;
+                break;
+            }
+            stack[depth++] = child.child;
+        }
+    }
+    return lookup;
+}
+
+std::string_view FenceTree::id(std::uint32_t fence) const {
+    if (fence >= header_->fenceCount) {
+        return {};
+    }
+    std::uint64_t begin = idOffsets_[fence];
+    std::uint64_t end = idOffsets_[fence + 1];
+    if (begin > end || end > header_->idBytesSize) {
+        return {};
+    }
+    return {idBytes_ + begin, static_cast<std::size_t>(end - begin)};
+}
+
+} // namespace tracker
@@ -0,0 +1,173 @@
+/**
+ * @file FenceTree.hpp
+ * @brief Out-of-core geofence index: a packed Hilbert R-tree in one read-only file
+ *
+ * For catalogs with millions of fences (one per customer address) that should
+ * not be copied into every worker as Geofence objects. `fence-index` builds
+ * the file once; every process maps it read-only, so the OS page cache holds
+ * one copy shared by all workers and only the pages queries touch are read.
+ *
+ * File layout (4 KiB pages, native little-endian):
+ *
+ * | Pages / region        | Contents                                              |
+ * |-----------------------|-------------------------------------------------------|
+ * | page 0                | FileHeader                                            |
+ * | pages 1..leafPages    | Leaves: fences in Hilbert order of their centres      |
+ * | following pages       | Internal levels bottom-up, root last                  |
+ * | after the pages       | Id offsets (u64, fenceCount + 1), then id bytes       |
+ *
+ * Leaves hold up to 170 fences (centre in degrees, radius in metres) and
+ * internal pages up to 204 child bounding boxes. Sorting by Hilbert key packs
+ * nearby fences into the same leaf, so boxes overlap little and a point query
+ * reads one page per level in the common case: 4 pages for 10 million fences.
+ * Queries stop after a page budget, so a pathological pile of overlapping
+ * fences cannot turn one lookup into a scan.
+ *
+ * Fence numbers are positions in Hilbert order; FenceTree::id() maps them to
+ * the ids used in events. Containment uses the same spherical Earth as Geo,
+ * locally flattened at the query latitude (fences are assumed much smaller
+ * than a degree and away from the poles and the antimeridian).
+ *
+ * @note The reader is a view over caller-provided memory (see MappedFile.hpp)
+ * @note Queries are const and allocation-free apart from the result vector
+ */
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace tracker {
+
+/**
+ * @brief One input fence for FenceTree::build()
+ */
+struct FenceRecord {
+    std::string id;
+    double lat = 0.0;
+    double lon = 0.0;
+    float radiusMeters = 100.0f;
+};
+
+class FenceTree {
+public:
+    static constexpr std::size_t kPageSize = 4096;
+    static constexpr std::uint32_t kFormatVersion = 1;
+
+    /// Pages one query may read before giving up (a root-to-leaf path is at most 6)
+    static constexpr std::size_t kMaxQueryPages = 64;
+
+    /// Leaf entry: one fence
+    struct LeafEntry {
+        double lat;
+        double lon;
+        float radiusMeters;
+        std::uint32_t fence;            ///< Fence number (Hilbert position, index into the id table)
+    };
+
+    /// Internal entry: a child page and the box of everything below it (degrees, rounded outward)
+    struct NodeEntry {
+        float minLat;
+        float minLon;
+        float maxLat;
+        float maxLon;
+        std::uint32_t child;
+    };
+
+    struct PageHeader {
+        std::uint32_t count;            ///< Entries in this page
+        std::uint32_t level;            ///< 0 = leaf
+    };
+
+    static constexpr std::size_t kLeafCapacity = (kPageSize - sizeof(PageHeader)) / sizeof(LeafEntry);
+    static constexpr std::size_t kNodeCapacity = (kPageSize - sizeof(PageHeader)) / sizeof(NodeEntry);
+
+    struct FileHeader {
+        char magic[8];                  ///< "TRKFTREE"
+        std::uint32_t byteOrder;        ///< 0x01020304 as written
+        std::uint32_t formatVersion;
+        std::uint32_t pageSize;
+        std::uint32_t levels;           ///< 1 = the root is a leaf
+        std::uint64_t fenceCount;
+        std::uint32_t rootPage;
+        std::uint32_t leafPages;
+        std::uint32_t pageCount;        ///< Including the header page
+        std::uint32_t reserved;
+        std::uint64_t idOffsetsAt;      ///< Byte offset of the id offset table
+        std::uint64_t idBytesAt;        ///< Byte offset of the id bytes
+        std::uint64_t idBytesSize;
+        std::array<float, 4> bounds;    ///< minLat, minLon, maxLat, maxLon of all fences
+    };
+
+    /// Result of one query
+    struct Lookup {
+        std::size_t pages = 0;          ///< Pages read
+        bool complete = true;           ///< False if the page budget ran out (result partial)
+    };
+
+    struct BuildOptions {
+        unsigned threads = 0;           ///< Key, sort and page-fill threads (0 = one per core)
+    };
+
+    /**
+     * @brief Serialize fences into an index image
+     * @param fences Input fences; ids should be unique (not checked)
+     * @param options Thread count
+     * @param error Reason on failure (invalid coordinate or radius, too many fences)
+     * @return File image, empty on failure
+     */
+    static std::vector<char> build(const std::vector<FenceRecord>& fences, const BuildOptions& options,
+                                   std::string& error);
+
+    /**
+     * @brief Open an index image
+     * @param storage Keeps the memory alive for the tree's lifetime (e.g. a mapping)
+     * @param data First byte of the image (8-byte aligned)
+     * @param size Image length
+     * @param error Reason on failure
+     * @return Tree, or nullptr if the header or table bounds are invalid
+     */
+    static std::unique_ptr<FenceTree> open(std::shared_ptr<const void> storage, const char* data,
+                                           std::size_t size, std::string& error);
+
+    /**
+     * @brief Fences containing a point
+     * @param inside Replaced with fence numbers, ascending
+     * @param maxPages Page budget (clamped to kMaxQueryPages)
+     */
+    Lookup query(double lat, double lon, std::vector<std::uint32_t>& inside,
+                 std::size_t maxPages = kMaxQueryPages) const;
+
+    /** @brief Event id of a fence number */
+    std::string_view id(std::uint32_t fence) const;
+
+    std::size_t fenceCount() const { return static_cast<std::size_t>(header_->fenceCount); }
+    std::size_t levels() const { return header_->levels; }
+    std::size_t pageCount() const { return header_->pageCount; }
+    std::size_t leafPages() const { return header_->leafPages; }
+
+    /** @brief Byte range of the internal levels (what a warm-up should prefetch) */
+    std::size_t nodesOffset() const { return (static_cast<std::size_t>(header_->leafPages) + 1) * kPageSize; }
+    std::size_t nodesSize() const { return (pageCount() - leafPages() - 1) * kPageSize; }
+
+    std::size_t sizeBytes() const { return size_; }
+
+private:
+    FenceTree() = default;
+
+    const char* page(std::uint32_t number) const { return data_ + static_cast<std::size_t>(number) * kPageSize; }
+
+    std::shared_ptr<const void> storage_;
+    const char* data_ = nullptr;
+    std::size_t size_ = 0;
+    const FileHeader* header_ = nullptr;
+    const std::uint64_t* idOffsets_ = nullptr;
+    const char* idBytes_ = nullptr;
+};
+
+} // namespace tracker
@@ -0,0 +1,247 @@
+#include "FieldSchema.hpp"
+#include "IRng.hpp"
+#include <nlohmann/json.hpp>
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+
+namespace tracker {
+
+namespace {
+
+/// Top-level keys JsonCodec already writes
+constexpr const char* kReservedNames[] = {
+    "deviceId", "ts", "eventType", "seq", "loc", "speedKph", "heading",
+    "battery", "network", "extras", "trace"};
+
+std::size_t sizeOf(FieldType type) {
+    switch (type) {
+        case FieldType::Bool:   return 1;
+        case FieldType::String: return 4;
+        default:                return 8;
+    }
+}
+
+bool parseType(const std::string& text, FieldType& type) {
+    if (text == "bool") type = FieldType::Bool;
+    else if (text == "int") type = FieldType::Int;
+    else if (text == "float") type = FieldType::Float;
+    else if (text == "string") type = FieldType::String;
+    else return false;
+    return true;
+}
+
+bool parseGenerator(const std::string& text, FieldGenerator& generator) {
+    if (text == "constant") generator = FieldGenerator::Constant;
+    else if (text == "uniform") generator = FieldGenerator::Uniform;
+    else if (text == "normal") generator = FieldGenerator::Normal;
+    else if (text == "random_walk") generator = FieldGenerator::RandomWalk;
+    else if (text == "counter") generator = FieldGenerator::Counter;
+    else if (text == "toggle") generator = FieldGenerator::Toggle;
+    else if (text == "choice") generator = FieldGenerator::Choice;
+    else return false;
+    return true;
+}
+
+bool parseNumber(const std::string& text, double& value) {
+    if (text.empty()) return false;
+    char* end = nullptr;
+    value = std::strtod(text.c_str(), &end);
+    return end == text.c_str() + text.size() && std::isfinite(value);
+}
+
+template <typename T>
+T load(const std::uint8_t* record, std::uint32_t offset) {
+    T value;
+    std::memcpy(&value, record + offset, sizeof(T));
+    return value;
+}
+
+template <typename T>
+void store(std::uint8_t* record, std::uint32_t offset, T value) {
+    std::memcpy(record + offset, &value, sizeof(T));
+}
+
+} // namespace
+
+std::shared_ptr<const FieldSchema> FieldSchema::compile(const std::vector<FieldSpec>& specs, std::string& error) {
+    auto schema = std::make_shared<FieldSchema>();
+    std::vector<Slot> slots;
+
+    for (const auto& spec : specs) {
+        auto fail = [&](const std::string& reason) {
+            error = "field '" + spec.name + "': " + reason;
+            return nullptr;
+        };
+
+        if (spec.name.empty()) return fail("missing name");
+        for (const char* reserved : kReservedNames) {
+            if (spec.name == reserved) return fail("name is a built-in field");
+        }
+        for (const auto& other : slots) {
+            if (other.name == spec.name) return fail("declared twice");
+        }
+
+        Slot slot;
+        slot.name = spec.name;
+        if (!parseType(spec.type, slot.type)) return fail("unknown type '" + spec.type + "'");
+        if (!parseGenerator(spec.generator, slot.generator)) return fail("unknown generator '" + spec.generator + "'");
+        slot.min = spec.min;
+        slot.max = spec.max;
+        slot.mean = spec.mean;
+
+        bool numeric = slot.type == FieldType::Int || slot.type == FieldType::Float;
+        switch (slot.generator) {
+            case FieldGenerator::Constant:
+                if (slot.type == FieldType::String) {
+                    slot.firstValue = static_cast<std::uint32_t>(schema->strings_.size());
+                    slot.valueCount = 1;
+                    schema->strings_.push_back(spec.value);
+                } else if (slot.type == FieldType::Bool) {
+                    if (spec.value != "true" && spec.value != "false") return fail("value must be true or false");
+                    slot.initial = spec.value == "true" ? 1.0 : 0.0;
+                } else if (!parseNumber(spec.value, slot.initial)) {
+                    return fail("value is not a number");
+                }
+                break;
+            case FieldGenerator::Uniform:
+                if (!numeric) return fail("uniform needs an int or float field");
+                if (!(spec.max > spec.min)) return fail("uniform needs max > min");
+                slot.initial = spec.min;
+                break;
+            case FieldGenerator::Normal:
+                if (!numeric) return fail("normal needs an int or float field");
+                if (spec.stddev < 0.0) return fail("stddev must not be negative");
+                slot.initial = spec.mean;
+                slot.spread = spec.stddev;
+                break;
+            case FieldGenerator::RandomWalk:
+                if (!numeric) return fail("random_walk needs an int or float field");
+                if (!(spec.step > 0.0)) return fail("step must be positive");
+                slot.initial = spec.mean;
+                slot.spread = spec.step;
+                break;
+            case FieldGenerator::Counter:
+                if (!numeric) return fail("counter needs an int or float field");
+                slot.initial = spec.min;
+                slot.spread = spec.step;
+                break;
+            case FieldGenerator::Toggle:
+                if (slot.type != FieldType::Bool) return fail("toggle needs a bool field");
+                if (spec.probability < 0.0 || spec.probability > 1.0) return fail("probability must be in 0..1");
+                slot.initial = spec.value == "true" ? 1.0 : 0.0;
+                slot.spread = spec.probability;
+                break;
+            case FieldGenerator::Choice:
+                if (slot.type != FieldType::String) return fail("choice needs a string field");
+                if (spec.values.empty()) return fail("choice needs values");
+                slot.firstValue = static_cast<std::uint32_t>(schema->strings_.size());
+                slot.valueCount = static_cast<std::uint32_t>(spec.values.size());
+                schema->strings_.insert(schema->strings_.end(), spec.values.begin(), spec.values.end());
+                break;
+        }
+        if (slot.type == FieldType::Int) {
+            slot.initial = std::round(slot.initial);
+        }
+        slots.push_back(std::move(slot));
+    }
+
+    // Widest fields first keeps every slot naturally aligned without padding
+    std::stable_sort(slots.begin(), slots.end(), [](const Slot& a, const Slot& b) {
+        return sizeOf(a.type) > sizeOf(b.type);
+    });
+    std::uint32_t offset = 0;
+    for (auto& slot : slots) {
+        slot.offset = offset;
+        offset += static_cast<std::uint32_t>(sizeOf(slot.type));
+    }
+    schema->recordBytes_ = (offset + 7u) & ~std::size_t{7};
+    schema->plan_ = std::move(slots);
+    return schema;
+}
+
+void FieldSchema::initialize(std::uint8_t* record) const {
+    std::memset(record, 0, recordBytes_);
+    for (const auto& slot : plan_) {
+        switch (slot.type) {
+            case FieldType::Bool:   store<std::uint8_t>(record, slot.offset, slot.initial != 0.0); break;
+            case FieldType::Int:    store<std::int64_t>(record, slot.offset, static_cast<std::int64_t>(slot.initial)); break;
+            case FieldType::Float:  store<double>(record, slot.offset, slot.initial); break;
+            case FieldType::String: store<std::uint32_t>(record, slot.offset, slot.firstValue); break;
+        }
+    }
+}
+
+void FieldSchema::advance(std::uint8_t* record, IRng& rng) const {
+    for (const auto& slot : plan_) {
+        double next = 0.0;
+        switch (slot.generator) {
+            case FieldGenerator::Constant:
+                continue;
+            case FieldGenerator::Toggle:
+                if (rng.uniform() < slot.spread) {
+                    store<std::uint8_t>(record, slot.offset, !load<std::uint8_t>(record, slot.offset));
+                }
+                continue;
+            case FieldGenerator::Choice:
+                store<std::uint32_t>(record, slot.offset, slot.firstValue + static_cast<std::uint32_t>(
+                    rng.uniformInt(0, static_cast<int>(slot.valueCount) - 1)));
+                continue;
+            case FieldGenerator::Uniform:
+                // Integers draw from [min, max + 1) so max is as likely as any other value
+                next = slot.type == FieldType::Int ? std::min(std::floor(rng.uniform(slot.min, slot.max + 1.0)), slot.max)
+                                                   : rng.uniform(slot.min, slot.max);
+                break;
+            case FieldGenerator::Normal:
+                next = rng.normal(slot.mean, slot.spread);
+                break;
+            case FieldGenerator::RandomWalk:
+                next = (slot.type == FieldType::Int ? static_cast<double>(load<std::int64_t>(record, slot.offset))
+                                                    : load<double>(record, slot.offset)) + rng.normal(0.0, slot.spread);
+                break;
+            case FieldGenerator::Counter:
+                next = (slot.type == FieldType::Int ? static_cast<double>(load<std::int64_t>(record, slot.offset))
+                                                    : load<double>(record, slot.offset)) + slot.spread;
+                break;
+        }
+
+        if (slot.max > slot.min && slot.generator != FieldGenerator::Counter) {
+            next = std::clamp(next, slot.min, slot.max);
+        }
+        if (slot.type == FieldType::Int) {
+            store<std::int64_t>(record, slot.offset, std::llround(next));
+        } else {
+            store<double>(record, slot.offset, next);
+        }
+    }
+}
+
+void FieldSchema::toJson(const std::uint8_t* record, nlohmann::json& json) const {
+    for (const auto& slot : plan_) {
+        switch (slot.type) {
+            case FieldType::Bool:   json[slot.name] = boolValue(record, slot); break;
+            case FieldType::Int:    json[slot.name] = intValue(record, slot); break;
+            case FieldType::Float:  json[slot.name] = floatValue(record, slot); break;
+            case FieldType::String: json[slot.name] = stringValue(record, slot); break;
+        }
+    }
+}
+
+bool FieldSchema::boolValue(const std::uint8_t* record, const Slot& slot) const {
+    return load<std::uint8_t>(record, slot.offset) != 0;
+}
+
+std::int64_t FieldSchema::intValue(const std::uint8_t* record, const Slot& slot) const {
+    return load<std::int64_t>(record, slot.offset);
+}
+
+double FieldSchema::floatValue(const std::uint8_t* record, const Slot& slot) const {
+    return load<double>(record, slot.offset);
+}
+
+const std::string& FieldSchema::stringValue(const std::uint8_t* record, const Slot& slot) const {
+    return strings_[load<std::uint32_t>(record, slot.offset)];
+}
+
+} // namespace tracker
@@ -0,0 +1,132 @@
+/**
+ * @file FieldSchema.hpp
+ * @brief User-defined telemetry fields compiled to a flat per-device record
+ *
+ * A schema lists typed custom fields (door sensor, probe temperature, driver
+ * ID, ...) and the generator that produces each value. compile() validates it
+ * once at load time and lays the fields out at fixed offsets in a flat record:
+ * 8-byte numbers first, then 4-byte string indices, then 1-byte booleans.
+ *
+ * Every device owns one record; generating and encoding walk the precomputed
+ * plan and read or write values in place, so per event there is no map lookup,
+ * no string conversion and no allocation beyond what JsonCodec already does
+ * for built-in fields. String fields are indices into the schema's value
+ * table.
+ *
+ * | Generator   | Types       | Parameters                         |
+ * |-------------|-------------|------------------------------------|
+ * | constant    | all         | value                              |
+ * | uniform     | int, float  | min, max                           |
+ * | normal      | int, float  | mean, stddev (clamped to min..max) |
+ * | random_walk | int, float  | mean (start), step, min, max       |
+ * | counter     | int, float  | min (start), step                  |
+ * | toggle      | bool        | probability of flipping per event  |
+ * | choice      | string      | values                             |
+ *
+ * @note A compiled schema is immutable and shared by all devices
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+#include <nlohmann/json_fwd.hpp>
+
+namespace tracker {
+
+class IRng;
+
+enum class FieldType : std::uint8_t {
+    Bool,
+    Int,        ///< int64
+    Float,      ///< double
+    String      ///< Index into the schema's value table
+};
+
+enum class FieldGenerator : std::uint8_t {
+    Constant,
+    Uniform,
+    Normal,
+    RandomWalk,
+    Counter,
+    Toggle,
+    Choice
+};
+
+/**
+ * @brief One field as declared in the schema file (unvalidated)
+ */
+struct FieldSpec {
+    std::string name;
+    std::string type = "float";             ///< bool, int, float or string
+    std::string generator = "constant";
+    std::string value;                      ///< Constant value (text)
+    std::vector<std::string> values;        ///< Choice values
+    double min = 0.0;
+    double max = 0.0;                       ///< Range ignored unless max > min
+    double mean = 0.0;
+    double stddev = 1.0;
+    double step = 1.0;
+    double probability = 0.1;
+};
+
+class FieldSchema {
+public:
+    /**
+     * @brief One compiled field: where it lives and how it is produced
+     */
+    struct Slot {
+        std::string name;
+        FieldType type = FieldType::Float;
+        FieldGenerator generator = FieldGenerator::Constant;
+        std::uint32_t offset = 0;           ///< Byte offset in the record
+        std::uint32_t firstValue = 0;       ///< String table range (choice/constant strings)
+        std::uint32_t valueCount = 0;
+        double initial = 0.0;               ///< Constant, walk start or counter start
+        double min = 0.0;
+        double max = 0.0;
+        double mean = 0.0;
+        double spread = 1.0;                ///< Normal stddev, walk/counter step or toggle probability
+    };
+
+    /**
+     * @brief Validate and lay out a field list
+     * @param specs Fields in declaration order
+     * @param error Reason on failure
+     * @return Compiled schema, or nullptr if a field is invalid
+     */
+    static std::shared_ptr<const FieldSchema> compile(const std::vector<FieldSpec>& specs, std::string& error);
+
+    /** @brief Record size in bytes (multiple of 8) */
+    std::size_t recordBytes() const { return recordBytes_; }
+
+    /** @brief Record size in 8-byte words, for aligned storage */
+    std::size_t recordWords() const { return recordBytes_ / 8; }
+
+    /** @brief Fields in layout order */
+    const std::vector<Slot>& plan() const { return plan_; }
+
+    /** @brief Write initial values (constants, walk and counter starts) */
+    void initialize(std::uint8_t* record) const;
+
+    /** @brief Draw the next event's values in place */
+    void advance(std::uint8_t* record, IRng& rng) const;
+
+    /** @brief Add every field to an event object */
+    void toJson(const std::uint8_t* record, nlohmann::json& json) const;
+
+    bool boolValue(const std::uint8_t* record, const Slot& slot) const;
+    std::int64_t intValue(const std::uint8_t* record, const Slot& slot) const;
+    double floatValue(const std::uint8_t* record, const Slot& slot) const;
+    const std::string& stringValue(const std::uint8_t* record, const Slot& slot) const;
+
+private:
+    std::vector<Slot> plan_;
+    std::vector<std::string> strings_;      ///< Value table of string fields
+    std::size_t recordBytes_ = 0;
+};
+
+} // namespace tracker
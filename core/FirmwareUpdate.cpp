@@ -0,0 +1,411 @@
+#include "FirmwareUpdate.hpp"
+#include "Sha256.hpp"
+#include <algorithm>
+#include <cctype>
+#include <cstdio>
+
+namespace tracker {
+
+namespace {
+
+/// splitmix64: one 64-bit state per worker, no shared engine
+std::uint64_t nextRandom(std::uint64_t& state) {
+    std::uint64_t z = (state += 0x9E3779B97F4A7C15ull);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    return z ^ (z >> 31);
+}
+
+double uniform(std::uint64_t& state) {
+    return static_cast<double>(nextRandom(state) >> 11) * 0x1.0p-53;
+}
+
+double secondsSince(std::chrono::steady_clock::time_point start, std::chrono::steady_clock::time_point end) {
+    return std::chrono::duration<double>(end - start).count();
+}
+
+double percentile(std::vector<double> values, double fraction) {
+    if (values.empty()) {
+        return 0.0;
+    }
+    auto rank = static_cast<std::size_t>(fraction * static_cast<double>(values.size() - 1) + 0.5);
+    std::nth_element(values.begin(), values.begin() + static_cast<std::ptrdiff_t>(rank), values.end());
+    return values[rank];
+}
+
+} // namespace
+
+struct FirmwareCampaign::Session {
+    std::size_t device = 0;
+    FirmwareJob job;
+    Result result;
+    std::unique_ptr<Sha256> hash;           ///< Released when the download ends
+    std::FILE* flash = nullptr;
+    std::uint64_t offset = 0;
+    unsigned errors = 0;                    ///< Consecutive source errors
+    bool prepared = false;
+    std::chrono::steady_clock::time_point triggered;
+};
+
+// ============================================================================
+// FirmwareJob
+// ============================================================================
+
+bool FirmwareJob::fromDesired(const nlohmann::json& ota, FirmwareJob& job, std::string& error) {
+    if (!ota.is_object()) {
+        error = "ota must be an object";
+        return false;
+    }
+    auto text = [&ota](const char* key) -> std::string {
+        if (!ota.contains(key)) return "";
+        const auto& value = ota[key];
+        return value.is_string() ? value.get<std::string>() : value.dump();
+    };
+
+    job.version = text("version");
+    job.source = ota.contains("source") ? text("source") : text("url");
+    job.sha256 = text("sha256");
+    std::transform(job.sha256.begin(), job.sha256.end(), job.sha256.begin(),
+                   [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+
+    if (job.version.empty()) {
+        error = "ota.version is missing";
+        return false;
+    }
+    if (job.source.empty()) {
+        error = "ota.source is missing";
+        return false;
+    }
+    if (job.sha256.size() != 64 ||
+        !std::all_of(job.sha256.begin(), job.sha256.end(), [](unsigned char c) { return std::isxdigit(c); })) {
+        error = "ota.sha256 must be 64 hex digits";
+        return false;
+    }
+    if (!ota.contains("size") || !ota["size"].is_number_integer() || ota["size"].get<std::int64_t>() <= 0) {
+        error = "ota.size must be a positive byte count";
+        return false;
+    }
+    job.size = ota["size"].get<std::uint64_t>();
+    return true;
+}
+
+// ============================================================================
+// TokenBucket
+// ============================================================================
+
+TokenBucket::TokenBucket(double bytesPerSecond, double burstBytes)
+    : rate_(bytesPerSecond)
+    , burst_(std::max(burstBytes, 1.0))
+    , tokens_(burst_)
+    , refilled_(std::chrono::steady_clock::now()) {
+}
+
+void TokenBucket::acquire(std::size_t bytes) {
+    if (rate_ <= 0.0) {
+        return;
+    }
+    double debtSeconds;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto now = std::chrono::steady_clock::now();
+        tokens_ = std::min(burst_, tokens_ + secondsSince(refilled_, now) * rate_);
+        refilled_ = now;
+        tokens_ -= static_cast<double>(bytes);
+        debtSeconds = tokens_ < 0.0 ? -tokens_ / rate_ : 0.0;
+    }
+    if (debtSeconds > 0.0) {
+        std::this_thread::sleep_for(std::chrono::duration<double>(debtSeconds));
+    }
+}
+
+// ============================================================================
+// FirmwareCampaign
+// ============================================================================
+
+FirmwareCampaign::FirmwareCampaign(std::shared_ptr<IFirmwareSource> source, const FotaConfig& config)
+    : source_(std::move(source))
+    , config_(config)
+    , bucket_(config.bytesPerSecond,
+              config.burstBytes > 0.0 ? config.burstBytes
+                                      : static_cast<double>(config.chunkBytes) * std::max(1u, config.workers)) {
+    config_.workers = std::max(1u, config_.workers);
+    config_.chunkBytes = std::max<std::size_t>(1, config_.chunkBytes);
+    config_.maxActive = std::max<std::size_t>(1, config_.maxActive);
+    config_.maxAttempts = std::max(1u, config_.maxAttempts);
+}
+
+FirmwareCampaign::~FirmwareCampaign() {
+    stop();
+}
+
+void FirmwareCampaign::setFinishedCallback(FinishedCallback callback) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    finished_ = std::move(callback);
+}
+
+bool FirmwareCampaign::start(std::size_t device, const std::string& deviceId, const FirmwareJob& job) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (stopping_) {
+        return false;
+    }
+    auto& slot = sessions_[device];
+    if (slot) {
+        auto state = slot->result.state;
+        if (state == State::Queued || state == State::Downloading ||
+            (state == State::Verified && slot->job.version == job.version)) {
+            return false;
+        }
+    }
+
+    auto now = std::chrono::steady_clock::now();
+    slot = std::make_unique<Session>();
+    slot->device = device;
+    slot->job = job;
+    slot->result.deviceId = deviceId;
+    slot->result.version = job.version;
+    slot->hash = std::make_unique<Sha256>();
+    slot->triggered = now;
+    if (started_++ == 0) {
+        firstStart_ = now;
+    }
+    waiting_.push_back(slot.get());
+    admitQueued();
+
+    while (workers_.size() < config_.workers) {
+        unsigned worker = static_cast<unsigned>(workers_.size());
+        workers_.emplace_back([this, worker]() { run(worker); });
+    }
+    return true;
+}
+
+FirmwareCampaign::Report FirmwareCampaign::report() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    Report report;
+    report.started = started_;
+    report.active = active_;
+    report.queued = waiting_.size();
+    report.verified = verified_;
+    report.failed = failed_;
+    report.bytes = bytes_;
+    report.resumes = resumes_;
+    report.firstError = firstError_;
+    if (started_ > 0) {
+        auto end = report.done() ? lastFinish_ : std::chrono::steady_clock::now();
+        report.seconds = secondsSince(firstStart_, end);
+    }
+    report.p50Seconds = percentile(completionSeconds_, 0.50);
+    report.p95Seconds = percentile(completionSeconds_, 0.95);
+    report.maxSeconds = completionSeconds_.empty()
+        ? 0.0 : *std::max_element(completionSeconds_.begin(), completionSeconds_.end());
+    return report;
+}
+
+FirmwareCampaign::Result FirmwareCampaign::result(std::size_t device) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = sessions_.find(device);
+    return it != sessions_.end() ? it->second->result : Result{};
+}
+
+void FirmwareCampaign::stop() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    ready_.notify_all();
+    for (auto& worker : workers_) {
+        worker.join();
+    }
+    workers_.clear();
+    for (auto& [device, session] : sessions_) {
+        if (session->flash) {
+            std::fclose(session->flash);
+            session->flash = nullptr;
+        }
+    }
+}
+
+void FirmwareCampaign::run(unsigned worker) {
+    std::vector<std::uint8_t> buffer(config_.chunkBytes);
+    std::uint64_t random = config_.seed ^ (0xD1B54A32D192ED03ull * (worker + 1));
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (true) {
+        ready_.wait(lock, [this]() { return stopping_ || !runnable_.empty(); });
+        if (stopping_) {
+            return;
+        }
+        Session* session = runnable_.front();
+        runnable_.pop_front();
+        lock.unlock();
+        bool finished = step(*session, buffer, random);
+        lock.lock();
+        if (!finished) {
+            // Back of the line: active downloads share the workers range by range
+            runnable_.push_back(session);
+            ready_.notify_one();
+        }
+    }
+}
+
+bool FirmwareCampaign::prepare(Session& session, std::vector<std::uint8_t>& buffer) {
+    session.prepared = true;
+    if (config_.flashDirectory.empty()) {
+        return true;
+    }
+
+    // An earlier run's partial image is re-hashed from flash and kept
+    auto path = flashPath(session);
+    std::uint64_t kept = 0;
+    if (std::FILE* existing = std::fopen(path.c_str(), "rb")) {
+        std::size_t n;
+        while (kept < session.job.size &&
+               (n = std::fread(buffer.data(), 1,
+                               static_cast<std::size_t>(std::min<std::uint64_t>(buffer.size(), session.job.size - kept)),
+                               existing)) > 0) {
+            session.hash->update(buffer.data(), n);
+            kept += n;
+        }
+        bool longer = std::fgetc(existing) != EOF;
+        std::fclose(existing);
+        if (longer) {
+            // Not a prefix of this image
+            session.hash->reset();
+            kept = 0;
+        }
+    }
+
+    session.flash = std::fopen(path.c_str(), kept > 0 ? "r+b" : "wb");
+    if (!session.flash || std::fseek(session.flash, static_cast<long>(kept), SEEK_SET) != 0) {
+        finish(session, State::Failed, "cannot open flash file " + path);
+        return false;
+    }
+    session.offset = kept;
+    if (kept > 0) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        ++session.result.resumes;
+        ++resumes_;
+    }
+    return true;
+}
+
+bool FirmwareCampaign::step(Session& session, std::vector<std::uint8_t>& buffer, std::uint64_t& random) {
+    if (!session.prepared && !prepare(session, buffer)) {
+        return true;
+    }
+
+    if (session.offset < session.job.size) {
+        auto length = static_cast<std::size_t>(std::min<std::uint64_t>(buffer.size(),
+                                                                       session.job.size - session.offset));
+        bucket_.acquire(length);
+        std::size_t received = 0;
+        std::string error;
+        if (!source_->readRange(session.job.source, session.offset, buffer.data(), length, received, error)) {
+            if (++session.errors >= config_.maxAttempts) {
+                finish(session, State::Failed, error);
+                return true;
+            }
+            std::lock_guard<std::mutex> lock(mutex_);
+            ++session.result.resumes;
+            ++resumes_;
+            return false;
+        }
+        if (received == 0) {
+            finish(session, State::Failed, "image ends at byte " + std::to_string(session.offset) + " of " +
+                                               std::to_string(session.job.size));
+            return true;
+        }
+
+        // A dropped connection delivers part of the range; the next request resumes after it
+        bool interrupted = received > 1 && config_.interruptRate > 0.0 && uniform(random) < config_.interruptRate;
+        if (interrupted) {
+            received = 1 + static_cast<std::size_t>(nextRandom(random) % (received - 1));
+        }
+
+        session.errors = 0;
+        session.hash->update(buffer.data(), received);
+        if (session.flash && std::fwrite(buffer.data(), 1, received, session.flash) != received) {
+            finish(session, State::Failed, "flash write failed at byte " + std::to_string(session.offset));
+            return true;
+        }
+        session.offset += received;
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        session.result.bytes += received;
+        bytes_ += received;
+        if (interrupted) {
+            ++session.result.resumes;
+            ++resumes_;
+        }
+    }
+
+    if (session.offset < session.job.size) {
+        return false;
+    }
+    auto digest = session.hash->finalHex();
+    if (digest != session.job.sha256) {
+        finish(session, State::Failed, "SHA-256 mismatch: image is " + digest);
+    } else {
+        finish(session, State::Verified, "");
+    }
+    return true;
+}
+
+void FirmwareCampaign::finish(Session& session, State state, std::string error) {
+    if (session.flash) {
+        std::fclose(session.flash);
+        session.flash = nullptr;
+        if (state == State::Failed && session.offset >= session.job.size) {
+            // Complete but corrupt: erase the slot so a retry starts clean
+            std::remove(flashPath(session).c_str());
+        }
+    }
+    session.hash.reset();
+
+    auto now = std::chrono::steady_clock::now();
+    Result result;
+    FinishedCallback callback;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        session.result.state = state;
+        session.result.error = std::move(error);
+        session.result.seconds = secondsSince(session.triggered, now);
+        if (state == State::Verified) {
+            ++verified_;
+            completionSeconds_.push_back(session.result.seconds);
+        } else {
+            ++failed_;
+            if (firstError_.empty()) {
+                firstError_ = session.result.deviceId + ": " + session.result.error;
+            }
+        }
+        lastFinish_ = now;
+        --active_;
+        admitQueued();
+        result = session.result;
+        callback = finished_;
+    }
+    if (callback) {
+        callback(session.device, result);
+    }
+}
+
+void FirmwareCampaign::admitQueued() {
+    while (active_ < config_.maxActive && !waiting_.empty()) {
+        Session* session = waiting_.front();
+        waiting_.pop_front();
+        session->result.state = State::Downloading;
+        ++active_;
+        runnable_.push_back(session);
+        ready_.notify_one();
+    }
+}
+
+std::string FirmwareCampaign::flashPath(const Session& session) const {
+    std::string path = config_.flashDirectory;
+    if (path.back() != '/' && path.back() != '\\') {
+        path += '/';
+    }
+    return path + session.result.deviceId + "-" + session.job.version + ".bin";
+}
+
+} // namespace tracker
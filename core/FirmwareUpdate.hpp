@@ -0,0 +1,212 @@
+/**
+ * @file FirmwareUpdate.hpp
+ * @brief Simulated firmware-over-the-air downloads for a whole fleet
+ *
+ * A twin desired-properties patch with an "ota" object starts a download on
+ * the device that receives it:
+ *
+ *     "ota": {"version": "2.4.1", "source": "tracker-2.4.1.bin",
+ *             "sha256": "9f86d0...", "size": 4194304}
+ *
+ * The image is fetched in range requests of chunkBytes from an
+ * IFirmwareSource (an HTTP/blob stand-in). Each chunk is hashed and written
+ * to the device's flash emulation file, then dropped. Memory is bounded by
+ * one chunk buffer per worker thread plus a hash state per active download,
+ * whatever the image size and fleet size.
+ *
+ * - Rate limiting: one token bucket caps the fleet's aggregate download
+ *   rate, and maxActive caps concurrent downloads. Further devices queue.
+ * - Resume: interruptRate drops the connection partway through a range.
+ *   The device keeps its offset and hash state and continues with a range
+ *   starting where it stopped. A flash file left by an earlier run is
+ *   re-hashed from flash and the download resumes after it.
+ * - Verification: the digest of all bytes received must match "sha256"
+ *   once "size" bytes have arrived, or the download fails and its flash
+ *   file is removed.
+ *
+ * The report gives aggregate throughput and time-to-complete percentiles,
+ * measured from the trigger to verification, queueing included.
+ *
+ * @note Worker threads start with the first download; the destructor stops them
+ */
+
+#pragma once
+
+#include <nlohmann/json.hpp>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace tracker {
+
+/// Fleet-level download settings ([fota] in the TOML file)
+struct FotaConfig {
+    std::string imageDirectory;             ///< Where the source looks up image names (empty = as given)
+    std::string flashDirectory;             ///< Flash emulation files (empty = verify only, nothing written)
+    unsigned workers = 4;                   ///< Download threads shared by all devices
+    std::size_t chunkBytes = 64 * 1024;     ///< Bytes per range request
+    std::size_t maxActive = 512;            ///< Concurrent downloads; the rest wait in line
+    double bytesPerSecond = 0.0;            ///< Aggregate rate limit (0 = unlimited)
+    double burstBytes = 0.0;                ///< Token bucket depth (0 = one chunk per worker)
+    double interruptRate = 0.0;             ///< Probability that a range request is cut off
+    unsigned maxAttempts = 5;               ///< Consecutive source errors before a download fails
+    std::uint64_t seed = 1;                 ///< Interruption sampling seed
+};
+
+/// One image to download, as described by the twin's "ota" object
+struct FirmwareJob {
+    std::string version;
+    std::string source;                     ///< Image name or path handed to the source
+    std::string sha256;                     ///< Expected digest, hex
+    std::uint64_t size = 0;                 ///< Image size in bytes
+
+    /**
+     * @brief Read a job from the twin's "ota" object
+     * @return false with error set if a field is missing or malformed
+     */
+    static bool fromDesired(const nlohmann::json& ota, FirmwareJob& job, std::string& error);
+};
+
+/**
+ * @brief Range reads of firmware images (port; HTTP server or blob store)
+ */
+class IFirmwareSource {
+public:
+    virtual ~IFirmwareSource() = default;
+
+    /**
+     * @brief Read up to length bytes of an image starting at offset
+     * @param received Bytes stored in buffer; short only at the end of the image
+     * @return false with error set if the image cannot be read
+     * @note Called concurrently from every download worker
+     */
+    virtual bool readRange(const std::string& source, std::uint64_t offset, std::uint8_t* buffer,
+                           std::size_t length, std::size_t& received, std::string& error) = 0;
+};
+
+/**
+ * @brief Thread-safe token bucket in bytes
+ *
+ * acquire() takes tokens at once and sleeps off any debt, so waiting callers
+ * are served in the order they arrived and the long-run rate never exceeds
+ * the limit.
+ */
+class TokenBucket {
+public:
+    /** @param bytesPerSecond Refill rate (0 = unlimited) @param burstBytes Bucket depth */
+    TokenBucket(double bytesPerSecond, double burstBytes);
+
+    void acquire(std::size_t bytes);
+
+private:
+    std::mutex mutex_;
+    double rate_;
+    double burst_;
+    double tokens_;
+    std::chrono::steady_clock::time_point refilled_;
+};
+
+class FirmwareCampaign {
+public:
+    enum class State { Queued, Downloading, Verified, Failed };
+
+    struct Result {
+        std::string deviceId;
+        std::string version;
+        State state = State::Queued;
+        std::uint64_t bytes = 0;            ///< Bytes downloaded (excluding a resumed flash prefix)
+        unsigned resumes = 0;               ///< Ranges restarted after an interruption or restart
+        double seconds = 0.0;               ///< Trigger to verification or failure
+        std::string error;
+    };
+
+    struct Report {
+        std::size_t started = 0;
+        std::size_t active = 0;             ///< Downloading now
+        std::size_t queued = 0;             ///< Waiting for a download slot
+        std::size_t verified = 0;
+        std::size_t failed = 0;
+        std::uint64_t bytes = 0;            ///< Bytes downloaded by all devices
+        std::uint64_t resumes = 0;
+        double seconds = 0.0;               ///< First trigger to last completion (or now)
+        double p50Seconds = 0.0;            ///< Time to complete, verified devices
+        double p95Seconds = 0.0;
+        double maxSeconds = 0.0;
+        std::string firstError;
+
+        double bytesPerSecond() const { return seconds > 0.0 ? static_cast<double>(bytes) / seconds : 0.0; }
+        bool done() const { return started > 0 && active == 0 && queued == 0; }
+    };
+
+    /// Called on a worker thread when a download is verified or fails
+    using FinishedCallback = std::function<void(std::size_t device, const Result& result)>;
+
+    FirmwareCampaign(std::shared_ptr<IFirmwareSource> source, const FotaConfig& config);
+    ~FirmwareCampaign();
+
+    FirmwareCampaign(const FirmwareCampaign&) = delete;
+    FirmwareCampaign& operator=(const FirmwareCampaign&) = delete;
+
+    void setFinishedCallback(FinishedCallback callback);
+
+    /**
+     * @brief Queue a download for a device
+     * @return false while the device is downloading, or if it already verified this version
+     * @note A failed download, or a verified one followed by a new version, starts over
+     */
+    bool start(std::size_t device, const std::string& deviceId, const FirmwareJob& job);
+
+    Report report() const;
+
+    /** @brief Result so far for a device (state Queued if it never started) */
+    Result result(std::size_t device) const;
+
+    /** @brief Stop the workers; downloads in progress keep their flash files for a later resume */
+    void stop();
+
+private:
+    struct Session;
+
+    void run(unsigned worker);
+    /** @return true when the session has finished */
+    bool step(Session& session, std::vector<std::uint8_t>& buffer, std::uint64_t& random);
+    bool prepare(Session& session, std::vector<std::uint8_t>& buffer);
+    void finish(Session& session, State state, std::string error);
+    void admitQueued();
+    std::string flashPath(const Session& session) const;
+
+    std::shared_ptr<IFirmwareSource> source_;
+    FotaConfig config_;
+    TokenBucket bucket_;
+    FinishedCallback finished_;
+
+    mutable std::mutex mutex_;
+    std::condition_variable ready_;
+    std::unordered_map<std::size_t, std::unique_ptr<Session>> sessions_;
+    std::deque<Session*> waiting_;          ///< Triggered, no download slot yet
+    std::deque<Session*> runnable_;         ///< Active, next range not yet claimed by a worker
+    std::size_t active_ = 0;
+    std::vector<std::thread> workers_;
+    bool stopping_ = false;
+
+    std::chrono::steady_clock::time_point firstStart_;
+    std::chrono::steady_clock::time_point lastFinish_;
+    std::vector<double> completionSeconds_;
+    std::uint64_t bytes_ = 0;
+    std::uint64_t resumes_ = 0;
+    std::size_t started_ = 0;
+    std::size_t verified_ = 0;
+    std::size_t failed_ = 0;
+    std::string firstError_;
+};
+
+} // namespace tracker
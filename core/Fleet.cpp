@@ -0,0 +1,444 @@
+#include "Fleet.hpp"
+#include "Stats.hpp"
+#include "Probes.hpp"
+#include "../crypto/SasToken.hpp"
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <limits>
+#include <iostream>
+
+namespace tracker {
+
+namespace {
+/// Set while a worker ticks its range, so device events find the worker's merge lane
+thread_local const Fleet* t_tickingFleet = nullptr;
+thread_local std::size_t t_tickLane = 0;
+
+/// Seed of a device's generator: the fleet seed mixed with the index (SplitMix64 finalizer)
+std::uint32_t deviceSeed(std::uint32_t fleetSeed, std::size_t index) {
+    std::uint64_t x = (static_cast<std::uint64_t>(fleetSeed) << 32 | index) + 0x9E3779B97F4A7C15ull;
+    x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ull;
+    x = (x ^ (x >> 27)) * 0x94D049BB133111EBull;
+    return static_cast<std::uint32_t>(x ^ (x >> 31));
+}
+}
+
+Fleet::Fleet(ClientFactory clientFactory,
+             std::shared_ptr<IClock> clock,
+             std::shared_ptr<IRng> rng)
+    : clientFactory_(std::move(clientFactory)), clock_(clock), rng_(rng) {}
+
+Fleet::~Fleet() {
+    stopMerge();
+    stopWorkers();
+    devices_.clear();   // Before the sink and merge state they may still call into
+}
+
+void Fleet::configure(const SimulatorConfig& base, std::size_t deviceCount) {
+    deviceCount = std::max<std::size_t>(deviceCount, 1);
+
+    stopMerge();
+    stopWorkers();
+    merge_.reset();
+    devices_.clear();
+    devices_.reserve(deviceCount);
+    spatialIndex_.reset();
+    batteries_ = std::make_shared<BatteryBank>();
+    catalogs_ = std::make_shared<CatalogStore>(
+        Catalog::build(base.startLocation, base.route, base.geofences));
+    catalogReader_ = catalogs_->registerReader();
+
+    activity_.reset();
+    SimulatorConfig scaled = base;
+    if (base.activity.enabled()) {
+        std::string error;
+        auto seed = static_cast<std::uint64_t>(rng_->uniformInt(0, std::numeric_limits<int>::max()));
+        activity_ = ActivityModel::create(base.activity, deviceCount, seed, error);
+        if (!activity_) {
+            std::cerr << "[Fleet] Activity model disabled: " << error << std::endl;
+        } else if (base.activity.timeScale != 1.0) {
+            // Periodic traffic keeps its simulated-time interval
+            auto compress = [&](int seconds) {
+                return seconds > 0 ? std::max(1, static_cast<int>(std::lround(seconds / base.activity.timeScale))) : seconds;
+            };
+            scaled.heartbeatSeconds = compress(base.heartbeatSeconds);
+            scaled.twinRefreshSeconds = compress(base.twinRefreshSeconds);
+        }
+    }
+    
+    std::vector<SimulatorConfig> configs;
+    configs.reserve(deviceCount);
+    for (std::size_t i = 0; i < deviceCount; ++i) {
+        configs.push_back(deriveDeviceConfig(scaled, i, deviceCount));
+        if (base.batteryAmbientSpreadC > 0.0) {
+            configs.back().batteryAmbientC += rng_->uniform(-base.batteryAmbientSpreadC, base.batteryAmbientSpreadC);
+        }
+    }
+    deriveSymmetricKeys(configs);
+
+    CatalogStore::ReadGuard catalog(*catalogs_, catalogReader_);
+    std::size_t workers = std::min(tickWorkers_, deviceCount);
+    // Every device draws from its own generator, whatever the worker count, so
+    // its draws depend only on the fleet seed and its index
+    auto fleetSeed = static_cast<std::uint32_t>(rng_->uniformInt(0, std::numeric_limits<int>::max()));
+    for (std::size_t i = 0; i < deviceCount; ++i) {
+        auto rng = std::make_shared<StandardRng>(deviceSeed(fleetSeed, i));
+        auto simulator = std::make_unique<Simulator>(clientFactory_(), clock_, rng);
+        simulator->useCatalog(catalog.get());
+        if (startupProfiler_) {
+            simulator->setStartupTimeline(startupProfiler_->addDevice(configs[i].deviceId));
+        }
+        simulator->configure(configs[i]);
+        simulator->attachBatteryBank(batteries_);
+        devices_.push_back(std::move(simulator));
+    }
+
+    for (std::size_t worker = 1; worker < workers; ++worker) {
+        workers_.emplace_back(&Fleet::workerLoop, this, worker);
+    }
+}
+
+void Fleet::start() {
+    lastTick_ = std::chrono::steady_clock::now();
+    startTime_ = lastTick_;
+    for (auto& device : devices_) {
+        device->start();
+    }
+}
+
+void Fleet::stop() {
+    for (auto& device : devices_) {
+        device->stop();
+    }
+    stopMerge();
+}
+
+void Fleet::tick() {
+    auto now = std::chrono::steady_clock::now();
+    TRACKER_PROBE1(tick_start, devices_.size());
+    double deltaSeconds = std::chrono::duration<double>(now - lastTick_).count();
+    lastTick_ = now;
+
+    // One batched battery update for the whole fleet (loads selected last frame)
+    if (batteries_) {
+        batteries_->refreshNoise(*rng_);
+        batteries_->tick(deltaSeconds);
+    }
+
+    // Scheduled trips start before the devices tick so the first frame moves
+    if (activity_) {
+        startDueTrips();
+    }
+
+    ++tickNumber_;
+    if (merge_) {
+        advanceExternal();
+    }
+
+    // Devices read the catalog only inside this section; reloads never block it
+    if (catalogs_) {
+        CatalogStore::ReadGuard catalog(*catalogs_, catalogReader_);
+        tickDevices(catalog.get());
+        if (spatialIndex_) {
+            for (std::size_t i = 0; i < devices_.size(); ++i) {
+                spatialIndex_->update(static_cast<std::uint32_t>(i), devices_[i]->getPosition(),
+                                      devices_[i]->getInsideFences());
+            }
+            spatialIndex_->publish(*catalog.get());
+        }
+    }
+
+    auto elapsedNs = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now() - now).count());
+    Stats::instance().recordTick(elapsedNs);
+    TRACKER_PROBE2(tick_end, devices_.size(), elapsedNs);
+}
+
+void Fleet::startDueTrips() {
+    double timeScale = activity_->config().timeScale;
+    activity_->advanceTo(simulatedSeconds(), dueTrips_);
+    for (const auto& trip : dueTrips_) {
+        auto& device = *devices_[trip.vehicle];
+        if (device.isDriving()) {
+            continue;   // Already on a manual drive; the schedule moves on
+        }
+        device.startDriving(trip.durationSeconds / timeScale / 60.0);
+    }
+    TRACKER_PROBE2(trips_started, dueTrips_.size(), activity_->tripsStarted());
+}
+
+void Fleet::tickDevices(const Catalog* catalog) {
+    tickOrdered_ = merge_ && !mergeClosed_;
+    if (workers_.empty()) {
+        tickRange(0, catalog);
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(workMutex_);
+        workCatalog_ = catalog;
+        workPending_ = workers_.size();
+        ++workGeneration_;
+    }
+    workReady_.notify_all();
+    tickRange(0, catalog);
+
+    std::unique_lock<std::mutex> lock(workMutex_);
+    workDone_.wait(lock, [this] { return workPending_ == 0; });
+}
+
+void Fleet::tickRange(std::size_t worker, const Catalog* catalog) {
+    std::size_t count = devices_.size();
+    std::size_t ranges = workers_.size() + 1;
+    std::size_t begin = count * worker / ranges;
+    std::size_t end = count * (worker + 1) / ranges;
+
+    if (tickOrdered_) {
+        t_tickingFleet = this;
+        t_tickLane = worker;
+    }
+    for (std::size_t i = begin; i < end; ++i) {
+        devices_[i]->useCatalog(catalog);
+        devices_[i]->tick();
+    }
+    if (tickOrdered_) {
+        t_tickingFleet = nullptr;
+        merge_->advance(worker, 2 * tickNumber_ + 2);
+    }
+}
+
+void Fleet::workerLoop(std::size_t worker) {
+    std::uint64_t generation = 0;
+    while (true) {
+        const Catalog* catalog = nullptr;
+        {
+            std::unique_lock<std::mutex> lock(workMutex_);
+            workReady_.wait(lock, [&] { return workStopping_ || workGeneration_ != generation; });
+            if (workStopping_) {
+                return;
+            }
+            generation = workGeneration_;
+            catalog = workCatalog_;
+        }
+
+        tickRange(worker, catalog);
+
+        std::lock_guard<std::mutex> lock(workMutex_);
+        if (--workPending_ == 0) {
+            workDone_.notify_one();
+        }
+    }
+}
+
+void Fleet::stopWorkers() {
+    {
+        std::lock_guard<std::mutex> lock(workMutex_);
+        workStopping_ = true;
+    }
+    workReady_.notify_all();
+    for (auto& worker : workers_) {
+        worker.join();
+    }
+    workers_.clear();
+    workStopping_ = false;
+    workGeneration_ = 0;
+}
+
+void Fleet::setOrderedEventSink(std::function<void(const std::string& json)> sink) {
+    stopMerge();
+    orderedSink_ = std::move(sink);
+
+    // One lane per tick worker, plus the external lane
+    std::size_t external = workers_.size() + 1;
+    merge_ = std::make_unique<EventMerge>(external + 1);
+    for (std::size_t lane = 0; lane < external; ++lane) {
+        merge_->advance(lane, 2 * tickNumber_ + 2);
+    }
+    externalTime_ = 2 * tickNumber_ + 1;
+    merge_->advance(external, externalTime_);
+    externalPending_.clear();
+    mergeClosed_ = false;
+    mergeStopping_ = false;
+
+    for (std::size_t i = 0; i < devices_.size(); ++i) {
+        devices_[i]->setEventCallback([this, i](const Event& event, const std::string& json) {
+            appendEvent(i, event, json);
+        });
+    }
+    mergeThread_ = std::thread(&Fleet::mergeLoop, this);
+}
+
+void Fleet::appendEvent(std::size_t device, const Event& event, const std::string& json) {
+    MergeKey key{0, static_cast<std::uint32_t>(device), event.sequence};
+    if (t_tickingFleet == this) {
+        key.time = 2 * tickNumber_;
+        merge_->append(t_tickLane, key, json);
+        return;
+    }
+
+    // Raised off the tick: the order among these is arrival order, so sort them by key per tick
+    std::lock_guard<std::mutex> lock(externalMutex_);
+    if (mergeClosed_) {
+        orderedSink_(json);
+        return;
+    }
+    key.time = externalTime_;
+    externalPending_.emplace_back(key, json);
+}
+
+void Fleet::advanceExternal() {
+    std::lock_guard<std::mutex> lock(externalMutex_);
+    if (mergeClosed_) {
+        return;
+    }
+    flushExternal();
+    externalTime_ = 2 * tickNumber_ + 1;
+    merge_->advance(merge_->lanes() - 1, externalTime_);
+}
+
+void Fleet::flushExternal() {
+    std::sort(externalPending_.begin(), externalPending_.end(),
+              [](const auto& a, const auto& b) { return a.first < b.first; });
+    for (auto& [key, json] : externalPending_) {
+        merge_->append(merge_->lanes() - 1, key, std::move(json));
+    }
+    externalPending_.clear();
+}
+
+void Fleet::mergeLoop() {
+    auto deliver = [this](const MergeKey&, std::string& json) { orderedSink_(json); };
+    while (!mergeStopping_.load(std::memory_order_acquire)) {
+        if (merge_->drain(deliver) == 0) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+    }
+    while (!merge_->finished()) {
+        merge_->drain(deliver);
+    }
+}
+
+void Fleet::stopMerge() {
+    // Holding the lock keeps late events out until the merge thread has delivered the rest
+    std::lock_guard<std::mutex> lock(externalMutex_);
+    if (!merge_ || mergeClosed_) {
+        return;
+    }
+    flushExternal();
+    for (std::size_t lane = 0; lane < merge_->lanes(); ++lane) {
+        merge_->close(lane);
+    }
+    mergeStopping_ = true;
+    mergeThread_.join();
+    mergeClosed_ = true;
+}
+
+double Fleet::simulatedSeconds() const {
+    double wallSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime_).count();
+    if (!activity_) {
+        return wallSeconds;
+    }
+    return activity_->config().startHour * 3600.0 + wallSeconds * activity_->config().timeScale;
+}
+
+void Fleet::enableSpatialIndex(float cellMeters) {
+    std::vector<std::string> deviceIds;
+    deviceIds.reserve(devices_.size());
+    for (const auto& device : devices_) {
+        deviceIds.push_back(device->getConfig().deviceId);
+    }
+    spatialIndex_ = std::make_shared<FleetIndex>(std::move(deviceIds), cellMeters);
+}
+
+void Fleet::forEach(const std::function<void(Simulator&)>& action) {
+    for (auto& device : devices_) {
+        action(*device);
+    }
+}
+
+SimulatorConfig Fleet::deriveDeviceConfig(const SimulatorConfig& base,
+                                          std::size_t index, std::size_t count) {
+    if (count <= 1) {
+        return base;
+    }
+
+    SimulatorConfig config = base;
+    config.deviceId = base.deviceId + "-" + indexSuffix(index, count);
+
+    if (!base.imei.empty()) {
+        config.imei = deriveImei(base.imei, index);
+        if (base.deviceId == base.imei) {
+            config.deviceId = config.imei;  // IMEI doubles as device ID under DPS
+        }
+
+        // Certificates live in a per-IMEI directory (<base>/<imei>/device.*.pem)
+        auto rebase = [&](std::string& path) {
+            std::string from = "/" + base.imei + "/";
+            auto pos = path.find(from);
+            if (pos != std::string::npos) {
+                path.replace(pos, from.size(), "/" + config.imei + "/");
+            }
+        };
+        rebase(config.deviceCertPath);
+        rebase(config.deviceKeyPath);
+        rebase(config.deviceChainPath);
+    }
+
+    return config;
+}
+
+std::vector<std::string> Fleet::deriveDeviceIds(const SimulatorConfig& base, std::size_t count) {
+    std::vector<std::string> ids;
+    ids.reserve(count);
+    for (std::size_t i = 0; i < count; ++i) {
+        ids.push_back(deriveDeviceConfig(base, i, count).deviceId);
+    }
+    return ids;
+}
+
+void Fleet::deriveSymmetricKeys(std::vector<SimulatorConfig>& configs) {
+    if (configs.empty() || configs.front().enrollmentGroupKeyBase64.empty()) {
+        return;
+    }
+
+    auto started = std::chrono::steady_clock::now();
+    std::vector<std::string> registrationIds;
+    registrationIds.reserve(configs.size());
+    for (const auto& config : configs) {
+        registrationIds.push_back(config.imei);
+    }
+
+    auto keys = SasToken::deriveDeviceKeys(configs.front().enrollmentGroupKeyBase64, registrationIds);
+    if (keys.size() != configs.size()) {
+        std::cerr << "[Fleet] Could not derive device keys from the enrollment group key" << std::endl;
+        return;
+    }
+    for (std::size_t i = 0; i < configs.size(); ++i) {
+        configs[i].dpsDeviceKeyBase64 = std::move(keys[i]);
+    }
+
+    auto elapsedMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - started).count();
+    std::cout << "[Fleet] Derived " << configs.size() << " device keys in " << elapsedMs << " ms" << std::endl;
+}
+
+std::string Fleet::indexSuffix(std::size_t index, std::size_t count) {
+    std::size_t width = std::to_string(count - 1).size();
+    std::string digits = std::to_string(index);
+    return std::string(width > digits.size() ? width - digits.size() : 0, '0') + digits;
+}
+
+std::string Fleet::deriveImei(const std::string& imei, std::size_t index) {
+    bool numeric = !imei.empty() && imei.size() <= 18 &&
+                   std::all_of(imei.begin(), imei.end(), [](unsigned char c) { return std::isdigit(c); });
+    if (!numeric) {
+        return imei + "-" + std::to_string(index);
+    }
+
+    std::string next = std::to_string(std::stoull(imei) + index);
+    if (next.size() < imei.size()) {
+        next.insert(0, imei.size() - next.size(), '0');
+    }
+    return next;
+}
+
+} // namespace tracker
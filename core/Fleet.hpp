@@ -0,0 +1,234 @@
+/**
+ * @file Fleet.hpp
+ * @brief In-process fleet of simulated trackers sharing a clock and an RNG seed
+ *
+ * Runs N Simulator instances from one base configuration. Per-device identity
+ * (device ID, IMEI and certificate directory) is derived from the device index,
+ * so a single TOML file can describe a load test. Each device phase-spreads its
+ * periodic activity by its derived ID (see PhaseSchedule.hpp), so a fleet that
+ * starts together does not fire together.
+ *
+ * With a DPS group enrollment key, configure() derives every device's
+ * symmetric key in one batch, so provisioning needs no per-device certificates.
+ *
+ * Battery cells of all devices live in one BatteryBank that tick() advances
+ * with a single batched kernel before the devices run.
+ *
+ * Route and geofences live in one CatalogStore shared by all devices. A reload
+ * thread may publish a new catalog at any time; tick() picks it up inside a
+ * lock-free read section and each device remaps its fence membership.
+ *
+ * With the spatial index enabled, tick() also records every device's position
+ * and fence membership in a FleetIndex and publishes a snapshot that query
+ * threads can search without holding up the next tick.
+ *
+ * With [[activity.cohorts]] configured, an ActivityModel schedules trip
+ * starts by time of day and tick() starts due trips on parked devices. A
+ * time scale above 1 runs the simulated day faster than wall time: trips,
+ * heartbeats and twin refreshes are shortened by the same factor.
+ *
+ * With a startup profiler attached, every device gets a cold-start timeline
+ * before it is configured (see StartupProfiler.hpp).
+ *
+ * Each device draws from its own RNG, seeded from one draw of the fleet
+ * RNG and the device index, so its draws do not depend on the worker
+ * count. With several tick workers, tick() splits the devices into
+ * contiguous ranges and advances them on persistent threads. An ordered
+ * event sink sees every
+ * device's events in (tick, device index, sequence) order whatever the
+ * worker count: each worker appends to its own lane and a merge thread
+ * combines the lanes (see EventMerge.hpp).
+ *
+ * @note A fleet of one uses the base configuration unchanged
+ * @note tick() and the other members are called from one driver thread
+ */
+
+#pragma once
+
+#include "Simulator.hpp"
+#include "BatteryModel.hpp"
+#include "CatalogStore.hpp"
+#include "FleetIndex.hpp"
+#include "StartupProfiler.hpp"
+#include "ActivityModel.hpp"
+#include "EventMerge.hpp"
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <chrono>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace tracker {
+
+class Fleet {
+public:
+    /// Creates one MQTT client per device
+    using ClientFactory = std::function<std::shared_ptr<IMqttClient>()>;
+
+    Fleet(ClientFactory clientFactory,
+          std::shared_ptr<IClock> clock,
+          std::shared_ptr<IRng> rng);
+    ~Fleet();
+
+    Fleet(const Fleet&) = delete;
+    Fleet& operator=(const Fleet&) = delete;
+
+    /**
+     * @brief Create and configure deviceCount simulators
+     * @param base Configuration template
+     * @param deviceCount Number of devices (>= 1)
+     */
+    void configure(const SimulatorConfig& base, std::size_t deviceCount);
+
+    void start();
+
+    /** @brief Stop every device, then flush the ordered event sink */
+    void stop();
+
+    /** @brief Advance the battery bank, then every device, by one simulation frame */
+    void tick();
+
+    std::size_t size() const { return devices_.size(); }
+    Simulator& device(std::size_t index) { return *devices_[index]; }
+
+    /** @brief Route/geofence catalogs shared by all devices (publish reloads here) */
+    std::shared_ptr<CatalogStore> catalogs() const { return catalogs_; }
+
+    /**
+     * @brief Maintain a spatial index of device positions from the next tick on
+     * @param cellMeters Grid cell edge in metres
+     * @note Call after configure() and before ticking starts
+     */
+    void enableSpatialIndex(float cellMeters = FleetIndex::kDefaultCellMeters);
+    
+    /**
+     * @brief Give every device configured from now on a cold-start timeline
+     * @param profiler Profiler created before the configuration was parsed
+     * @note Call before configure()
+     */
+    void setStartupProfiler(std::shared_ptr<StartupProfiler> profiler) { startupProfiler_ = std::move(profiler); }
+    
+    /**
+     * @brief Advance devices on this many threads (1 = the calling thread only)
+     * @note Call before configure(); the driver thread counts as one worker
+     */
+    void setTickWorkers(std::size_t workers) { tickWorkers_ = std::max<std::size_t>(workers, 1); }
+    std::size_t tickWorkers() const { return tickWorkers_; }
+
+    /**
+     * @brief Deliver every device's events to one sink in deterministic order
+     *
+     * Events raised while a device ticks are keyed by (tick, device index,
+     * sequence). Events raised off the tick (MQTT callbacks, UI actions,
+     * scheduled trips) follow every event of the tick in progress and
+     * precede the next tick's. The sink runs on a merge thread about one
+     * tick behind; stop() delivers the rest.
+     *
+     * @note Call after configure() and before start(); replaces the devices' event callbacks
+     */
+    void setOrderedEventSink(std::function<void(const std::string& json)> sink);
+
+    /** @brief Spatial index (null unless enabled); snapshot() is safe from any thread */
+    std::shared_ptr<FleetIndex> spatialIndex() const { return spatialIndex_; }
+
+    /** @brief Trip schedule (null unless the configuration has activity cohorts) */
+    const ActivityModel* activity() const { return activity_.get(); }
+    
+    /** @brief Simulated seconds since midnight of day 0 (wall time when no activity model) */
+    double simulatedSeconds() const;
+    
+    /** @brief Apply an action to every device in index order */
+    void forEach(const std::function<void(Simulator&)>& action);
+
+    /**
+     * @brief Derive per-device configuration from a template
+     *
+     * Device IDs get a zero-padded index suffix. Numeric IMEIs are incremented
+     * by the index (keeping their width); certificate paths follow the IMEI
+     * directory. With count == 1 the template is returned unchanged.
+     */
+    static SimulatorConfig deriveDeviceConfig(const SimulatorConfig& base,
+                                              std::size_t index, std::size_t count);
+
+    /** @brief Derived device IDs for count devices (what the fleet would use) */
+    static std::vector<std::string> deriveDeviceIds(const SimulatorConfig& base, std::size_t count);
+
+private:
+    /**
+     * @brief Fill in per-device DPS keys from the group enrollment key
+     *
+     * All keys are derived in one pass with a single keyed HMAC context
+     * before any device connects.
+     */
+    static void deriveSymmetricKeys(std::vector<SimulatorConfig>& configs);
+    
+    /** @brief Start the activity model's due trips on parked devices */
+    void startDueTrips();
+
+    /** @brief Tick every device, on the worker pool when there is one */
+    void tickDevices(const Catalog* catalog);
+
+    /** @brief Tick one worker's contiguous device range */
+    void tickRange(std::size_t worker, const Catalog* catalog);
+
+    /** @brief Route one device event to the ticking worker's lane or the external lane */
+    void appendEvent(std::size_t device, const Event& event, const std::string& json);
+
+    /** @brief Hand events raised since the last tick to the external lane (driver thread) */
+    void advanceExternal();
+    void flushExternal();
+
+    void workerLoop(std::size_t worker);
+    void stopWorkers();
+    void mergeLoop();
+    void stopMerge();
+
+    static std::string indexSuffix(std::size_t index, std::size_t count);
+    static std::string deriveImei(const std::string& imei, std::size_t index);
+
+    ClientFactory clientFactory_;
+    std::shared_ptr<IClock> clock_;
+    std::shared_ptr<IRng> rng_;
+    std::vector<std::unique_ptr<Simulator>> devices_;
+    std::shared_ptr<BatteryBank> batteries_;   ///< SoA battery cells for all devices
+    std::shared_ptr<CatalogStore> catalogs_;   ///< Shared route/geofence catalog versions
+    std::size_t catalogReader_ = CatalogStore::kNoReader;  ///< Read slot of the ticking thread
+    std::shared_ptr<FleetIndex> spatialIndex_;  ///< Optional position index published per tick
+    std::shared_ptr<StartupProfiler> startupProfiler_;  ///< Optional cold-start timelines
+    std::unique_ptr<ActivityModel> activity_;  ///< Optional time-of-day trip schedule
+    std::vector<ActivityModel::Trip> dueTrips_;  ///< Per-tick scratch (reused)
+    std::chrono::steady_clock::time_point startTime_;  ///< Wall time of start() (simulated clock origin)
+    std::chrono::steady_clock::time_point lastTick_;
+
+    // Parallel ticks
+    std::size_t tickWorkers_ = 1;
+    std::vector<std::thread> workers_;          ///< Workers 1..n-1 (the driver is worker 0)
+    std::mutex workMutex_;
+    std::condition_variable workReady_;
+    std::condition_variable workDone_;
+    std::uint64_t workGeneration_ = 0;          ///< Bumped once per dispatched tick
+    std::size_t workPending_ = 0;               ///< Workers still ticking this generation
+    const Catalog* workCatalog_ = nullptr;
+    bool workStopping_ = false;
+    bool tickOrdered_ = false;                  ///< This tick's events go to the worker lanes
+    std::uint64_t tickNumber_ = 0;              ///< Ticks started; events of tick t have key time 2t
+
+    // Ordered event sink
+    std::unique_ptr<EventMerge> merge_;         ///< Lanes 0..n-1 tick workers, lane n external
+    std::function<void(const std::string&)> orderedSink_;
+    std::thread mergeThread_;
+    std::atomic<bool> mergeStopping_{false};
+    std::mutex externalMutex_;                  ///< Guards the external lane's pending events
+    std::vector<std::pair<MergeKey, std::string>> externalPending_;  ///< Sorted into the lane per tick
+    std::uint64_t externalTime_ = 1;            ///< Key time 2t+1 for events raised after tick t started
+    bool mergeClosed_ = false;                  ///< After stop(): events go straight to the sink
+};
+
+} // namespace tracker
@@ -0,0 +1,352 @@
+#include "FleetIndex.hpp"
+#include <algorithm>
+#include <cmath>
+#include <queue>
+
+namespace tracker {
+
+namespace {
+    constexpr std::size_t kMaxPooledSnapshots = 4;
+
+    std::int32_t keyCol(std::uint64_t key) { return static_cast<std::int32_t>(static_cast<std::uint32_t>(key >> 32)); }
+    std::int32_t keyRow(std::uint64_t key) { return static_cast<std::int32_t>(static_cast<std::uint32_t>(key)); }
+
+    bool insidePolygon(EnuPoint p, const std::vector<EnuPoint>& polygon) {
+        bool inside = false;
+        for (std::size_t i = 0, j = polygon.size() - 1; i < polygon.size(); j = i++) {
+            const EnuPoint& a = polygon[i];
+            const EnuPoint& b = polygon[j];
+            if ((a.north > p.north) != (b.north > p.north) &&
+                p.east < (b.east - a.east) * (p.north - a.north) / (b.north - a.north) + a.east) {
+                inside = !inside;
+            }
+        }
+        return inside;
+    }
+}
+
+// --- FleetSnapshot ---
+
+std::int32_t FleetSnapshot::cellOf(float meters) const {
+    return static_cast<std::int32_t>(std::clamp(std::floor(meters / cellMeters_), -1e9f, 1e9f));
+}
+
+FleetSnapshot::CellRange FleetSnapshot::cellRange(EnuPoint a, EnuPoint b) const {
+    return {std::max(minCol_, cellOf(std::min(a.east, b.east))),
+            std::min(maxCol_, cellOf(std::max(a.east, b.east))),
+            std::max(minRow_, cellOf(std::min(a.north, b.north))),
+            std::min(maxRow_, cellOf(std::max(a.north, b.north)))};
+}
+
+bool FleetSnapshot::findCell(std::int32_t col, std::int32_t row,
+                             std::uint32_t& begin, std::uint32_t& end) const {
+    std::uint64_t key = (static_cast<std::uint64_t>(static_cast<std::uint32_t>(col)) << 32) |
+                        static_cast<std::uint32_t>(row);
+    auto it = std::lower_bound(cellKeys_.begin(), cellKeys_.end(), key);
+    if (it == cellKeys_.end() || *it != key) {
+        return false;
+    }
+    std::size_t cell = static_cast<std::size_t>(it - cellKeys_.begin());
+    begin = cellStart_[cell];
+    end = cellStart_[cell + 1];
+    return true;
+}
+
+template <typename Visit>
+void FleetSnapshot::forEachInCells(const CellRange& range, Visit&& visit) const {
+    if (range.col0 > range.col1 || range.row0 > range.row1) {
+        return;
+    }
+
+    // Large boxes over a sparse grid: scan occupied cells instead of the box
+    double span = (static_cast<double>(range.col1) - range.col0 + 1.0) *
+                  (static_cast<double>(range.row1) - range.row0 + 1.0);
+    if (span > static_cast<double>(cellKeys_.size())) {
+        for (std::size_t cell = 0; cell < cellKeys_.size(); ++cell) {
+            std::int32_t col = keyCol(cellKeys_[cell]);
+            std::int32_t row = keyRow(cellKeys_[cell]);
+            if (col < range.col0 || col > range.col1 || row < range.row0 || row > range.row1) continue;
+            for (std::uint32_t i = cellStart_[cell]; i < cellStart_[cell + 1]; ++i) {
+                visit(cellDevices_[i]);
+            }
+        }
+        return;
+    }
+
+    for (std::int32_t col = range.col0; col <= range.col1; ++col) {
+        for (std::int32_t row = range.row0; row <= range.row1; ++row) {
+            std::uint32_t begin, end;
+            if (!findCell(col, row, begin, end)) continue;
+            for (std::uint32_t i = begin; i < end; ++i) {
+                visit(cellDevices_[i]);
+            }
+        }
+    }
+}
+
+std::vector<std::uint32_t> FleetSnapshot::inBox(EnuPoint a, EnuPoint b) const {
+    float minEast = std::min(a.east, b.east), maxEast = std::max(a.east, b.east);
+    float minNorth = std::min(a.north, b.north), maxNorth = std::max(a.north, b.north);
+
+    std::vector<std::uint32_t> result;
+    forEachInCells(cellRange(a, b), [&](std::uint32_t device) {
+        float e = east_[device], n = north_[device];
+        if (e >= minEast && e <= maxEast && n >= minNorth && n <= maxNorth) {
+            result.push_back(device);
+        }
+    });
+    std::sort(result.begin(), result.end());
+    return result;
+}
+
+std::vector<std::uint32_t> FleetSnapshot::inBox(const Location& a, const Location& b) const {
+    return inBox(frame_.project(a), frame_.project(b));
+}
+
+std::vector<std::uint32_t> FleetSnapshot::inPolygon(const std::vector<EnuPoint>& polygon) const {
+    std::vector<std::uint32_t> result;
+    if (polygon.size() < 3) {
+        return result;
+    }
+
+    EnuPoint low = polygon[0], high = polygon[0];
+    for (const auto& vertex : polygon) {
+        low = {std::min(low.east, vertex.east), std::min(low.north, vertex.north)};
+        high = {std::max(high.east, vertex.east), std::max(high.north, vertex.north)};
+    }
+    forEachInCells(cellRange(low, high), [&](std::uint32_t device) {
+        if (insidePolygon(position(device), polygon)) {
+            result.push_back(device);
+        }
+    });
+    std::sort(result.begin(), result.end());
+    return result;
+}
+
+std::vector<std::uint32_t> FleetSnapshot::inPolygon(const std::vector<Location>& polygon) const {
+    std::vector<EnuPoint> projected;
+    projected.reserve(polygon.size());
+    for (const auto& vertex : polygon) {
+        projected.push_back(frame_.project(vertex));
+    }
+    return inPolygon(projected);
+}
+
+std::vector<DeviceHit> FleetSnapshot::nearest(EnuPoint point, std::size_t k) const {
+    std::vector<DeviceHit> result;
+    k = std::min(k, size());
+    if (k == 0) {
+        return result;
+    }
+
+    auto closer = [](const DeviceHit& a, const DeviceHit& b) {
+        return a.distanceMeters < b.distanceMeters || (a.distanceMeters == b.distanceMeters && a.device < b.device);
+    };
+    std::priority_queue<DeviceHit, std::vector<DeviceHit>, decltype(closer)> best(closer);  // Max-heap of k
+    auto consider = [&](std::uint32_t device) {
+        DeviceHit hit{device, LocalFrame::distanceMeters(point, position(device))};
+        if (best.size() < k) {
+            best.push(hit);
+        } else if (closer(hit, best.top())) {
+            best.pop();
+            best.push(hit);
+        }
+    };
+
+    // Expand square rings of cells; cells outside ring r are at least r cells away
+    std::int32_t col = cellOf(point.east), row = cellOf(point.north);
+    std::int32_t maxRing = std::max({col - minCol_, maxCol_ - col, row - minRow_, maxRow_ - row, 0});
+    for (std::int32_t r = 0; r <= maxRing; ++r) {
+        CellRange ring{col - r, col + r, row - r, row + r};
+        if (r == 0) {
+            forEachInCells(ring, consider);
+        } else {
+            forEachInCells({ring.col0, ring.col1, ring.row0, ring.row0}, consider);
+            forEachInCells({ring.col0, ring.col1, ring.row1, ring.row1}, consider);
+            forEachInCells({ring.col0, ring.col0, ring.row0 + 1, ring.row1 - 1}, consider);
+            forEachInCells({ring.col1, ring.col1, ring.row0 + 1, ring.row1 - 1}, consider);
+        }
+        if (best.size() == k && best.top().distanceMeters <= static_cast<float>(r) * cellMeters_) {
+            break;
+        }
+    }
+
+    result.resize(best.size());
+    for (std::size_t i = result.size(); i-- > 0;) {
+        result[i] = best.top();
+        best.pop();
+    }
+    return result;
+}
+
+std::vector<DeviceHit> FleetSnapshot::nearest(const Location& point, std::size_t k) const {
+    return nearest(frame_.project(point), k);
+}
+
+std::vector<std::uint32_t> FleetSnapshot::inFence(const std::string& fenceId) const {
+    if (!fenceById_) {
+        return {};
+    }
+    auto it = fenceById_->find(fenceId);
+    if (it == fenceById_->end() || it->second + 1 >= fenceStart_.size()) {
+        return {};
+    }
+    return std::vector<std::uint32_t>(fenceDevices_.begin() + fenceStart_[it->second],
+                                      fenceDevices_.begin() + fenceStart_[it->second + 1]);
+}
+
+// --- FleetIndex ---
+
+FleetIndex::FleetIndex(std::vector<std::string> deviceIds, float cellMeters)
+    : cellMeters_(cellMeters),
+      deviceIds_(std::make_shared<const std::vector<std::string>>(std::move(deviceIds))),
+      pool_(std::make_shared<Pool>()) {
+    std::size_t count = deviceIds_->size();
+    east_.assign(count, 0.0f);
+    north_.assign(count, 0.0f);
+    insideFences_.resize(count);
+
+    // Everyone starts at the frame origin until the first update
+    deviceCell_.assign(count, cellKey(0, 0));
+    auto& origin = cells_[cellKey(0, 0)];
+    origin.reserve(count);
+    cellSlot_.resize(count);
+    for (std::uint32_t i = 0; i < count; ++i) {
+        cellSlot_[i] = i;
+        origin.push_back(i);
+    }
+}
+
+std::uint64_t FleetIndex::cellKey(std::int32_t col, std::int32_t row) {
+    return (static_cast<std::uint64_t>(static_cast<std::uint32_t>(col)) << 32) | static_cast<std::uint32_t>(row);
+}
+
+void FleetIndex::update(std::uint32_t device, EnuPoint position, const std::vector<std::uint32_t>& insideFences) {
+    east_[device] = position.east;
+    north_[device] = position.north;
+
+    auto cellOf = [this](float meters) {
+        return static_cast<std::int32_t>(std::clamp(std::floor(meters / cellMeters_), -1e9f, 1e9f));
+    };
+    std::uint64_t key = cellKey(cellOf(position.east), cellOf(position.north));
+    if (key != deviceCell_[device]) {
+        // Swap-remove from the old cell, append to the new one
+        auto& from = cells_[deviceCell_[device]];
+        std::uint32_t slot = cellSlot_[device];
+        from[slot] = from.back();
+        cellSlot_[from[slot]] = slot;
+        from.pop_back();
+
+        auto& to = cells_[key];
+        cellSlot_[device] = static_cast<std::uint32_t>(to.size());
+        to.push_back(device);
+        deviceCell_[device] = key;
+        ++cellMoves_;
+    }
+
+    if (insideFences_[device] != insideFences) {
+        insideFences_[device] = insideFences;
+    }
+}
+
+void FleetIndex::publish(const Catalog& catalog) {
+    std::unique_ptr<FleetSnapshot> next;
+    {
+        std::lock_guard<std::mutex> lock(pool_->mutex);
+        if (!pool_->free.empty()) {
+            next = std::move(pool_->free.back());
+            pool_->free.pop_back();
+        }
+    }
+    if (!next) {
+        next = std::make_unique<FleetSnapshot>();
+    }
+
+    next->tick_ = ++ticks_;
+    next->catalogVersion_ = catalog.version;
+    next->frame_ = catalog.frame;
+    next->cellMeters_ = cellMeters_;
+    next->deviceIds_ = deviceIds_;
+    next->east_.assign(east_.begin(), east_.end());
+    next->north_.assign(north_.begin(), north_.end());
+
+    // Grid as CSR over occupied cells (empty cells are dropped here, not per move)
+    next->cellKeys_.clear();
+    for (auto it = cells_.begin(); it != cells_.end();) {
+        if (it->second.empty()) {
+            it = cells_.erase(it);
+        } else {
+            next->cellKeys_.push_back(it->first);
+            ++it;
+        }
+    }
+    std::sort(next->cellKeys_.begin(), next->cellKeys_.end());
+    next->cellStart_.assign(1, 0);
+    next->cellDevices_.clear();
+    next->minCol_ = next->minRow_ = 0;
+    next->maxCol_ = next->maxRow_ = -1;
+    for (std::size_t i = 0; i < next->cellKeys_.size(); ++i) {
+        std::uint64_t key = next->cellKeys_[i];
+        const auto& devices = cells_.at(key);
+        next->cellDevices_.insert(next->cellDevices_.end(), devices.begin(), devices.end());
+        next->cellStart_.push_back(static_cast<std::uint32_t>(next->cellDevices_.size()));
+
+        std::int32_t col = keyCol(key), row = keyRow(key);
+        if (i == 0) {
+            next->minCol_ = next->maxCol_ = col;
+            next->minRow_ = next->maxRow_ = row;
+        }
+        next->minCol_ = std::min(next->minCol_, col);
+        next->maxCol_ = std::max(next->maxCol_, col);
+        next->minRow_ = std::min(next->minRow_, row);
+        next->maxRow_ = std::max(next->maxRow_, row);
+    }
+
+    // Fence membership; fence ids are copied once per catalog version
+    if (fenceVersion_ != catalog.version || !fenceById_) {
+        fenceById_ = std::make_shared<const std::unordered_map<std::string, std::uint32_t>>(catalog.fenceById);
+        fenceVersion_ = catalog.version;
+    }
+    next->fenceById_ = fenceById_;
+    std::size_t fenceCount = catalog.geofences.size();
+    next->fenceStart_.assign(fenceCount + 1, 0);
+    for (const auto& inside : insideFences_) {
+        for (auto fence : inside) {
+            if (fence < fenceCount) ++next->fenceStart_[fence + 1];
+        }
+    }
+    for (std::size_t f = 0; f < fenceCount; ++f) {
+        next->fenceStart_[f + 1] += next->fenceStart_[f];
+    }
+    next->fenceDevices_.resize(next->fenceStart_.back());
+    std::vector<std::uint32_t> cursor(next->fenceStart_.begin(), next->fenceStart_.end() - 1);
+    for (std::uint32_t device = 0; device < insideFences_.size(); ++device) {
+        for (auto fence : insideFences_[device]) {
+            if (fence < fenceCount) next->fenceDevices_[cursor[fence]++] = device;
+        }
+    }
+
+    // Hand the buffer back to the pool once the last reader lets go of it
+    std::shared_ptr<const FleetSnapshot> published(next.release(), [pool = pool_](const FleetSnapshot* snapshot) {
+        std::unique_ptr<FleetSnapshot> owned(const_cast<FleetSnapshot*>(snapshot));
+        std::lock_guard<std::mutex> lock(pool->mutex);
+        if (pool->free.size() < kMaxPooledSnapshots) {
+            pool->free.push_back(std::move(owned));
+        }
+    });
+
+    std::shared_ptr<const FleetSnapshot> previous;
+    {
+        std::lock_guard<std::mutex> lock(currentMutex_);
+        previous = std::move(current_);
+        current_ = std::move(published);
+    }
+    // previous is released here, outside the lock
+}
+
+std::shared_ptr<const FleetSnapshot> FleetIndex::snapshot() const {
+    std::lock_guard<std::mutex> lock(currentMutex_);
+    return current_;
+}
+
+} // namespace tracker
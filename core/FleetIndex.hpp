@@ -0,0 +1,174 @@
+/**
+ * @file FleetIndex.hpp
+ * @brief Spatial queries over live fleet positions, served from per-tick snapshots
+ *
+ * The tick thread writes device positions into SoA columns (east/north per
+ * device) and keeps a uniform grid of device indices up to date
+ * incrementally: a device is only moved between cell lists when it crosses a
+ * cell edge. After each tick, publish() copies columns, grid (as CSR) and
+ * fence membership into an immutable FleetSnapshot.
+ *
+ * Query threads take the latest snapshot and search it for as long as they
+ * like; the simulation never waits for them. Snapshot buffers return to a
+ * pool when the last reader drops them, so steady-state publishing does not
+ * allocate.
+ *
+ * @note update()/publish() must be called from one thread (the fleet tick)
+ * @note Coordinates are in the catalog's local frame; Location overloads project
+ */
+
+#pragma once
+
+#include "Catalog.hpp"
+#include "LocalFrame.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace tracker {
+
+/** @brief Device index and distance returned by nearest-neighbour queries */
+struct DeviceHit {
+    std::uint32_t device = 0;      ///< Fleet index
+    float distanceMeters = 0.0f;
+};
+
+/**
+ * @brief Immutable positions, grid and fence membership as of one tick
+ */
+class FleetSnapshot {
+public:
+    std::uint64_t tick() const { return tick_; }
+    std::uint64_t catalogVersion() const { return catalogVersion_; }
+    std::size_t size() const { return east_.size(); }
+
+    const std::string& deviceId(std::uint32_t device) const { return (*deviceIds_)[device]; }
+    EnuPoint position(std::uint32_t device) const { return {east_[device], north_[device]}; }
+    Location location(std::uint32_t device) const { return frame_.unproject(position(device)); }
+
+    /** @brief Devices inside an axis-aligned box (corners in any order) */
+    std::vector<std::uint32_t> inBox(EnuPoint a, EnuPoint b) const;
+    std::vector<std::uint32_t> inBox(const Location& a, const Location& b) const;
+
+    /** @brief Devices inside a simple polygon (even-odd rule, open or closed ring) */
+    std::vector<std::uint32_t> inPolygon(const std::vector<EnuPoint>& polygon) const;
+    std::vector<std::uint32_t> inPolygon(const std::vector<Location>& polygon) const;
+
+    /** @brief Up to k devices closest to a point, nearest first */
+    std::vector<DeviceHit> nearest(EnuPoint point, std::size_t k) const;
+    std::vector<DeviceHit> nearest(const Location& point, std::size_t k) const;
+
+    /** @brief Devices inside a geofence of the snapshot's catalog (empty if unknown) */
+    std::vector<std::uint32_t> inFence(const std::string& fenceId) const;
+
+private:
+    friend class FleetIndex;
+
+    struct CellRange {
+        std::int32_t col0, col1, row0, row1;
+    };
+
+    CellRange cellRange(EnuPoint a, EnuPoint b) const;
+    std::int32_t cellOf(float meters) const;
+
+    /** @brief Call visit(device) for every device in the cells overlapping a box */
+    template <typename Visit>
+    void forEachInCells(const CellRange& range, Visit&& visit) const;
+
+    /** @brief Devices of one cell as [begin, end) into cellDevices_ */
+    bool findCell(std::int32_t col, std::int32_t row, std::uint32_t& begin, std::uint32_t& end) const;
+
+    std::uint64_t tick_ = 0;
+    std::uint64_t catalogVersion_ = 0;
+    LocalFrame frame_;
+    float cellMeters_ = 0.0f;
+    std::shared_ptr<const std::vector<std::string>> deviceIds_;
+
+    // SoA position columns
+    std::vector<float> east_;
+    std::vector<float> north_;
+
+    // Occupied grid cells, sorted by key, with CSR device lists
+    std::vector<std::uint64_t> cellKeys_;
+    std::vector<std::uint32_t> cellStart_;   ///< cellKeys_.size() + 1 offsets
+    std::vector<std::uint32_t> cellDevices_;
+    std::int32_t minCol_ = 0, maxCol_ = -1, minRow_ = 0, maxRow_ = -1;
+
+    // Fence membership (catalog fence index -> devices), CSR
+    std::shared_ptr<const std::unordered_map<std::string, std::uint32_t>> fenceById_;
+    std::vector<std::uint32_t> fenceStart_;
+    std::vector<std::uint32_t> fenceDevices_;
+};
+
+/**
+ * @brief Write side: incrementally maintained grid and snapshot publisher
+ */
+class FleetIndex {
+public:
+    /// Grid cell edge; a few hundred metres keeps cells small for urban fleets
+    static constexpr float kDefaultCellMeters = 250.0f;
+
+    /**
+     * @brief Create an index for a fixed set of devices
+     * @param deviceIds Identity of each fleet index (reported by snapshots)
+     * @param cellMeters Grid cell edge in metres
+     */
+    explicit FleetIndex(std::vector<std::string> deviceIds, float cellMeters = kDefaultCellMeters);
+
+    FleetIndex(const FleetIndex&) = delete;
+    FleetIndex& operator=(const FleetIndex&) = delete;
+
+    std::size_t size() const { return east_.size(); }
+
+    /**
+     * @brief Record a device's position and fence membership for this tick
+     * @param device Fleet index
+     * @param position Position in the catalog frame
+     * @param insideFences Catalog indices of fences containing the device (ascending)
+     */
+    void update(std::uint32_t device, EnuPoint position, const std::vector<std::uint32_t>& insideFences);
+
+    /** @brief Publish everything recorded so far as the next snapshot */
+    void publish(const Catalog& catalog);
+
+    /** @brief Latest snapshot (null before the first publish); safe from any thread */
+    std::shared_ptr<const FleetSnapshot> snapshot() const;
+
+    /** @brief Devices moved between grid cells since construction */
+    std::uint64_t cellMoves() const { return cellMoves_; }
+
+private:
+    static std::uint64_t cellKey(std::int32_t col, std::int32_t row);
+
+    /// Recycled snapshot buffers (outlives the index while readers hold snapshots)
+    struct Pool {
+        std::mutex mutex;
+        std::vector<std::unique_ptr<FleetSnapshot>> free;
+    };
+
+    float cellMeters_;
+    std::shared_ptr<const std::vector<std::string>> deviceIds_;
+
+    // Live SoA columns and incremental grid (tick thread only)
+    std::vector<float> east_;
+    std::vector<float> north_;
+    std::vector<std::uint64_t> deviceCell_;   ///< Grid key per device
+    std::vector<std::uint32_t> cellSlot_;     ///< Position of the device in its cell list
+    std::unordered_map<std::uint64_t, std::vector<std::uint32_t>> cells_;
+    std::vector<std::vector<std::uint32_t>> insideFences_;
+    std::uint64_t ticks_ = 0;
+    std::uint64_t cellMoves_ = 0;
+
+    std::uint64_t fenceVersion_ = ~0ULL;      ///< Catalog version fenceById_ was copied from
+    std::shared_ptr<const std::unordered_map<std::string, std::uint32_t>> fenceById_;
+
+    std::shared_ptr<Pool> pool_;
+    mutable std::mutex currentMutex_;         ///< Guards only the pointer swap/copy
+    std::shared_ptr<const FleetSnapshot> current_;
+};
+
+} // namespace tracker
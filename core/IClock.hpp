@@ -2,6 +2,7 @@
 
 #include <chrono>
 #include <cstdint>
+#include <string>
 
 namespace tracker {
 
@@ -12,6 +13,11 @@ public:
     virtual std::chrono::system_clock::time_point now() const = 0;
     virtual uint64_t epochSeconds() const = 0;
     virtual std::string iso8601() const = 0;
+    
+    /** @brief Monotonic time for ticks, deadlines and intervals; tests override it to step time */
+    virtual std::chrono::steady_clock::time_point steadyNow() const {
+        return std::chrono::steady_clock::now();
+    }
 };
 
 class SystemClock : public IClock {
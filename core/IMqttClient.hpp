@@ -21,6 +21,7 @@
 #include <functional>
 #include <memory>
 #include <cstdint>
+#include <cstddef>
 
 namespace tracker {
 
@@ -80,6 +81,15 @@ public:
     /// Callback function type for connection state changes
     using ConnectionCallback = std::function<void(bool connected, const std::string& reason)>;
     
+    /// Broker acknowledgement kinds reported to the AckCallback
+    enum class Ack {
+        Publish,    ///< PUBACK (QoS 1) or send completion (QoS 0)
+        Subscribe   ///< SUBACK
+    };
+    
+    /// Callback function type for acknowledgements of this client's requests
+    using AckCallback = std::function<void(Ack ack, int qos, bool success)>;
+    
     /**
      * @brief Connect to MQTT broker using username/password authentication
      * @param host MQTT broker hostname (e.g., "your-hub.azure-devices.net")
@@ -163,12 +173,32 @@ public:
      */
     virtual void setConnectionCallback(ConnectionCallback callback) = 0;
     
+    /**
+     * @brief Set callback for publish and subscribe acknowledgements
+     * @param callback Function to call when the broker acknowledges a request
+     * @note Callback is called from MQTT thread - ensure thread safety
+     * @note Optional - implementations without acknowledgement tracking ignore it
+     */
+    virtual void setAckCallback(AckCallback callback) { (void)callback; }
+    
     /**
      * @brief Process pending MQTT events
      * @note Must be called regularly for asynchronous message processing
      * @note Implementation should be non-blocking for embedded compatibility
      */
     virtual void processEvents() = 0;
+    
+    /**
+     * @brief Number of messages held in the offline queue
+     * @note Statistics only - implementations without a queue report 0
+     */
+    virtual std::size_t queuedMessages() const { return 0; }
+    
+    /**
+     * @brief Number of published messages awaiting delivery confirmation
+     * @note Statistics only - implementations without tracking report 0
+     */
+    virtual std::size_t inflightMessages() const { return 0; }
 
 protected:
     // Protected constructors to prevent direct instantiation
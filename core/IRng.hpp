@@ -1,5 +1,6 @@
 #pragma once
 
+#include <cstdint>
 #include <random>
 
 namespace tracker {
@@ -20,6 +21,7 @@ private:
     
 public:
     StandardRng() : gen_(rd_()) {}
+    explicit StandardRng(std::uint32_t seed) : gen_(seed) {}
     
     double uniform(double min = 0.0, double max = 1.0) override {
         std::uniform_real_distribution<double> dist(min, max);
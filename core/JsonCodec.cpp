@@ -1,4 +1,6 @@
 #include "JsonCodec.hpp"
+#include "FieldSchema.hpp"
+#include <string_view>
 
 namespace tracker {
 
@@ -36,6 +38,14 @@ nlohmann::json JsonCodec::eventToJson(const Event& event) {
         j["extras"] = extras;
     }
     
+    if (event.trace.enabled()) {
+        j["trace"] = traceToJson(event.trace);
+    }
+    
+    if (event.fieldSchema) {
+        event.fieldSchema->toJson(event.fieldRecord, j);
+    }
+    
     return j;
 }
 
@@ -74,6 +84,10 @@ Event JsonCodec::jsonToEvent(const nlohmann::json& json) {
         }
     }
     
+    if (json.contains("trace") && json["trace"].is_object()) {
+        event.trace = jsonToTrace(json["trace"]);
+    }
+    
     return event;
 }
 
@@ -123,4 +137,36 @@ NetworkInfo JsonCodec::jsonToNetwork(const nlohmann::json& json) {
     return network;
 }
 
-} // namespace tracker
\ No newline at end of file
+nlohmann::json JsonCodec::traceToJson(const TraceInfo& trace) {
+    nlohmann::json j;
+    j["run"] = trace.runId;
+    j["gen"] = trace.generatedUs;
+    if (trace.filteredUs) j["flt"] = trace.filteredUs;
+    if (trace.encodedUs) j["enc"] = trace.encodedUs;
+    if (trace.receivedUs) j["rcv"] = trace.receivedUs;
+    return j;
+}
+
+TraceInfo JsonCodec::jsonToTrace(const nlohmann::json& json) {
+    TraceInfo trace;
+    trace.runId = json.value("run", "");
+    trace.generatedUs = json.value("gen", int64_t{0});
+    trace.filteredUs = json.value("flt", int64_t{0});
+    trace.encodedUs = json.value("enc", int64_t{0});
+    trace.receivedUs = json.value("rcv", int64_t{0});
+    return trace;
+}
+
+std::string JsonCodec::stampReceived(std::string json, int64_t receivedUs) {
+    // Keys are never escaped and string values escape quotes, so this only matches the key;
+    // the object always holds "run" and "gen", so a trailing comma is safe
+    static constexpr std::string_view kTraceKey = "\"trace\":{";
+    auto pos = json.rfind(kTraceKey);
+    if (pos == std::string::npos) {
+        return json;
+    }
+    json.insert(pos + kTraceKey.size(), "\"rcv\":" + std::to_string(receivedUs) + ",");
+    return json;
+}
+
+} // namespace tracker
@@ -22,6 +22,12 @@ public:
     
     static nlohmann::json networkToJson(const NetworkInfo& network);
     static NetworkInfo jsonToNetwork(const nlohmann::json& json);
+    
+    static nlohmann::json traceToJson(const TraceInfo& trace);
+    static TraceInfo jsonToTrace(const nlohmann::json& json);
+    
+    /** @brief Add a receive stamp to the trace object of a serialized event (unchanged if untraced) */
+    static std::string stampReceived(std::string json, int64_t receivedUs);
 };
 
 } // namespace tracker
\ No newline at end of file
@@ -0,0 +1,158 @@
+#include "LatencyConsumer.hpp"
+#include "JsonCodec.hpp"
+#include <algorithm>
+#include <charconv>
+#include <iomanip>
+
+namespace tracker {
+
+void LatencyConsumer::Histogram::record(std::uint64_t us) {
+    ++buckets[Stats::latencyBucket(us)];
+    ++count;
+    sumUs += us;
+    maxUs = std::max(maxUs, us);
+}
+
+std::uint64_t LatencyConsumer::Histogram::percentileUs(double percentile) const {
+    if (count == 0) {
+        return 0;
+    }
+
+    std::uint64_t rank = static_cast<std::uint64_t>(percentile / 100.0 * static_cast<double>(count - 1)) + 1;
+    std::uint64_t seen = 0;
+    for (std::size_t i = 0; i < buckets.size(); ++i) {
+        seen += buckets[i];
+        if (seen >= rank) {
+            return std::min(Stats::latencyBucketUpperUs(i), maxUs);
+        }
+    }
+    return maxUs;
+}
+
+LatencyConsumer::LatencyConsumer(std::string runId) : runId_(std::move(runId)) {}
+
+void LatencyConsumer::onMessage(std::string_view topic, std::string_view payload) {
+    onMessage(topic, payload, traceClockUs());
+}
+
+void LatencyConsumer::onMessage(std::string_view topic, std::string_view payload, std::int64_t receivedUs) {
+    auto parsed = nlohmann::json::parse(payload.begin(), payload.end(), nullptr, false);
+    if (parsed.is_discarded() || (!parsed.is_object() && !parsed.is_array())) {
+        ++malformed_;
+        return;
+    }
+
+    MessageStamps message = parseProperties(topic);
+    bool counted = false;
+
+    auto account = [&](const nlohmann::json& object) {
+        if (!object.is_object() || !object.contains("trace") || !object["trace"].is_object()) {
+            ++foreign_;
+            return;
+        }
+        TraceInfo trace = JsonCodec::jsonToTrace(object["trace"]);
+        if (trace.runId != runId_) {
+            ++foreign_;
+            return;
+        }
+
+        ++events_;
+        std::int64_t received = trace.receivedUs ? trace.receivedUs : receivedUs;
+        if (!counted) {
+            counted = true;
+            ++messages_;
+            if (message.attempt > 1) {
+                ++retried_;
+            }
+        }
+
+        recordSpan(Stage::Ingress, trace.generatedUs, trace.filteredUs);
+        recordSpan(Stage::Encode, trace.filteredUs ? trace.filteredUs : trace.generatedUs, trace.encodedUs);
+        recordSpan(Stage::Batch, trace.encodedUs, message.flushedUs);
+        recordSpan(Stage::Dispatch, message.flushedUs, message.dequeuedUs);
+        recordSpan(Stage::Retry, message.dequeuedUs, message.sentUs);
+        recordSpan(Stage::Delivery, message.sentUs ? message.sentUs : trace.encodedUs, received);
+        recordSpan(Stage::Total, trace.generatedUs, received);
+    };
+
+    if (parsed.is_array()) {
+        for (const auto& object : parsed) {
+            account(object);
+        }
+    } else {
+        account(parsed);
+    }
+}
+
+LatencyConsumer::MessageStamps LatencyConsumer::parseProperties(std::string_view topic) {
+    MessageStamps stamps;
+    auto slash = topic.rfind('/');
+    std::string_view bag = slash == std::string_view::npos ? topic : topic.substr(slash + 1);
+
+    while (!bag.empty()) {
+        auto amp = bag.find('&');
+        std::string_view pair = bag.substr(0, amp);
+        bag = amp == std::string_view::npos ? std::string_view{} : bag.substr(amp + 1);
+
+        auto eq = pair.find('=');
+        if (eq == std::string_view::npos) continue;
+        std::string_view key = pair.substr(0, eq);
+        std::string_view value = pair.substr(eq + 1);
+
+        std::int64_t* field = key == "lt.f" ? &stamps.flushedUs
+                            : key == "lt.d" ? &stamps.dequeuedUs
+                            : key == "lt.p" ? &stamps.sentUs
+                            : key == "lt.n" ? &stamps.attempt
+                            : nullptr;
+        if (field) {
+            std::from_chars(value.data(), value.data() + value.size(), *field);
+        }
+    }
+    return stamps;
+}
+
+void LatencyConsumer::recordSpan(Stage stage, std::int64_t fromUs, std::int64_t toUs) {
+    if (fromUs == 0 || toUs == 0) {
+        return;   // Stamp not carried (untraced hop or older producer)
+    }
+    // Clamp small negative spans from clock steps to zero
+    stages_[static_cast<std::size_t>(stage)].record(
+        static_cast<std::uint64_t>(std::max<std::int64_t>(toUs - fromUs, 0)));
+}
+
+void LatencyConsumer::print(std::ostream& out) const {
+    auto millis = [](double us) { return us / 1000.0; };
+
+    out << "Run " << runId_ << ": " << events_ << " events in " << messages_ << " messages ("
+        << retried_ << " retried, " << foreign_ << " foreign, " << malformed_ << " malformed)\n";
+    out << std::left << std::setw(10) << "Stage" << std::right
+        << std::setw(10) << "events" << std::setw(12) << "mean ms" << std::setw(12) << "p50 ms"
+        << std::setw(12) << "p99 ms" << std::setw(12) << "max ms" << "\n";
+
+    out << std::fixed << std::setprecision(3);
+    for (std::size_t i = 0; i < kStageCount; ++i) {
+        const auto& histogram = stages_[i];
+        out << std::left << std::setw(10) << stageName(static_cast<Stage>(i)) << std::right
+            << std::setw(10) << histogram.count
+            << std::setw(12) << millis(histogram.meanUs())
+            << std::setw(12) << millis(static_cast<double>(histogram.percentileUs(50.0)))
+            << std::setw(12) << millis(static_cast<double>(histogram.percentileUs(99.0)))
+            << std::setw(12) << millis(static_cast<double>(histogram.maxUs)) << "\n";
+    }
+    out << std::defaultfloat;
+}
+
+const char* LatencyConsumer::stageName(Stage stage) {
+    switch (stage) {
+        case Stage::Ingress:  return "ingress";
+        case Stage::Encode:   return "encode";
+        case Stage::Batch:    return "batch";
+        case Stage::Dispatch: return "dispatch";
+        case Stage::Retry:    return "retry";
+        case Stage::Delivery: return "delivery";
+        case Stage::Total:    return "total";
+    }
+    return "unknown";
+}
+
+} // namespace tracker
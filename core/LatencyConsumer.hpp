@@ -0,0 +1,129 @@
+/**
+ * @file LatencyConsumer.hpp
+ * @brief Backend-side end-to-end latency histograms for traced telemetry
+ *
+ * Consumes messages published by a TelemetryPipeline that has a trace run ID
+ * (PipelineOptions::traceRunId) and splits each event's generation-to-receive
+ * latency into pipeline stages:
+ *
+ * | Stage    | From → to                       | Covers                              |
+ * |----------|---------------------------------|-------------------------------------|
+ * | Ingress  | generated → filtered            | Ingress ring wait, reporting policy |
+ * | Encode   | filtered (generated) → encoded  | Filter ring wait, serialization     |
+ * | Batch    | encoded → flushed               | Batching delay, compression         |
+ * | Dispatch | flushed → dequeued              | Publish ring wait                   |
+ * | Retry    | dequeued → sent                 | Offline queueing and retry backoff  |
+ * | Delivery | sent (encoded) → received       | Transport and broker                |
+ * | Total    | generated → received            | All of the above                    |
+ *
+ * Event stamps come from the payload's "trace" object; message stamps from
+ * the topic property bag (`lt.f` flushed, `lt.d` dequeued, `lt.p` sent,
+ * `lt.n` attempt). Messages from other runs are counted and ignored. Spans
+ * whose stamps a producer does not carry are skipped: the Simulator path has
+ * no filter, batch or publish rings and stamps only generated, encoded and
+ * sent, so Encode starts at generation there.
+ *
+ * Feed it from a broker stand-in subscription (MockTransport's publish
+ * observer) or by replaying a capture. A `sim-cli --record` capture has no
+ * topics; its events carry their own receive stamp (`rcv`, the time the
+ * recorder wrote them), which takes precedence over the receive time passed
+ * in, and Delivery then runs from encoded to recorded (`sim-verify --latency`).
+ *
+ * @note Not thread-safe; call from one consumer thread
+ * @note Stamps are wall-clock microseconds: hosts must be clock-synchronized
+ */
+
+#pragma once
+
+#include "Stats.hpp"
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <string_view>
+
+namespace tracker {
+
+class LatencyConsumer {
+public:
+    enum class Stage : std::size_t {
+        Ingress,
+        Encode,
+        Batch,
+        Dispatch,
+        Retry,
+        Delivery,
+        Total
+    };
+
+    static constexpr std::size_t kStageCount = 7;
+
+    /**
+     * @brief Log-linear latency histogram (Stats bucket layout)
+     */
+    struct Histogram {
+        std::array<std::uint64_t, Stats::kLatencyBuckets> buckets{};
+        std::uint64_t count = 0;
+        std::uint64_t sumUs = 0;
+        std::uint64_t maxUs = 0;
+
+        void record(std::uint64_t us);
+
+        /** @brief Percentile in microseconds (bucket upper bound), 0 if empty */
+        std::uint64_t percentileUs(double percentile) const;
+
+        double meanUs() const {
+            return count ? static_cast<double>(sumUs) / static_cast<double>(count) : 0.0;
+        }
+    };
+
+    explicit LatencyConsumer(std::string runId);
+
+    /**
+     * @brief Account one received message
+     * @param topic D2C topic including the property bag
+     * @param payload One event object or a JSON array of them
+     * @param receivedUs Receive time (traceClockUs); 0 if only recorded stamps apply
+     */
+    void onMessage(std::string_view topic, std::string_view payload, std::int64_t receivedUs);
+
+    /** @brief Account one message received now */
+    void onMessage(std::string_view topic, std::string_view payload);
+
+    const Histogram& stage(Stage stage) const { return stages_[static_cast<std::size_t>(stage)]; }
+
+    std::uint64_t messages() const { return messages_; }        ///< Messages of this run
+    std::uint64_t events() const { return events_; }            ///< Events of this run
+    std::uint64_t retried() const { return retried_; }          ///< Messages sent on a later attempt
+    std::uint64_t foreign() const { return foreign_; }          ///< Events of other or no runs
+    std::uint64_t malformed() const { return malformed_; }      ///< Unparseable payloads
+
+    /** @brief Per-stage table: count, mean, p50, p99, max */
+    void print(std::ostream& out) const;
+
+    static const char* stageName(Stage stage);
+
+private:
+    /// Message-level stamps from the topic property bag (0 = absent)
+    struct MessageStamps {
+        std::int64_t flushedUs = 0;
+        std::int64_t dequeuedUs = 0;
+        std::int64_t sentUs = 0;
+        std::int64_t attempt = 0;
+    };
+
+    static MessageStamps parseProperties(std::string_view topic);
+
+    void recordSpan(Stage stage, std::int64_t fromUs, std::int64_t toUs);
+
+    std::string runId_;
+    std::array<Histogram, kStageCount> stages_{};
+    std::uint64_t messages_ = 0;
+    std::uint64_t events_ = 0;
+    std::uint64_t retried_ = 0;
+    std::uint64_t foreign_ = 0;
+    std::uint64_t malformed_ = 0;
+};
+
+} // namespace tracker
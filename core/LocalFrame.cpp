@@ -0,0 +1,112 @@
+#include "LocalFrame.hpp"
+#include <algorithm>
+#include <cmath>
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+namespace tracker {
+
+LocalFrame::LocalFrame(double originLat, double originLon)
+    : originLat_(originLat), originLon_(originLon) {
+    constexpr double degToRad = M_PI / 180.0;
+    metersPerDegLat_ = kEarthRadiusMeters * degToRad;
+    metersPerDegLon_ = kEarthRadiusMeters * degToRad * std::cos(originLat * degToRad);
+}
+
+EnuPoint LocalFrame::project(double lat, double lon) const {
+    EnuPoint p;
+    p.east = static_cast<float>((lon - originLon_) * metersPerDegLon_);
+    p.north = static_cast<float>((lat - originLat_) * metersPerDegLat_);
+    return p;
+}
+
+EnuFence LocalFrame::projectFence(const Geofence& fence) const {
+    EnuPoint centre = project(fence.lat, fence.lon);
+
+    EnuFence f;
+    f.east = centre.east;
+    f.north = centre.north;
+    f.radiusSq = static_cast<float>(fence.radiusMeters * fence.radiusMeters);
+    return f;
+}
+
+std::vector<EnuPoint> LocalFrame::projectRoute(const std::vector<RoutePoint>& route) const {
+    std::vector<EnuPoint> projected;
+    projected.reserve(route.size());
+    for (const auto& point : route) {
+        projected.push_back(project(point.lat, point.lon));
+    }
+    return projected;
+}
+
+Location LocalFrame::unproject(EnuPoint point, const Location& base) const {
+    Location result = base;
+    result.lat = originLat_ + static_cast<double>(point.north) / metersPerDegLat_;
+    result.lon = originLon_ + static_cast<double>(point.east) / metersPerDegLon_;
+    return result;
+}
+
+float LocalFrame::distanceMeters(EnuPoint a, EnuPoint b) {
+    float de = a.east - b.east;
+    float dn = a.north - b.north;
+    return std::sqrt(de * de + dn * dn);
+}
+
+EnuPoint LocalFrame::move(EnuPoint from, double bearingDeg, double distanceMeters) {
+    double bearing = bearingDeg * M_PI / 180.0;
+
+    EnuPoint to;
+    to.east = from.east + static_cast<float>(distanceMeters * std::sin(bearing));
+    to.north = from.north + static_cast<float>(distanceMeters * std::cos(bearing));
+    return to;
+}
+
+EnuPoint LocalFrame::interpolateRoute(const std::vector<EnuPoint>& route, double progress) {
+    if (route.empty()) {
+        return EnuPoint{};
+    }
+
+    if (route.size() == 1) {
+        return route[0];
+    }
+
+    progress = std::clamp(progress, 0.0, 1.0);
+    double segmentProgress = progress * (route.size() - 1);
+    size_t segmentIndex = static_cast<size_t>(segmentProgress);
+
+    if (segmentIndex >= route.size() - 1) {
+        return route.back();
+    }
+
+    float localProgress = static_cast<float>(segmentProgress - segmentIndex);
+    const auto& p1 = route[segmentIndex];
+    const auto& p2 = route[segmentIndex + 1];
+
+    EnuPoint p;
+    p.east = p1.east + (p2.east - p1.east) * localProgress;
+    p.north = p1.north + (p2.north - p1.north) * localProgress;
+    return p;
+}
+
+void LocalFrame::advance(float* east, float* north,
+                         const float* speedMs, const float* headingRad,
+                         std::size_t count, float dtSeconds) {
+    for (std::size_t i = 0; i < count; ++i) {
+        float step = speedMs[i] * dtSeconds;
+        east[i] += step * std::sin(headingRad[i]);
+        north[i] += step * std::cos(headingRad[i]);
+    }
+}
+
+void LocalFrame::insideFences(EnuPoint point, const EnuFence* fences,
+                              std::size_t count, std::uint8_t* inside) {
+    for (std::size_t i = 0; i < count; ++i) {
+        float de = point.east - fences[i].east;
+        float dn = point.north - fences[i].north;
+        inside[i] = static_cast<std::uint8_t>(de * de + dn * dn <= fences[i].radiusSq);
+    }
+}
+
+} // namespace tracker
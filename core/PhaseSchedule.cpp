@@ -0,0 +1,151 @@
+#include "PhaseSchedule.hpp"
+#include <algorithm>
+#include <cmath>
+
+namespace tracker {
+
+std::uint64_t PhaseSchedule::hashDeviceId(const std::string& deviceId) {
+    std::uint64_t hash = 14695981039346656037ULL;
+    for (unsigned char c : deviceId) {
+        hash ^= c;
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
+double PhaseSchedule::phaseFraction(const std::string& deviceId, PeriodicActivity activity) {
+    // Salt per activity, then finalize (splitmix64) so sequential IDs spread evenly
+    std::uint64_t x = hashDeviceId(deviceId) ^
+                      (0x9E3779B97F4A7C15ULL * (static_cast<std::uint64_t>(activity) + 1));
+    x ^= x >> 30;
+    x *= 0xBF58476D1CE4E5B9ULL;
+    x ^= x >> 27;
+    x *= 0x94D049BB133111EBULL;
+    x ^= x >> 31;
+
+    // Top 53 bits -> [0, 1)
+    return static_cast<double>(x >> 11) * (1.0 / 9007199254740992.0);
+}
+
+std::chrono::milliseconds PhaseSchedule::phaseOffset(const std::string& deviceId,
+                                                     PeriodicActivity activity,
+                                                     std::chrono::milliseconds period) {
+    if (period.count() <= 0) {
+        return std::chrono::milliseconds(0);
+    }
+    auto offset = static_cast<std::int64_t>(phaseFraction(deviceId, activity) * period.count());
+    return std::chrono::milliseconds(std::min<std::int64_t>(offset, period.count() - 1));
+}
+
+std::chrono::seconds PhaseSchedule::spreadPeriod(const std::string& deviceId,
+                                                 PeriodicActivity activity,
+                                                 std::chrono::seconds period,
+                                                 double spreadFraction) {
+    spreadFraction = std::clamp(spreadFraction, 0.0, 1.0);
+    double reduction = phaseFraction(deviceId, activity) * spreadFraction * period.count();
+    auto spread = static_cast<std::int64_t>(std::llround(period.count() - reduction));
+    return std::chrono::seconds(std::clamp<std::int64_t>(spread, 1, period.count()));
+}
+
+void PeriodicDeadline::arm(Clock::time_point now, std::chrono::milliseconds period,
+                           std::chrono::milliseconds phase) {
+    period_ = period;
+    slot_ = now + phase;
+    deadline_ = slot_;
+    armed_ = period.count() > 0;
+}
+
+void PeriodicDeadline::advance(Clock::time_point now, IRng* rng, double jitterFraction) {
+    if (!armed_) {
+        return;
+    }
+
+    // Stay on the phase grid; skip slots that were missed entirely
+    slot_ += period_;
+    if (slot_ <= now) {
+        auto behind = std::chrono::duration_cast<std::chrono::milliseconds>(now - slot_);
+        slot_ += period_ * (behind / period_ + 1);
+    }
+
+    deadline_ = slot_;
+    if (rng && jitterFraction > 0.0) {
+        double delayMs = rng->uniform(0.0, jitterFraction) * static_cast<double>(period_.count());
+        deadline_ += std::chrono::milliseconds(static_cast<std::int64_t>(delayMs));
+    }
+}
+
+void PeriodicDeadline::restart(Clock::time_point at, IRng* rng, double jitterFraction) {
+    if (!armed_) {
+        return;
+    }
+
+    auto slot = slot_;
+    auto deadline = deadline_;
+    slot_ = at;
+    advance(at, rng, jitterFraction);
+    if (deadline_ < deadline) {
+        slot_ = slot;
+        deadline_ = deadline;
+    }
+}
+
+PhaseAnalyzer::Report PhaseAnalyzer::analyze(const std::vector<std::string>& deviceIds,
+                                             const std::vector<Activity>& activities,
+                                             const Options& options) {
+    Report report;
+    report.deviceCount = deviceIds.size();
+
+    double horizon = static_cast<double>(options.horizon.count());
+    double bucketSeconds = options.bucketSeconds > 0.0 ? options.bucketSeconds : 1.0;
+    std::size_t bucketCount = static_cast<std::size_t>(std::ceil(horizon / bucketSeconds));
+    if (bucketCount == 0 || deviceIds.empty()) {
+        return report;
+    }
+
+    // Histogram of expected messages per bucket (fractional when jitter spreads a firing)
+    std::vector<double> buckets(bucketCount, 0.0);
+    double jitter = std::clamp(options.jitterFraction, 0.0, 1.0);
+
+    for (const auto& activity : activities) {
+        double period = static_cast<double>(activity.period.count());
+        if (period <= 0.0) {
+            continue;
+        }
+        double window = jitter * period;
+
+        for (const auto& deviceId : deviceIds) {
+            double phase = options.phaseSpreading
+                ? PhaseSchedule::phaseFraction(deviceId, activity.kind) * period
+                : 0.0;
+
+            for (double t = phase; t < horizon; t += period) {
+                report.totalMessages++;
+
+                if (window < bucketSeconds) {
+                    buckets[static_cast<std::size_t>(t / bucketSeconds)] += 1.0;
+                    continue;
+                }
+
+                // Uniform jitter over [t, t + window): spread unit mass over covered buckets
+                double end = std::min(t + window, horizon);
+                double density = 1.0 / window;
+                for (double start = t; start < end;) {
+                    std::size_t index = static_cast<std::size_t>(start / bucketSeconds);
+                    double bucketEnd = std::min((index + 1) * bucketSeconds, end);
+                    buckets[index] += (bucketEnd - start) * density;
+                    start = bucketEnd;
+                }
+            }
+        }
+    }
+
+    double peak = *std::max_element(buckets.begin(), buckets.end());
+    report.averagePerSecond = static_cast<double>(report.totalMessages) / horizon;
+    report.peakPerSecond = peak / bucketSeconds;
+    report.peakToAverage = report.averagePerSecond > 0.0
+        ? report.peakPerSecond / report.averagePerSecond
+        : 0.0;
+    return report;
+}
+
+} // namespace tracker
@@ -0,0 +1,172 @@
+/**
+ * @file PhaseSchedule.hpp
+ * @brief Deterministic per-device phase spreading for periodic fleet activity
+ *
+ * Devices that share a period (heartbeat, MQTT keep-alive, SAS token renewal,
+ * twin refresh) and start together fire in lock-step, producing a burst every
+ * interval. PhaseSchedule derives a stable phase offset in [0, period) from a
+ * hash of the device ID and activity, so a fleet spreads evenly over the period
+ * and the same device always lands in the same slot across runs. Optional
+ * jitter delays each firing by a random fraction of the period.
+ *
+ * PhaseAnalyzer models the resulting message rate analytically (no simulation,
+ * no network) and reports the peak-to-average ratio.
+ *
+ * @note Offsets are deterministic: no RNG state is consumed to compute them
+ * @note Jitter never advances the phase grid, so it cannot accumulate drift
+ */
+
+#pragma once
+
+#include "IRng.hpp"
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace tracker {
+
+/**
+ * @brief Periodic activities that are phase-spread independently
+ *
+ * Each activity salts the device hash so one device's heartbeat and
+ * keep-alive do not coincide.
+ */
+enum class PeriodicActivity : std::uint8_t {
+    Heartbeat,
+    KeepAlive,
+    TokenRenewal,
+    TwinRefresh
+};
+
+/**
+ * @brief Stateless helpers for deriving phase offsets and spread periods
+ */
+class PhaseSchedule {
+public:
+    /** @brief FNV-1a 64-bit hash of a device identifier */
+    static std::uint64_t hashDeviceId(const std::string& deviceId);
+
+    /** @brief Deterministic phase fraction in [0, 1) for a device and activity */
+    static double phaseFraction(const std::string& deviceId, PeriodicActivity activity);
+
+    /** @brief Deterministic phase offset in [0, period) */
+    static std::chrono::milliseconds phaseOffset(const std::string& deviceId,
+                                                 PeriodicActivity activity,
+                                                 std::chrono::milliseconds period);
+
+    /**
+     * @brief Deterministically shorten a period by up to spreadFraction
+     *
+     * Used where the firing instant cannot be scheduled directly (MQTT
+     * keep-alive is timed by the client library from the last packet):
+     * devices get slightly different periods so their PINGREQs de-correlate
+     * instead of staying aligned forever. Never exceeds the nominal period.
+     */
+    static std::chrono::seconds spreadPeriod(const std::string& deviceId,
+                                             PeriodicActivity activity,
+                                             std::chrono::seconds period,
+                                             double spreadFraction);
+};
+
+/**
+ * @brief Phase-locked periodic deadline with optional jitter
+ *
+ * Tracks a phase grid (slot) advanced by whole periods and a deadline that
+ * may trail the slot by up to jitterFraction * period.
+ */
+class PeriodicDeadline {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    /**
+     * @brief Arm the deadline so the first firing is at now + phase
+     * @param now Current time
+     * @param period Firing period
+     * @param phase Offset of the first firing (0 fires immediately)
+     */
+    void arm(Clock::time_point now, std::chrono::milliseconds period,
+             std::chrono::milliseconds phase);
+
+    /** @brief True if the deadline has passed */
+    bool due(Clock::time_point now) const { return armed_ && now >= deadline_; }
+
+    /**
+     * @brief Advance to the next slot after firing
+     * @param now Current time (slots missed entirely are skipped)
+     * @param rng Jitter source, may be null when jitterFraction is 0
+     * @param jitterFraction Maximum delay after the slot as a fraction of the period
+     */
+    void advance(Clock::time_point now, IRng* rng, double jitterFraction);
+
+    /**
+     * @brief Start a fresh period at activity that makes the next firing redundant
+     * @param at When the activity happened (e.g. a publish standing in for a heartbeat)
+     * @param rng Jitter source, may be null when jitterFraction is 0
+     * @param jitterFraction Maximum delay after the slot as a fraction of the period
+     * @note Never moves the deadline earlier than it already is
+     */
+    void restart(Clock::time_point at, IRng* rng, double jitterFraction);
+
+    /** @brief Change the period, keeping the current slot; a non-positive period disarms like arm() */
+    void setPeriod(std::chrono::milliseconds period) {
+        period_ = period;
+        armed_ = armed_ && period.count() > 0;
+    }
+
+    std::chrono::milliseconds period() const { return period_; }
+    Clock::time_point deadline() const { return deadline_; }
+    bool isArmed() const { return armed_; }
+    void disarm() { armed_ = false; }
+
+private:
+    Clock::time_point slot_{};
+    Clock::time_point deadline_{};
+    std::chrono::milliseconds period_{0};
+    bool armed_ = false;
+};
+
+/**
+ * @brief Analytical fleet load model for periodic activity
+ *
+ * Places every firing of every device on a histogram of bucketSeconds bins
+ * over the horizon and reports average and peak rates. With phase spreading
+ * disabled all devices share phase 0, reproducing the lock-step start.
+ */
+class PhaseAnalyzer {
+public:
+    /** @brief One periodic activity to model */
+    struct Activity {
+        PeriodicActivity kind = PeriodicActivity::Heartbeat;
+        std::chrono::seconds period{60};
+    };
+
+    /** @brief Analyzer inputs */
+    struct Options {
+        bool phaseSpreading = true;        ///< Use per-device phase offsets
+        double jitterFraction = 0.0;       ///< Jitter as fraction of period (expected-value model)
+        std::chrono::seconds horizon{3600};///< Modelled time span
+        double bucketSeconds = 1.0;        ///< Rate resolution
+    };
+
+    /** @brief Analyzer result */
+    struct Report {
+        std::size_t deviceCount = 0;
+        std::uint64_t totalMessages = 0;
+        double averagePerSecond = 0.0;
+        double peakPerSecond = 0.0;
+        double peakToAverage = 0.0;
+    };
+
+    /**
+     * @brief Model message rate for a set of devices
+     * @param deviceIds Device identifiers (determine phase offsets)
+     * @param activities Periodic activities every device performs
+     * @param options Spreading, jitter and resolution settings
+     */
+    static Report analyze(const std::vector<std::string>& deviceIds,
+                          const std::vector<Activity>& activities,
+                          const Options& options);
+};
+
+} // namespace tracker
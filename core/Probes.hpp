@@ -0,0 +1,57 @@
+/**
+ * @file Probes.hpp
+ * @brief USDT static tracepoints for perf, bpftrace and SystemTap
+ *
+ * With ENABLE_USDT (CMake) and <sys/sdt.h> available, each TRACKER_PROBE*
+ * site compiles to a single nop plus an ELF note describing its arguments;
+ * nothing runs until a tracer attaches. Otherwise the macros compile away
+ * and their arguments are never evaluated.
+ *
+ * Provider: tracker. List the probes of a binary with
+ *
+ *     bpftrace -l 'usdt:./sim-cli:tracker:*'
+ *
+ * | Probe            | Arguments                                         |
+ * |------------------|---------------------------------------------------|
+ * | tick_start       | device count                                      |
+ * | tick_end         | device count, elapsed ns                          |
+ * | event_emit       | event type, device id (str), payload bytes        |
+ * | publish          | client, topic (str), payload bytes, qos           |
+ * | puback           | client, latency us                                |
+ * | publish_failed   | client, Paho return code (0 = async failure)      |
+ * | offline_enqueue  | client, queue depth after enqueue                 |
+ * | offline_dequeue  | client, queue depth after dequeue                 |
+ * | connect_start    | client, host (str), port, X.509 (0/1)             |
+ * | connect_success  | client                                            |
+ * | connect_failure  | client, CONNACK/Paho code                         |
+ * | dps_state        | component (0 = provisioning, 1 = manager), from, to |
+ * | twin_apply       | config version (str), status, elapsed us          |
+ * | trips_started    | trips due this tick, total trips started          |
+ *
+ * Keep arguments cheap (integers, pointers, c_str()): they are evaluated
+ * whenever probes are compiled in, attached or not.
+ *
+ * @note Tracing scripts live in tools/bpftrace/
+ */
+
+#pragma once
+
+#if defined(TRACKER_ENABLE_USDT) && defined(__has_include)
+#if __has_include(<sys/sdt.h>)
+#include <sys/sdt.h>
+#define TRACKER_USDT_AVAILABLE 1
+#endif
+#endif
+
+#ifdef TRACKER_USDT_AVAILABLE
+#define TRACKER_PROBE1(name, a1) DTRACE_PROBE1(tracker, name, a1)
+#define TRACKER_PROBE2(name, a1, a2) DTRACE_PROBE2(tracker, name, a1, a2)
+#define TRACKER_PROBE3(name, a1, a2, a3) DTRACE_PROBE3(tracker, name, a1, a2, a3)
+#define TRACKER_PROBE4(name, a1, a2, a3, a4) DTRACE_PROBE4(tracker, name, a1, a2, a3, a4)
+#else
+// Arguments stay in an unevaluated operand so probe-only locals count as used
+#define TRACKER_PROBE1(name, a1) ((void)sizeof(((void)(a1), 0)))
+#define TRACKER_PROBE2(name, a1, a2) ((void)sizeof(((void)(a1), (void)(a2), 0)))
+#define TRACKER_PROBE3(name, a1, a2, a3) ((void)sizeof(((void)(a1), (void)(a2), (void)(a3), 0)))
+#define TRACKER_PROBE4(name, a1, a2, a3, a4) ((void)sizeof(((void)(a1), (void)(a2), (void)(a3), (void)(a4), 0)))
+#endif
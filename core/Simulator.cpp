@@ -16,11 +16,15 @@
 
 #include "Simulator.hpp"
 #include "TwinHandler.hpp"
+#include "Stats.hpp"
+#include "Probes.hpp"
 #include "../crypto/SasToken.hpp"
 #include "../net/mqtt/PahoMqttClient.hpp"
 #include <iostream>
 #include <thread>
 #include <cmath>
+#include <algorithm>
+#include <limits>
 
 namespace tracker {
 
@@ -83,21 +87,43 @@ Simulator::Simulator(std::shared_ptr<IMqttClient> mqttClient,
  * 
  * @pre config must contain valid deviceId for MQTT topic construction
  * @post Simulator is ready to start with specified configuration
- * @post Battery is initialized to 100% charge
+ * @post Battery is initialized to 100% charge at the configured ambient temperature
  */
 void Simulator::configure(const SimulatorConfig& config) {
     config_ = config;
     currentLocation_ = config.startLocation;
+    
+    // Project fences and route once into the regional ENU frame (unless a fleet shares them)
+    insideFences_.clear();
+    insideFenceIds_.clear();
+    if (!sharedCatalog_) {
+        ownCatalog_ = Catalog::build(config.startLocation, config.route, config.geofences);
+        adoptCatalog(ownCatalog_.get());
+    }
+    position_ = frame_.project(config.startLocation);
     battery_.setPercentage(100.0);  // Start with full battery
+    battery_.setTemperature(config.batteryAmbientC);
+    
+    // Custom fields: one flat record laid out by the shared schema
+    fieldRecord_.clear();
+    if (config.fieldSchema) {
+        fieldRecord_.resize(config.fieldSchema->recordWords());
+        config.fieldSchema->initialize(reinterpret_cast<uint8_t*>(fieldRecord_.data()));
+    }
     
     // Construct Azure IoT Hub MQTT topics using device ID
     d2cTopic_ = "devices/" + config.deviceId + "/messages/events/";
     c2dTopic_ = "devices/" + config.deviceId + "/messages/devicebound/#";
     
     // Enable route following if route waypoints are provided
-    if (!config.route.empty()) {
+    if (!enuRoute_.empty()) {
         followingRoute_ = true;
         routeProgress_ = 0.0;  // Start at beginning of route
+        crossingCursorValid_ = false;
+    }
+    
+    if (startup_) {
+        startup_->end(StartupPhase::Config);
     }
 }
 
@@ -117,8 +143,27 @@ void Simulator::start() {
     if (running_) return;  // Already running - ignore duplicate start calls
     
     running_ = true;
-    lastTick_ = std::chrono::steady_clock::now();
-    lastHeartbeat_ = lastTick_;
+    lastTick_ = clock_->steadyNow();
+    
+    // Arm periodic activity at per-device phase offsets so a fleet started
+    // in the same instant does not fire in lock-step
+    auto heartbeatPeriod = std::chrono::milliseconds(std::chrono::seconds(config_.heartbeatSeconds));
+    heartbeatDeadline_.arm(lastTick_, heartbeatPeriod,
+                           config_.phaseSpreading ? phaseFor(PeriodicActivity::Heartbeat, heartbeatPeriod)
+                                                  : heartbeatPeriod);
+    
+    // Renew at 60% of TTL; the first renewal lands in [30%, 90%) of TTL
+    auto renewalPeriod = std::chrono::milliseconds(config_.sasTokenTtlSeconds * 600LL);
+    auto renewalPhase = phaseFor(PeriodicActivity::TokenRenewal, renewalPeriod);
+    if (renewalPhase < renewalPeriod / 2) {
+        renewalPhase += renewalPeriod;
+    }
+    tokenRenewalDeadline_.arm(lastTick_, renewalPeriod, renewalPhase);
+    
+    auto twinPeriod = std::chrono::milliseconds(std::chrono::seconds(config_.twinRefreshSeconds));
+    twinRefreshDeadline_.arm(lastTick_, twinPeriod,
+                             config_.phaseSpreading ? phaseFor(PeriodicActivity::TwinRefresh, twinPeriod)
+                                                    : twinPeriod);
     
     // Establish secure MQTT connection to Azure IoT Hub
     connectToIoTHub();
@@ -151,6 +196,19 @@ void Simulator::stop() {
  * @note Connection uses TLS encryption for security
  */
 void Simulator::connectToIoTHub() {
+    if (startup_) {
+        startup_->begin(StartupPhase::Credentials);
+    }
+    // PUBACKs restart the heartbeat period; the first SUBACK and PUBACK also end startup phases
+    getTelemetryClient()->setAckCallback([this](IMqttClient::Ack ack, int qos, bool success) {
+        if (startup_) {
+            startup_->acknowledged(ack, qos, success);
+        }
+        if (ack == IMqttClient::Ack::Publish) {
+            onPublishAck(qos, success);
+        }
+    });
+    
     // Check if DPS configuration is available (preferred method)
     if (config_.hasDpsConfig()) {
         std::cout << "[Simulator] Initiating DPS-based connection" << std::endl;
@@ -171,6 +229,19 @@ void Simulator::connectToIoTHub() {
         deviceConfig.verifyServerCert = config_.verifyServerCert;
         deviceConfig.timeout = std::chrono::seconds(120);  // 2-minute timeout for provisioning
         
+        if (config_.hasDpsSymmetricKey()) {
+            // Group enrollment: fleets derive keys in bulk up front, a single device here
+            if (config_.dpsDeviceKeyBase64.empty()) {
+                config_.dpsDeviceKeyBase64 = SasToken::deriveDeviceKey(config_.enrollmentGroupKeyBase64, config_.imei);
+            }
+            if (config_.dpsDeviceKeyBase64.empty()) {
+                std::cerr << "[Simulator] Invalid enrollment group key - connection aborted" << std::endl;
+                return;
+            }
+            deviceConfig.symmetricKeyBase64 = config_.dpsDeviceKeyBase64;
+            deviceConfig.sasTokenTtl = std::chrono::seconds(config_.sasTokenTtlSeconds);
+        }
+        
         dpsConnectionManager_->connectToIotHub(deviceConfig, 
             [this](bool connected, const std::string& reason) {
                 onDpsConnectionComplete(connected, reason);
@@ -195,13 +266,16 @@ void Simulator::connectToIoTHub() {
     sasConfig.host = config_.iotHubHost;
     sasConfig.deviceId = config_.deviceId;
     sasConfig.deviceKeyBase64 = config_.deviceKeyBase64;
-    sasConfig.expirySeconds = 3600; // 1 hour token validity (Microsoft recommendation)
+    sasConfig.expirySeconds = config_.sasTokenTtlSeconds; // 1 hour by default (Microsoft recommendation)
     
     try {
         // Generate SAS token for MQTT password authentication
         std::string password = SasToken::generate(sasConfig);
         
         // Initiate secure MQTT connection (TLS on port 8883)
+        if (startup_) {
+            startup_->transition(StartupPhase::Credentials, StartupPhase::HubConnect);
+        }
         bool connectionStarted = mqttClient_->connect(config_.iotHubHost, 8883, config_.deviceId, username, password);
         
         if (!connectionStarted) {
@@ -232,20 +306,21 @@ void Simulator::tick() {
     if (!running_) return;  // Skip processing if simulation is stopped
     
     // Calculate elapsed time since last tick for frame-rate independence
-    auto now = std::chrono::steady_clock::now();
+    auto now = clock_->steadyNow();
     auto deltaTime = std::chrono::duration_cast<std::chrono::duration<double>>(now - lastTick_);
     lastTick_ = now;
     
     double deltaSeconds = deltaTime.count();
     
-    // Update battery simulation (drain faster when driving)
-    battery_.tick(deltaSeconds, stateMachine_.getCurrentState() == DeviceState::Driving);
+    // Update battery simulation (higher draw when driving, charging while ignition is on)
+    battery_.tick(deltaSeconds, stateMachine_.getCurrentState() == DeviceState::Driving,
+                  stateMachine_.isIgnitionOn());
     stateMachine_.processBatteryLevel(battery_.getPercentage());
     
     // Update all simulation subsystems
     updateLocation();   // GPS coordinate simulation
     checkGeofences();   // Geofence enter/exit detection
-    checkHeartbeat();   // Periodic heartbeat transmission
+    checkPeriodicMaintenance();  // Token renewal and twin refresh
     
     // Handle automatic reconnection if connection was lost
     if (shouldReconnect_) {
@@ -265,6 +340,17 @@ void Simulator::tick() {
         }
     }
     
+    // End a timed drive session (automated driving, scheduled trips)
+    if (driveDurationSeconds_ > 0.0 &&
+        std::chrono::duration<double>(now - driveStartTime_).count() >= driveDurationSeconds_) {
+        driveDurationSeconds_ = 0.0;
+        setSpeed(0.0);
+        setIgnition(false);
+    }
+    
+    // Last, so an event raised anywhere in this frame stands in for a due heartbeat
+    checkHeartbeat();
+    
     // Process incoming MQTT messages and connection events
     if (config_.hasDpsConfig()) {
         dpsConnectionManager_->processEvents();
@@ -333,6 +419,50 @@ void Simulator::setBatteryPercentage(double pct) {
     battery_.setPercentage(pct);
 }
 
+/**
+ * @brief Profile this device's cold start
+ * 
+ * The timeline is shared with the DPS connection manager, which stamps the
+ * provisioning and hub connect phases; the simulator stamps the rest.
+ * 
+ * @param timeline Device timeline owned by a StartupProfiler
+ */
+void Simulator::setStartupTimeline(StartupTimeline* timeline) {
+    startup_ = timeline;
+    dpsConnectionManager_->setStartupTimeline(timeline);
+}
+
+/**
+ * @brief Move this device's battery cell into a fleet-wide bank
+ * 
+ * The bank owner advances all cells in one batched kernel per frame;
+ * this device then only selects its load in tick().
+ * 
+ * @param bank Shared battery bank
+ */
+void Simulator::attachBatteryBank(std::shared_ptr<BatteryBank> bank) {
+    battery_.attach(bank);
+}
+
+/**
+ * @brief Use a shared route/geofence catalog
+ * 
+ * Fleets publish catalogs through CatalogStore and hand the current version to
+ * every device before each tick. Adopting a new version is incremental: the
+ * route is copied, fence membership is carried over by id, and the next
+ * checkGeofences() tests the device against the new index only.
+ * 
+ * @param catalog Catalog valid for the duration of the caller's read guard
+ */
+void Simulator::useCatalog(const Catalog* catalog) {
+    if (!catalog) {
+        return;
+    }
+    sharedCatalog_ = true;
+    ownCatalog_.reset();
+    adoptCatalog(catalog);
+}
+
 /**
  * @brief Start automated driving simulation
  * 
@@ -353,13 +483,14 @@ void Simulator::startDriving(double durationMinutes) {
     setSpeed(45.0 + rng_->uniform(-15.0, 15.0));
     
     // Initialize drive session timing
-    driveStartTime_ = std::chrono::steady_clock::now();
+    driveStartTime_ = clock_->steadyNow();
     driveDurationSeconds_ = durationMinutes * 60.0;
     
     // Start route following if waypoints are configured
-    if (!config_.route.empty()) {
+    if (!enuRoute_.empty()) {
         followingRoute_ = true;
         routeProgress_ = 0.0;  // Start at beginning of route
+        crossingCursorValid_ = false;
     }
 }
 
@@ -409,29 +540,45 @@ void Simulator::generateSpike(int eventCount) {
  * @note Strategy pattern: Supports pluggable acknowledgment and error handling
  */
 void Simulator::setTwinHandler(std::shared_ptr<TwinHandler> twinHandler) {
-    twinHandler_ = twinHandler;
+    {
+        std::lock_guard<std::mutex> lock(twinMutex_);
+        twinHandler_ = twinHandler;
+    }
     
     if (twinHandler_) {
-        // Configure Observer pattern callbacks for configuration events
-        twinHandler_->setConfigUpdateCallback([](const TwinUpdateResult& result, const nlohmann::json& configData) {
-            (void)configData; // Bounded processing - config already persisted
-            
-            // Log configuration change with essential metadata only
-            std::cout << "Configuration " << (result.status == TwinStatus::Success ? "updated" : "failed")
-                      << ": v" << result.configVersion << std::endl;
-            
-            if (result.status != TwinStatus::Success) {
-                std::cerr << "Config error: " << result.errorMessage << std::endl;
-            }
-        });
+        attachTwinCallbacks();
+    }
+}
+
+void Simulator::attachTwinCallbacks() {
+    // Configure Observer pattern callbacks for configuration events
+    twinHandler_->setConfigUpdateCallback([this](const TwinUpdateResult& result, const nlohmann::json& configData) {
+        // Log configuration change with essential metadata only
+        std::cout << "Configuration " << (result.status == TwinStatus::Success ? "updated" : "failed")
+                  << ": v" << result.configVersion << std::endl;
         
-        // Minimal logging for twin operation responses (bounded output)
-        twinHandler_->setTwinResponseCallback([](TwinStatus status, const std::string& message) {
-            if (status != TwinStatus::Success) {
-                std::cerr << "Twin error: " << message << std::endl;
-            }
-        });
+        if (result.status != TwinStatus::Success) {
+            std::cerr << "Config error: " << result.errorMessage << std::endl;
+        } else if (firmwareUpdateCallback_ && configData.contains("ota")) {
+            firmwareUpdateCallback_(configData["ota"]);
+        }
+    });
+    
+    // Minimal logging for twin operation responses (bounded output)
+    twinHandler_->setTwinResponseCallback([](TwinStatus status, const std::string& message) {
+        if (status != TwinStatus::Success) {
+            std::cerr << "Twin error: " << message << std::endl;
+        }
+    });
+}
+
+bool Simulator::reportFirmware(const nlohmann::json& ota) {
+    std::shared_ptr<TwinHandler> twinHandler;
+    {
+        std::lock_guard<std::mutex> lock(twinMutex_);
+        twinHandler = twinHandler_;
     }
+    return twinHandler && twinHandler->sendReportedAck("ota", {{"ota", ota}});
 }
 
 /**
@@ -451,6 +598,9 @@ void Simulator::setTwinHandler(std::shared_ptr<TwinHandler> twinHandler) {
 void Simulator::onMqttMessage(const MqttMessage& message) {
     // First, check if this is a Device Twin message and route to TwinHandler
     if (twinHandler_ && message.topic.find("$iothub/twin/") != std::string::npos) {
+        if (startup_ && message.topic.find("$iothub/twin/res/") == 0) {
+            startup_->end(StartupPhase::TwinGet);
+        }
         twinHandler_->handleMqttMessage(message);
         return;
     }
@@ -465,7 +615,13 @@ void Simulator::onMqttMessage(const MqttMessage& message) {
             
             // Handle heartbeat interval configuration
             if (cmd == "setHeartbeatSeconds" && json.contains("value")) {
-                config_.heartbeatSeconds = json["value"];
+                const auto& value = json["value"];
+                if (value.is_number_integer() && value >= 1 && value <= std::numeric_limits<int>::max()) {
+                    config_.heartbeatSeconds = value.get<int>();
+                    heartbeatDeadline_.setPeriod(std::chrono::seconds(config_.heartbeatSeconds));
+                } else {
+                    std::cerr << "[Simulator] Ignoring setHeartbeatSeconds: value must be an integer >= 1" << std::endl;
+                }
             }
             // Handle speed limit configuration
             else if (cmd == "setSpeedLimit" && json.contains("value")) {
@@ -497,12 +653,19 @@ void Simulator::onMqttMessage(const MqttMessage& message) {
  * @post Reconnection logic is activated on disconnect
  */
 void Simulator::onMqttConnection(bool connected, const std::string& reason) {
-    connected_ = connected;
+    if (connected) {
+        connected_ = true;
+    } else {
+        markDisconnected();
+    }
     
     if (connected) {
         std::cout << "MQTT Connection: CONNECTED - " << reason << std::endl;
         
         // Subscribe to cloud-to-device message topic
+        if (startup_) {
+            startup_->transition(StartupPhase::HubConnect, StartupPhase::Subscribe);
+        }
         mqttClient_->subscribe(c2dTopic_);
         
         // Initialize Device Twin subscriptions if TwinHandler is available
@@ -513,6 +676,9 @@ void Simulator::onMqttConnection(bool connected, const std::string& reason) {
                 
                 // Request full Device Twin to get current desired properties
                 std::cout << "Requesting full Device Twin..." << std::endl;
+                if (startup_) {
+                    startup_->begin(StartupPhase::TwinGet);
+                }
                 twinHandler_->requestFullTwin("1");
             } else {
                 std::cerr << "Failed to initialize Device Twin subscriptions" << std::endl;
@@ -528,7 +694,7 @@ void Simulator::onMqttConnection(bool connected, const std::string& reason) {
         // Activate reconnection logic if simulation is still running
         if (running_) {
             shouldReconnect_ = true;
-            lastReconnectAttempt_ = std::chrono::steady_clock::now();
+            lastReconnectAttempt_ = clock_->steadyNow();
         }
     }
 }
@@ -550,8 +716,33 @@ void Simulator::onMqttConnection(bool connected, const std::string& reason) {
  * @note JSON payload is pretty-printed for readability
  */
 void Simulator::emitEvent(const Event& event) {
+    // Draw this event's custom field values in place (event.fieldRecord points at them)
+    if (config_.fieldSchema) {
+        config_.fieldSchema->advance(reinterpret_cast<uint8_t*>(fieldRecord_.data()), *rng_);
+    }
+    
     // Serialize event to JSON format for transmission
-    std::string json = JsonCodec::serialize(event);
+    std::string json;
+    if (event.trace.enabled()) {
+        Event traced = event;
+        traced.trace.encodedUs = traceClockUs();
+        json = JsonCodec::serialize(traced);
+    } else {
+        json = JsonCodec::serialize(event);
+    }
+    Stats::instance().recordEvent(event.eventType);
+    TRACKER_PROBE3(event_emit, static_cast<int>(event.eventType), event.deviceId.c_str(), json.size());
+    
+    if (eventCallback_) {
+        eventCallback_(event, json);
+    }
+    
+    if (!config_.logEvents) {
+        if (connected_) {
+            publishEvent(event, json);
+        }
+        return;
+    }
     
     // Parse and format JSON for readable logging output
     try {
@@ -568,14 +759,7 @@ void Simulator::emitEvent(const Event& event) {
         // Attempt to publish to Azure IoT Hub if connected
         if (connected_) {
             std::cout << "📤 Publishing to topic: " << d2cTopic_ << std::endl;
-            bool success = false;
-            
-            // Use appropriate MQTT client based on connection type
-            if (config_.hasDpsConfig() && dpsConnectionManager_->isConnected()) {
-                success = dpsConnectionManager_->publish("", json, 1);  // DPS manager handles topic
-            } else {
-                success = mqttClient_->publish(d2cTopic_, json, 1);  // QoS 1 for reliability
-            }
+            bool success = publishEvent(event, json);
             
             std::cout << (success ? "✅ Published to Azure IoT Hub" : "❌ Publish failed") << std::endl;
         } else {
@@ -590,6 +774,67 @@ void Simulator::emitEvent(const Event& event) {
     }
 }
 
+bool Simulator::publishTelemetry(const std::string& json) {
+    // IoT Hub property bag: the send stamp LatencyConsumer measures delivery from
+    std::string properties;
+    if (!config_.traceRunId.empty()) {
+        properties = "lt.p=" + std::to_string(traceClockUs());
+    }
+    
+    // Use appropriate MQTT client based on connection type
+    if (config_.hasDpsConfig() && dpsConnectionManager_->isConnected()) {
+        if (startup_) {
+            startup_->begin(StartupPhase::FirstPuback);
+        }
+        return dpsConnectionManager_->publish(properties, json, 1);  // DPS manager handles topic
+    }
+    if (startup_ && mqttClient_->isConnected()) {
+        startup_->begin(StartupPhase::FirstPuback);
+    }
+    return mqttClient_->publish(d2cTopic_ + properties, json, 1);  // QoS 1 for reliability
+}
+
+bool Simulator::publishEvent(const Event& event, const std::string& json) {
+    // Every event carries battery and network status, so any of them proves liveness
+    // once the hub has it. Counted before publishing: the PUBACK may beat the return
+    bool counted = event.eventType != EventType::Heartbeat;
+    if (counted) {
+        telemetryInFlight_.fetch_add(1, std::memory_order_relaxed);
+    }
+    bool published = publishTelemetry(json);
+    if (!published && counted) {
+        telemetryInFlight_.fetch_sub(1, std::memory_order_relaxed);
+    }
+    return published;
+}
+
+void Simulator::markDisconnected() {
+    connected_ = false;
+    telemetryInFlight_.store(0, std::memory_order_relaxed);
+}
+
+void Simulator::onPublishAck(int qos, bool success) {
+    // Telemetry goes out at QoS 1; QoS 0 completions are twin traffic
+    if (qos < 1) {
+        return;
+    }
+    // PUBACKs are not matched to messages: each one settles the oldest counted event
+    int pending = telemetryInFlight_.load(std::memory_order_relaxed);
+    while (pending > 0 &&
+           !telemetryInFlight_.compare_exchange_weak(pending, pending - 1, std::memory_order_relaxed)) {
+    }
+    if (pending > 0 && success) {
+        lastTelemetryNs_.store(clock_->steadyNow().time_since_epoch().count(), std::memory_order_relaxed);
+    }
+}
+
+std::shared_ptr<IMqttClient> Simulator::getTelemetryClient() const {
+    if (config_.hasDpsConfig() && dpsConnectionManager_) {
+        return dpsConnectionManager_->getHubClient();
+    }
+    return mqttClient_;
+}
+
 /**
  * @brief Update GPS location based on current movement state
  * 
@@ -605,8 +850,8 @@ void Simulator::emitEvent(const Event& event) {
  */
 void Simulator::updateLocation() {
     // Use route interpolation if following predefined route
-    if (followingRoute_ && !config_.route.empty()) {
-        currentLocation_ = Geo::interpolateRoute(config_.route, routeProgress_);
+    if (followingRoute_ && !enuRoute_.empty()) {
+        position_ = LocalFrame::interpolateRoute(enuRoute_, routeProgress_);
     }
     // Calculate free movement based on current speed and heading
     else if (currentSpeed_ > 0.0) {
@@ -617,8 +862,8 @@ void Simulator::updateLocation() {
         currentHeading_ += rng_->normal(0.0, 5.0);
         currentHeading_ = std::fmod(currentHeading_ + 360.0, 360.0);  // Normalize to 0-359°
         
-        // Calculate new GPS position based on heading and distance
-        currentLocation_ = Geo::moveLocation(currentLocation_, currentHeading_, distance);
+        // Advance local ENU position; WGS84 is only derived when an event is encoded
+        position_ = LocalFrame::move(position_, currentHeading_, distance);
     }
 }
 
@@ -632,59 +877,246 @@ void Simulator::updateLocation() {
  * @post Geofence enter/exit events are generated as appropriate
  * @post Current geofence state is updated
  * 
- * @note Uses circular geofences with radius-based detection
+ * @note Uses circular geofences tested in the regional ENU frame (see LocalFrame.hpp)
  * @note Maintains state to detect entry/exit transitions
+ * @note While following the route, crossings come from the catalog's precomputed
+ *       schedule: one comparison per tick regardless of fence count
+ * @note Fences in the out-of-core index (config_.fenceTree) are looked up
+ *       separately each tick the device moves; they are not in the catalog
  */
 void Simulator::checkGeofences() {
-    // Check which geofences currently contain the device
-    auto insideIds = Geo::checkGeofences(currentLocation_, config_.geofences);
-    
-    // Detect new geofence entries
-    for (const auto& id : insideIds) {
-        if (std::find(currentGeofenceIds_.begin(), currentGeofenceIds_.end(), id) == 
-            currentGeofenceIds_.end()) {
-            // Device has entered a new geofence
-            stateMachine_.processGeofenceChange(true, id);
-            currentGeofenceIds_.push_back(id);
+    if (config_.fenceTree) {
+        scanFenceTree();
+    }
+    if (!catalog_) return;
+    
+    bool onRoute = followingRoute_ && !enuRoute_.empty();
+    if (onRoute && crossingCursorValid_) {
+        advanceRouteCrossings();
+        return;
+    }
+    
+    scanGeofences();
+    
+    // Membership now matches the route at this point; replay crossings from here on
+    crossingCursorValid_ = onRoute;
+    if (onRoute) {
+        const auto& crossings = catalog_->routeCrossings;
+        nextCrossing_ = static_cast<size_t>(std::upper_bound(crossings.begin(), crossings.end(), routeProgress_,
+            [](double progress, const RouteCrossing& crossing) { return progress < crossing.progress; }) -
+            crossings.begin());
+    }
+}
+
+void Simulator::scanGeofences() {
+    // Only fences bucketed in the device's grid cell can contain it
+    auto candidates = catalog_->fenceIndex.query(position_);
+    fenceScratch_.resize(std::max(fenceScratch_.size(), candidates.count));
+    LocalFrame::insideFences(position_, candidates.fences, candidates.count, fenceScratch_.data());
+    
+    nowInside_.clear();
+    for (size_t i = 0; i < candidates.count; ++i) {
+        if (fenceScratch_[i]) {
+            nowInside_.push_back(candidates.ids[i]);
+        }
+    }
+    if (nowInside_ == insideFences_) return;
+    
+    // Merge previous and current membership (both ascending) to find exits and entries
+    size_t a = 0, b = 0;
+    while (a < insideFences_.size() || b < nowInside_.size()) {
+        if (b == nowInside_.size() || (a < insideFences_.size() && insideFences_[a] < nowInside_[b])) {
+            stateMachine_.processGeofenceChange(false, catalog_->geofences[insideFences_[a++]].id);
+        } else if (a == insideFences_.size() || nowInside_[b] < insideFences_[a]) {
+            stateMachine_.processGeofenceChange(true, catalog_->geofences[nowInside_[b++]].id);
+        } else {
+            ++a;
+            ++b;
+        }
+    }
+    
+    insideFences_.swap(nowInside_);
+    insideFenceIds_.clear();
+    for (auto index : insideFences_) {
+        insideFenceIds_.push_back(catalog_->geofences[index].id);
+    }
+}
+
+void Simulator::advanceRouteCrossings() {
+    const auto& crossings = catalog_->routeCrossings;
+    bool changed = false;
+    
+    while (nextCrossing_ < crossings.size() && crossings[nextCrossing_].progress <= routeProgress_) {
+        const auto& crossing = crossings[nextCrossing_++];
+        auto it = std::lower_bound(insideFences_.begin(), insideFences_.end(), crossing.fence);
+        bool inside = it != insideFences_.end() && *it == crossing.fence;
+        if (inside == crossing.enter) continue;
+        
+        if (crossing.enter) {
+            insideFences_.insert(it, crossing.fence);
+        } else {
+            insideFences_.erase(it);
+        }
+        stateMachine_.processGeofenceChange(crossing.enter, catalog_->geofences[crossing.fence].id);
+        changed = true;
+    }
+    if (!changed) return;
+    
+    insideFenceIds_.clear();
+    for (auto index : insideFences_) {
+        insideFenceIds_.push_back(catalog_->geofences[index].id);
+    }
+}
+
+void Simulator::scanFenceTree() {
+    // Parked devices cannot change membership; skip the lookup entirely
+    if (treeScanned_ && position_.east == treePosition_.east && position_.north == treePosition_.north) return;
+    
+    Location here = frame_.unproject(position_, currentLocation_);
+    auto lookup = config_.fenceTree->query(here.lat, here.lon, treeNowInside_, config_.fenceTreeMaxPages);
+    if (!lookup.complete) return;   // Over the page budget: keep the last known membership
+    treePosition_ = position_;
+    treeScanned_ = true;
+    if (treeNowInside_ == treeInside_) return;
+    
+    size_t a = 0, b = 0;
+    while (a < treeInside_.size() || b < treeNowInside_.size()) {
+        if (b == treeNowInside_.size() || (a < treeInside_.size() && treeInside_[a] < treeNowInside_[b])) {
+            stateMachine_.processGeofenceChange(false, std::string(config_.fenceTree->id(treeInside_[a++])));
+        } else if (a == treeInside_.size() || treeNowInside_[b] < treeInside_[a]) {
+            stateMachine_.processGeofenceChange(true, std::string(config_.fenceTree->id(treeNowInside_[b++])));
+        } else {
+            ++a;
+            ++b;
         }
     }
+    treeInside_.swap(treeNowInside_);
+}
+
+void Simulator::adoptCatalog(const Catalog* catalog) {
+    if (catalog == catalog_ && catalog->version == catalogVersion_) return;
+    
+    // Keep the world position if the new catalog uses a different frame
+    if (catalog->frame.originLat() != frame_.originLat() || catalog->frame.originLon() != frame_.originLon()) {
+        Location here = frame_.unproject(position_, currentLocation_);
+        frame_ = catalog->frame;
+        position_ = frame_.project(here);
+    }
+    enuRoute_ = catalog->enuRoute;
     
-    // Detect geofence exits by checking previously entered geofences
-    auto it = currentGeofenceIds_.begin();
-    while (it != currentGeofenceIds_.end()) {
-        if (std::find(insideIds.begin(), insideIds.end(), *it) == insideIds.end()) {
-            // Device has exited this geofence
-            stateMachine_.processGeofenceChange(false, *it);
-            it = currentGeofenceIds_.erase(it);
+    // Carry membership over by fence id; fences that disappeared are exited.
+    // The previous catalog may already be reclaimed, so only local copies are read.
+    std::vector<std::uint32_t> remapped;
+    std::vector<std::string> removed;
+    for (const auto& id : insideFenceIds_) {
+        auto it = catalog->fenceById.find(id);
+        if (it != catalog->fenceById.end()) {
+            remapped.push_back(it->second);
         } else {
-            ++it;
+            removed.push_back(id);
         }
     }
+    std::sort(remapped.begin(), remapped.end());
+    
+    catalog_ = catalog;
+    catalogVersion_ = catalog->version;
+    crossingCursorValid_ = false;   // Schedule belongs to the previous route
+    insideFences_.swap(remapped);
+    insideFenceIds_.clear();
+    for (auto index : insideFences_) {
+        insideFenceIds_.push_back(catalog->geofences[index].id);
+    }
+    
+    for (const auto& id : removed) {
+        stateMachine_.processGeofenceChange(false, id);
+    }
 }
 
 /**
  * @brief Check and send periodic heartbeat messages
  * 
- * Monitors time since last heartbeat and sends periodic status updates
- * to Azure IoT Hub at configured intervals for device health monitoring.
+ * Sends a status update once the hub has acknowledged nothing else from
+ * the device for a heartbeat period. Any other event carries the same
+ * battery and network fields, so its PUBACK restarts the period instead.
+ * An event published but never acknowledged does not. The longest silence
+ * the hub sees is unchanged: one period plus jitter.
  * 
  * @pre Heartbeat interval must be configured (> 0 seconds)
  * @post Heartbeat event is generated when interval expires
  * @post Heartbeat timer is reset after transmission
  * 
- * @note Heartbeat provides regular status updates even when idle
+ * @note Idle devices keep their phase-spread heartbeat slots
  * @note Critical for device connectivity monitoring in IoT systems
  */
 void Simulator::checkHeartbeat() {
-    auto now = std::chrono::steady_clock::now();
-    auto elapsed = std::chrono::duration_cast<std::chrono::seconds>(now - lastHeartbeat_);
+    auto now = clock_->steadyNow();
     
-    // Send heartbeat if configured interval has elapsed
-    if (elapsed.count() >= config_.heartbeatSeconds) {
+    // Telemetry acknowledged since the last check (on the client's thread) stands in for a heartbeat
+    int64_t acknowledged = lastTelemetryNs_.load(std::memory_order_relaxed);
+    if (acknowledged != telemetrySeenNs_) {
+        telemetrySeenNs_ = acknowledged;
+        heartbeatDeadline_.restart(std::chrono::steady_clock::time_point(std::chrono::steady_clock::duration(acknowledged)),
+                                   rng_.get(), config_.periodicJitter);
+    }
+    
+    // Send heartbeat when this device's phase slot comes around
+    if (heartbeatDeadline_.due(now)) {
         Event event = createBaseEvent(EventType::Heartbeat);
         emitEvent(event);
-        lastHeartbeat_ = now;  // Reset heartbeat timer
+        heartbeatDeadline_.advance(now, rng_.get(), config_.periodicJitter);
+    }
+}
+
+/**
+ * @brief Run phase-spread maintenance activity
+ * 
+ * Renews the legacy SAS token before expiry by reconnecting (IoT Hub only
+ * accepts a new token on CONNECT) and, when enabled, refreshes the full
+ * Device Twin. Both are phase-offset per device like the heartbeat.
+ * 
+ * @note DPS connections use X.509 certificates and need no token renewal
+ */
+void Simulator::checkPeriodicMaintenance() {
+    auto now = clock_->steadyNow();
+    
+    if (tokenRenewalDeadline_.due(now)) {
+        tokenRenewalDeadline_.advance(now, rng_.get(), config_.periodicJitter);
+        
+        if (config_.hasDpsConfig() && config_.hasDpsSymmetricKey() && connected_) {
+            // Keep the DPS assignment; only the hub token expires
+            if (!dpsConnectionManager_->renewHubCredentials()) {
+                markDisconnected();
+                shouldReconnect_ = true;
+                reconnectAttempts_ = 0;
+                lastReconnectAttempt_ = now;
+            }
+        } else if (!config_.hasDpsConfig() && connected_) {
+            std::cout << "[Simulator] Renewing SAS token" << std::endl;
+            mqttClient_->disconnect();
+            markDisconnected();
+            
+            // Reconnect with a fresh token via the regular backoff path
+            shouldReconnect_ = true;
+            reconnectAttempts_ = 0;
+            lastReconnectAttempt_ = now;
+        }
+    }
+    
+    if (twinRefreshDeadline_.due(now)) {
+        twinRefreshDeadline_.advance(now, rng_.get(), config_.periodicJitter);
+        
+        if (twinHandler_ && connected_) {
+            twinHandler_->requestFullTwin(std::to_string(++twinRequestId_));
+        }
+    }
+}
+
+std::chrono::milliseconds Simulator::phaseFor(PeriodicActivity activity,
+                                              std::chrono::milliseconds period) const {
+    if (!config_.phaseSpreading) {
+        return std::chrono::milliseconds(0);
     }
+    return PhaseSchedule::phaseOffset(config_.deviceId, activity, period);
 }
 
 /**
@@ -711,14 +1143,24 @@ Event Simulator::createBaseEvent(EventType type) const {
     event.timestamp = clock_->iso8601();
     event.eventType = type;
     event.sequence = ++const_cast<Simulator*>(this)->sequenceNumber_;  // Atomic increment
+    if (!config_.traceRunId.empty()) {
+        event.trace.runId = config_.traceRunId;
+        event.trace.generatedUs = traceClockUs();
+    }
     
     // Include current telemetry data
-    event.location = currentLocation_;   // GPS coordinates and altitude
+    event.location = frame_.unproject(position_, currentLocation_);  // ENU -> WGS84 at encode time
     event.speedKph = currentSpeed_;      // Current vehicle speed
     event.heading = currentHeading_;     // Direction of travel (degrees)
     event.battery = battery_.getInfo();  // Battery percentage and voltage
     event.network = networkInfo_;        // Network signal strength and type
     
+    // Custom fields are encoded straight from the device's flat record
+    if (config_.fieldSchema) {
+        event.fieldSchema = config_.fieldSchema.get();
+        event.fieldRecord = reinterpret_cast<const uint8_t*>(fieldRecord_.data());
+    }
+    
     return event;
 }
 
@@ -737,7 +1179,7 @@ Event Simulator::createBaseEvent(EventType type) const {
  * @note Stops attempting after MAX_RECONNECT_ATTEMPTS failures
  */
 void Simulator::attemptReconnection() {
-    auto now = std::chrono::steady_clock::now();
+    auto now = clock_->steadyNow();
     auto elapsed = std::chrono::duration_cast<std::chrono::seconds>(now - lastReconnectAttempt_);
     
     // Calculate exponential backoff delay with 60-second maximum
@@ -769,6 +1211,10 @@ bool Simulator::validateDpsConfiguration() const {
         return false;
     }
     
+    if (config_.hasDpsSymmetricKey()) {
+        return true;  // SAS tokens replace the certificate files
+    }
+    
     if (config_.deviceCertPath.empty() || config_.deviceKeyPath.empty()) {
         std::cerr << "[Simulator] Missing device certificate or key paths" << std::endl;
         return false;
@@ -810,25 +1256,11 @@ void Simulator::initializeDeviceTwinAdapter() {
     }
     
     // Recreate TwinHandler with correct MQTT client for IoT Hub (not DPS client)
-    twinHandler_ = std::make_shared<TwinHandler>(hubClient, config_.deviceId);
-    
-    // Configure Observer pattern callbacks (reuse existing setup)
-    twinHandler_->setConfigUpdateCallback([](const TwinUpdateResult& result, const nlohmann::json& configData) {
-        (void)configData; // Bounded processing - config already persisted
-        
-        std::cout << "Configuration " << (result.status == TwinStatus::Success ? "updated" : "failed")
-                  << ": v" << result.configVersion << std::endl;
-        
-        if (result.status != TwinStatus::Success) {
-            std::cerr << "Config error: " << result.errorMessage << std::endl;
-        }
-    });
-    
-    twinHandler_->setTwinResponseCallback([](TwinStatus status, const std::string& message) {
-        if (status != TwinStatus::Success) {
-            std::cerr << "Twin error: " << message << std::endl;
-        }
-    });
+    {
+        std::lock_guard<std::mutex> lock(twinMutex_);
+        twinHandler_ = std::make_shared<TwinHandler>(hubClient, config_.deviceId);
+    }
+    attachTwinCallbacks();   // Same handling as the legacy path, including "ota" patches
     
     // Set up MQTT message routing for Device Twin messages (Command pattern dispatch)
     hubClient->setMessageCallback([this](const MqttMessage& message) {
@@ -839,6 +1271,9 @@ void Simulator::initializeDeviceTwinAdapter() {
     std::cout << "Initializing Device Twin..." << std::endl;
     if (twinHandler_->initializeSubscriptions()) {
         // Request current configuration from Azure IoT Hub (Command pattern)
+        if (startup_) {
+            startup_->begin(StartupPhase::TwinGet);
+        }
         twinHandler_->requestFullTwin("1");
     } else {
         std::cerr << "Device Twin initialization failed" << std::endl;
@@ -870,7 +1305,7 @@ void Simulator::onDpsConnectionComplete(bool connected, const std::string& reaso
         
     } else {
         std::cerr << "[Simulator] ❌ DPS connection failed: " << reason << std::endl;
-        connected_ = false;
+        markDisconnected();
         shouldReconnect_ = true;
     }
 }
@@ -20,15 +20,25 @@
 #include "Event.hpp"
 #include "StateMachine.hpp"
 #include "Geo.hpp"
+#include "LocalFrame.hpp"
+#include "Catalog.hpp"
+#include "PhaseSchedule.hpp"
 #include "Battery.hpp"
+#include "FieldSchema.hpp"
+#include "ActivityModel.hpp"
+#include "FenceTree.hpp"
+#include "FirmwareUpdate.hpp"
 #include "JsonCodec.hpp"
 #include "IMqttClient.hpp"
 #include "IClock.hpp"
 #include "IRng.hpp"
 #include "DpsConnectionManager.hpp"
+#include <atomic>
 #include <memory>
+#include <mutex>
 #include <vector>
 #include <chrono>
+#include <functional>
 
 namespace tracker {
 
@@ -54,6 +64,10 @@ struct SimulatorConfig {
     std::string rootCaPath;                   ///< Path to root CA certificate
     bool verifyServerCert = true;             ///< Enable server certificate verification
     
+    // DPS symmetric-key attestation (replaces the X.509 files when set)
+    std::string enrollmentGroupKeyBase64;     ///< Group enrollment key; device keys are derived from it
+    std::string dpsDeviceKeyBase64;           ///< Device key (derived from the group key if empty)
+    
     // Legacy Configuration (for backward compatibility)
     std::string iotHubHost;                   ///< Azure IoT Hub hostname (deprecated, use DPS)
     std::string deviceKeyBase64;              ///< Base64-encoded device shared access key (deprecated)
@@ -61,14 +75,39 @@ struct SimulatorConfig {
     Location startLocation = {-26.2041, 28.0473, 1720.0, 12.5};  ///< Initial GPS coordinates (lat, lon, alt, accuracy)
     double speedLimitKph = 90.0;              ///< Speed limit for violation detection (km/h)
     int heartbeatSeconds = 60;                ///< Interval between periodic heartbeat messages
+    bool logEvents = true;                    ///< Print every event with its JSON payload
+    
+    // Periodic activity spreading (see PhaseSchedule.hpp)
+    bool phaseSpreading = true;               ///< Offset periodic activity by a per-device phase
+    double periodicJitter = 0.0;              ///< Extra random delay per firing (fraction of period, 0 = off)
+    int twinRefreshSeconds = 0;               ///< Periodic full twin GET interval (0 = disabled)
+    int sasTokenTtlSeconds = 3600;            ///< Legacy SAS token validity; renewed at 60% of TTL
     
     std::vector<RoutePoint> route;            ///< Optional predefined route waypoints
     std::vector<Geofence> geofences;          ///< Circular geofences for enter/exit detection
+    std::shared_ptr<const FieldSchema> fieldSchema;  ///< Compiled [[fields]] (optional, shared by all devices)
+    ActivityConfig activity;                  ///< Scheduled trips by time of day (fleet-level, see ActivityModel.hpp)
+    std::shared_ptr<const FenceTree> fenceTree;  ///< Out-of-core fence index (optional, shared by all devices)
+    std::size_t fenceTreeMaxPages = FenceTree::kMaxQueryPages;  ///< Page budget per fence-index lookup
+    std::vector<std::string> sourceAddresses; ///< Local addresses/interfaces for broker connections ([network])
+    bool leanConnections = false;             ///< Lean per-connection memory profile (see LeanConnections.hpp)
+    FotaConfig fota;                          ///< Firmware download settings (fleet-level, see FirmwareUpdate.hpp)
+    std::string traceRunId;                   ///< Non-empty: stamp events for end-to-end latency (see LatencyConsumer.hpp)
+    double batteryAmbientC = 25.0;            ///< Ambient (cell) temperature for the battery model ([battery])
+    double batteryAmbientSpreadC = 0.0;       ///< Fleet: per-device ambient drawn from ambient ± spread
+    
+    // Check if DPS symmetric-key attestation is configured
+    bool hasDpsSymmetricKey() const {
+        return !enrollmentGroupKeyBase64.empty() || !dpsDeviceKeyBase64.empty();
+    }
     
-    // Check if DPS configuration is available
+    // Check if DPS configuration is available (X.509 or symmetric key)
     bool hasDpsConfig() const {
-        return !idScope.empty() && !imei.empty() && 
-               !deviceCertPath.empty() && !deviceKeyPath.empty() && !rootCaPath.empty();
+        if (idScope.empty() || imei.empty()) {
+            return false;
+        }
+        return hasDpsSymmetricKey() ||
+               (!deviceCertPath.empty() && !deviceKeyPath.empty() && !rootCaPath.empty());
     }
 };
 
@@ -85,6 +124,9 @@ struct SimulatorConfig {
  */
 class Simulator {
 public:
+    /// Observer for every emitted event and its serialized payload
+    using EventCallback = std::function<void(const Event& event, const std::string& json)>;
+    
     /**
      * @brief Construct simulator with dependency injection
      * @param mqttClient MQTT client implementation for cloud connectivity
@@ -145,6 +187,20 @@ public:
      */
     void setBatteryPercentage(double pct);
     
+    /**
+     * @brief Share a fleet-wide battery bank (batched battery updates)
+     * @param bank Bank advanced once per frame by its owner
+     */
+    void attachBatteryBank(std::shared_ptr<BatteryBank> bank);
+    
+    /**
+     * @brief Use a shared route/geofence catalog instead of one built from the config
+     * @param catalog Catalog read inside a CatalogStore::ReadGuard
+     * @note Call before configure() and then before every tick(); switching versions
+     *       keeps fence membership by id and exits fences that were removed
+     */
+    void useCatalog(const Catalog* catalog);
+    
     /**
      * @brief Start automated driving simulation
      * @param durationMinutes Duration of driving session
@@ -166,6 +222,59 @@ public:
      */
     void setTwinHandler(std::shared_ptr<class TwinHandler> twinHandler);
     
+    /**
+     * @brief Receive the "ota" object of applied desired properties (see FirmwareUpdate.hpp)
+     * @note Called on the MQTT thread, for patches and full twin reads alike
+     */
+    void setFirmwareUpdateCallback(std::function<void(const nlohmann::json& ota)> callback) {
+        firmwareUpdateCallback_ = std::move(callback);
+    }
+    
+    /**
+     * @brief Report a firmware download result as the reported "ota" property
+     * @param ota Result object (version, status, bytes, seconds, error)
+     * @return false without a twin handler or when the publish is rejected
+     * @note Uses the twin handler of the current connection (hub client under DPS); any thread
+     */
+    bool reportFirmware(const nlohmann::json& ota);
+    
+    /**
+     * @brief Observe emitted events (UI logs, statistics, recorders)
+     * @param callback Invoked on the emitting thread after serialization
+     */
+    void setEventCallback(EventCallback callback) { eventCallback_ = std::move(callback); }
+    
+    /**
+     * @brief Stamp cold-start phases on a timeline (see StartupProfiler.hpp)
+     * @param timeline Device timeline that outlives the simulator, or nullptr
+     * @note Call before configure() so the config phase is closed
+     */
+    void setStartupTimeline(StartupTimeline* timeline);
+    
+    /** @brief Active configuration (device ID is updated after DPS assignment) */
+    const SimulatorConfig& getConfig() const { return config_; }
+    
+    /** @brief Legacy MQTT client injected at construction */
+    std::shared_ptr<IMqttClient> getMqttClient() const { return mqttClient_; }
+    
+    /** @brief Client carrying device-to-cloud telemetry (IoT Hub client under DPS) */
+    std::shared_ptr<IMqttClient> getTelemetryClient() const;
+    
+    DeviceState getState() const { return stateMachine_.getCurrentState(); }
+    
+    /** @brief Current position in the catalog frame (metres east/north of the start location) */
+    EnuPoint getPosition() const { return position_; }
+    
+    /** @brief Catalog indices of the fences containing the device (ascending) */
+    const std::vector<std::uint32_t>& getInsideFences() const { return insideFences_; }
+    bool isConnected() const { return connected_; }
+    
+    /** @brief A timed drive session (startDriving) is in progress */
+    bool isDriving() const { return driveDurationSeconds_ > 0.0; }
+    
+    /** @brief Connection lost and reconnection attempts are pending */
+    bool isReconnecting() const { return shouldReconnect_; }
+    
 private:
     // === Azure IoT Hub Connection Management ===
     
@@ -178,58 +287,115 @@ private:
     /** @brief Handle MQTT connection status changes */
     void onMqttConnection(bool connected, const std::string& reason);
     
+    /** @brief Clear the connection state, including publishes whose PUBACKs will not come */
+    void markDisconnected();
+    
     // === Event Processing and Telemetry ===
     
     /** @brief Emit tracking event to Azure IoT Hub with logging */
     void emitEvent(const Event& event);
     
+    /** @brief Publish a serialized event on the active connection (QoS 1), with its send stamp when tracing */
+    bool publishTelemetry(const std::string& json);
+    
     /** @brief Update GPS location based on movement model */
     void updateLocation();
     
+    /** @brief Switch catalog version, remapping fence membership by id */
+    void adoptCatalog(const Catalog* catalog);
+    
     /** @brief Check for geofence enter/exit events */
     void checkGeofences();
     
-    /** @brief Send periodic heartbeat messages */
+    /** @brief Test the current position against the fence index */
+    void scanGeofences();
+    
+    /** @brief Apply the catalog's route crossings up to routeProgress_ */
+    void advanceRouteCrossings();
+    
+    /** @brief Look the current position up in config_.fenceTree (skipped while parked) */
+    void scanFenceTree();
+    
+    /** @brief Send a heartbeat once no other telemetry went out for a heartbeat period */
     void checkHeartbeat();
     
+    /** @brief Publish an event; one that stands in for a heartbeat is counted until acknowledged */
+    bool publishEvent(const Event& event, const std::string& json);
+    
+    /** @brief Restart the heartbeat period when the hub acknowledges a counted event */
+    void onPublishAck(int qos, bool success);
+    
+    /** @brief Run phase-spread SAS token renewal and twin refresh when due */
+    void checkPeriodicMaintenance();
+    
+    /** @brief Phase offset of an activity for this device (0 when spreading is disabled) */
+    std::chrono::milliseconds phaseFor(PeriodicActivity activity, std::chrono::milliseconds period) const;
+    
     /** @brief Create base event with current telemetry data */
     Event createBaseEvent(EventType type) const;
     
     // === Dependency Injection Components ===
     std::shared_ptr<IMqttClient> mqttClient_;  ///< MQTT client for Azure IoT Hub communication (legacy)
-    std::shared_ptr<IClock> clock_;            ///< System clock abstraction for timestamps
+    std::shared_ptr<IClock> clock_;            ///< Clock abstraction for timestamps and steady timing
     std::shared_ptr<IRng> rng_;                ///< Random number generator for realistic simulation
     std::unique_ptr<DpsConnectionManager> dpsConnectionManager_;  ///< DPS-based connection manager
     std::shared_ptr<class TwinHandler> twinHandler_;  ///< Device Twin adapter (Hexagonal Architecture)
+    mutable std::mutex twinMutex_;             ///< Guards replacing twinHandler_ against reportFirmware()
+    EventCallback eventCallback_;              ///< Optional observer of emitted events
+    std::function<void(const nlohmann::json&)> firmwareUpdateCallback_;  ///< Optional FOTA trigger
+    StartupTimeline* startup_ = nullptr;       ///< Optional cold-start profiling
     
     // === Core Simulation Components ===
     SimulatorConfig config_;                   ///< Device configuration parameters
     StateMachine stateMachine_;                ///< Device state management (Idle/Driving/Parked/LowBattery)
-    Battery battery_;                          ///< Battery simulation with realistic drain model
+    Battery battery_;                          ///< Li-ion battery cell (OCV curve, load sag, charging)
     
     // === Runtime State ===
     bool running_ = false;                     ///< Simulation running flag
     bool connected_ = false;                   ///< MQTT connection status
     
     // === Current Telemetry Data ===
-    Location currentLocation_;                 ///< Current GPS coordinates
+    Location currentLocation_;                 ///< Altitude/accuracy template; lat/lon derived from position_ when encoding
+    LocalFrame frame_;                         ///< Regional ENU frame anchored at the start location
+    EnuPoint position_;                        ///< Current position in frame_ (metres east/north)
     double currentSpeed_ = 0.0;                ///< Current vehicle speed (km/h)
     double currentHeading_ = 0.0;              ///< Current direction of travel (degrees, 0-359)
     NetworkInfo networkInfo_;                  ///< Network signal strength and type
+    std::vector<uint64_t> fieldRecord_;        ///< Custom field values (config_.fieldSchema layout, 8-byte aligned)
     
     // === Message Sequencing and Timing ===
     uint64_t sequenceNumber_ = 0;              ///< Message sequence counter for ordering
-    std::chrono::steady_clock::time_point lastHeartbeat_;  ///< Last heartbeat transmission time
+    PeriodicDeadline heartbeatDeadline_;       ///< Phase-spread heartbeat schedule, restarted by other telemetry
+    std::atomic<int64_t> lastTelemetryNs_{0};  ///< clock_->steadyNow() of the last PUBACK for a non-heartbeat event (any thread)
+    std::atomic<int> telemetryInFlight_{0};    ///< Non-heartbeat events published and not yet acknowledged
+    int64_t telemetrySeenNs_ = 0;              ///< lastTelemetryNs_ already applied to heartbeatDeadline_
+    PeriodicDeadline tokenRenewalDeadline_;    ///< Phase-spread SAS token renewal (legacy and DPS symmetric key)
+    PeriodicDeadline twinRefreshDeadline_;     ///< Phase-spread periodic twin GET
+    uint64_t twinRequestId_ = 1;               ///< Request ID counter for twin GETs
     std::chrono::steady_clock::time_point lastTick_;       ///< Last simulation tick time
     
     // === Geofencing State ===
-    std::vector<std::string> currentGeofenceIds_;  ///< Currently entered geofences
+    std::unique_ptr<Catalog> ownCatalog_;      ///< Catalog built from config_ (standalone devices)
+    const Catalog* catalog_ = nullptr;         ///< Active catalog; shared ones are only valid during tick()
+    uint64_t catalogVersion_ = 0;              ///< Version of catalog_ when adopted
+    bool sharedCatalog_ = false;               ///< catalog_ comes from a CatalogStore
+    std::vector<std::uint32_t> insideFences_;  ///< Catalog indices of fences containing the device (ascending)
+    std::vector<std::string> insideFenceIds_;  ///< Ids of insideFences_ (survive catalog swaps)
+    std::vector<std::uint32_t> nowInside_;     ///< Per-tick membership scratch (reused)
+    std::vector<std::uint8_t> fenceScratch_;   ///< Per-tick containment results (reused)
+    std::vector<std::uint32_t> treeInside_;    ///< Fence-index fences containing the device (ascending)
+    std::vector<std::uint32_t> treeNowInside_; ///< Fence-index lookup scratch (reused)
+    EnuPoint treePosition_{};                  ///< Position of the last complete fence-index lookup
+    bool treeScanned_ = false;                 ///< treePosition_ is valid
     
     // === Route Following ===
+    std::vector<EnuPoint> enuRoute_;           ///< Route waypoints projected into frame_ (copied from the catalog)
     double routeProgress_ = 0.0;               ///< Progress along predefined route (0.0-1.0)
     bool followingRoute_ = false;              ///< Route following active flag
+    std::size_t nextCrossing_ = 0;             ///< Next catalog_->routeCrossings entry ahead of routeProgress_
+    bool crossingCursorValid_ = false;         ///< Membership matches the route at routeProgress_ (replay active)
     std::chrono::steady_clock::time_point driveStartTime_;  ///< Automated driving start time
-    double driveDurationSeconds_ = 0.0;        ///< Automated driving duration
+    double driveDurationSeconds_ = 0.0;        ///< Automated driving duration (0 = no timed session)
     
     // === MQTT Topics ===
     std::string d2cTopic_;                     ///< Device-to-cloud topic for telemetry
@@ -255,6 +421,9 @@ private:
     
     /** @brief Initialize Device Twin adapter after IoT Hub connection */
     void initializeDeviceTwinAdapter();
+    
+    /** @brief Log twin results and hand applied "ota" objects to firmwareUpdateCallback_ */
+    void attachTwinCallbacks();
 };
 
 } // namespace tracker
\ No newline at end of file
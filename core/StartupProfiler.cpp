@@ -0,0 +1,290 @@
+#include "StartupProfiler.hpp"
+#include <nlohmann/json.hpp>
+#include <algorithm>
+#include <iomanip>
+
+namespace tracker {
+
+namespace {
+
+double millis(double us) {
+    return us / 1000.0;
+}
+
+nlohmann::json histogramToJson(const StartupProfiler::Histogram& histogram) {
+    return {
+        {"count", histogram.count},
+        {"meanMs", millis(histogram.meanUs())},
+        {"p50Ms", millis(static_cast<double>(histogram.percentileUs(50.0)))},
+        {"p90Ms", millis(static_cast<double>(histogram.percentileUs(90.0)))},
+        {"p99Ms", millis(static_cast<double>(histogram.percentileUs(99.0)))},
+        {"maxMs", millis(static_cast<double>(histogram.maxUs))}
+    };
+}
+
+double share(std::uint64_t part, std::uint64_t total) {
+    return total ? static_cast<double>(part) / static_cast<double>(total) : 0.0;
+}
+
+} // namespace
+
+StartupTimeline::StartupTimeline(std::chrono::steady_clock::time_point epoch) : epoch_(epoch) {
+    for (std::size_t i = 0; i < kStartupPhaseCount; ++i) {
+        begin_[i].store(-1, std::memory_order_relaxed);
+        end_[i].store(-1, std::memory_order_relaxed);
+    }
+    // Configuration starts with the process, before any device exists
+    begin_[static_cast<std::size_t>(StartupPhase::Config)].store(0, std::memory_order_relaxed);
+}
+
+std::int64_t StartupTimeline::nowUs() const {
+    return std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - epoch_).count();
+}
+
+void StartupTimeline::transition(StartupPhase from, StartupPhase to) {
+    auto now = nowUs();
+    end(from, now);
+    begin(to, now);
+}
+
+void StartupTimeline::begin(StartupPhase phase, std::int64_t atUs) {
+    std::int64_t unset = -1;
+    begin_[static_cast<std::size_t>(phase)].compare_exchange_strong(unset, atUs, std::memory_order_acq_rel);
+}
+
+void StartupTimeline::end(StartupPhase phase, std::int64_t atUs) {
+    auto started = beginUs(phase);
+    if (started < 0) {
+        return;
+    }
+    std::int64_t unset = -1;
+    end_[static_cast<std::size_t>(phase)].compare_exchange_strong(
+        unset, std::max(atUs, started), std::memory_order_acq_rel);
+}
+
+void StartupTimeline::acknowledged(IMqttClient::Ack ack, int qos, bool success) {
+    if (!success) {
+        return;
+    }
+    if (ack == IMqttClient::Ack::Subscribe) {
+        end(StartupPhase::Subscribe);
+    } else if (qos >= 1) {
+        end(StartupPhase::FirstPuback);
+    }
+}
+
+void StartupTimeline::watch(IMqttClient& client) {
+    client.setAckCallback([this](IMqttClient::Ack ack, int qos, bool success) {
+        acknowledged(ack, qos, success);
+    });
+}
+
+StartupProfiler::StartupProfiler() : epoch_(std::chrono::steady_clock::now()) {}
+
+StartupTimeline* StartupProfiler::addDevice(std::string deviceId) {
+    timelines_.push_back(std::make_unique<StartupTimeline>(epoch_));
+    deviceIds_.push_back(std::move(deviceId));
+    return timelines_.back().get();
+}
+
+bool StartupProfiler::finished() const {
+    return std::all_of(timelines_.begin(), timelines_.end(), [](const auto& timeline) {
+        return timeline->completed(StartupPhase::FirstPuback);
+    });
+}
+
+std::vector<StartupProfiler::PathStep> StartupProfiler::criticalPath(std::size_t device) const {
+    const auto& timeline = *timelines_[device];
+    std::vector<PathStep> path;
+    if (!timeline.completed(StartupPhase::FirstPuback)) {
+        return path;
+    }
+
+    std::array<bool, kStartupPhaseCount> used{};
+    auto current = StartupPhase::FirstPuback;
+    while (true) {
+        used[static_cast<std::size_t>(current)] = true;
+        std::int64_t start = timeline.beginUs(current);
+        path.push_back({false, current, start, timeline.endUs(current) - start});
+
+        // The predecessor is whatever finished last before this phase could begin
+        std::size_t best = kStartupPhaseCount;
+        for (std::size_t i = 0; i < kStartupPhaseCount; ++i) {
+            auto phase = static_cast<StartupPhase>(i);
+            if (used[i] || !timeline.completed(phase) || timeline.endUs(phase) > start) {
+                continue;
+            }
+            if (best == kStartupPhaseCount || timeline.endUs(phase) > timeline.endUs(static_cast<StartupPhase>(best))) {
+                best = i;
+            }
+        }
+
+        std::int64_t readyAt = best == kStartupPhaseCount ? 0 : timeline.endUs(static_cast<StartupPhase>(best));
+        if (start > readyAt) {
+            path.push_back({true, current, readyAt, start - readyAt});
+        }
+        if (best == kStartupPhaseCount) {
+            break;
+        }
+        current = static_cast<StartupPhase>(best);
+    }
+
+    std::reverse(path.begin(), path.end());
+    return path;
+}
+
+StartupProfiler::Summary StartupProfiler::summarize() const {
+    Summary summary;
+    summary.devices = timelines_.size();
+
+    std::int64_t slowestUs = -1;
+    for (std::size_t device = 0; device < timelines_.size(); ++device) {
+        const auto& timeline = *timelines_[device];
+        for (std::size_t i = 0; i < kStartupPhaseCount; ++i) {
+            auto phase = static_cast<StartupPhase>(i);
+            if (timeline.completed(phase)) {
+                summary.phases[i].record(static_cast<std::uint64_t>(timeline.endUs(phase) - timeline.beginUs(phase)));
+            }
+        }
+
+        if (!timeline.completed(StartupPhase::FirstPuback)) {
+            continue;
+        }
+        ++summary.completed;
+        auto ttft = timeline.endUs(StartupPhase::FirstPuback);
+        summary.timeToFirstTelemetry.record(static_cast<std::uint64_t>(ttft));
+        summary.criticalTotalUs += static_cast<std::uint64_t>(ttft);
+
+        auto path = criticalPath(device);
+        for (const auto& step : path) {
+            if (step.wait) {
+                summary.criticalWaitUs += static_cast<std::uint64_t>(step.durationUs);
+            } else {
+                summary.criticalUs[static_cast<std::size_t>(step.phase)] += static_cast<std::uint64_t>(step.durationUs);
+            }
+        }
+        if (ttft > slowestUs) {
+            slowestUs = ttft;
+            summary.slowest = device;
+            summary.slowestPath = std::move(path);
+        }
+    }
+    return summary;
+}
+
+void StartupProfiler::print(std::ostream& out) const {
+    auto summary = summarize();
+
+    out << "Startup: " << summary.completed << "/" << summary.devices << " devices reached first PUBACK\n";
+    out << std::left << std::setw(14) << "Phase" << std::right
+        << std::setw(8) << "devices" << std::setw(12) << "mean ms" << std::setw(12) << "p50 ms"
+        << std::setw(12) << "p99 ms" << std::setw(12) << "max ms" << std::setw(10) << "critical" << "\n";
+
+    out << std::fixed << std::setprecision(1);
+    auto row = [&](const char* name, const Histogram& histogram, double criticalShare) {
+        out << std::left << std::setw(14) << name << std::right
+            << std::setw(8) << histogram.count
+            << std::setw(12) << millis(histogram.meanUs())
+            << std::setw(12) << millis(static_cast<double>(histogram.percentileUs(50.0)))
+            << std::setw(12) << millis(static_cast<double>(histogram.percentileUs(99.0)))
+            << std::setw(12) << millis(static_cast<double>(histogram.maxUs));
+        if (criticalShare >= 0.0) {
+            out << std::setw(9) << criticalShare * 100.0 << "%";
+        }
+        out << "\n";
+    };
+    for (std::size_t i = 0; i < kStartupPhaseCount; ++i) {
+        if (summary.phases[i].count == 0) {
+            continue;   // Not part of this connection mode
+        }
+        row(phaseName(static_cast<StartupPhase>(i)), summary.phases[i],
+            share(summary.criticalUs[i], summary.criticalTotalUs));
+    }
+    row("ttft", summary.timeToFirstTelemetry, -1.0);
+    out << std::left << std::setw(14) << "waiting" << std::right << std::setw(65)
+        << share(summary.criticalWaitUs, summary.criticalTotalUs) * 100.0 << "%\n";
+
+    if (!summary.slowestPath.empty()) {
+        out << "Slowest device " << deviceIds_[summary.slowest] << " critical path:\n";
+        for (const auto& step : summary.slowestPath) {
+            out << "  " << std::left << std::setw(14) << (step.wait ? "waiting" : phaseName(step.phase)) << std::right
+                << std::setw(10) << millis(static_cast<double>(step.startUs)) << " ms  +"
+                << millis(static_cast<double>(step.durationUs)) << " ms\n";
+        }
+    }
+    out << std::defaultfloat;
+}
+
+std::string StartupProfiler::toJson() const {
+    auto summary = summarize();
+    nlohmann::json json;
+    json["devices"] = summary.devices;
+    json["completed"] = summary.completed;
+    json["ttft"] = histogramToJson(summary.timeToFirstTelemetry);
+
+    nlohmann::json phases = nlohmann::json::object();
+    for (std::size_t i = 0; i < kStartupPhaseCount; ++i) {
+        auto entry = histogramToJson(summary.phases[i]);
+        entry["criticalShare"] = share(summary.criticalUs[i], summary.criticalTotalUs);
+        phases[phaseName(static_cast<StartupPhase>(i))] = std::move(entry);
+    }
+    json["phases"] = std::move(phases);
+
+    nlohmann::json critical;
+    critical["waitShare"] = share(summary.criticalWaitUs, summary.criticalTotalUs);
+    if (!summary.slowestPath.empty()) {
+        critical["slowestDevice"] = deviceIds_[summary.slowest];
+        nlohmann::json steps = nlohmann::json::array();
+        for (const auto& step : summary.slowestPath) {
+            steps.push_back({
+                {"phase", step.wait ? "waiting" : phaseName(step.phase)},
+                {"startMs", millis(static_cast<double>(step.startUs))},
+                {"durationMs", millis(static_cast<double>(step.durationUs))}
+            });
+        }
+        critical["slowestPath"] = std::move(steps);
+    }
+    json["criticalPath"] = std::move(critical);
+
+    nlohmann::json devices = nlohmann::json::array();
+    for (std::size_t device = 0; device < timelines_.size(); ++device) {
+        const auto& timeline = *timelines_[device];
+        nlohmann::json stamps = nlohmann::json::object();
+        for (std::size_t i = 0; i < kStartupPhaseCount; ++i) {
+            auto phase = static_cast<StartupPhase>(i);
+            if (timeline.beginUs(phase) < 0) {
+                continue;
+            }
+            nlohmann::json stamp = {{"beginMs", millis(static_cast<double>(timeline.beginUs(phase)))}};
+            if (timeline.completed(phase)) {
+                stamp["endMs"] = millis(static_cast<double>(timeline.endUs(phase)));
+            }
+            stamps[phaseName(phase)] = std::move(stamp);
+        }
+        nlohmann::json entry = {{"deviceId", deviceIds_[device]}, {"phases", std::move(stamps)}};
+        if (timeline.completed(StartupPhase::FirstPuback)) {
+            entry["ttftMs"] = millis(static_cast<double>(timeline.endUs(StartupPhase::FirstPuback)));
+        }
+        devices.push_back(std::move(entry));
+    }
+    json["perDevice"] = std::move(devices);
+    return json.dump(2);
+}
+
+const char* StartupProfiler::phaseName(StartupPhase phase) {
+    switch (phase) {
+        case StartupPhase::Config:      return "config";
+        case StartupPhase::Credentials: return "credentials";
+        case StartupPhase::DpsConnect:  return "dps_connect";
+        case StartupPhase::Register:    return "register";
+        case StartupPhase::PollWait:    return "poll_wait";
+        case StartupPhase::HubConnect:  return "hub_connect";
+        case StartupPhase::Subscribe:   return "subscribe";
+        case StartupPhase::TwinGet:     return "twin_get";
+        case StartupPhase::FirstPuback: return "first_puback";
+    }
+    return "unknown";
+}
+
+} // namespace tracker
@@ -0,0 +1,180 @@
+/**
+ * @file StartupProfiler.hpp
+ * @brief Per-device cold-start timeline: where time-to-first-telemetry goes
+ *
+ * Every device gets a StartupTimeline that the connect path stamps as it
+ * goes. Times are microseconds since the profiler was created, which is
+ * before the configuration file is parsed.
+ *
+ * | Phase       | Begins                             | Ends                               |
+ * |-------------|------------------------------------|------------------------------------|
+ * | config      | profiler created (before parsing)  | device configured                  |
+ * | credentials | connect requested                  | keys derived, SAS token built      |
+ * | dps_connect | DPS connect initiated              | DPS CONNACK (TLS + MQTT)           |
+ * | register    | registration published             | first registration response        |
+ * | poll_wait   | "assigning" response               | "assigned" response                |
+ * | hub_connect | hub connect initiated              | hub CONNACK (TLS + MQTT)           |
+ * | subscribe   | C2D subscription sent              | SUBACK                             |
+ * | twin_get    | full twin requested                | twin response                      |
+ * | first_puback| first telemetry on a live link     | its PUBACK                         |
+ *
+ * Only the first begin and end of a phase count, so reconnects and retries
+ * extend the phase they happen in instead of restarting it. Phases that do
+ * not apply (DPS phases in legacy mode, twin without a handler) stay unset.
+ *
+ * Phases overlap (twin GET and the first publish race), so the summary also
+ * walks each device's critical path backwards from the first PUBACK: each
+ * step is the phase that finished last before the current one began, and
+ * gaps between them are reported as waiting (mostly the first heartbeat's
+ * phase offset).
+ *
+ * @note Timelines are stamped lock-free from any thread; summaries may be
+ *       taken while devices are still starting
+ */
+
+#pragma once
+
+#include "IMqttClient.hpp"
+#include "LatencyConsumer.hpp"
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace tracker {
+
+enum class StartupPhase : std::size_t {
+    Config,
+    Credentials,
+    DpsConnect,
+    Register,
+    PollWait,
+    HubConnect,
+    Subscribe,
+    TwinGet,
+    FirstPuback
+};
+
+constexpr std::size_t kStartupPhaseCount = 9;
+
+/**
+ * @brief One device's phase stamps (-1 = not reached)
+ */
+class StartupTimeline {
+public:
+    explicit StartupTimeline(std::chrono::steady_clock::time_point epoch);
+
+    StartupTimeline(const StartupTimeline&) = delete;
+    StartupTimeline& operator=(const StartupTimeline&) = delete;
+
+    void begin(StartupPhase phase) { begin(phase, nowUs()); }
+    void end(StartupPhase phase) { end(phase, nowUs()); }
+
+    /** @brief End one phase and begin the next at the same instant */
+    void transition(StartupPhase from, StartupPhase to);
+
+    /** @brief Stamp a begin at an explicit time (first stamp wins) */
+    void begin(StartupPhase phase, std::int64_t atUs);
+
+    /** @brief Stamp an end at an explicit time (ignored before the begin) */
+    void end(StartupPhase phase, std::int64_t atUs);
+
+    /**
+     * @brief End Subscribe or FirstPuback from one acknowledgement of the telemetry client
+     * @note The first SUBACK ends Subscribe, the first QoS >= 1 PUBACK ends FirstPuback
+     */
+    void acknowledged(IMqttClient::Ack ack, int qos, bool success);
+
+    /**
+     * @brief Feed a client's acknowledgements to acknowledged()
+     * @param client Telemetry client (hub client under DPS); replaces its ack callback
+     */
+    void watch(IMqttClient& client);
+
+    std::int64_t beginUs(StartupPhase phase) const {
+        return begin_[static_cast<std::size_t>(phase)].load(std::memory_order_acquire);
+    }
+    std::int64_t endUs(StartupPhase phase) const {
+        return end_[static_cast<std::size_t>(phase)].load(std::memory_order_acquire);
+    }
+
+    /** @brief Phase has both stamps */
+    bool completed(StartupPhase phase) const { return endUs(phase) >= 0; }
+
+    /** @brief Microseconds since the profiler epoch */
+    std::int64_t nowUs() const;
+
+private:
+    std::chrono::steady_clock::time_point epoch_;
+    std::array<std::atomic<std::int64_t>, kStartupPhaseCount> begin_;
+    std::array<std::atomic<std::int64_t>, kStartupPhaseCount> end_;
+};
+
+class StartupProfiler {
+public:
+    using Histogram = LatencyConsumer::Histogram;
+
+    /** @brief One step of a critical path (a phase, or waiting between phases) */
+    struct PathStep {
+        bool wait = false;
+        StartupPhase phase = StartupPhase::Config;  ///< Unused for waits
+        std::int64_t startUs = 0;
+        std::int64_t durationUs = 0;
+    };
+
+    struct Summary {
+        std::size_t devices = 0;
+        std::size_t completed = 0;                             ///< Devices with a first PUBACK
+        std::array<Histogram, kStartupPhaseCount> phases{};    ///< Durations of completed phases
+        Histogram timeToFirstTelemetry;                        ///< Epoch to first PUBACK
+        std::array<std::uint64_t, kStartupPhaseCount> criticalUs{};  ///< Critical-path time per phase, all devices
+        std::uint64_t criticalWaitUs = 0;                      ///< Critical-path waiting, all devices
+        std::uint64_t criticalTotalUs = 0;                     ///< Sum of completed devices' TTFT
+        std::size_t slowest = 0;                               ///< Device with the longest TTFT
+        std::vector<PathStep> slowestPath;                     ///< Its critical path (empty if none completed)
+    };
+
+    StartupProfiler();
+
+    /**
+     * @brief Add a device timeline
+     * @return Timeline valid for the profiler's lifetime
+     * @note Call from one thread, before the device starts connecting
+     */
+    StartupTimeline* addDevice(std::string deviceId);
+
+    std::size_t size() const { return timelines_.size(); }
+    const StartupTimeline& timeline(std::size_t device) const { return *timelines_[device]; }
+    const std::string& deviceId(std::size_t device) const { return deviceIds_[device]; }
+
+    /** @brief Every device has a first PUBACK */
+    bool finished() const;
+
+    /**
+     * @brief Critical path of one device, oldest step first
+     * @return Empty if the device has no first PUBACK yet
+     */
+    std::vector<PathStep> criticalPath(std::size_t device) const;
+
+    Summary summarize() const;
+
+    /** @brief Phase table, TTFT and the critical-path breakdown */
+    void print(std::ostream& out) const;
+
+    /** @brief Summary plus every device's stamps as a JSON document */
+    std::string toJson() const;
+
+    static const char* phaseName(StartupPhase phase);
+
+private:
+    std::chrono::steady_clock::time_point epoch_;
+    std::vector<std::unique_ptr<StartupTimeline>> timelines_;
+    std::vector<std::string> deviceIds_;
+};
+
+} // namespace tracker
@@ -22,6 +22,7 @@ public:
     void setEventEmitter(EventEmitter emitter) { eventEmitter_ = emitter; }
     
     DeviceState getCurrentState() const { return currentState_; }
+    bool isIgnitionOn() const { return ignitionOn_; }
     
     void processIgnition(bool on);
     void processMotion(bool moving);
@@ -0,0 +1,138 @@
+#include "Stats.hpp"
+#include <algorithm>
+#include <bit>
+
+namespace tracker {
+
+Stats& Stats::instance() {
+    static Stats stats;
+    return stats;
+}
+
+Stats::Shard& Stats::local() {
+    thread_local Shard* shard = nullptr;
+    if (shard) {
+        return *shard;
+    }
+
+    std::lock_guard<std::mutex> lock(registryMutex_);
+    std::size_t count = shardCount_.load(std::memory_order_relaxed);
+    if (count < kMaxShards) {
+        shards_[count] = std::make_unique<Shard>();
+        shard = shards_[count].get();
+        shardCount_.store(count + 1, std::memory_order_release);
+    } else {
+        shard = shards_[kMaxShards - 1].get();
+    }
+    return *shard;
+}
+
+void Stats::recordEvent(EventType type) {
+    bump(local().events[static_cast<std::size_t>(type)]);
+}
+
+void Stats::recordPublishOk(uint64_t latencyUs) {
+    Shard& shard = local();
+    bump(shard.publishOk);
+    bump(shard.pubackLatency[latencyBucket(latencyUs)]);
+}
+
+void Stats::recordPublishFailed() {
+    bump(local().publishFailed);
+}
+
+void Stats::recordPublishQueued() {
+    bump(local().publishQueued);
+}
+
+void Stats::recordTick(uint64_t nanos) {
+    Shard& shard = local();
+    bump(shard.ticks);
+    bump(shard.tickNanos, nanos);
+}
+
+Stats::Snapshot Stats::snapshot() const {
+    Snapshot total;
+    std::size_t count = shardCount_.load(std::memory_order_acquire);
+
+    for (std::size_t s = 0; s < count; ++s) {
+        const Shard& shard = *shards_[s];
+        for (std::size_t i = 0; i < kEventTypes; ++i) {
+            total.events[i] += shard.events[i].load(std::memory_order_relaxed);
+        }
+        total.publishOk += shard.publishOk.load(std::memory_order_relaxed);
+        total.publishFailed += shard.publishFailed.load(std::memory_order_relaxed);
+        total.publishQueued += shard.publishQueued.load(std::memory_order_relaxed);
+        for (std::size_t i = 0; i < kLatencyBuckets; ++i) {
+            total.pubackLatency[i] += shard.pubackLatency[i].load(std::memory_order_relaxed);
+        }
+        total.ticks += shard.ticks.load(std::memory_order_relaxed);
+        total.tickNanos += shard.tickNanos.load(std::memory_order_relaxed);
+    }
+    return total;
+}
+
+std::size_t Stats::latencyBucket(uint64_t us) {
+    // Exact below 4 us, then 4 linear sub-buckets per power of two
+    if (us < 4) {
+        return static_cast<std::size_t>(us);
+    }
+    std::size_t exponent = static_cast<std::size_t>(std::bit_width(us)) - 1;
+    std::size_t mantissa = static_cast<std::size_t>((us >> (exponent - 2)) & 3);
+    return std::min(4 + (exponent - 2) * 4 + mantissa, kLatencyBuckets - 1);
+}
+
+uint64_t Stats::latencyBucketUpperUs(std::size_t bucket) {
+    if (bucket < 4) {
+        return bucket;
+    }
+    std::size_t exponent = (bucket - 4) / 4 + 2;
+    uint64_t mantissa = (bucket - 4) % 4;
+    return ((4 + mantissa + 1) << (exponent - 2)) - 1;
+}
+
+uint64_t Stats::Snapshot::totalEvents() const {
+    uint64_t total = 0;
+    for (auto count : events) {
+        total += count;
+    }
+    return total;
+}
+
+uint64_t Stats::Snapshot::latencyPercentileUs(double percentile) const {
+    uint64_t samples = 0;
+    for (auto count : pubackLatency) {
+        samples += count;
+    }
+    if (samples == 0) {
+        return 0;
+    }
+
+    uint64_t rank = static_cast<uint64_t>(percentile / 100.0 * static_cast<double>(samples - 1)) + 1;
+    uint64_t seen = 0;
+    for (std::size_t i = 0; i < kLatencyBuckets; ++i) {
+        seen += pubackLatency[i];
+        if (seen >= rank) {
+            return latencyBucketUpperUs(i);
+        }
+    }
+    return latencyBucketUpperUs(kLatencyBuckets - 1);
+}
+
+Stats::Snapshot Stats::Snapshot::since(const Snapshot& earlier) const {
+    Snapshot delta;
+    for (std::size_t i = 0; i < kEventTypes; ++i) {
+        delta.events[i] = events[i] - earlier.events[i];
+    }
+    delta.publishOk = publishOk - earlier.publishOk;
+    delta.publishFailed = publishFailed - earlier.publishFailed;
+    delta.publishQueued = publishQueued - earlier.publishQueued;
+    for (std::size_t i = 0; i < kLatencyBuckets; ++i) {
+        delta.pubackLatency[i] = pubackLatency[i] - earlier.pubackLatency[i];
+    }
+    delta.ticks = ticks - earlier.ticks;
+    delta.tickNanos = tickNanos - earlier.tickNanos;
+    return delta;
+}
+
+} // namespace tracker
@@ -0,0 +1,98 @@
+/**
+ * @file Stats.hpp
+ * @brief Process-wide runtime counters with per-thread shards
+ *
+ * Hot paths (event emission, Paho delivery callbacks, fleet ticks) record into
+ * a shard owned by the calling thread: a relaxed atomic increment on a cache
+ * line no other thread writes. Readers sum all shards with relaxed loads, so
+ * neither side takes a lock after a thread's first record (registration).
+ *
+ * Counters only grow; rates and windowed percentiles come from the difference
+ * of two snapshots.
+ *
+ * @note Shards outlive their threads so totals never go backwards
+ */
+
+#pragma once
+
+#include "Event.hpp"
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+
+namespace tracker {
+
+class Stats {
+public:
+    /// One slot per EventType
+    static constexpr std::size_t kEventTypes = static_cast<std::size_t>(EventType::LowBattery) + 1;
+
+    /// Log-linear latency buckets (4 per power of two, microseconds, up to ~33 s)
+    static constexpr std::size_t kLatencyBuckets = 96;
+
+    /**
+     * @brief Summed view of all shards at one point in time
+     */
+    struct Snapshot {
+        std::array<uint64_t, kEventTypes> events{};       ///< Emitted events per type
+        uint64_t publishOk = 0;                           ///< Delivered (PUBACK / send complete)
+        uint64_t publishFailed = 0;                       ///< Rejected or failed delivery
+        uint64_t publishQueued = 0;                       ///< Stored in an offline queue
+        std::array<uint64_t, kLatencyBuckets> pubackLatency{};
+        uint64_t ticks = 0;                               ///< Fleet frames
+        uint64_t tickNanos = 0;                           ///< Total frame time
+
+        uint64_t totalEvents() const;
+
+        /** @brief Latency percentile in microseconds (bucket upper bound), 0 if empty */
+        uint64_t latencyPercentileUs(double percentile) const;
+
+        /** @brief Counter-wise difference (this - earlier) */
+        Snapshot since(const Snapshot& earlier) const;
+    };
+
+    static Stats& instance();
+
+    void recordEvent(EventType type);
+    void recordPublishOk(uint64_t latencyUs);
+    void recordPublishFailed();
+    void recordPublishQueued();
+    void recordTick(uint64_t nanos);
+
+    Snapshot snapshot() const;
+
+    static std::size_t latencyBucket(uint64_t us);
+    static uint64_t latencyBucketUpperUs(std::size_t bucket);
+
+private:
+    struct alignas(64) Shard {
+        std::array<std::atomic<uint64_t>, kEventTypes> events{};
+        std::atomic<uint64_t> publishOk{0};
+        std::atomic<uint64_t> publishFailed{0};
+        std::atomic<uint64_t> publishQueued{0};
+        std::array<std::atomic<uint64_t>, kLatencyBuckets> pubackLatency{};
+        std::atomic<uint64_t> ticks{0};
+        std::atomic<uint64_t> tickNanos{0};
+    };
+
+    Stats() = default;
+
+    /** @brief Calling thread's shard (registered on first use) */
+    Shard& local();
+
+    static void bump(std::atomic<uint64_t>& counter, uint64_t amount = 1) {
+        counter.fetch_add(amount, std::memory_order_relaxed);
+    }
+
+    /// Threads beyond this share the last shard (still correct, just contended)
+    static constexpr std::size_t kMaxShards = 256;
+
+    std::mutex registryMutex_;                              ///< Serializes shard registration
+    std::array<std::unique_ptr<Shard>, kMaxShards> shards_;
+    std::atomic<std::size_t> shardCount_{0};                ///< Published with release
+};
+
+} // namespace tracker
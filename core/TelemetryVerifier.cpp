@@ -0,0 +1,438 @@
+#include "TelemetryVerifier.hpp"
+#include <algorithm>
+#include <cstring>
+#include <functional>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
+
+namespace tracker {
+
+namespace {
+    constexpr std::size_t kMinChunkBytes = 1 << 20;  // Automatic thread count: at least this much per thread
+    constexpr std::uint8_t kNoType = 0xFF;
+    constexpr std::size_t kTypicalLineBytes = 256;   // Record reservation estimate (events are ~300 B)
+
+    // Order matches EventType
+    constexpr std::string_view kEventTypes[] = {
+        "heartbeat", "ignition_on", "ignition_off", "motion_start", "motion_stop",
+        "geofence_enter", "geofence_exit", "speed_over_limit", "low_battery"
+    };
+    constexpr std::uint8_t kGeofenceEnter = 5;
+    constexpr std::uint8_t kGeofenceExit = 6;
+
+    /// One parsed event; views point into the verified buffer
+    struct Record {
+        const char* device;
+        const char* fence;
+        std::uint64_t seq;
+        std::int64_t tsMs;
+        std::uint32_t line;         ///< Chunk-local line index
+        std::uint16_t deviceLen;
+        std::uint16_t fenceLen;
+        std::uint8_t type;
+    };
+
+    using Violation = TelemetryVerifier::Violation;
+    using Kind = TelemetryVerifier::ViolationKind;
+
+    // Required top-level fields, in JsonCodec's (sorted) key order
+    enum Field : unsigned {
+        kBattery = 1u << 0, kDeviceId = 1u << 1, kEventType = 1u << 2, kHeading = 1u << 3,
+        kLoc = 1u << 4, kNetwork = 1u << 5, kSeq = 1u << 6, kSpeed = 1u << 7, kTs = 1u << 8
+    };
+    constexpr unsigned kRequired = (1u << 9) - 1;
+    constexpr const char* kFieldNames[] = {"battery", "deviceId", "eventType", "heading", "loc",
+                                           "network", "seq", "speedKph", "ts"};
+
+    bool isSpace(char c) { return c == ' ' || c == '\t' || c == '\r'; }
+
+    void skipSpace(const char*& p, const char* end) {
+        while (p < end && isSpace(*p)) ++p;
+    }
+
+    /// p at an opening quote; leaves p after the closing quote
+    bool skipString(const char*& p, const char* end) {
+        ++p;
+        while (p < end) {
+            auto quote = static_cast<const char*>(std::memchr(p, '"', static_cast<std::size_t>(end - p)));
+            if (!quote) return false;
+            const char* b = quote;
+            while (b > p && b[-1] == '\\') --b;
+            p = quote + 1;
+            if (((quote - b) & 1) == 0) return true;   // Even run of backslashes: not escaped
+        }
+        return false;
+    }
+
+    /// Skip any JSON value; p is left after it
+    bool skipValue(const char*& p, const char* end) {
+        if (p >= end) return false;
+        if (*p == '"') return skipString(p, end);
+        if (*p == '{' || *p == '[') {
+            int depth = 0;
+            while (p < end) {
+                char c = *p;
+                if (c == '"') {
+                    if (!skipString(p, end)) return false;
+                    continue;
+                }
+                if (c == '{' || c == '[') ++depth;
+                else if ((c == '}' || c == ']') && --depth == 0) {
+                    ++p;
+                    return true;
+                }
+                ++p;
+            }
+            return false;
+        }
+        const char* start = p;
+        while (p < end && *p != ',' && *p != '}' && *p != ']' && !isSpace(*p)) ++p;
+        return p > start;
+    }
+
+    bool parseUnsigned(const char* p, const char* end, std::uint64_t& value) {
+        if (p == end) return false;
+        value = 0;
+        for (; p < end; ++p) {
+            if (*p < '0' || *p > '9') return false;
+            value = value * 10 + static_cast<std::uint64_t>(*p - '0');
+        }
+        return true;
+    }
+
+    /**
+     * @brief Check one line against the event schema and extract its keys
+     * @return nullptr on success, else a static description of the problem
+     */
+    const char* parseLine(const char* p, const char* end, Record& record) {
+        if (*p != '{') return "not a JSON object";
+        ++p;
+
+        unsigned seen = 0;
+        record.fence = nullptr;
+        record.fenceLen = 0;
+        for (;;) {
+            skipSpace(p, end);
+            if (p < end && *p == '}' && seen == 0) break;
+            if (p >= end || *p != '"') return "expected key";
+            const char* key = p + 1;
+            if (!skipString(p, end)) return "unterminated key";
+            std::string_view name(key, static_cast<std::size_t>(p - 1 - key));
+            skipSpace(p, end);
+            if (p >= end || *p != ':') return "expected ':'";
+            ++p;
+            skipSpace(p, end);
+            const char* value = p;
+            if (!skipValue(p, end)) return "malformed value";
+            const char* valueEnd = p;
+            bool isString = *value == '"';
+            bool isObject = *value == '{';
+
+            if (name == "deviceId") {
+                if (!isString || valueEnd - value < 3 || valueEnd - value > 0xFFFF) return "deviceId is not a non-empty string";
+                record.device = value + 1;
+                record.deviceLen = static_cast<std::uint16_t>(valueEnd - value - 2);
+                seen |= kDeviceId;
+            } else if (name == "eventType") {
+                if (!isString) return "eventType is not a string";
+                std::string_view type(value + 1, static_cast<std::size_t>(valueEnd - value - 2));
+                record.type = kNoType;
+                for (std::uint8_t i = 0; i < std::size(kEventTypes); ++i) {
+                    if (kEventTypes[i] == type) record.type = i;
+                }
+                if (record.type == kNoType) return "unknown eventType";
+                seen |= kEventType;
+            } else if (name == "seq") {
+                if (!parseUnsigned(value, valueEnd, record.seq)) return "seq is not an unsigned integer";
+                seen |= kSeq;
+            } else if (name == "ts") {
+                if (!isString || !TelemetryVerifier::parseTimestamp(value + 1, static_cast<std::size_t>(valueEnd - value - 2), record.tsMs)) {
+                    return "ts is not an ISO 8601 UTC timestamp";
+                }
+                seen |= kTs;
+            } else if (name == "loc" || name == "battery" || name == "network") {
+                if (!isObject) return "loc/battery/network is not an object";
+                seen |= name == "loc" ? kLoc : name == "battery" ? kBattery : kNetwork;
+            } else if (name == "heading" || name == "speedKph") {
+                if (*value != '-' && (*value < '0' || *value > '9')) return "heading/speedKph is not a number";
+                seen |= name == "heading" ? kHeading : kSpeed;
+            } else if (name == "extras") {
+                if (!isObject) return "extras is not an object";
+                static constexpr std::string_view kFenceKey = "\"geofenceId\":\"";
+                std::string_view extras(value, static_cast<std::size_t>(valueEnd - value));
+                auto at = extras.find(kFenceKey);
+                if (at != std::string_view::npos) {
+                    const char* id = value + at + kFenceKey.size();
+                    auto close = static_cast<const char*>(std::memchr(id, '"', static_cast<std::size_t>(valueEnd - id)));
+                    if (!close || close - id > 0xFFFF) return "malformed geofenceId";
+                    record.fence = id;
+                    record.fenceLen = static_cast<std::uint16_t>(close - id);
+                }
+            }
+
+            skipSpace(p, end);
+            if (p < end && *p == ',') {
+                ++p;
+                continue;
+            }
+            if (p < end && *p == '}') break;
+            return "expected ',' or '}'";
+        }
+        ++p;
+        skipSpace(p, end);
+        if (p != end) return "trailing characters after object";
+
+        if (seen != kRequired) {
+            for (unsigned bit = 0; bit < 9; ++bit) {
+                if (!(seen & (1u << bit))) {
+                    static thread_local std::string missing;
+                    missing = std::string("missing '") + kFieldNames[bit] + "'";
+                    return missing.c_str();
+                }
+            }
+        }
+        if ((record.type == kGeofenceEnter || record.type == kGeofenceExit) && !record.fence) {
+            return "geofence event without extras.geofenceId";
+        }
+        return nullptr;
+    }
+
+    struct ChunkResult {
+        std::uint64_t lines = 0;            ///< All lines including blank ones
+        std::uint64_t nonBlank = 0;
+        std::uint64_t schemaErrors = 0;
+        std::vector<std::vector<Record>> shards;
+        std::vector<Violation> samples;     ///< line is chunk-local here
+    };
+
+    struct ShardResult {
+        std::uint64_t devices = 0;
+        std::uint64_t events = 0;
+        std::uint64_t sequenceGaps = 0, missingEvents = 0, duplicates = 0;
+        std::uint64_t timestampRegressions = 0, unpairedEnters = 0, unpairedExits = 0, openFences = 0;
+        std::vector<Violation> samples;
+    };
+
+    struct DeviceState {
+        std::uint64_t lastSeq = 0;
+        std::int64_t lastTs = 0;
+        bool any = false;
+        std::vector<std::string_view> inside;   ///< Fences entered and not yet exited
+    };
+
+    void scanChunk(const char* begin, const char* end, std::size_t shardCount,
+                   std::size_t maxSamples, ChunkResult& result) {
+        result.shards.resize(shardCount);
+        for (auto& shard : result.shards) {
+            shard.reserve(static_cast<std::size_t>(end - begin) / kTypicalLineBytes / shardCount);
+        }
+        std::hash<std::string_view> hash;
+        std::uint32_t line = 0;
+        for (const char* p = begin; p < end; ++line) {
+            auto newline = static_cast<const char*>(std::memchr(p, '\n', static_cast<std::size_t>(end - p)));
+            const char* lineEnd = newline ? newline : end;
+            const char* next = newline ? newline + 1 : end;
+
+            const char* first = p;
+            const char* last = lineEnd;
+            while (first < last && isSpace(*first)) ++first;
+            while (last > first && isSpace(last[-1])) --last;
+            p = next;
+            ++result.lines;
+            if (first == last) continue;
+            ++result.nonBlank;
+
+            Record record{};
+            record.line = line;
+            if (const char* error = parseLine(first, last, record)) {
+                ++result.schemaErrors;
+                if (result.samples.size() < maxSamples) {
+                    result.samples.push_back({Kind::Schema, line, error});
+                }
+                continue;
+            }
+            std::size_t shard = hash(std::string_view(record.device, record.deviceLen)) % shardCount;
+            result.shards[shard].push_back(record);
+        }
+    }
+
+    void checkShard(const std::vector<ChunkResult>& chunks, const std::vector<std::uint64_t>& lineBase,
+                    std::size_t shard, std::size_t maxSamples, ShardResult& result) {
+        std::unordered_map<std::string_view, DeviceState> devices;
+        auto sample = [&](Kind kind, std::uint64_t line, std::string detail) {
+            if (result.samples.size() < maxSamples) {
+                result.samples.push_back({kind, line, std::move(detail)});
+            }
+        };
+
+        for (std::size_t c = 0; c < chunks.size(); ++c) {
+            for (const Record& record : chunks[c].shards[shard]) {
+                ++result.events;
+                std::string_view id(record.device, record.deviceLen);
+                DeviceState& state = devices[id];
+                std::uint64_t line = lineBase[c] + record.line + 1;
+
+                if (state.any) {
+                    if (record.seq > state.lastSeq + 1) {
+                        ++result.sequenceGaps;
+                        result.missingEvents += record.seq - state.lastSeq - 1;
+                        sample(Kind::SequenceGap, line, std::string(id) + ": seq " + std::to_string(record.seq) +
+                               " after " + std::to_string(state.lastSeq));
+                    } else if (record.seq <= state.lastSeq) {
+                        ++result.duplicates;
+                        sample(Kind::DuplicateSequence, line, std::string(id) + ": seq " + std::to_string(record.seq) +
+                               " after " + std::to_string(state.lastSeq));
+                    }
+                    if (record.tsMs < state.lastTs) {
+                        ++result.timestampRegressions;
+                        sample(Kind::TimestampRegression, line, std::string(id) + ": ts " +
+                               std::to_string(state.lastTs - record.tsMs) + " ms earlier than previous event");
+                    }
+                }
+                state.any = true;
+                state.lastSeq = std::max(state.lastSeq, record.seq);
+                state.lastTs = std::max(state.lastTs, record.tsMs);
+
+                if (record.fence) {
+                    std::string_view fence(record.fence, record.fenceLen);
+                    auto it = std::find(state.inside.begin(), state.inside.end(), fence);
+                    if (record.type == kGeofenceEnter) {
+                        if (it != state.inside.end()) {
+                            ++result.unpairedEnters;
+                            sample(Kind::UnpairedEnter, line, std::string(id) + ": enter '" + std::string(fence) + "' while inside");
+                        } else {
+                            state.inside.push_back(fence);
+                        }
+                    } else if (record.type == kGeofenceExit) {
+                        if (it == state.inside.end()) {
+                            ++result.unpairedExits;
+                            sample(Kind::UnpairedExit, line, std::string(id) + ": exit '" + std::string(fence) + "' without enter");
+                        } else {
+                            state.inside.erase(it);
+                        }
+                    }
+                }
+            }
+        }
+
+        result.devices = devices.size();
+        for (const auto& [id, state] : devices) {
+            result.openFences += state.inside.empty() ? 0 : 1;
+        }
+    }
+}
+
+const char* TelemetryVerifier::kindName(ViolationKind kind) {
+    switch (kind) {
+        case ViolationKind::Schema: return "schema";
+        case ViolationKind::SequenceGap: return "sequence gap";
+        case ViolationKind::DuplicateSequence: return "duplicate sequence";
+        case ViolationKind::TimestampRegression: return "timestamp regression";
+        case ViolationKind::UnpairedEnter: return "unpaired enter";
+        case ViolationKind::UnpairedExit: return "unpaired exit";
+    }
+    return "unknown";
+}
+
+bool TelemetryVerifier::parseTimestamp(const char* text, std::size_t length, std::int64_t& unixMs) {
+    // 2025-01-31T12:34:56.789Z
+    static constexpr char kPattern[] = "dddd-dd-ddTdd:dd:dd.dddZ";
+    if (length != sizeof(kPattern) - 1) return false;
+    for (std::size_t i = 0; i < length; ++i) {
+        bool digit = text[i] >= '0' && text[i] <= '9';
+        if (kPattern[i] == 'd' ? !digit : text[i] != kPattern[i]) return false;
+    }
+    auto number = [text](std::size_t at, std::size_t digits) {
+        int value = 0;
+        for (std::size_t i = 0; i < digits; ++i) value = value * 10 + (text[at + i] - '0');
+        return value;
+    };
+    int year = number(0, 4), month = number(5, 2), day = number(8, 2);
+    int hour = number(11, 2), minute = number(14, 2), second = number(17, 2), millis = number(20, 3);
+    if (month < 1 || month > 12 || day < 1 || day > 31 || hour > 23 || minute > 59 || second > 60) return false;
+
+    // Days from civil (proleptic Gregorian), Howard Hinnant's algorithm
+    year -= month <= 2;
+    const int era = (year >= 0 ? year : year - 399) / 400;
+    const unsigned yoe = static_cast<unsigned>(year - era * 400);
+    const unsigned doy = static_cast<unsigned>((153 * (month + (month > 2 ? -3 : 9)) + 2) / 5 + day - 1);
+    const unsigned doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+    std::int64_t days = static_cast<std::int64_t>(era) * 146097 + static_cast<std::int64_t>(doe) - 719468;
+
+    unixMs = ((days * 24 + hour) * 60 + minute) * 60000LL + second * 1000LL + millis;
+    return true;
+}
+
+TelemetryVerifier::Report TelemetryVerifier::verify(const char* data, std::size_t size, const Options& options) {
+    Report report;
+    report.bytes = size;
+
+    unsigned threads = options.threads;
+    if (threads == 0) {
+        threads = std::max(1u, std::thread::hardware_concurrency());
+        threads = static_cast<unsigned>(std::clamp<std::size_t>(size / kMinChunkBytes, 1, threads));
+    }
+    report.threads = threads;
+
+    // Chunk boundaries at line starts
+    std::vector<const char*> bounds{data};
+    for (unsigned i = 1; i < threads; ++i) {
+        const char* p = std::max(bounds.back(), data + size * i / threads);
+        auto newline = static_cast<const char*>(std::memchr(p, '\n', static_cast<std::size_t>(data + size - p)));
+        bounds.push_back(newline ? newline + 1 : data + size);
+    }
+    bounds.push_back(data + size);
+
+    auto runParallel = [threads](const std::function<void(unsigned)>& work) {
+        std::vector<std::thread> workers;
+        for (unsigned i = 1; i < threads; ++i) workers.emplace_back(work, i);
+        work(0);
+        for (auto& worker : workers) worker.join();
+    };
+
+    std::vector<ChunkResult> chunks(threads);
+    runParallel([&](unsigned i) {
+        scanChunk(bounds[i], bounds[i + 1], threads, options.maxSamples, chunks[i]);
+    });
+
+    std::vector<std::uint64_t> lineBase(threads, 0);
+    for (unsigned i = 0; i < threads; ++i) {
+        if (i > 0) lineBase[i] = lineBase[i - 1] + chunks[i - 1].lines;
+        report.lines += chunks[i].nonBlank;
+        report.schemaErrors += chunks[i].schemaErrors;
+        for (auto violation : chunks[i].samples) {
+            violation.line += lineBase[i] + 1;
+            report.samples.push_back(std::move(violation));
+        }
+    }
+
+    std::vector<ShardResult> shards(threads);
+    runParallel([&](unsigned i) {
+        checkShard(chunks, lineBase, i, options.maxSamples, shards[i]);
+    });
+
+    for (auto& shard : shards) {
+        report.devices += shard.devices;
+        report.events += shard.events;
+        report.sequenceGaps += shard.sequenceGaps;
+        report.missingEvents += shard.missingEvents;
+        report.duplicates += shard.duplicates;
+        report.timestampRegressions += shard.timestampRegressions;
+        report.unpairedEnters += shard.unpairedEnters;
+        report.unpairedExits += shard.unpairedExits;
+        report.openFences += shard.openFences;
+        for (auto& violation : shard.samples) {
+            report.samples.push_back(std::move(violation));
+        }
+    }
+
+    std::sort(report.samples.begin(), report.samples.end(),
+              [](const Violation& a, const Violation& b) { return a.line < b.line; });
+    if (report.samples.size() > options.maxSamples) {
+        report.samples.resize(options.maxSamples);
+    }
+    return report;
+}
+
+} // namespace tracker
@@ -0,0 +1,91 @@
+/**
+ * @file TelemetryVerifier.hpp
+ * @brief Parallel invariant checks over recorded NDJSON telemetry (sim-verify)
+ *
+ * Input is one event object per line, as written by `sim-cli --record` or
+ * captured from the hub. Verification runs in two parallel passes over an
+ * in-memory (typically memory-mapped) buffer:
+ *
+ * 1. Scan: the buffer is split at line boundaries into one chunk per thread.
+ *    Lines are found with memchr and each object is walked once by a
+ *    streaming scanner that checks the schema and extracts device ID,
+ *    sequence, timestamp, event type and geofence ID. Records are bucketed
+ *    by a hash of the device ID.
+ * 2. Check: one thread per device shard replays its records in file order
+ *    and checks sequence gaps and duplicates, timestamp monotonicity and
+ *    geofence enter/exit pairing per device.
+ *
+ * Records point into the buffer, so it must outlive verify().
+ *
+ * @note Only the fast path is hand-rolled; keys must be unescaped (JsonCodec never escapes them)
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace tracker {
+
+class TelemetryVerifier {
+public:
+    enum class ViolationKind {
+        Schema,                 ///< Malformed line or missing/mistyped field
+        SequenceGap,            ///< Sequence numbers skipped
+        DuplicateSequence,      ///< Sequence repeated or went backwards
+        TimestampRegression,    ///< Timestamp earlier than the device's previous event
+        UnpairedEnter,          ///< Geofence enter while already inside
+        UnpairedExit            ///< Geofence exit without a matching enter
+    };
+
+    struct Violation {
+        ViolationKind kind = ViolationKind::Schema;
+        std::uint64_t line = 0;   ///< 1-based line number
+        std::string detail;
+    };
+
+    struct Options {
+        unsigned threads = 0;            ///< Scan/check threads (0 = one per core, at most one per MB)
+        std::size_t maxSamples = 20;     ///< Violations reported verbatim
+    };
+
+    struct Report {
+        std::uint64_t bytes = 0;
+        std::uint64_t lines = 0;             ///< Non-blank lines
+        std::uint64_t events = 0;            ///< Lines that passed the schema check
+        std::uint64_t devices = 0;
+        std::uint64_t schemaErrors = 0;
+        std::uint64_t sequenceGaps = 0;      ///< Places where sequence numbers were skipped
+        std::uint64_t missingEvents = 0;     ///< Total sequence numbers skipped
+        std::uint64_t duplicates = 0;
+        std::uint64_t timestampRegressions = 0;
+        std::uint64_t unpairedEnters = 0;
+        std::uint64_t unpairedExits = 0;
+        std::uint64_t openFences = 0;        ///< Devices still inside a fence at the end (informational)
+        unsigned threads = 0;
+        std::vector<Violation> samples;      ///< First violations by line number
+
+        std::uint64_t violations() const {
+            return schemaErrors + sequenceGaps + duplicates + timestampRegressions +
+                   unpairedEnters + unpairedExits;
+        }
+        bool ok() const { return violations() == 0; }
+    };
+
+    /**
+     * @brief Verify a buffer of NDJSON events
+     * @param data First byte of the buffer
+     * @param size Buffer length in bytes
+     * @param options Thread count and sample limit
+     */
+    static Report verify(const char* data, std::size_t size, const Options& options);
+
+    static const char* kindName(ViolationKind kind);
+
+    /** @brief Parse "YYYY-MM-DDTHH:MM:SS.mmmZ" to Unix milliseconds; false if malformed */
+    static bool parseTimestamp(const char* text, std::size_t length, std::int64_t& unixMs);
+};
+
+} // namespace tracker
@@ -17,6 +17,7 @@
  */
 
 #include "TwinHandler.hpp"
+#include "Probes.hpp"
 #include <fstream>
 #include <iostream>
 #include <sstream>
@@ -265,6 +266,14 @@ void TwinHandler::processDesiredPatch(const std::string& topic, const std::strin
 }
 
 TwinUpdateResult TwinHandler::applyDesiredAndWriteFile(const nlohmann::json& desired) {
+    const auto applyStart = std::chrono::steady_clock::now();
+    auto traceApply = [&applyStart](const TwinUpdateResult& outcome) {
+        auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now() - applyStart).count();
+        TRACKER_PROBE3(twin_apply, outcome.configVersion.c_str(), static_cast<int>(outcome.status),
+                       static_cast<long long>(elapsed));
+    };
+    
     TwinUpdateResult result;
     result.status = TwinStatus::Success;
     result.appliedAt = getCurrentTimestamp();
@@ -303,6 +312,7 @@ TwinUpdateResult TwinHandler::applyDesiredAndWriteFile(const nlohmann::json& des
         if (!configFile.is_open()) {
             result.status = TwinStatus::FileWriteError;
             result.errorMessage = "Failed to open configuration file: " + std::string(kConfigFilePath);
+            traceApply(result);
             return result;
         }
         
@@ -326,6 +336,7 @@ TwinUpdateResult TwinHandler::applyDesiredAndWriteFile(const nlohmann::json& des
         std::cerr << "TwinHandler: " << result.errorMessage << std::endl;
     }
     
+    traceApply(result);
     return result;
 }
 
@@ -12,6 +12,12 @@ MqttTransportAdapter::MqttTransportAdapter(std::shared_ptr<IMqttClient> mqttClie
     mqttClient_->setConnectionCallback([this](bool connected, const std::string& reason) {
         onMqttConnection(connected, reason);
     });
+
+    mqttClient_->setAckCallback([this](IMqttClient::Ack ack, int qos, bool success) {
+        if (ack == IMqttClient::Ack::Publish && ackHandler_) {
+            ackHandler_(qos, success);
+        }
+    });
 }
 
 bool MqttTransportAdapter::connect(const ports::Credentials& credentials) {
@@ -43,6 +49,10 @@ void MqttTransportAdapter::setConnectionHandler(ConnectionHandler handler) {
     connectionHandler_ = std::move(handler);
 }
 
+void MqttTransportAdapter::setAckHandler(AckHandler handler) {
+    ackHandler_ = std::move(handler);
+}
+
 void MqttTransportAdapter::processEvents() {
     mqttClient_->processEvents();
 }
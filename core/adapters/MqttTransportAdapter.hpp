@@ -20,6 +20,7 @@ public:
 
     void setMessageHandler(MessageHandler handler) override;
     void setConnectionHandler(ConnectionHandler handler) override;
+    void setAckHandler(AckHandler handler) override;
 
     void processEvents() override;
 
@@ -30,6 +31,7 @@ private:
     std::shared_ptr<IMqttClient> mqttClient_;
     MessageHandler messageHandler_;
     ConnectionHandler connectionHandler_;
+    AckHandler ackHandler_;
 };
 
 } // namespace tracker::adapters
\ No newline at end of file
@@ -0,0 +1,104 @@
+/**
+ * @file SpscRing.hpp
+ * @brief Bounded lock-free single-producer/single-consumer ring
+ *
+ * Connects two pipeline stages. The producer only writes tail_, the consumer
+ * only writes head_; each side caches the other's index so the common case
+ * touches no shared cache line.
+ *
+ * @note Exactly one producer thread and one consumer thread at a time
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+namespace tracker::domain {
+
+template <typename T>
+class SpscRing {
+public:
+    /// @param capacity Minimum capacity (rounded up to a power of two)
+    explicit SpscRing(std::size_t capacity) {
+        std::size_t size = 2;
+        while (size < capacity) {
+            size <<= 1;
+        }
+        slots_.resize(size);
+        mask_ = size - 1;
+    }
+
+    SpscRing(const SpscRing&) = delete;
+    SpscRing& operator=(const SpscRing&) = delete;
+
+    // --- Producer side ---
+
+    /** @brief Append an item; false if the ring is full */
+    bool tryPush(T&& value) {
+        std::size_t tail = tail_.load(std::memory_order_relaxed);
+        if (tail - cachedHead_ > mask_) {
+            cachedHead_ = head_.load(std::memory_order_acquire);
+            if (tail - cachedHead_ > mask_) {
+                return false;
+            }
+        }
+        slots_[tail & mask_] = std::move(value);
+        tail_.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    /** @brief Whether the next tryPush() would fail */
+    bool full() {
+        std::size_t tail = tail_.load(std::memory_order_relaxed);
+        if (tail - cachedHead_ > mask_) {
+            cachedHead_ = head_.load(std::memory_order_acquire);
+        }
+        return tail - cachedHead_ > mask_;
+    }
+
+    // --- Consumer side ---
+
+    /** @brief Oldest item, or nullptr if empty (stays queued until pop()) */
+    T* front() {
+        std::size_t head = head_.load(std::memory_order_relaxed);
+        if (head == cachedTail_) {
+            cachedTail_ = tail_.load(std::memory_order_acquire);
+            if (head == cachedTail_) {
+                return nullptr;
+            }
+        }
+        return &slots_[head & mask_];
+    }
+
+    /** @brief Release the item returned by front() */
+    void pop() {
+        std::size_t head = head_.load(std::memory_order_relaxed);
+        slots_[head & mask_] = T{};  // Drop owned buffers now, not on wrap-around
+        head_.store(head + 1, std::memory_order_release);
+    }
+
+    // --- Either side ---
+
+    /** @brief Items queued (exact for either endpoint, a snapshot for observers) */
+    std::size_t size() const {
+        std::size_t head = head_.load(std::memory_order_acquire);
+        std::size_t tail = tail_.load(std::memory_order_acquire);
+        return tail >= head ? tail - head : 0;
+    }
+
+    std::size_t capacity() const { return mask_ + 1; }
+
+private:
+    std::vector<T> slots_;
+    std::size_t mask_ = 0;
+
+    alignas(64) std::atomic<std::size_t> head_{0};   ///< Next slot to consume
+    std::size_t cachedTail_ = 0;                     ///< Consumer's view of tail_
+    alignas(64) std::atomic<std::size_t> tail_{0};   ///< Next slot to produce
+    std::size_t cachedHead_ = 0;                     ///< Producer's view of head_
+};
+
+} // namespace tracker::domain
@@ -1,143 +1,450 @@
 #include "TelemetryPipeline.hpp"
+#include <algorithm>
 #include <iostream>
 
 namespace tracker::domain {
 
+namespace {
+
+constexpr std::array<EventType, 9> kAllEventTypes = {
+    EventType::Heartbeat, EventType::IgnitionOn, EventType::IgnitionOff,
+    EventType::MotionStart, EventType::MotionStop, EventType::GeofenceEnter,
+    EventType::GeofenceExit, EventType::SpeedOverLimit, EventType::LowBattery};
+
+constexpr std::array<PipelineStage, kPipelineStageCount> kStages = {
+    PipelineStage::Filter, PipelineStage::Encode, PipelineStage::Batch, PipelineStage::Publish};
+
+} // namespace
+
 TelemetryPipeline::TelemetryPipeline(std::shared_ptr<ports::ITransport> transport,
                                    std::shared_ptr<ports::IEventBus> eventBus,
-                                   std::shared_ptr<ports::IPolicyEngine> policyEngine)
-    : transport_(transport), eventBus_(eventBus), policyEngine_(policyEngine) {
+                                   std::shared_ptr<ports::IPolicyEngine> policyEngine,
+                                   PipelineOptions options)
+    : transport_(transport), eventBus_(eventBus), policyEngine_(policyEngine),
+      options_(std::move(options)),
+      ingress_(options_.ringCapacity), filtered_(options_.ringCapacity),
+      encoded_(options_.ringCapacity), batched_(options_.ringCapacity) {
+    options_.maxBatchMessages = std::max<std::size_t>(options_.maxBatchMessages, 1);
+}
+
+TelemetryPipeline::~TelemetryPipeline() {
+    stop();
 }
 
 void TelemetryPipeline::start(const std::string& deviceId) {
+    if (running_) return;
+
     deviceId_ = deviceId;
-    running_ = true;
     lastHeartbeat_ = std::chrono::steady_clock::now();
-    
+    running_ = true;
+
+    transport_->setAckHandler([this](int qos, bool success) {
+        onPublishAck(qos, success);
+    });
+
     // Subscribe to all events
-    for (auto eventType : {EventType::Heartbeat, EventType::IgnitionOn, EventType::IgnitionOff,
-                          EventType::MotionStart, EventType::MotionStop, EventType::GeofenceEnter,
-                          EventType::GeofenceExit, EventType::SpeedOverLimit, EventType::LowBattery}) {
+    for (auto eventType : kAllEventTypes) {
         eventBus_->subscribe(eventType, [this](const Event& event) {
             onEvent(event);
         });
     }
+
+    for (auto stage : kStages) {
+        if (isThreaded(stage)) {
+            workers_.emplace_back([this, stage]() { stageLoop(stage); });
+        }
+    }
 }
 
 void TelemetryPipeline::stop() {
-    running_ = false;
+    if (!running_.exchange(false)) return;
+
+    for (auto& worker : workers_) {
+        worker.join();
+    }
+    workers_.clear();
+
     // Unsubscribe from events
-    for (auto eventType : {EventType::Heartbeat, EventType::IgnitionOn, EventType::IgnitionOff,
-                          EventType::MotionStart, EventType::MotionStop, EventType::GeofenceEnter,
-                          EventType::GeofenceExit, EventType::SpeedOverLimit, EventType::LowBattery}) {
+    for (auto eventType : kAllEventTypes) {
         eventBus_->unsubscribe(eventType);
     }
+
+    // Every stage now belongs to this thread: drain what was accepted
+    bool progressed = true;
+    while (progressed) {
+        progressed = false;
+        for (auto stage : kStages) {
+            progressed |= runStage(stage);
+        }
+        progressed |= flushBatch();
+    }
+    transport_->setAckHandler(nullptr);
 }
 
 void TelemetryPipeline::processEvents() {
     if (!running_) return;
-    
-    retryFailedMessages();
-    
-    // Check if heartbeat is due
+
+    // The interval runs from the last acknowledged publish, or the last heartbeat queued
     auto now = std::chrono::steady_clock::now();
-    bool inMotion = lastMotionState_;
-    auto heartbeatInterval = policyEngine_->getReportingPolicy().getHeartbeatInterval(inMotion);
-    
-    if (now - lastHeartbeat_ >= heartbeatInterval) {
+    auto heartbeatInterval = policyEngine_->getReportingPolicy().getHeartbeatInterval(
+        inMotion_.load(std::memory_order_relaxed));
+    std::chrono::steady_clock::time_point lastSent{
+        std::chrono::steady_clock::duration(lastSentNs_.load(std::memory_order_relaxed))};
+
+    // An event already in the stages will restart the interval once it is acknowledged
+    if (now - std::max(lastSent, lastHeartbeat_) >= heartbeatInterval && !eventsInFlight()) {
         Event heartbeat;
         heartbeat.eventType = EventType::Heartbeat;
         heartbeat.deviceId = deviceId_;
+        heartbeat.location = lastLocation_;
+        heartbeat.battery = lastBattery_;
+        heartbeat.network = lastNetwork_;
         eventBus_->publish(heartbeat);
         lastHeartbeat_ = now;
     }
+
+    // Bounded so a busy threaded producer cannot keep this call from returning
+    std::size_t rounds = options_.ringCapacity / kStageBudget + kPipelineStageCount;
+    while (rounds-- > 0 && pumpInline()) {
+    }
+}
+
+StageMetrics TelemetryPipeline::metrics(PipelineStage stage) const {
+    const auto& counters = counters_[static_cast<std::size_t>(stage)];
+    StageMetrics result;
+    result.processed = counters.processed.load(std::memory_order_relaxed);
+    result.busyNs = counters.busyNs.load(std::memory_order_relaxed);
+    result.maxServiceNs = counters.maxServiceNs.load(std::memory_order_relaxed);
+
+    switch (stage) {
+        case PipelineStage::Filter:
+            result.queueDepth = ingress_.size();
+            result.queueCapacity = ingress_.capacity();
+            break;
+        case PipelineStage::Encode:
+            result.queueDepth = filtered_.size();
+            result.queueCapacity = filtered_.capacity();
+            break;
+        case PipelineStage::Batch:
+            result.queueDepth = encoded_.size();
+            result.queueCapacity = encoded_.capacity();
+            break;
+        case PipelineStage::Publish:
+            result.queueDepth = batched_.size();
+            result.queueCapacity = batched_.capacity();
+            break;
+    }
+    return result;
 }
 
 void TelemetryPipeline::onEvent(const Event& event) {
-    if (!running_ || !shouldPublish(event)) return;
-    
-    sendTelemetry(event);
-    
-    // Update state for policy decisions
-    if (event.eventType == EventType::MotionStart) {
-        lastMotionState_ = true;
-    } else if (event.eventType == EventType::MotionStop) {
-        lastMotionState_ = false;
+    if (!running_) return;
+
+    if (event.eventType != EventType::Heartbeat) {
+        lastLocation_ = event.location;
+        lastBattery_ = event.battery;
+        lastNetwork_ = event.network;
+    }
+
+    // A full ring pushes back on the bus; inline stages are ours to advance
+    Event queued = event;
+    if (tracing()) {
+        if (!queued.trace.enabled()) queued.trace.runId = options_.traceRunId;
+        if (queued.trace.generatedUs == 0) queued.trace.generatedUs = traceClockUs();
+    }
+    while (!ingress_.tryPush(std::move(queued))) {
+        if (!pumpInline()) {
+            std::this_thread::yield();
+        }
+    }
+}
+
+bool TelemetryPipeline::eventsInFlight() const {
+    return ingress_.size() > 0 || filtered_.size() > 0 || encoded_.size() > 0 ||
+           batchSize_.load(std::memory_order_relaxed) > 0 || batched_.size() > 0;
+}
+
+bool TelemetryPipeline::runStage(PipelineStage stage) {
+    switch (stage) {
+        case PipelineStage::Filter:  return runFilter();
+        case PipelineStage::Encode:  return runEncode();
+        case PipelineStage::Batch:   return runBatch();
+        case PipelineStage::Publish: return runPublish();
+    }
+    return false;
+}
+
+bool TelemetryPipeline::pumpInline() {
+    bool progressed = false;
+    for (auto stage : kStages) {
+        if (!isThreaded(stage)) {
+            progressed |= runStage(stage);
+        }
+    }
+    return progressed;
+}
+
+void TelemetryPipeline::stageLoop(PipelineStage stage) {
+    while (running_.load(std::memory_order_acquire)) {
+        if (!runStage(stage)) {
+            std::this_thread::sleep_for(kIdleSleep);
+        }
+    }
+}
+
+bool TelemetryPipeline::runFilter() {
+    std::size_t done = 0;
+    while (done < kStageBudget && !filtered_.full()) {
+        Event* event = ingress_.front();
+        if (!event) break;
+
+        auto started = std::chrono::steady_clock::now();
+        if (shouldPublish(*event)) {
+            if (tracing()) event->trace.filteredUs = traceClockUs();
+            filtered_.tryPush(std::move(*event));
+        }
+        ingress_.pop();
+        recordService(PipelineStage::Filter, started);
+        ++done;
     }
+    return done > 0;
 }
 
-void TelemetryPipeline::sendTelemetry(const Event& event) {
+bool TelemetryPipeline::runEncode() {
+    std::size_t done = 0;
+    while (done < kStageBudget && !encoded_.full()) {
+        Event* event = filtered_.front();
+        if (!event) break;
+
+        auto started = std::chrono::steady_clock::now();
+        Outgoing message;
+        message.topic = buildTopic(deviceId_);
+        if (tracing()) event->trace.encodedUs = traceClockUs();
+        message.payload = JsonCodec::serialize(*event);
+        message.events = 1;
+        encoded_.tryPush(std::move(message));
+        filtered_.pop();
+        recordService(PipelineStage::Encode, started);
+        ++done;
+    }
+    return done > 0;
+}
+
+bool TelemetryPipeline::runBatch() {
+    std::size_t done = 0;
+    bool flushed = false;
+    while (done < kStageBudget) {
+        Outgoing* message = encoded_.front();
+        if (!message) break;
+
+        // A batch shares one topic and is capped in size
+        if (!batch_.empty() && (batch_.size() >= options_.maxBatchMessages ||
+                                message->topic != batch_.front().topic)) {
+            if (!flushBatch()) break;
+            flushed = true;
+        }
+
+        auto started = std::chrono::steady_clock::now();
+        if (batch_.empty()) {
+            batchStarted_ = started;
+        }
+        batch_.push_back(std::move(*message));
+        batchSize_.store(batch_.size(), std::memory_order_relaxed);
+        encoded_.pop();
+        recordService(PipelineStage::Batch, started);
+        ++done;
+    }
+
+    // Send a full batch now, a partial one once the input has been idle long enough
+    if (!batch_.empty()) {
+        bool due = batch_.size() >= options_.maxBatchMessages ||
+                   (encoded_.front() == nullptr &&
+                    std::chrono::steady_clock::now() - batchStarted_ >= options_.maxBatchDelay);
+        if (due) {
+            flushed |= flushBatch();
+        }
+    }
+    return done > 0 || flushed;
+}
+
+bool TelemetryPipeline::flushBatch() {
+    if (batch_.empty() || batched_.full()) {
+        return false;
+    }
+
+    auto started = std::chrono::steady_clock::now();
+    Outgoing message;
+    if (batch_.size() == 1) {
+        message = std::move(batch_.front());
+    } else {
+        // JSON array of the encoded events
+        std::size_t bytes = batch_.size() + 1;
+        for (const auto& item : batch_) {
+            bytes += item.payload.size();
+        }
+        message.topic = std::move(batch_.front().topic);
+        message.payload.reserve(bytes);
+        message.payload += '[';
+        for (std::size_t i = 0; i < batch_.size(); ++i) {
+            if (i > 0) {
+                message.payload += ',';
+            }
+            message.payload += batch_[i].payload;
+            message.events += batch_[i].events;
+        }
+        message.payload += ']';
+    }
+    batch_.clear();
+
+    if (options_.compress) {
+        message.payload = options_.compress(std::move(message.payload));
+    }
+    if (tracing()) {
+        message.flushedUs = traceClockUs();
+    }
+
+    batched_.tryPush(std::move(message));
+    batchSize_.store(0, std::memory_order_relaxed);   // After the push: never seen as empty in between
+    recordService(PipelineStage::Batch, started, 0);
+    return true;
+}
+
+bool TelemetryPipeline::runPublish() {
+    bool progressed = retryFailedMessages();
+
+    std::size_t done = 0;
+    while (done < kStageBudget) {
+        Outgoing* message = batched_.front();
+        if (!message) break;
+
+        auto started = std::chrono::steady_clock::now();
+        publishOrQueue(std::move(*message));
+        batched_.pop();
+        recordService(PipelineStage::Publish, started);
+        ++done;
+    }
+    return progressed || done > 0;
+}
+
+void TelemetryPipeline::publishOrQueue(Outgoing&& message) {
+    PendingMessage pending;
+    if (tracing()) {
+        pending.flushedUs = message.flushedUs;
+        pending.dequeuedUs = traceClockUs();
+    }
+
     if (!transport_->isConnected()) {
         // Queue for retry when connection restored
-        PendingMessage msg;
-        msg.event = event;
-        msg.topic = buildTopic(deviceId_, event);
-        msg.payload = codec_.encode(event);
-        msg.nextRetry = std::chrono::steady_clock::now();
-        retryQueue_.push(msg);
+        pending.nextRetry = std::chrono::steady_clock::now();
+    } else if (send(message.topic, message.payload, pending, 1)) {
         return;
-    }
-    
-    std::string topic = buildTopic(deviceId_, event);
-    std::string payload = codec_.encode(event);
-    
-    if (!transport_->publish(topic, payload, 1)) {
+    } else {
         // Failed to publish - add to retry queue
-        PendingMessage msg;
-        msg.event = event;
-        msg.topic = topic;
-        msg.payload = payload;
-        msg.attempts = 1;
-        msg.nextRetry = std::chrono::steady_clock::now() + 
-                       policyEngine_->getRetryPolicy().getBackoffDelay(1);
-        retryQueue_.push(msg);
+        pending.attempts = 1;
+        pending.nextRetry = std::chrono::steady_clock::now() +
+                           policyEngine_->getRetryPolicy().getBackoffDelay(1);
     }
+
+    pending.topic = std::move(message.topic);
+    pending.payload = std::move(message.payload);
+    retryQueue_.push(std::move(pending));
+    retryQueueSize_.store(retryQueue_.size(), std::memory_order_relaxed);
 }
 
-void TelemetryPipeline::retryFailedMessages() {
-    if (retryQueue_.empty() || !transport_->isConnected()) return;
-    
+bool TelemetryPipeline::retryFailedMessages() {
+    if (retryQueue_.empty() || !transport_->isConnected()) return false;
+
     auto now = std::chrono::steady_clock::now();
-    
+    bool progressed = false;
+
     while (!retryQueue_.empty()) {
         auto& msg = retryQueue_.front();
-        
+
         if (msg.nextRetry > now) break;
-        
+
         if (!policyEngine_->getRetryPolicy().shouldRetry(msg.attempts)) {
             std::cout << "Dropping message after " << msg.attempts << " attempts" << std::endl;
             retryQueue_.pop();
+            progressed = true;
             continue;
         }
-        
-        if (transport_->publish(msg.topic, msg.payload, 1)) {
+
+        if (send(msg.topic, msg.payload, msg, msg.attempts + 1)) {
             retryQueue_.pop();
+            progressed = true;
         } else {
             msg.attempts++;
             msg.nextRetry = now + policyEngine_->getRetryPolicy().getBackoffDelay(msg.attempts);
             break; // Try this message again later, keep others in queue
         }
     }
+
+    retryQueueSize_.store(retryQueue_.size(), std::memory_order_relaxed);
+    return progressed;
+}
+
+bool TelemetryPipeline::send(const std::string& topic, const std::string& payload,
+                             const PendingMessage& pending, int attempt) {
+    bool sent;
+    if (!tracing()) {
+        sent = transport_->publish(topic, payload, 1);
+    } else {
+        // IoT Hub property bag: application properties appended to the D2C topic
+        std::string traced = topic;
+        traced += "lt.f=" + std::to_string(pending.flushedUs);
+        traced += "&lt.d=" + std::to_string(pending.dequeuedUs);
+        traced += "&lt.n=" + std::to_string(attempt);
+        traced += "&lt.p=" + std::to_string(traceClockUs());
+        sent = transport_->publish(traced, payload, 1);
+    }
+    return sent;
+}
+
+void TelemetryPipeline::onPublishAck(int qos, bool success) {
+    // Only a PUBACK shows the hub has the message, and with it that the device is alive
+    if (qos >= 1 && success) {
+        lastSentNs_.store(std::chrono::steady_clock::now().time_since_epoch().count(), std::memory_order_relaxed);
+    }
+}
+
+void TelemetryPipeline::recordService(PipelineStage stage, std::chrono::steady_clock::time_point started,
+                                      std::uint64_t items) {
+    auto elapsed = static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now() - started).count());
+
+    // Single writer per stage: plain load/store is enough
+    auto& counters = counters_[static_cast<std::size_t>(stage)];
+    counters.processed.store(counters.processed.load(std::memory_order_relaxed) + items, std::memory_order_relaxed);
+    counters.busyNs.store(counters.busyNs.load(std::memory_order_relaxed) + elapsed, std::memory_order_relaxed);
+    if (elapsed > counters.maxServiceNs.load(std::memory_order_relaxed)) {
+        counters.maxServiceNs.store(elapsed, std::memory_order_relaxed);
+    }
 }
 
-bool TelemetryPipeline::shouldPublish(const Event& event) const {
+bool TelemetryPipeline::shouldPublish(const Event& event) {
     const auto& policy = policyEngine_->getReportingPolicy();
-    
+
     switch (event.eventType) {
         case EventType::Heartbeat:
             return true; // Heartbeats are always sent when scheduled
         case EventType::MotionStart:
         case EventType::MotionStop:
+            // Track motion for the heartbeat interval whether or not it is reported
+            inMotion_.store(event.eventType == EventType::MotionStart, std::memory_order_relaxed);
             return policy.shouldReportMotionChange();
         case EventType::LowBattery:
-            return policy.shouldReportBatteryLevel(event.battery.percentage, lastReportedBatteryPct_);
+            if (!policy.shouldReportBatteryLevel(event.battery.percentage, lastReportedBatteryPct_)) {
+                return false;
+            }
+            lastReportedBatteryPct_ = event.battery.percentage;
+            return true;
         default:
             return true; // All other events are important
     }
 }
 
-std::string TelemetryPipeline::buildTopic(const std::string& deviceId, const Event& event) const {
+std::string TelemetryPipeline::buildTopic(const std::string& deviceId) const {
     return "devices/" + deviceId + "/messages/events/";
 }
 
-} // namespace tracker::domain
\ No newline at end of file
+} // namespace tracker::domain
@@ -1,57 +1,208 @@
+/**
+ * @file TelemetryPipeline.hpp
+ * @brief Staged telemetry path: policy filter → encode → batch/compress → publish
+ *
+ * Events from the bus enter a bounded SPSC ring; each stage drains its input
+ * ring into the next one. A stage runs either inline (pumped by
+ * processEvents()) or on its own thread, so CPU-heavy encoding can overlap
+ * network I/O. Full rings push back on the stage before them instead of
+ * growing without bound.
+ *
+ * With a trace run ID set, each event carries its generation, filter and
+ * encode times in the payload and each publish attempt carries the batch
+ * flush, dequeue and send times as topic properties, so a LatencyConsumer
+ * can break end-to-end latency down by stage.
+ *
+ * Heartbeats are traffic-aware: the interval runs from the last publish the
+ * broker acknowledged (PUBACK), so a device that is sending events anyway
+ * sends no heartbeats. A publish the transport merely accepted proves
+ * nothing; with a transport that reports no acknowledgements, heartbeats
+ * keep their plain interval. A heartbeat that comes due while an event is
+ * still on its way through the stages is left out, since that event proves
+ * liveness just as soon.
+ * Heartbeats carry the location, battery and network status of the latest
+ * event.
+ *
+ * @note Events must be published from the thread that calls processEvents()
+ * @note A threaded publish stage calls the transport from its own thread
+ */
+
 #pragma once
 
+#include "SpscRing.hpp"
 #include "../ports/ITransport.hpp"
 #include "../ports/IEventBus.hpp"
 #include "../ports/IPolicyEngine.hpp"
 #include "../JsonCodec.hpp"
 #include "../Event.hpp"
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
 #include <memory>
 #include <queue>
-#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
 
 namespace tracker::domain {
 
+enum class PipelineStage : std::size_t {
+    Filter,     ///< Reporting policy decisions
+    Encode,     ///< JSON serialization and topic
+    Batch,      ///< Optional batching and compression
+    Publish     ///< Transport publish and retry queue
+};
+
+constexpr std::size_t kPipelineStageCount = 4;
+
+struct PipelineOptions {
+    std::array<bool, kPipelineStageCount> threaded{};   ///< Per stage: own thread (true) or inline
+    std::size_t ringCapacity = 1024;                    ///< Capacity of each inter-stage ring
+    std::size_t maxBatchMessages = 1;                   ///< > 1 publishes JSON arrays of up to N events
+    std::chrono::milliseconds maxBatchDelay{0};         ///< Hold partial batches this long (0 = flush when idle)
+    std::function<std::string(std::string&&)> compress; ///< Optional payload codec (none bundled)
+    std::string traceRunId;                             ///< Non-empty: stamp events and messages (LatencyConsumer)
+
+    void setThreaded(PipelineStage stage, bool onThread = true) {
+        threaded[static_cast<std::size_t>(stage)] = onThread;
+    }
+};
+
+/**
+ * @brief Snapshot of one stage's load
+ */
+struct StageMetrics {
+    std::size_t queueDepth = 0;         ///< Items waiting in the stage's input ring
+    std::size_t queueCapacity = 0;
+    std::uint64_t processed = 0;        ///< Items serviced
+    std::uint64_t busyNs = 0;           ///< Total service time
+    std::uint64_t maxServiceNs = 0;     ///< Slowest single item
+
+    double meanServiceUs() const {
+        return processed ? static_cast<double>(busyNs) / static_cast<double>(processed) / 1000.0 : 0.0;
+    }
+};
+
 class TelemetryPipeline {
 public:
     TelemetryPipeline(std::shared_ptr<ports::ITransport> transport,
                      std::shared_ptr<ports::IEventBus> eventBus,
-                     std::shared_ptr<ports::IPolicyEngine> policyEngine);
+                     std::shared_ptr<ports::IPolicyEngine> policyEngine,
+                     PipelineOptions options = {});
+    ~TelemetryPipeline();
+
+    TelemetryPipeline(const TelemetryPipeline&) = delete;
+    TelemetryPipeline& operator=(const TelemetryPipeline&) = delete;
 
     void start(const std::string& deviceId);
+
+    /** @brief Stop stage threads and drain queued events through to publish */
     void stop();
-    
+
+    /** @brief Send a heartbeat if nothing was published for an interval, then pump the inline stages */
     void processEvents();
-    
+
+    StageMetrics metrics(PipelineStage stage) const;
+
+    /** @brief Messages waiting for a retry (publish stage) */
+    std::size_t retryQueueSize() const { return retryQueueSize_.load(std::memory_order_relaxed); }
+
 private:
-    void onEvent(const Event& event);
-    void sendTelemetry(const Event& event);
-    void retryFailedMessages();
-    
-    bool shouldPublish(const Event& event) const;
-    std::string buildTopic(const std::string& deviceId, const Event& event) const;
-    
+    /// Encoded (possibly batched) message between encode and publish
+    struct Outgoing {
+        std::string topic;
+        std::string payload;
+        std::uint32_t events = 0;
+        std::int64_t flushedUs = 0;     ///< Left the batch stage (tracing only)
+    };
+
     struct PendingMessage {
-        Event event;
         std::string topic;
         std::string payload;
         int attempts = 0;
         std::chrono::steady_clock::time_point nextRetry;
+        std::int64_t flushedUs = 0;     ///< Tracing only
+        std::int64_t dequeuedUs = 0;    ///< Taken by the publish stage (tracing only)
+    };
+
+    /// Written only by the stage's own thread, read by metrics()
+    struct alignas(64) StageCounters {
+        std::atomic<std::uint64_t> processed{0};
+        std::atomic<std::uint64_t> busyNs{0};
+        std::atomic<std::uint64_t> maxServiceNs{0};
     };
-    
+
+    /// Items a stage services per call before yielding to the next stage
+    static constexpr std::size_t kStageBudget = 64;
+
+    /// Sleep of an idle stage thread
+    static constexpr std::chrono::microseconds kIdleSleep{500};
+
+    void onEvent(const Event& event);
+
+    /** @brief Whether events are queued anywhere between the bus and the publish stage */
+    bool eventsInFlight() const;
+
+    bool runStage(PipelineStage stage);
+    bool runFilter();
+    bool runEncode();
+    bool runBatch();
+    bool runPublish();
+    bool pumpInline();
+    void stageLoop(PipelineStage stage);
+
+    bool shouldPublish(const Event& event);
+    bool flushBatch();
+    void publishOrQueue(Outgoing&& message);
+    bool retryFailedMessages();
+    bool send(const std::string& topic, const std::string& payload, const PendingMessage& pending, int attempt);
+    /** @brief Transport acknowledgement: a PUBACK restarts the heartbeat interval */
+    void onPublishAck(int qos, bool success);
+    void recordService(PipelineStage stage, std::chrono::steady_clock::time_point started,
+                       std::uint64_t items = 1);
+    bool isThreaded(PipelineStage stage) const { return options_.threaded[static_cast<std::size_t>(stage)]; }
+    bool tracing() const { return !options_.traceRunId.empty(); }
+
+    std::string buildTopic(const std::string& deviceId) const;
+
     std::shared_ptr<ports::ITransport> transport_;
     std::shared_ptr<ports::IEventBus> eventBus_;
     std::shared_ptr<ports::IPolicyEngine> policyEngine_;
-    
-    JsonCodec codec_;
+    PipelineOptions options_;
+
     std::string deviceId_;
-    bool running_ = false;
-    
+    std::atomic<bool> running_{false};
+
+    // Stage input rings: bus → filter → encode → batch → publish
+    SpscRing<Event> ingress_;
+    SpscRing<Event> filtered_;
+    SpscRing<Outgoing> encoded_;
+    SpscRing<Outgoing> batched_;
+    std::array<StageCounters, kPipelineStageCount> counters_;
+    std::vector<std::thread> workers_;
+
+    // Filter stage state (reporting policies)
+    double lastReportedBatteryPct_ = 100.0;
+    std::atomic<bool> inMotion_{false};     ///< Also read by the heartbeat scheduler
+
+    // Batch stage state
+    std::vector<Outgoing> batch_;
+    std::atomic<std::size_t> batchSize_{0};     ///< batch_.size() for the heartbeat scheduler
+    std::chrono::steady_clock::time_point batchStarted_;
+
+    // Publish stage state
     std::queue<PendingMessage> retryQueue_;
+    std::atomic<std::size_t> retryQueueSize_{0};
+
+    // Heartbeat scheduler (processEvents() thread)
+    std::atomic<std::int64_t> lastSentNs_{0};   ///< steady_clock time of the last acknowledged publish
     std::chrono::steady_clock::time_point lastHeartbeat_;
-    
-    // State for reporting policies
-    double lastReportedBatteryPct_ = 100.0;
-    bool lastMotionState_ = false;
+    Location lastLocation_;                     ///< Status of the latest event, carried by heartbeats
+    BatteryInfo lastBattery_;
+    NetworkInfo lastNetwork_;
 };
 
-} // namespace tracker::domain
\ No newline at end of file
+} // namespace tracker::domain
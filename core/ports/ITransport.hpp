@@ -20,6 +20,8 @@ public:
     
     using MessageHandler = std::function<void(std::string_view topic, std::string_view payload)>;
     using ConnectionHandler = std::function<void(bool connected, std::string_view reason)>;
+    /// Broker acknowledgement of a publish: PUBACK for QoS 1, send completion for QoS 0
+    using AckHandler = std::function<void(int qos, bool success)>;
     
     virtual bool connect(const Credentials& credentials) = 0;
     virtual void disconnect() = 0;
@@ -30,6 +32,8 @@ public:
     
     virtual void setMessageHandler(MessageHandler handler) = 0;
     virtual void setConnectionHandler(ConnectionHandler handler) = 0;
+    /// Optional: transports that cannot report acknowledgements never call the handler
+    virtual void setAckHandler(AckHandler handler) { (void)handler; }
     
     virtual void processEvents() = 0;
 };
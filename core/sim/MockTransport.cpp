@@ -40,10 +40,19 @@ bool MockTransport::publish(std::string_view topic, std::string_view payload, in
     msg.timestamp = std::chrono::steady_clock::now();
     
     publishedMessages_.push_back(msg);
+    if (publishObserver_) {
+        publishObserver_(topic, payload);
+    }
+    if (!autoAck_) {
+        unacknowledged_.push(qos);
+    } else if (ackHandler_) {
+        ackHandler_(qos, true);
+    }
     return true;
 }
 
 bool MockTransport::subscribe(std::string_view topic, int qos) {
+    (void)qos;  // Suppress unused parameter warning - the mock grants every subscription as requested
     if (!connected_) return false;
     
     auto topicStr = std::string(topic);
@@ -61,6 +70,22 @@ void MockTransport::setConnectionHandler(ConnectionHandler handler) {
     connectionHandler_ = std::move(handler);
 }
 
+void MockTransport::setAckHandler(AckHandler handler) {
+    ackHandler_ = std::move(handler);
+}
+
+std::size_t MockTransport::acknowledge(bool success) {
+    std::size_t count = unacknowledged_.size();
+    while (!unacknowledged_.empty()) {
+        int qos = unacknowledged_.front();
+        unacknowledged_.pop();
+        if (ackHandler_) {
+            ackHandler_(qos, success);
+        }
+    }
+    return count;
+}
+
 void MockTransport::processEvents() {
     // Process incoming messages
     while (!incomingMessages_.empty()) {
@@ -30,6 +30,7 @@ public:
 
     void setMessageHandler(MessageHandler handler) override;
     void setConnectionHandler(ConnectionHandler handler) override;
+    void setAckHandler(AckHandler handler) override;
 
     void processEvents() override;
 
@@ -42,18 +43,30 @@ public:
     const std::vector<MockMessage>& getPublishedMessages() const { return publishedMessages_; }
     void clearPublishedMessages() { publishedMessages_.clear(); }
     
+    /** @brief Broker stand-in: observer sees every accepted publish, as a D2C subscriber would */
+    void setPublishObserver(MessageHandler observer) { publishObserver_ = std::move(observer); }
+
     bool shouldFailPublish() const { return failPublish_; }
     void setFailPublish(bool fail) { failPublish_ = fail; }
 
+    /** @brief Acknowledge each publish as it is accepted (default), or hold acknowledgements for acknowledge() */
+    void setAutoAck(bool autoAck) { autoAck_ = autoAck; }
+    /** @brief Deliver the held acknowledgements in publish order; returns how many */
+    std::size_t acknowledge(bool success = true);
+
 private:
     bool connected_ = false;
     bool failPublish_ = false;
+    bool autoAck_ = true;
     
     MessageHandler messageHandler_;
     ConnectionHandler connectionHandler_;
+    AckHandler ackHandler_;
+    MessageHandler publishObserver_;
     
     std::vector<MockMessage> publishedMessages_;
     std::queue<MockMessage> incomingMessages_;
+    std::queue<int> unacknowledged_;    ///< QoS of each held acknowledgement
     std::vector<std::string> subscriptions_;
     
     ports::Credentials lastCredentials_;
@@ -20,6 +20,11 @@
 #include <openssl/evp.h>
 #include <openssl/bio.h>
 #include <openssl/buffer.h>
+#include <openssl/opensslv.h>
+#if OPENSSL_VERSION_NUMBER >= 0x30000000L
+#include <openssl/core_names.h>
+#include <openssl/params.h>
+#endif
 #include <sstream>
 #include <iomanip>
 #include <chrono>
@@ -80,6 +85,40 @@ std::string SasToken::generate(const std::string& host,
     std::transform(lowerHost.begin(), lowerHost.end(), lowerHost.begin(), ::tolower);
     std::string resourceUri = lowerHost + "/devices/" + deviceId;
     
+    return sign(resourceUri, deviceKeyBase64, expiryEpochSeconds);
+}
+
+/**
+ * @brief Generate DPS registration SAS token (symmetric-key attestation)
+ * 
+ * The resource URI is the registration path under the ID scope, and DPS
+ * requires the key name "registration" for device-level credentials.
+ * 
+ * @param idScope DPS ID scope
+ * @param registrationId Device registration ID (case-sensitive)
+ * @param deviceKeyBase64 Base64-encoded device key (e.g. from deriveDeviceKey)
+ * @param expiryEpochSeconds Token expiry time as Unix timestamp
+ * @return MQTT password for the DPS CONNECT
+ */
+std::string SasToken::generateDps(const std::string& idScope,
+                                  const std::string& registrationId,
+                                  const std::string& deviceKeyBase64,
+                                  uint64_t expiryEpochSeconds) {
+    std::string resourceUri = idScope + "/registrations/" + registrationId;
+    return sign(resourceUri, deviceKeyBase64, expiryEpochSeconds) + "&skn=registration";
+}
+
+/**
+ * @brief Sign a resource URI and assemble the SAS token fields
+ * 
+ * @param resourceUri Resource URI (URL-encoded here)
+ * @param deviceKeyBase64 Base64-encoded signing key
+ * @param expiryEpochSeconds Token expiry time as Unix timestamp
+ * @return "SharedAccessSignature sr=...&sig=...&se=..."
+ */
+std::string SasToken::sign(const std::string& resourceUri,
+                           const std::string& deviceKeyBase64,
+                           uint64_t expiryEpochSeconds) {
     // Create string-to-sign with URL-encoded resource URI
     std::string stringToSign = createStringToSign(resourceUri, expiryEpochSeconds);
     
@@ -97,6 +136,99 @@ std::string SasToken::generate(const std::string& host,
     return token.str();
 }
 
+/**
+ * @brief Derive a device key from a DPS group enrollment key
+ * 
+ * @param groupKeyBase64 Base64-encoded enrollment group key
+ * @param registrationId Device registration ID
+ * @return Base64-encoded device key, or empty string on failure
+ */
+std::string SasToken::deriveDeviceKey(const std::string& groupKeyBase64,
+                                      const std::string& registrationId) {
+    auto keys = deriveDeviceKeys(groupKeyBase64, {registrationId});
+    return keys.empty() ? std::string() : keys.front();
+}
+
+/**
+ * @brief Derive device keys in bulk from a DPS group enrollment key
+ * 
+ * HMAC keying (hashing the key into the inner/outer pads) happens once;
+ * each device then costs one re-initialization, update and final. Output
+ * is Base64-encoded straight from the digest without a BIO chain.
+ * 
+ * @param groupKeyBase64 Base64-encoded enrollment group key
+ * @param registrationIds Device registration IDs
+ * @return Base64-encoded device keys in input order, or empty on failure
+ * 
+ * @note OpenSSL 3 uses EVP_MAC; older releases use HMAC_CTX
+ */
+std::vector<std::string> SasToken::deriveDeviceKeys(const std::string& groupKeyBase64,
+                                                    const std::vector<std::string>& registrationIds) {
+    std::string groupKey = base64Decode(groupKeyBase64);
+    if (groupKey.empty()) {
+        return {};
+    }
+    const auto* key = reinterpret_cast<const unsigned char*>(groupKey.data());
+    
+    std::vector<std::string> keys;
+    keys.reserve(registrationIds.size());
+    unsigned char digest[EVP_MAX_MD_SIZE];
+    char encoded[4 * ((EVP_MAX_MD_SIZE + 2) / 3) + 1];
+    
+    auto append = [&](std::size_t digestLength) {
+        int length = EVP_EncodeBlock(reinterpret_cast<unsigned char*>(encoded), digest,
+                                     static_cast<int>(digestLength));
+        keys.emplace_back(encoded, static_cast<std::size_t>(length));
+    };
+    
+#if OPENSSL_VERSION_NUMBER >= 0x30000000L
+    EVP_MAC* mac = EVP_MAC_fetch(nullptr, "HMAC", nullptr);
+    EVP_MAC_CTX* ctx = mac ? EVP_MAC_CTX_new(mac) : nullptr;
+    char digestName[] = "SHA256";
+    OSSL_PARAM params[] = {
+        OSSL_PARAM_construct_utf8_string(OSSL_MAC_PARAM_DIGEST, digestName, 0),
+        OSSL_PARAM_construct_end()
+    };
+    
+    bool ok = ctx && EVP_MAC_init(ctx, key, groupKey.size(), params) == 1;
+    for (std::size_t i = 0; ok && i < registrationIds.size(); ++i) {
+        const auto& id = registrationIds[i];
+        std::size_t digestLength = 0;
+        // A null key re-initializes with the pads computed above
+        ok = (i == 0 || EVP_MAC_init(ctx, nullptr, 0, nullptr) == 1) &&
+             EVP_MAC_update(ctx, reinterpret_cast<const unsigned char*>(id.data()), id.size()) == 1 &&
+             EVP_MAC_final(ctx, digest, &digestLength, sizeof(digest)) == 1;
+        if (ok) {
+            append(digestLength);
+        }
+    }
+    
+    EVP_MAC_CTX_free(ctx);
+    EVP_MAC_free(mac);
+#else
+    HMAC_CTX* ctx = HMAC_CTX_new();
+    
+    bool ok = ctx && HMAC_Init_ex(ctx, key, static_cast<int>(groupKey.size()), EVP_sha256(), nullptr) == 1;
+    for (std::size_t i = 0; ok && i < registrationIds.size(); ++i) {
+        const auto& id = registrationIds[i];
+        unsigned int digestLength = 0;
+        ok = (i == 0 || HMAC_Init_ex(ctx, nullptr, 0, nullptr, nullptr) == 1) &&
+             HMAC_Update(ctx, reinterpret_cast<const unsigned char*>(id.data()), id.size()) == 1 &&
+             HMAC_Final(ctx, digest, &digestLength) == 1;
+        if (ok) {
+            append(digestLength);
+        }
+    }
+    
+    HMAC_CTX_free(ctx);
+#endif
+    
+    if (!ok) {
+        keys.clear();
+    }
+    return keys;
+}
+
 /**
  * @brief Create string-to-sign for HMAC computation
  * 
@@ -167,7 +299,7 @@ std::string SasToken::base64Encode(const std::string& data) {
     
     // Encode data and flush output
     BIO_write(bio, data.c_str(), static_cast<int>(data.length()));
-    BIO_flush(bio);
+    (void)BIO_flush(bio);
     
     // Extract encoded result
     BUF_MEM* bufferPtr;
@@ -2,6 +2,7 @@
 
 #include <string>
 #include <cstdint>
+#include <vector>
 
 namespace tracker {
 
@@ -20,11 +21,43 @@ public:
                                const std::string& deviceKeyBase64,
                                uint64_t expiryEpochSeconds);
     
+    /**
+     * @brief DPS registration token for symmetric-key attestation
+     *
+     * Signs "{idScope}/registrations/{registrationId}" and appends
+     * skn=registration, as DPS expects in the MQTT password.
+     */
+    static std::string generateDps(const std::string& idScope,
+                                   const std::string& registrationId,
+                                   const std::string& deviceKeyBase64,
+                                   uint64_t expiryEpochSeconds);
+    
+    /**
+     * @brief Device key of a DPS group enrollment
+     * @return Base64(HMAC-SHA256(groupKey, registrationId)), empty on failure
+     */
+    static std::string deriveDeviceKey(const std::string& groupKeyBase64,
+                                       const std::string& registrationId);
+    
+    /**
+     * @brief Derive device keys for many registration IDs (fleet startup)
+     *
+     * Keys the HMAC context once and re-initializes it per device, so the
+     * group key's inner/outer pads are computed a single time.
+     *
+     * @return One key per registration ID, or empty if the group key is invalid
+     */
+    static std::vector<std::string> deriveDeviceKeys(const std::string& groupKeyBase64,
+                                                     const std::vector<std::string>& registrationIds);
+    
     static std::string urlEncode(const std::string& value);
     static std::string base64Decode(const std::string& encoded);
     static std::string base64Encode(const std::string& data);
     
 private:
+    static std::string sign(const std::string& resourceUri,
+                            const std::string& deviceKeyBase64,
+                            uint64_t expiryEpochSeconds);
     static std::string hmacSha256(const std::string& key, const std::string& message);
     static std::string createStringToSign(const std::string& resourceUri, uint64_t expiry);
 };
@@ -0,0 +1,61 @@
+#include "Sha256.hpp"
+#include <openssl/evp.h>
+#include <cstdio>
+#include <vector>
+
+namespace tracker {
+
+namespace {
+EVP_MD_CTX* asContext(void* context) {
+    return static_cast<EVP_MD_CTX*>(context);
+}
+}
+
+Sha256::Sha256()
+    : context_(EVP_MD_CTX_new()) {
+    reset();
+}
+
+Sha256::~Sha256() {
+    EVP_MD_CTX_free(asContext(context_));
+}
+
+void Sha256::reset() {
+    EVP_DigestInit_ex(asContext(context_), EVP_sha256(), nullptr);
+}
+
+void Sha256::update(const void* data, std::size_t length) {
+    EVP_DigestUpdate(asContext(context_), data, length);
+}
+
+std::string Sha256::finalHex() {
+    static const char kHex[] = "0123456789abcdef";
+    unsigned char digest[EVP_MAX_MD_SIZE];
+    unsigned int length = 0;
+    EVP_DigestFinal_ex(asContext(context_), digest, &length);
+    std::string hex;
+    hex.reserve(length * 2);
+    for (unsigned int i = 0; i < length; ++i) {
+        hex += kHex[digest[i] >> 4];
+        hex += kHex[digest[i] & 0x0f];
+    }
+    return hex;
+}
+
+std::string Sha256::fileHex(const std::string& path) {
+    FILE* file = std::fopen(path.c_str(), "rb");
+    if (!file) {
+        return "";
+    }
+    Sha256 hash;
+    std::vector<unsigned char> buffer(1 << 16);
+    std::size_t n;
+    while ((n = std::fread(buffer.data(), 1, buffer.size(), file)) > 0) {
+        hash.update(buffer.data(), n);
+    }
+    bool failed = std::ferror(file) != 0;
+    std::fclose(file);
+    return failed ? "" : hash.finalHex();
+}
+
+} // namespace tracker
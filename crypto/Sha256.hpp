@@ -0,0 +1,40 @@
+/**
+ * @file Sha256.hpp
+ * @brief Incremental SHA-256 for verifying large images while they stream
+ *
+ * Data is hashed as it arrives, so a multi-megabyte firmware image is never
+ * held in memory to be checked. The OpenSSL context stays out of the header,
+ * so an mbedTLS build can swap the implementation without touching callers.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <string>
+
+namespace tracker {
+
+class Sha256 {
+public:
+    Sha256();
+    ~Sha256();
+
+    Sha256(const Sha256&) = delete;
+    Sha256& operator=(const Sha256&) = delete;
+
+    /** @brief Start a new digest */
+    void reset();
+
+    void update(const void* data, std::size_t length);
+
+    /** @brief Finish the digest as lowercase hex; call reset() before reusing */
+    std::string finalHex();
+
+    /** @brief Digest of a whole file as lowercase hex, empty if it cannot be read */
+    static std::string fileHex(const std::string& path);
+
+private:
+    void* context_;   ///< EVP_MD_CTX
+};
+
+} // namespace tracker
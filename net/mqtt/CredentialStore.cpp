@@ -0,0 +1,266 @@
+#include "CredentialStore.hpp"
+#include "TlsHooks.hpp"
+#include <openssl/bio.h>
+#include <openssl/err.h>
+#include <openssl/evp.h>
+#include <openssl/pem.h>
+#include <openssl/ssl.h>
+#include <openssl/x509.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <mutex>
+#include <shared_mutex>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+
+namespace tracker {
+
+namespace {
+
+/// Files per parser thread below which more threads do not pay off
+constexpr std::size_t kFilesPerThread = 32;
+
+/// One path may hold a chain, a key or both (combined PEM)
+struct Credential {
+    std::vector<X509*> chain;   ///< Leaf first (empty without hooks)
+    EVP_PKEY* key = nullptr;    ///< Null without hooks
+    bool hasChain = false;      ///< Parsed as a chain
+    bool hasKey = false;        ///< Parsed as a key
+    std::size_t chainLength = 0;  ///< Certificates in the chain file
+};
+
+// Never freed: Paho's threads may load credentials until exit
+std::shared_mutex g_mutex;
+auto* g_credentials = new std::unordered_map<std::string, Credential>();
+std::atomic<bool> g_active{false};
+
+// Never prompt on the terminal for an encrypted key
+int noPassword(char*, int, int, void*) {
+    return -1;
+}
+
+std::string openSslError() {
+    char text[256] = "unknown error";
+    if (unsigned long code = ERR_peek_last_error()) {
+        ERR_error_string_n(code, text, sizeof(text));
+    }
+    ERR_clear_error();
+    return text;
+}
+
+bool readFile(const std::string& path, std::string& data, std::string& error) {
+    FILE* file = std::fopen(path.c_str(), "rb");
+    if (!file) {
+        error = path + ": cannot open";
+        return false;
+    }
+    char buffer[16384];
+    std::size_t n;
+    data.clear();
+    while ((n = std::fread(buffer, 1, sizeof(buffer), file)) > 0) {
+        data.append(buffer, n);
+    }
+    std::fclose(file);
+    return true;
+}
+
+void release(Credential& credential) {
+    for (X509* certificate : credential.chain) X509_free(certificate);
+    credential.chain.clear();
+    EVP_PKEY_free(credential.key);
+    credential.key = nullptr;
+}
+
+bool has(const Credential& credential, bool isKey) {
+    return isKey ? credential.hasKey : credential.hasChain;
+}
+
+/// Add a parsed chain or key to a path's entry (caller holds the unique lock)
+void merge(const std::string& path, Credential& parsed, bool isKey) {
+    auto& entry = (*g_credentials)[path];
+    if (has(entry, isKey)) {
+        release(parsed);
+    } else if (isKey) {
+        entry.key = parsed.key;
+        entry.hasKey = true;
+    } else {
+        entry.chain = std::move(parsed.chain);
+        entry.hasChain = true;
+    }
+}
+
+/// Same reading rules as SSL_CTX_use_certificate_chain_file / SSL_CTX_use_PrivateKey_file
+bool load(const std::string& path, bool isKey, Credential& credential, std::string& error) {
+    std::string data;
+    if (!readFile(path, data, error)) {
+        return false;
+    }
+    BIO* bio = BIO_new_mem_buf(data.data(), static_cast<int>(data.size()));
+    if (!bio) {
+        error = path + ": out of memory";
+        return false;
+    }
+
+    if (isKey) {
+        credential.key = PEM_read_bio_PrivateKey(bio, nullptr, noPassword, nullptr);
+    } else if (X509* leaf = PEM_read_bio_X509_AUX(bio, nullptr, noPassword, nullptr)) {
+        credential.chain.push_back(leaf);
+        while (X509* next = PEM_read_bio_X509(bio, nullptr, noPassword, nullptr)) {
+            credential.chain.push_back(next);
+        }
+        // The loop ends on "no start line" at the end of the file
+        ERR_clear_error();
+    }
+    BIO_free(bio);
+
+    if (isKey ? !credential.key : credential.chain.empty()) {
+        error = path + ": " + openSslError();
+        return false;
+    }
+    (isKey ? credential.hasKey : credential.hasChain) = true;
+    credential.chainLength = credential.chain.size();
+#if !defined(TRACKER_TLS_HOOKS)
+    // Nothing can use the parsed objects; keep only the fact that the file is valid
+    release(credential);
+#endif
+    return true;
+}
+
+#if defined(TRACKER_TLS_HOOKS)
+/// Loaded credential for a path, parsing it on first use; nullptr when not in use or unreadable
+const Credential* find(const char* path, bool isKey) {
+    if (!path || !g_active.load(std::memory_order_acquire)) {
+        return nullptr;
+    }
+    {
+        std::shared_lock<std::shared_mutex> lock(g_mutex);
+        auto it = g_credentials->find(path);
+        if (it != g_credentials->end() && has(it->second, isKey)) {
+            return &it->second;
+        }
+    }
+    Credential credential;
+    std::string error;
+    if (!load(path, isKey, credential, error)) {
+        return nullptr;
+    }
+    std::unique_lock<std::shared_mutex> lock(g_mutex);
+    merge(path, credential, isKey);
+    return &g_credentials->at(path);   // Node addresses are stable across rehashing
+}
+#endif
+
+} // namespace
+
+CredentialStore::LoadReport CredentialStore::preload(const std::vector<std::string>& chainFiles,
+                                                     const std::vector<std::string>& keyFiles,
+                                                     unsigned threads) {
+    auto started = std::chrono::steady_clock::now();
+    LoadReport report;
+
+    struct Job {
+        const std::string* path;
+        bool isKey;
+        Credential credential;
+        std::string error;
+        bool ok = false;
+    };
+    std::vector<Job> jobs;
+    {
+        std::shared_lock<std::shared_mutex> lock(g_mutex);
+        std::unordered_set<std::string> seen;
+        for (const auto* files : {&chainFiles, &keyFiles}) {
+            for (const auto& path : *files) {
+                bool isKey = files == &keyFiles;
+                auto it = g_credentials->find(path);
+                if (path.empty() || (it != g_credentials->end() && has(it->second, isKey)) ||
+                    !seen.insert(path + (isKey ? "\n(key)" : "")).second) {
+                    continue;
+                }
+                jobs.push_back({&path, isKey, {}, {}, false});
+            }
+        }
+    }
+    report.files = jobs.size();
+
+    unsigned hardware = std::max(1u, std::thread::hardware_concurrency());
+    report.threads = static_cast<unsigned>(
+        std::clamp<std::size_t>(jobs.size() / kFilesPerThread, 1, threads ? threads : hardware));
+    std::atomic<std::size_t> nextJob{0};
+    auto work = [&]() {
+        for (std::size_t i; (i = nextJob.fetch_add(1, std::memory_order_relaxed)) < jobs.size();) {
+            auto& job = jobs[i];
+            job.ok = load(*job.path, job.isKey, job.credential, job.error);
+        }
+    };
+    std::vector<std::thread> workers;
+    for (unsigned i = 1; i < report.threads; ++i) {
+        workers.emplace_back(work);
+    }
+    work();
+    for (auto& worker : workers) worker.join();
+
+    {
+        std::unique_lock<std::shared_mutex> lock(g_mutex);
+        for (auto& job : jobs) {
+            if (!job.ok) {
+                if (report.failed++ == 0) report.firstError = job.error;
+                continue;
+            }
+            if (job.isKey) {
+                ++report.keys;
+            } else {
+                report.certificates += job.credential.chainLength;
+            }
+            merge(*job.path, job.credential, job.isKey);
+        }
+    }
+    g_active.store(true, std::memory_order_release);
+    report.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - started).count();
+    return report;
+}
+
+bool CredentialStore::contains(const std::string& path) {
+    std::shared_lock<std::shared_mutex> lock(g_mutex);
+    return g_credentials->count(path) != 0;
+}
+
+bool CredentialStore::servesTls() {
+    return hooks::sslInterposed();
+}
+
+std::size_t CredentialStore::size() {
+    std::shared_lock<std::shared_mutex> lock(g_mutex);
+    return g_credentials->size();
+}
+
+#if defined(TRACKER_TLS_HOOKS)
+int hooks::storedChain(SSL_CTX* context, const char* file) {
+    const auto* credential = find(file, false);
+    if (!credential) {
+        return -1;
+    }
+    if (SSL_CTX_use_certificate(context, credential->chain.front()) != 1 || !SSL_CTX_clear_chain_certs(context)) {
+        return 0;
+    }
+    for (std::size_t i = 1; i < credential->chain.size(); ++i) {
+        if (!SSL_CTX_add1_chain_cert(context, credential->chain[i])) {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+int hooks::storedKey(SSL_CTX* context, const char* file, int type) {
+    const auto* credential = type == SSL_FILETYPE_PEM ? find(file, true) : nullptr;
+    if (!credential) {
+        return -1;
+    }
+    return SSL_CTX_use_PrivateKey(context, credential->key);
+}
+#endif
+
+} // namespace tracker
@@ -0,0 +1,67 @@
+/**
+ * @file CredentialStore.hpp
+ * @brief In-memory keystore of parsed device certificate chains and private keys
+ *
+ * An X.509 fleet has one certificate chain and one private key per device.
+ * Without the store, every connect first opens each file to check it
+ * exists. Paho then opens each file again and parses the PEM, one device at
+ * a time on the connecting thread. preload() reads and parses all of them
+ * on a pool of threads before the fleet starts and keeps the parsed X509
+ * and EVP_PKEY objects.
+ *
+ * Paho takes credentials only as file paths. Where the libssl hooks are
+ * built (TRACKER_TLS_HOOKS: Linux, shared libssl), the store serves
+ * SSL_CTX_use_certificate_chain_file() and SSL_CTX_use_PrivateKey_file()
+ * through the interposed functions in TlsHooks.cpp.
+ * A path the store knows is then served from memory and shared by
+ * reference. A path it does not know is parsed on first use and kept. Other
+ * builds keep only the validation: bad files are reported before any device
+ * connects, and the files are in the page cache when Paho reads them.
+ *
+ * @note Keys must be unencrypted; encrypted keys fail preload and Paho reads them with its password callback
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace tracker {
+
+class CredentialStore {
+public:
+    struct LoadReport {
+        std::size_t files = 0;         ///< Distinct paths requested
+        std::size_t certificates = 0;  ///< Certificates parsed (all chain members)
+        std::size_t keys = 0;          ///< Private keys parsed
+        std::size_t failed = 0;        ///< Files that could not be read or parsed
+        std::string firstError;        ///< Path and reason of the first failure
+        unsigned threads = 0;
+        double seconds = 0.0;
+
+        double certificatesPerSecond() const {
+            return seconds > 0.0 ? static_cast<double>(certificates) / seconds : 0.0;
+        }
+    };
+
+    /**
+     * @brief Read and parse chains and keys in parallel
+     * @param chainFiles PEM certificate chains (leaf first); duplicates are loaded once
+     * @param keyFiles PEM private keys
+     * @param threads Parser threads (0 = hardware concurrency)
+     * @note Failed files are left out; Paho then reads them itself and reports the error
+     */
+    static LoadReport preload(const std::vector<std::string>& chainFiles, const std::vector<std::string>& keyFiles,
+                              unsigned threads = 0);
+
+    /** @brief Whether a path was loaded (connects skip the file checks) */
+    static bool contains(const std::string& path);
+
+    /** @brief Whether TLS contexts are fed from memory (libssl hooks built) */
+    static bool servesTls();
+
+    static std::size_t size();
+};
+
+} // namespace tracker
@@ -0,0 +1,87 @@
+#include "KernelTls.hpp"
+#include "TlsHooks.hpp"
+#include <openssl/opensslv.h>
+#include <openssl/opensslconf.h>
+#include <atomic>
+#include <fstream>
+#include <sstream>
+
+namespace tracker {
+
+namespace {
+
+constexpr const char* kTlsStatPath = "/proc/net/tls_stat";
+
+std::atomic<bool> g_enabled{false};
+
+} // namespace
+
+KernelTls::Status KernelTls::probe() {
+    Status status;
+#if !defined(__linux__)
+    status.reason = "kernel TLS needs Linux";
+#elif OPENSSL_VERSION_NUMBER < 0x30000000L || defined(OPENSSL_NO_KTLS)
+    status.reason = "OpenSSL built without kTLS support (" OPENSSL_VERSION_TEXT ")";
+#else
+    if (!counters().present) {
+        status.reason = "tls kernel module not loaded (modprobe tls)";
+    } else {
+        status.available = true;
+    }
+#endif
+    return status;
+}
+
+KernelTls::Status KernelTls::enable() {
+    auto status = probe();
+    if (!status.available) {
+        return status;
+    }
+    if (!hooks::sslInterposed()) {
+        status.available = false;
+        status.reason = "TLS hooks need a shared libssl; Paho's contexts cannot be reached";
+        return status;
+    }
+    g_enabled.store(true, std::memory_order_release);
+    return status;
+}
+
+bool KernelTls::enabled() {
+    return g_enabled.load(std::memory_order_acquire);
+}
+
+#if defined(TRACKER_TLS_HOOKS)
+void hooks::kernelTlsContext(SSL_CTX* context) {
+#if defined(SSL_OP_ENABLE_KTLS)
+    if (KernelTls::enabled()) {
+        SSL_CTX_set_options(context, SSL_OP_ENABLE_KTLS);
+    }
+#else
+    (void)context;
+#endif
+}
+#endif
+
+KernelTls::Counters KernelTls::counters() {
+    Counters counters;
+    std::ifstream file(kTlsStatPath);
+    if (!file.is_open()) {
+        return counters;
+    }
+    counters.present = true;
+
+    std::string line;
+    while (std::getline(file, line)) {
+        std::istringstream fields(line);
+        std::string name;
+        std::uint64_t value = 0;
+        if (!(fields >> name >> value)) continue;
+        if (name == "TlsCurrTxSw") counters.currentTxSoftware = value;
+        else if (name == "TlsCurrTxDevice") counters.currentTxDevice = value;
+        else if (name == "TlsTxSw") counters.totalTxSoftware = value;
+        else if (name == "TlsTxDevice") counters.totalTxDevice = value;
+    }
+    return counters;
+}
+
+} // namespace tracker
@@ -0,0 +1,64 @@
+/**
+ * @file KernelTls.hpp
+ * @brief Opt-in Linux kernel TLS (kTLS) offload for MQTT connections
+ *
+ * With kTLS, OpenSSL performs the handshake and then hands the negotiated
+ * keys to the kernel, which encrypts records inside send(). That saves a
+ * user-space copy and the AES-GCM work per message on the telemetry path,
+ * and it lets pre-encoded data go out with sendfile()/splice().
+ *
+ * Paho creates its own SSL_CTX objects and does not expose them. After
+ * enable(), the interposed SSL_CTX_new() (TlsHooks.cpp) sets
+ * SSL_OP_ENABLE_KTLS on each context Paho creates. The process's OpenSSL
+ * configuration, including the system MinProtocol and security level, is
+ * left alone. The hook needs a shared libssl on Linux (TRACKER_TLS_HOOKS).
+ *
+ * Fallback is per connection and silent. If the kernel refuses the offload,
+ * for example because the cipher is unsupported, OpenSSL keeps encrypting in
+ * user space. counters() reads /proc/net/tls_stat to show how many sessions
+ * actually use the offload.
+ *
+ * @note Linux with OpenSSL 3 built with enable-ktls and the `tls` module loaded
+ * @note See tls-bench for CPU per MB with and without the offload
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+namespace tracker {
+
+class KernelTls {
+public:
+    struct Status {
+        bool available = false;   ///< Offload can be requested on this host
+        std::string reason;       ///< Why not (empty when available)
+    };
+
+    /// System-wide kTLS session counters from /proc/net/tls_stat
+    struct Counters {
+        bool present = false;               ///< tls module loaded
+        std::uint64_t currentTxSoftware = 0;  ///< Open sessions with kernel (software) encryption
+        std::uint64_t currentTxDevice = 0;    ///< Open sessions offloaded to the NIC
+        std::uint64_t totalTxSoftware = 0;
+        std::uint64_t totalTxDevice = 0;
+    };
+
+    /** @brief Whether OpenSSL and the kernel support the offload */
+    static Status probe();
+
+    /**
+     * @brief Request kTLS for every TLS context this process creates
+     * @return available = false with the reason if the offload cannot be requested
+     * @note Applies to contexts created afterwards; call before the first connection
+     */
+    static Status enable();
+
+    /** @brief Whether enable() succeeded */
+    static bool enabled();
+
+    static Counters counters();
+};
+
+} // namespace tracker
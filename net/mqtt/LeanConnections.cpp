@@ -0,0 +1,121 @@
+#include "LeanConnections.hpp"
+#include "TlsHooks.hpp"
+#include <atomic>
+#include <cstdint>
+#include <fstream>
+#include <map>
+#include <mutex>
+
+#if defined(__linux__)
+#include <unistd.h>
+#endif
+#if defined(__GLIBC__)
+#include <malloc.h>
+#endif
+
+#if defined(TRACKER_TLS_HOOKS)
+#include <openssl/ssl.h>
+#include <openssl/x509_vfy.h>
+#endif
+
+namespace tracker {
+
+namespace {
+
+std::atomic<bool> g_enabled{false};
+
+#if defined(TRACKER_TLS_HOOKS)
+/// Requested record size; heartbeat and event payloads are a few hundred bytes
+constexpr std::uint8_t kMaxFragmentLength = TLSEXT_max_fragment_length_4096;
+
+// Stores live until exit: contexts on Paho's threads may still reference them
+std::mutex g_storesMutex;
+std::map<std::string, X509_STORE*>* g_stores = new std::map<std::string, X509_STORE*>();
+
+/// Shared store for a CA file, parsed on first use; nullptr if the file does not load
+X509_STORE* sharedStore(const std::string& caFile) {
+    std::lock_guard<std::mutex> lock(g_storesMutex);
+    auto it = g_stores->find(caFile);
+    if (it != g_stores->end()) {
+        return it->second;
+    }
+    X509_STORE* store = X509_STORE_new();
+#if OPENSSL_VERSION_NUMBER >= 0x30000000L
+    bool loaded = store && X509_STORE_load_file(store, caFile.c_str()) == 1;
+#else
+    bool loaded = store && X509_STORE_load_locations(store, caFile.c_str(), nullptr) == 1;
+#endif
+    if (!loaded) {
+        X509_STORE_free(store);
+        return nullptr;
+    }
+    g_stores->emplace(caFile, store);
+    return store;
+}
+#endif
+
+} // namespace
+
+LeanConnections::Status LeanConnections::enable() {
+    Status status;
+    g_enabled.store(true, std::memory_order_release);
+    status.tlsHooks = hooks::sslInterposed();
+    if (!status.tlsHooks) {
+        status.reason = "TLS hooks need Linux with a shared libssl; TLS contexts unchanged";
+    }
+    return status;
+}
+
+bool LeanConnections::enabled() {
+    return g_enabled.load(std::memory_order_acquire);
+}
+
+std::size_t LeanConnections::sharedTrustStores() {
+#if defined(TRACKER_TLS_HOOKS)
+    std::lock_guard<std::mutex> lock(g_storesMutex);
+    return g_stores->size();
+#else
+    return 0;
+#endif
+}
+
+std::size_t LeanConnections::residentBytes() {
+#if defined(__linux__)
+    std::ifstream statm("/proc/self/statm");
+    std::size_t totalPages = 0;
+    std::size_t residentPages = 0;
+    if (statm >> totalPages >> residentPages) {
+        return residentPages * static_cast<std::size_t>(sysconf(_SC_PAGESIZE));
+    }
+#endif
+    return 0;
+}
+
+void LeanConnections::releaseFreedMemory() {
+#if defined(__GLIBC__)
+    malloc_trim(0);
+#endif
+}
+
+#if defined(TRACKER_TLS_HOOKS)
+void hooks::leanContext(SSL_CTX* context) {
+    if (LeanConnections::enabled()) {
+        SSL_CTX_set_mode(context, SSL_MODE_RELEASE_BUFFERS);
+        SSL_CTX_set_tlsext_max_fragment_length(context, kMaxFragmentLength);
+    }
+}
+
+bool hooks::sharedVerifyLocations(SSL_CTX* context, const char* caFile, const char* caPath) {
+    if (!LeanConnections::enabled() || !caFile || caPath) {
+        return false;
+    }
+    X509_STORE* store = sharedStore(caFile);
+    if (!store) {
+        return false;
+    }
+    SSL_CTX_set1_cert_store(context, store);
+    return true;
+}
+#endif
+
+} // namespace tracker
@@ -0,0 +1,58 @@
+/**
+ * @file LeanConnections.hpp
+ * @brief Lean connection profile: less resident memory per idle MQTT/TLS connection
+ *
+ * At 10k+ devices, per-connection transport state makes up most of the
+ * resident set: OpenSSL's 17 KB read and write record buffers, each
+ * context's own parsed copy of the CA file, and queues allocated up front.
+ * The lean profile changes the TLS contexts Paho creates:
+ *
+ * - SSL_MODE_RELEASE_BUFFERS: the record buffers are freed whenever a
+ *   connection has no pending data, so an idle connection holds none.
+ * - Maximum fragment length of 4 KB (RFC 6066) is requested. Payloads are
+ *   well under 1 KB, and when the server agrees, active buffers shrink too.
+ * - One X509_STORE per CA file is shared by every context. The file is
+ *   parsed once, not once per connection.
+ *
+ * Paho creates its SSL_CTX objects internally, so SSL_CTX_new() and
+ * SSL_CTX_load_verify_locations() are interposed (TlsHooks.cpp). The hooks
+ * are built only against a shared libssl on Linux (TRACKER_TLS_HOOKS); elsewhere
+ * enable() reports that TLS is unchanged. Offline queues are allocated on
+ * first use in every profile.
+ *
+ * @note Call enable() before the first connection
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <string>
+
+namespace tracker {
+
+class LeanConnections {
+public:
+    struct Status {
+        bool tlsHooks = false;   ///< TLS contexts are slimmed (false: only the portable parts apply)
+        std::string reason;      ///< Why the TLS part is unavailable
+    };
+
+    /** @brief Apply the lean profile to TLS contexts created from now on */
+    static Status enable();
+
+    static bool enabled();
+
+    /** @brief Distinct CA stores shared so far (one per CA file) */
+    static std::size_t sharedTrustStores();
+
+    /** @brief Resident set size of this process in bytes (0 if unknown) */
+    static std::size_t residentBytes();
+
+    /**
+     * @brief Return freed heap pages to the kernel (glibc malloc_trim)
+     * @note Worth one call after a connect storm: handshakes free most of what they allocate
+     */
+    static void releaseFreedMemory();
+};
+
+} // namespace tracker
@@ -1,4 +1,8 @@
 #include "PahoMqttClient.hpp"
+#include "PhaseSchedule.hpp"
+#include "Stats.hpp"
+#include "Probes.hpp"
+#include "CredentialStore.hpp"
 #include <iostream>
 #include <cstring>
 #include <fstream>
@@ -8,10 +12,7 @@ namespace tracker {
 PahoMqttClient::PahoMqttClient() : client_(nullptr) {}
 
 PahoMqttClient::~PahoMqttClient() {
-    disconnect();
-    if (client_) {
-        MQTTAsync_destroy(&client_);
-    }
+    releaseClient();
 }
 
 bool PahoMqttClient::connect(const std::string& host, std::uint16_t port, 
@@ -19,11 +20,16 @@ bool PahoMqttClient::connect(const std::string& host, std::uint16_t port,
                             const std::string& username, 
                             const std::string& password) {
     
+    // Reconnects (e.g. token renewal) replace the previous handle
+    releaseClient();
+    
     std::string serverURI = "ssl://" + host + ":" + std::to_string(port);
+    TRACKER_PROBE4(connect_start, this, host.c_str(), port, 0);
     
     int rc = MQTTAsync_create(&client_, serverURI.c_str(), clientId.c_str(), 
                              MQTTCLIENT_PERSISTENCE_NONE, nullptr);
     if (rc != MQTTASYNC_SUCCESS) {
+        TRACKER_PROBE2(connect_failure, this, rc);
         return false;
     }
     
@@ -32,7 +38,7 @@ bool PahoMqttClient::connect(const std::string& host, std::uint16_t port,
     MQTTAsync_connectOptions conn_opts = MQTTAsync_connectOptions_initializer;
     MQTTAsync_SSLOptions ssl_opts = MQTTAsync_SSLOptions_initializer;
     
-    conn_opts.keepAliveInterval = kKeepAliveIntervalSeconds;
+    conn_opts.keepAliveInterval = keepAliveSeconds(clientId);
     conn_opts.cleansession = 1;
     conn_opts.connectTimeout = kConnectionTimeoutSeconds;
     conn_opts.retryInterval = 5;        // 5 seconds between retries
@@ -47,7 +53,11 @@ bool PahoMqttClient::connect(const std::string& host, std::uint16_t port,
     ssl_opts.verify = 0;
     
     rc = MQTTAsync_connect(client_, &conn_opts);
-    return rc == MQTTASYNC_SUCCESS;
+    if (rc != MQTTASYNC_SUCCESS) {
+        TRACKER_PROBE2(connect_failure, this, rc);
+        return false;
+    }
+    return true;
 }
 
 bool PahoMqttClient::connectWithTls(const std::string& host, std::uint16_t port,
@@ -67,11 +77,16 @@ bool PahoMqttClient::connectWithTls(const std::string& host, std::uint16_t port,
         return false;
     }
     
+    // Reconnects (e.g. token renewal) replace the previous handle
+    releaseClient();
+    
     std::string serverURI = "ssl://" + host + ":" + std::to_string(port);
+    TRACKER_PROBE4(connect_start, this, host.c_str(), port, 1);
     
     int rc = MQTTAsync_create(&client_, serverURI.c_str(), clientId.c_str(), 
                              MQTTCLIENT_PERSISTENCE_NONE, nullptr);
     if (rc != MQTTASYNC_SUCCESS) {
+        TRACKER_PROBE2(connect_failure, this, rc);
         std::cout << "[MQTT] Failed to create client, error code: " << rc << std::endl;
         return false;
     }
@@ -81,7 +96,7 @@ bool PahoMqttClient::connectWithTls(const std::string& host, std::uint16_t port,
     MQTTAsync_connectOptions conn_opts = MQTTAsync_connectOptions_initializer;
     MQTTAsync_SSLOptions ssl_opts = MQTTAsync_SSLOptions_initializer;
     
-    conn_opts.keepAliveInterval = kKeepAliveIntervalSeconds;
+    conn_opts.keepAliveInterval = keepAliveSeconds(clientId);
     conn_opts.cleansession = 1;
     conn_opts.connectTimeout = kConnectionTimeoutSeconds;
     conn_opts.retryInterval = 5;        // 5 seconds between retries
@@ -109,11 +124,75 @@ bool PahoMqttClient::connectWithTls(const std::string& host, std::uint16_t port,
         std::cout << "[MQTT] Connection attempt initiated successfully" << std::endl;
         return true;
     } else {
+        TRACKER_PROBE2(connect_failure, this, rc);
         std::cout << "[MQTT] Connection attempt failed, error code: " << rc << std::endl;
         return false;
     }
 }
 
+int PahoMqttClient::keepAliveSeconds(const std::string& clientId) {
+    // Per-client period so fleet PINGREQs de-correlate instead of bursting together
+    return static_cast<int>(PhaseSchedule::spreadPeriod(clientId, PeriodicActivity::KeepAlive,
+                                                        std::chrono::seconds(kKeepAliveIntervalSeconds),
+                                                        kKeepAliveSpreadFraction).count());
+}
+
+void PahoMqttClient::releaseClient() {
+    if (client_) {
+        // Destroying a connected handle drops the socket without DISCONNECT and abandons in-flight publishes
+        if (connected_) {
+            MQTTAsync_disconnectOptions disc_opts = MQTTAsync_disconnectOptions_initializer;
+            disc_opts.timeout = kDisconnectTimeoutMs;
+            disc_opts.onSuccess = onDisconnected;
+            disc_opts.onFailure = onDisconnectFailure;
+            disc_opts.context = this;
+            
+            std::unique_lock<std::mutex> lock(disconnectMutex_);
+            disconnectPending_ = true;
+            if (MQTTAsync_disconnect(client_, &disc_opts) == MQTTASYNC_SUCCESS) {
+                // Bounded: a reconnect issued from this client's own callback thread would wait forever
+                disconnectDone_.wait_for(lock, std::chrono::milliseconds(2 * kDisconnectTimeoutMs),
+                                         [this] { return !disconnectPending_; });
+            }
+            disconnectPending_ = false;
+        }
+        MQTTAsync_destroy(&client_);
+        client_ = nullptr;
+    }
+    connected_ = false;
+    failOutstandingPublishes();
+}
+
+bool PahoMqttClient::finishPublish(PublishContext* publish) {
+    std::lock_guard<std::mutex> lock(publishMutex_);
+    if (publishes_.erase(publish) == 0) {
+        return false;
+    }
+    inflight_.fetch_sub(1, std::memory_order_relaxed);
+    return true;
+}
+
+void PahoMqttClient::failOutstandingPublishes() {
+    std::unordered_set<PublishContext*> outstanding;
+    {
+        std::lock_guard<std::mutex> lock(publishMutex_);
+        outstanding.swap(publishes_);
+        // No handle is left to complete them
+        inflight_.store(0, std::memory_order_relaxed);
+    }
+    for (auto* publish : outstanding) {
+        Stats::instance().recordPublishFailed();
+        TRACKER_PROBE2(publish_failed, this, MQTTASYNC_OPERATION_INCOMPLETE);
+        delete publish;
+    }
+}
+
+void PahoMqttClient::notifyDisconnected() {
+    std::lock_guard<std::mutex> lock(disconnectMutex_);
+    disconnectPending_ = false;
+    disconnectDone_.notify_all();
+}
+
 void PahoMqttClient::disconnect() {
     if (client_ && connected_) {
         MQTTAsync_disconnectOptions disc_opts = MQTTAsync_disconnectOptions_initializer;
@@ -132,14 +211,18 @@ bool PahoMqttClient::publish(const std::string& topic, const std::string& payloa
                            int qos, bool retained) {
     if (!connected_) {
         queueMessage(topic, payload, qos, retained);
+        Stats::instance().recordPublishQueued();
         return false;
     }
     
     // Azure IoT Hub requires specific topic format for device-to-cloud messages
     std::string iotHubTopic = topic;
     if (topic.find("messages/events") != std::string::npos) {
-        // Add content-type and encoding properties for Azure IoT Hub
-        iotHubTopic = topic + "$.ct=application%2Fjson&$.ce=utf-8";
+        // Add content-type and encoding properties for Azure IoT Hub, after any the caller set (e.g. lt.*)
+        if (!iotHubTopic.empty() && iotHubTopic.back() != '/') {
+            iotHubTopic += '&';
+        }
+        iotHubTopic += "$.ct=application%2Fjson&$.ce=utf-8";
     }
     
     MQTTAsync_message pubmsg = MQTTAsync_message_initializer;
@@ -150,8 +233,28 @@ bool PahoMqttClient::publish(const std::string& topic, const std::string& payloa
     pubmsg.qos = qos;
     pubmsg.retained = retained ? 1 : 0;
     
+    // Delivery callbacks measure PUBACK latency (send complete for QoS 0)
+    auto* context = new PublishContext{this, std::chrono::steady_clock::now(), qos};
+    opts.onSuccess = onPublished;
+    opts.onFailure = onPublishFailure;
+    opts.context = context;
+    {
+        std::lock_guard<std::mutex> lock(publishMutex_);
+        publishes_.insert(context);
+        inflight_.fetch_add(1, std::memory_order_relaxed);
+    }
+    
     int rc = MQTTAsync_sendMessage(client_, iotHubTopic.c_str(), &pubmsg, &opts);
-    return rc == MQTTASYNC_SUCCESS;
+    if (rc != MQTTASYNC_SUCCESS) {
+        if (finishPublish(context)) {
+            delete context;
+        }
+        Stats::instance().recordPublishFailed();
+        TRACKER_PROBE2(publish_failed, this, rc);
+        return false;
+    }
+    TRACKER_PROBE4(publish, this, iotHubTopic.c_str(), payload.size(), qos);
+    return true;
 }
 
 bool PahoMqttClient::subscribe(const std::string& topic, int qos) {
@@ -160,6 +263,9 @@ bool PahoMqttClient::subscribe(const std::string& topic, int qos) {
     }
     
     MQTTAsync_responseOptions opts = MQTTAsync_responseOptions_initializer;
+    opts.onSuccess = onSubscribed;
+    opts.onFailure = onSubscribeFailure;
+    opts.context = this;
     
     int rc = MQTTAsync_subscribe(client_, topic.c_str(), qos, &opts);
     return rc == MQTTASYNC_SUCCESS;
@@ -184,9 +290,22 @@ void PahoMqttClient::setConnectionCallback(ConnectionCallback callback) {
     connectionCallback_ = callback;
 }
 
+void PahoMqttClient::setAckCallback(AckCallback callback) {
+    ackCallback_ = callback;
+}
+
 void PahoMqttClient::processEvents() {
 }
 
+std::size_t PahoMqttClient::queuedMessages() const {
+    std::lock_guard<std::mutex> lock(queueMutex_);
+    return offlineQueue_ ? offlineQueue_->size() : 0;
+}
+
+std::size_t PahoMqttClient::inflightMessages() const {
+    return inflight_.load(std::memory_order_relaxed);
+}
+
 int PahoMqttClient::messageArrived(void* context, char* topicName, int topicLen, MQTTAsync_message* message) {
     (void)topicLen;  // Suppress unused parameter warning - topicLen not needed since topicName is null-terminated
     
@@ -212,6 +331,7 @@ void PahoMqttClient::onConnected(void* context, MQTTAsync_successData* response)
     
     auto* client = static_cast<PahoMqttClient*>(context);
     client->connected_ = true;
+    TRACKER_PROBE1(connect_success, client);
     
     if (client->connectionCallback_) {
         client->connectionCallback_(true, "Connected successfully");
@@ -223,6 +343,7 @@ void PahoMqttClient::onConnected(void* context, MQTTAsync_successData* response)
 void PahoMqttClient::onConnectFailure(void* context, MQTTAsync_failureData* response) {
     auto* client = static_cast<PahoMqttClient*>(context);
     client->connected_ = false;
+    TRACKER_PROBE2(connect_failure, client, response ? response->code : -1);
     
     if (client->connectionCallback_) {
         std::string reason = "Connection failed";
@@ -251,25 +372,94 @@ void PahoMqttClient::onDisconnected(void* context, MQTTAsync_successData* respon
     
     auto* client = static_cast<PahoMqttClient*>(context);
     client->connected_ = false;
+    client->notifyDisconnected();
+}
+
+void PahoMqttClient::onDisconnectFailure(void* context, MQTTAsync_failureData* response) {
+    (void)response;  // Suppress unused parameter warning - the handle is destroyed either way
+    
+    auto* client = static_cast<PahoMqttClient*>(context);
+    client->connected_ = false;
+    client->notifyDisconnected();
+}
+
+void PahoMqttClient::onPublished(void* context, MQTTAsync_successData* response) {
+    (void)response;  // Suppress unused parameter warning - only timing is recorded
+    
+    auto* publish = static_cast<PublishContext*>(context);
+    if (!publish->client->finishPublish(publish)) {
+        return;
+    }
+    auto latency = std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - publish->sentAt);
+    Stats::instance().recordPublishOk(static_cast<uint64_t>(latency.count()));
+    TRACKER_PROBE2(puback, publish->client, static_cast<uint64_t>(latency.count()));
+    if (publish->client->ackCallback_) {
+        publish->client->ackCallback_(Ack::Publish, publish->qos, true);
+    }
+    delete publish;
+}
+
+void PahoMqttClient::onPublishFailure(void* context, MQTTAsync_failureData* response) {
+    (void)response;  // Suppress unused parameter warning - failure reason not tracked
+    
+    auto* publish = static_cast<PublishContext*>(context);
+    if (!publish->client->finishPublish(publish)) {
+        return;
+    }
+    Stats::instance().recordPublishFailed();
+    TRACKER_PROBE2(publish_failed, publish->client, 0);
+    if (publish->client->ackCallback_) {
+        publish->client->ackCallback_(Ack::Publish, publish->qos, false);
+    }
+    delete publish;
+}
+
+void PahoMqttClient::onSubscribed(void* context, MQTTAsync_successData* response) {
+    auto* client = static_cast<PahoMqttClient*>(context);
+    if (client->ackCallback_) {
+        client->ackCallback_(Ack::Subscribe, response ? response->alt.qos : 0, true);
+    }
+}
+
+void PahoMqttClient::onSubscribeFailure(void* context, MQTTAsync_failureData* response) {
+    (void)response;  // Suppress unused parameter warning - failure reason not tracked
+    
+    auto* client = static_cast<PahoMqttClient*>(context);
+    if (client->ackCallback_) {
+        client->ackCallback_(Ack::Subscribe, 0, false);
+    }
 }
 
 void PahoMqttClient::flushOfflineQueue() {
     std::lock_guard<std::mutex> lock(queueMutex_);
+    if (!offlineQueue_) {
+        return;
+    }
     
-    while (!offlineQueue_.empty() && connected_) {
-        const auto& msg = offlineQueue_.front();
+    while (!offlineQueue_->empty() && connected_) {
+        const auto& msg = offlineQueue_->front();
         publish(msg.topic, msg.payload, msg.qos, msg.retained);
-        offlineQueue_.pop();
+        offlineQueue_->pop();
+        TRACKER_PROBE2(offline_dequeue, this, offlineQueue_->size());
+    }
+    
+    // A std::deque holds a map and a block even when empty; idle clients keep neither
+    if (offlineQueue_->empty()) {
+        offlineQueue_.reset();
     }
 }
 
 void PahoMqttClient::queueMessage(const std::string& topic, const std::string& payload, 
                                 int qos, bool retained) {
     std::lock_guard<std::mutex> lock(queueMutex_);
+    if (!offlineQueue_) {
+        offlineQueue_ = std::make_unique<std::queue<MqttMessage>>();
+    }
     
     // Remove oldest message if queue is full (FIFO behavior)
-    if (offlineQueue_.size() >= kMaxOfflineQueueSize) {
-        offlineQueue_.pop();
+    if (offlineQueue_->size() >= kMaxOfflineQueueSize) {
+        offlineQueue_->pop();
     }
     
     MqttMessage msg;
@@ -278,10 +468,17 @@ void PahoMqttClient::queueMessage(const std::string& topic, const std::string& p
     msg.qos = qos;
     msg.retained = retained;
     
-    offlineQueue_.push(msg);
+    offlineQueue_->push(msg);
+    TRACKER_PROBE2(offline_enqueue, this, offlineQueue_->size());
 }
 
 bool PahoMqttClient::validateCertificateFiles(const TlsConfig& tlsConfig) const {
+    // Preloaded credentials were read and parsed at startup
+    if (CredentialStore::contains(tlsConfig.certPath) && CredentialStore::contains(tlsConfig.keyPath) &&
+        CredentialStore::contains(tlsConfig.caPath)) {
+        return true;
+    }
+    
     std::cout << "[MQTT] Validating certificate files..." << std::endl;
     
     std::ifstream certFile(tlsConfig.certPath);
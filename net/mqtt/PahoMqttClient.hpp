@@ -23,6 +23,10 @@
 #include <memory>
 #include <queue>
 #include <mutex>
+#include <condition_variable>
+#include <unordered_set>
+#include <atomic>
+#include <chrono>
 #include <cstdint>
 
 namespace tracker {
@@ -53,7 +57,7 @@ public:
     
     /**
      * @brief Destructor - ensures clean disconnection and resource cleanup
-     * @note Automatically disconnects if still connected
+     * @note Automatically disconnects if still connected, waiting briefly for in-flight publishes
      */
     ~PahoMqttClient() override;
     
@@ -84,9 +88,13 @@ public:
     
     void setMessageCallback(MessageCallback callback) override;
     void setConnectionCallback(ConnectionCallback callback) override;
+    void setAckCallback(AckCallback callback) override;
     
     void processEvents() override;
     
+    std::size_t queuedMessages() const override;
+    std::size_t inflightMessages() const override;
+    
 private:
     /// Maximum number of messages to queue when offline
     static constexpr std::size_t kMaxOfflineQueueSize = 100;
@@ -94,17 +102,39 @@ private:
     /// Azure IoT Hub recommended keep-alive interval (seconds)
     static constexpr int kKeepAliveIntervalSeconds = 240;
     
+    /// Keep-alive is shortened by up to this fraction per client ID (never lengthened)
+    static constexpr double kKeepAliveSpreadFraction = 0.1;
+    
     /// Connection timeout for Azure services (seconds)
     static constexpr int kConnectionTimeoutSeconds = 30;
     
+    /// Time in-flight publishes get to complete when a handle is replaced (milliseconds)
+    static constexpr int kDisconnectTimeoutMs = 1000;
+    
     MQTTAsync client_;                    ///< Paho MQTT client handle
     bool connected_ = false;              ///< Current connection state
     
     MessageCallback messageCallback_;     ///< User callback for incoming messages
     ConnectionCallback connectionCallback_; ///< User callback for connection events
+    AckCallback ackCallback_;             ///< Optional callback for PUBACK/SUBACK
+    
+    std::unique_ptr<std::queue<MqttMessage>> offlineQueue_; ///< Messages held while offline (allocated on first use)
+    mutable std::mutex queueMutex_;       ///< Mutex protecting offline queue
+    std::atomic<std::size_t> inflight_{0}; ///< Publishes awaiting PUBACK
     
-    std::queue<MqttMessage> offlineQueue_; ///< Queue for messages when offline
-    std::mutex queueMutex_;               ///< Mutex protecting offline queue
+    /// Per-publish context handed to Paho's delivery callbacks
+    struct PublishContext {
+        PahoMqttClient* client;
+        std::chrono::steady_clock::time_point sentAt;
+        int qos;
+    };
+    
+    std::mutex publishMutex_;             ///< Mutex protecting publishes_
+    std::unordered_set<PublishContext*> publishes_; ///< Contexts not yet returned by a delivery callback
+    
+    std::mutex disconnectMutex_;          ///< Mutex protecting disconnectPending_
+    std::condition_variable disconnectDone_; ///< Signalled by the disconnect callbacks
+    bool disconnectPending_ = false;      ///< releaseClient() is waiting for DISCONNECT to complete
     
     /**
      * @brief Static callback for incoming MQTT messages
@@ -144,12 +174,66 @@ private:
      */
     static void onDisconnected(void* context, MQTTAsync_successData* response);
     
+    /**
+     * @brief Static callback for a disconnect that could not complete cleanly
+     * @param context Pointer to PahoMqttClient instance
+     * @param response Failure response data (unused)
+     */
+    static void onDisconnectFailure(void* context, MQTTAsync_failureData* response);
+    
+    /**
+     * @brief Static callback for a delivered publish (PUBACK for QoS 1)
+     * @param context Heap-allocated PublishContext (freed here)
+     * @param response Success response data (unused)
+     */
+    static void onPublished(void* context, MQTTAsync_successData* response);
+    
+    /**
+     * @brief Static callback for a failed publish
+     * @param context Heap-allocated PublishContext (freed here)
+     * @param response Failure response data (unused)
+     */
+    static void onPublishFailure(void* context, MQTTAsync_failureData* response);
+    
+    /**
+     * @brief Static callback for a granted subscription (SUBACK)
+     * @param context Pointer to PahoMqttClient instance
+     * @param response Success response data (granted QoS)
+     */
+    static void onSubscribed(void* context, MQTTAsync_successData* response);
+    
+    /**
+     * @brief Static callback for a rejected or failed subscription
+     * @param context Pointer to PahoMqttClient instance
+     * @param response Failure response data (unused)
+     */
+    static void onSubscribeFailure(void* context, MQTTAsync_failureData* response);
+    
     /**
      * @brief Send all queued messages when connection is restored
      * @note Called automatically when connection is established
      */
     void flushOfflineQueue();
     
+    /** @brief Phase-spread keep-alive interval for a client ID */
+    static int keepAliveSeconds(const std::string& clientId);
+    
+    /**
+     * @brief Disconnect and destroy the current Paho handle
+     * @note Waits up to kDisconnectTimeoutMs for in-flight publishes and the DISCONNECT
+     * @note Publishes still outstanding once the handle is gone are counted as failed
+     */
+    void releaseClient();
+    
+    /** @brief Take a publish context back from Paho; false if already reclaimed */
+    bool finishPublish(PublishContext* publish);
+    
+    /** @brief Free contexts whose delivery callback will never run and reset inflight_ */
+    void failOutstandingPublishes();
+    
+    /** @brief Wake releaseClient() once the DISCONNECT has completed or failed */
+    void notifyDisconnected();
+    
     /**
      * @brief Add message to offline queue when not connected
      * @param topic MQTT topic for message
@@ -0,0 +1,338 @@
+#include "SourceAddressPool.hpp"
+#include "TlsHooks.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <fstream>
+#include <memory>
+
+#if defined(__linux__)
+#include <arpa/inet.h>
+#include <ifaddrs.h>
+#include <netinet/in.h>
+#include <sys/resource.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <cerrno>
+
+#ifndef IP_BIND_ADDRESS_NO_PORT
+#define IP_BIND_ADDRESS_NO_PORT 24   // Linux 4.2
+#endif
+#endif
+
+namespace tracker {
+
+#if defined(__linux__)
+namespace {
+
+/// Descriptors above this are still bound, just not counted as open
+constexpr std::size_t kMaxTrackedDescriptors = 1u << 20;
+
+/// Broker endpoints with their own rotation; further ones share the overflow counter
+constexpr std::size_t kDestinationSlots = 64;
+
+struct Entry {
+    sockaddr_storage address{};
+    socklen_t length = 0;
+    std::string text;
+    std::atomic<std::uint64_t> total{0};
+    std::atomic<std::uint64_t> failures{0};
+};
+
+/// Rotation for one destination address and port
+struct Destination {
+    std::atomic<std::uint64_t> key{0};     ///< destinationKey(), 0 = free slot
+    std::atomic<std::size_t> next{0};
+};
+
+struct Pool {
+    std::vector<std::unique_ptr<Entry>> entries;
+    std::unique_ptr<std::atomic<std::uint32_t>[]> owners;  ///< fd -> entry index + 1 (0 = not ours)
+    std::size_t ownerCount = 0;
+    Destination destinations[kDestinationSlots];
+    std::atomic<std::size_t> overflow{0};
+};
+
+// Never freed: connect() may run on Paho's threads during static destruction
+std::atomic<Pool*> g_pool{nullptr};
+
+bool sameAddress(const sockaddr_storage& a, const sockaddr_storage& b) {
+    if (a.ss_family != b.ss_family) return false;
+    if (a.ss_family == AF_INET) {
+        return std::memcmp(&reinterpret_cast<const sockaddr_in&>(a).sin_addr,
+                           &reinterpret_cast<const sockaddr_in&>(b).sin_addr, sizeof(in_addr)) == 0;
+    }
+    return std::memcmp(&reinterpret_cast<const sockaddr_in6&>(a).sin6_addr,
+                       &reinterpret_cast<const sockaddr_in6&>(b).sin6_addr, sizeof(in6_addr)) == 0;
+}
+
+bool isBound(const sockaddr_storage& local) {
+    if (local.ss_family == AF_INET) {
+        const auto& v4 = reinterpret_cast<const sockaddr_in&>(local);
+        return v4.sin_port != 0 || v4.sin_addr.s_addr != htonl(INADDR_ANY);
+    }
+    if (local.ss_family == AF_INET6) {
+        const auto& v6 = reinterpret_cast<const sockaddr_in6&>(local);
+        return v6.sin6_port != 0 || !IN6_IS_ADDR_UNSPECIFIED(&v6.sin6_addr);
+    }
+    return true;
+}
+
+/// FNV-1a over family, port and address; never 0. Colliding endpoints share a rotation
+std::uint64_t destinationKey(const sockaddr* destination) {
+    const unsigned char* bytes = nullptr;
+    std::size_t length = 0;
+    std::uint16_t port = 0;
+    if (destination->sa_family == AF_INET) {
+        const auto* v4 = reinterpret_cast<const sockaddr_in*>(destination);
+        bytes = reinterpret_cast<const unsigned char*>(&v4->sin_addr);
+        length = sizeof(in_addr);
+        port = v4->sin_port;
+    } else {
+        const auto* v6 = reinterpret_cast<const sockaddr_in6*>(destination);
+        bytes = reinterpret_cast<const unsigned char*>(&v6->sin6_addr);
+        length = sizeof(in6_addr);
+        port = v6->sin6_port;
+    }
+    std::uint64_t hash = 0xcbf29ce484222325ull;
+    auto mix = [&hash](unsigned char byte) { hash = (hash ^ byte) * 0x100000001b3ull; };
+    mix(static_cast<unsigned char>(destination->sa_family));
+    mix(static_cast<unsigned char>(port & 0xff));
+    mix(static_cast<unsigned char>(port >> 8));
+    for (std::size_t i = 0; i < length; ++i) {
+        mix(bytes[i]);
+    }
+    return hash | 1;
+}
+
+/// The rotation counter of a destination, claiming a free slot on first use
+std::atomic<std::size_t>& rotationFor(Pool& pool, const sockaddr* destination) {
+    const std::uint64_t key = destinationKey(destination);
+    for (std::size_t probe = 0; probe < kDestinationSlots; ++probe) {
+        Destination& slot = pool.destinations[(key + probe) % kDestinationSlots];
+        std::uint64_t current = slot.key.load(std::memory_order_acquire);
+        if (current == 0 && slot.key.compare_exchange_strong(current, key, std::memory_order_acq_rel)) {
+            return slot.next;
+        }
+        if (current == key) {
+            return slot.next;
+        }
+    }
+    return pool.overflow;
+}
+
+std::string toText(const sockaddr_storage& address) {
+    char text[INET6_ADDRSTRLEN] = {};
+    if (address.ss_family == AF_INET) {
+        inet_ntop(AF_INET, &reinterpret_cast<const sockaddr_in&>(address).sin_addr, text, sizeof(text));
+    } else {
+        inet_ntop(AF_INET6, &reinterpret_cast<const sockaddr_in6&>(address).sin6_addr, text, sizeof(text));
+    }
+    return text;
+}
+
+/// Literal address, or the first IPv4 (else global IPv6) address of an interface
+bool resolve(const std::string& spec, Entry& entry, std::string& error) {
+    auto& v4 = reinterpret_cast<sockaddr_in&>(entry.address);
+    auto& v6 = reinterpret_cast<sockaddr_in6&>(entry.address);
+    if (inet_pton(AF_INET, spec.c_str(), &v4.sin_addr) == 1) {
+        v4.sin_family = AF_INET;
+        entry.length = sizeof(sockaddr_in);
+        entry.text = spec;
+        return true;
+    }
+    if (inet_pton(AF_INET6, spec.c_str(), &v6.sin6_addr) == 1) {
+        v6.sin6_family = AF_INET6;
+        entry.length = sizeof(sockaddr_in6);
+        entry.text = spec;
+        return true;
+    }
+
+    ifaddrs* interfaces = nullptr;
+    if (getifaddrs(&interfaces) != 0) {
+        error = "cannot list interfaces: " + std::string(std::strerror(errno));
+        return false;
+    }
+    const sockaddr* found = nullptr;
+    for (ifaddrs* it = interfaces; it; it = it->ifa_next) {
+        if (!it->ifa_addr || spec != it->ifa_name) continue;
+        if (it->ifa_addr->sa_family == AF_INET) {
+            found = it->ifa_addr;
+            break;
+        }
+        if (it->ifa_addr->sa_family == AF_INET6 && !found &&
+            !IN6_IS_ADDR_LINKLOCAL(&reinterpret_cast<const sockaddr_in6*>(it->ifa_addr)->sin6_addr)) {
+            found = it->ifa_addr;
+        }
+    }
+    if (found) {
+        entry.length = found->sa_family == AF_INET ? sizeof(sockaddr_in) : sizeof(sockaddr_in6);
+        std::memcpy(&entry.address, found, entry.length);
+        if (found->sa_family == AF_INET6) v6.sin6_port = 0;
+        entry.text = toText(entry.address) + " (" + spec + ")";
+    } else {
+        error = "not an address or an interface with one: " + spec;
+    }
+    freeifaddrs(interfaces);
+    return found != nullptr;
+}
+
+/// Bind a throwaway socket so a non-local address fails at startup, not per device
+bool checkLocal(const Entry& entry, std::string& error) {
+    int fd = socket(entry.address.ss_family, SOCK_STREAM, 0);
+    if (fd < 0) {
+        error = entry.text + ": " + std::strerror(errno);
+        return false;
+    }
+    int one = 1;
+    setsockopt(fd, IPPROTO_IP, IP_BIND_ADDRESS_NO_PORT, &one, sizeof(one));
+    bool ok = bind(fd, reinterpret_cast<const sockaddr*>(&entry.address), entry.length) == 0;
+    if (!ok) error = entry.text + ": " + std::strerror(errno);
+    close(fd);
+    return ok;
+}
+
+} // namespace
+
+// Called from the interposed connect(); must not allocate or log
+void hooks::bindSourceAddress(int fd, const sockaddr* destination) {
+    Pool* pool = g_pool.load(std::memory_order_acquire);
+    if (!pool || !destination || (destination->sa_family != AF_INET && destination->sa_family != AF_INET6)) {
+        return;
+    }
+    int type = 0;
+    socklen_t typeLength = sizeof(type);
+    if (getsockopt(fd, SOL_SOCKET, SO_TYPE, &type, &typeLength) != 0 || type != SOCK_STREAM) {
+        return;
+    }
+    // Leave sockets the caller bound itself alone
+    sockaddr_storage local{};
+    socklen_t localLength = sizeof(local);
+    if (getsockname(fd, reinterpret_cast<sockaddr*>(&local), &localLength) != 0 || isBound(local)) {
+        return;
+    }
+
+    const std::size_t count = pool->entries.size();
+    // Rotate per broker endpoint: DPS and hub connections (and each hub) do not
+    // advance each other's rotation, so every endpoint sees an even spread
+    const std::size_t start = rotationFor(*pool, destination).fetch_add(1, std::memory_order_relaxed);
+    for (std::size_t i = 0; i < count; ++i) {
+        std::size_t index = (start + i) % count;
+        Entry& entry = *pool->entries[index];
+        if (entry.address.ss_family != destination->sa_family) continue;
+
+        int one = 1;
+        setsockopt(fd, IPPROTO_IP, IP_BIND_ADDRESS_NO_PORT, &one, sizeof(one));
+        if (bind(fd, reinterpret_cast<const sockaddr*>(&entry.address), entry.length) == 0) {
+            entry.total.fetch_add(1, std::memory_order_relaxed);
+            if (static_cast<std::size_t>(fd) < pool->ownerCount) {
+                pool->owners[fd].store(static_cast<std::uint32_t>(index + 1), std::memory_order_relaxed);
+            }
+        } else {
+            entry.failures.fetch_add(1, std::memory_order_relaxed);
+        }
+        return;
+    }
+}
+
+bool SourceAddressPool::configure(const std::vector<std::string>& specs, std::string& error) {
+    if (g_pool.load(std::memory_order_acquire)) {
+        error = "source addresses are already configured";
+        return false;
+    }
+    if (specs.empty()) {
+        error = "no source addresses given";
+        return false;
+    }
+    if (!hooks::connectInterposed()) {
+        error = "connect() is not interposed in this build";
+        return false;
+    }
+
+    auto pool = std::make_unique<Pool>();
+    for (const auto& spec : specs) {
+        auto entry = std::make_unique<Entry>();
+        if (!resolve(spec, *entry, error) || !checkLocal(*entry, error)) {
+            return false;
+        }
+        pool->entries.push_back(std::move(entry));
+    }
+
+    rlimit limit{};
+    std::size_t descriptors = getrlimit(RLIMIT_NOFILE, &limit) == 0 && limit.rlim_cur != RLIM_INFINITY
+                                  ? static_cast<std::size_t>(limit.rlim_cur)
+                                  : kMaxTrackedDescriptors;
+    pool->ownerCount = std::min(descriptors, kMaxTrackedDescriptors);
+    pool->owners = std::make_unique<std::atomic<std::uint32_t>[]>(pool->ownerCount);
+
+    Pool* expected = nullptr;
+    if (!g_pool.compare_exchange_strong(expected, pool.get(), std::memory_order_acq_rel)) {
+        error = "source addresses are already configured";
+        return false;
+    }
+    pool.release();
+    return true;
+}
+
+bool SourceAddressPool::active() {
+    return g_pool.load(std::memory_order_acquire) != nullptr;
+}
+
+std::vector<SourceAddressPool::AddressCount> SourceAddressPool::counts() {
+    std::vector<AddressCount> counts;
+    Pool* pool = g_pool.load(std::memory_order_acquire);
+    if (!pool) {
+        return counts;
+    }
+    for (const auto& entry : pool->entries) {
+        AddressCount count;
+        count.address = entry->text;
+        count.total = entry->total.load(std::memory_order_relaxed);
+        count.failures = entry->failures.load(std::memory_order_relaxed);
+        counts.push_back(count);
+    }
+
+    // Descriptors are not tracked on close(): a closed or reused one no longer has our address
+    for (std::size_t fd = 0; fd < pool->ownerCount; ++fd) {
+        std::uint32_t owner = pool->owners[fd].load(std::memory_order_relaxed);
+        if (owner == 0) continue;
+        sockaddr_storage local{};
+        socklen_t localLength = sizeof(local);
+        if (getsockname(static_cast<int>(fd), reinterpret_cast<sockaddr*>(&local), &localLength) == 0 &&
+            sameAddress(local, pool->entries[owner - 1]->address)) {
+            ++counts[owner - 1].open;
+        } else {
+            pool->owners[fd].compare_exchange_strong(owner, 0, std::memory_order_relaxed);
+        }
+    }
+    return counts;
+}
+
+#else
+
+bool SourceAddressPool::configure(const std::vector<std::string>&, std::string& error) {
+    error = "source address binding needs Linux (IP_BIND_ADDRESS_NO_PORT)";
+    return false;
+}
+
+bool SourceAddressPool::active() {
+    return false;
+}
+
+std::vector<SourceAddressPool::AddressCount> SourceAddressPool::counts() {
+    return {};
+}
+
+#endif
+
+std::uint32_t SourceAddressPool::portsPerAddress() {
+    std::ifstream file("/proc/sys/net/ipv4/ip_local_port_range");
+    std::uint32_t low = 0;
+    std::uint32_t high = 0;
+    if (!(file >> low >> high) || high < low) {
+        return 0;
+    }
+    return high - low + 1;
+}
+
+} // namespace tracker
@@ -0,0 +1,65 @@
+/**
+ * @file SourceAddressPool.hpp
+ * @brief Spread outbound TCP connections over several local source addresses (Linux)
+ *
+ * Every TCP connection to one broker endpoint needs its own local port, so
+ * one source address supports at most ip_local_port_range connections
+ * (28,232 by default) to that endpoint. Spreading a large fleet across
+ * several local addresses lifts that limit.
+ *
+ * Paho creates and connects its sockets internally, so connect() is
+ * interposed (TlsHooks.cpp). Once configure() succeeds, each stream socket
+ * that is not yet bound gets IP_BIND_ADDRESS_NO_PORT and is bound to the
+ * next address of the destination's family. With that option, the kernel
+ * picks the port at connect() time and checks uniqueness against the full
+ * 4-tuple, not per source address.
+ *
+ * The rotation is kept per destination address and port, because the port
+ * limit applies per destination. The n-th connection to an endpoint uses
+ * address n mod N, so the connections made to each endpoint are spread
+ * evenly, within one, across the addresses. The address is not tied to a device: the hook cannot
+ * tell which Paho client opened a socket, and DPS, hub, renewal and retry
+ * connections interleave. A device's reconnect usually lands on another
+ * address.
+ *
+ * @note Configure once, before the first connection; the list is fixed afterwards
+ * @note Without configure() the interposed connect() adds one relaxed load
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace tracker {
+
+class SourceAddressPool {
+public:
+    /// Connections per configured address
+    struct AddressCount {
+        std::string address;         ///< Numeric address (interface name in brackets when resolved)
+        std::uint64_t open = 0;      ///< Sockets currently bound to the address
+        std::uint64_t total = 0;     ///< Connections bound since configure()
+        std::uint64_t failures = 0;  ///< bind() errors (the socket then connects unbound)
+    };
+
+    /**
+     * @brief Start binding outbound connections to the given addresses
+     * @param specs IPv4/IPv6 literals or interface names (first global address of the interface)
+     * @param error Reason when an entry cannot be resolved or is not local
+     * @return false (pool stays inactive) on the first bad entry, on a second call, or off Linux
+     */
+    static bool configure(const std::vector<std::string>& specs, std::string& error);
+
+    /** @brief Whether configure() succeeded */
+    static bool active();
+
+    /** @brief Per-address counts; open sockets are re-checked with getsockname() */
+    static std::vector<AddressCount> counts();
+
+    /** @brief Ephemeral ports per source address and destination (ip_local_port_range), 0 if unknown */
+    static std::uint32_t portsPerAddress();
+};
+
+} // namespace tracker
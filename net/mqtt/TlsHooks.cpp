@@ -0,0 +1,96 @@
+#include "TlsHooks.hpp"
+
+#if defined(__linux__)
+#include <dlfcn.h>
+#include <sys/socket.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace tracker::hooks {
+
+bool connectInterposed() {
+#if defined(__linux__)
+    return true;
+#else
+    return false;
+#endif
+}
+
+bool sslInterposed() {
+#if defined(TRACKER_TLS_HOOKS)
+    return true;
+#else
+    return false;
+#endif
+}
+
+} // namespace tracker::hooks
+
+#if defined(__linux__)
+namespace tracker::hooks {
+namespace {
+
+/// The definition the hook replaces (libc or libssl); nullptr if none is loaded
+template <typename Function>
+Function next(const char* name) {
+    return reinterpret_cast<Function>(dlsym(RTLD_NEXT, name));
+}
+
+} // namespace
+} // namespace tracker::hooks
+
+// Paho connects its own sockets; bind them first when a pool is configured
+extern "C" int connect(int fd, const struct sockaddr* address, socklen_t length) {
+    static const auto real = tracker::hooks::next<int (*)(int, const struct sockaddr*, socklen_t)>("connect");
+    tracker::hooks::bindSourceAddress(fd, address);
+    if (!real) {
+        return static_cast<int>(syscall(SYS_connect, fd, address, length));
+    }
+    return real(fd, address, length);
+}
+#endif
+
+#if defined(TRACKER_TLS_HOOKS)
+// Paho creates one SSL_CTX per connection and does not expose it
+extern "C" SSL_CTX* SSL_CTX_new(const SSL_METHOD* method) {
+    static const auto real = tracker::hooks::next<SSL_CTX* (*)(const SSL_METHOD*)>("SSL_CTX_new");
+    SSL_CTX* context = real ? real(method) : nullptr;
+    if (context) {
+        tracker::hooks::kernelTlsContext(context);
+        tracker::hooks::leanContext(context);
+    }
+    return context;
+}
+
+// Every device loads the same root CA file; keep one parsed copy
+extern "C" int SSL_CTX_load_verify_locations(SSL_CTX* context, const char* caFile, const char* caPath) {
+    static const auto real =
+        tracker::hooks::next<int (*)(SSL_CTX*, const char*, const char*)>("SSL_CTX_load_verify_locations");
+    if (tracker::hooks::sharedVerifyLocations(context, caFile, caPath)) {
+        return 1;
+    }
+    return real ? real(context, caFile, caPath) : 0;
+}
+
+// Paho passes credentials by path; serve known paths from the parsed objects
+extern "C" int SSL_CTX_use_certificate_chain_file(SSL_CTX* context, const char* file) {
+    static const auto real =
+        tracker::hooks::next<int (*)(SSL_CTX*, const char*)>("SSL_CTX_use_certificate_chain_file");
+    int result = tracker::hooks::storedChain(context, file);
+    if (result >= 0) {
+        return result;
+    }
+    return real ? real(context, file) : 0;
+}
+
+extern "C" int SSL_CTX_use_PrivateKey_file(SSL_CTX* context, const char* file, int type) {
+    static const auto real =
+        tracker::hooks::next<int (*)(SSL_CTX*, const char*, int)>("SSL_CTX_use_PrivateKey_file");
+    int result = tracker::hooks::storedKey(context, file, type);
+    if (result >= 0) {
+        return result;
+    }
+    return real ? real(context, file, type) : 0;
+}
+#endif
@@ -0,0 +1,66 @@
+/**
+ * @file TlsHooks.hpp
+ * @brief Handlers behind the functions interposed for Paho (see TlsHooks.cpp)
+ *
+ * Paho creates its sockets and TLS contexts internally and exposes neither.
+ * TlsHooks.cpp is the only place that interposes the functions it calls and
+ * forwards to the next definition. The modules that need to reach those
+ * objects implement the handlers declared here:
+ *
+ * | Interposed                          | Handler               | Module            |
+ * |-------------------------------------|-----------------------|-------------------|
+ * | connect()                           | bindSourceAddress     | SourceAddressPool |
+ * | SSL_CTX_new()                       | kernelTlsContext      | KernelTls         |
+ * | SSL_CTX_new()                       | leanContext           | LeanConnections   |
+ * | SSL_CTX_load_verify_locations()     | sharedVerifyLocations | LeanConnections   |
+ * | SSL_CTX_use_certificate_chain_file()| storedChain           | CredentialStore   |
+ * | SSL_CTX_use_PrivateKey_file()       | storedKey             | CredentialStore   |
+ *
+ * connect() is interposed on every Linux build. The libssl functions are
+ * interposed only against a shared libssl on Linux (TRACKER_TLS_HOOKS).
+ * The modules report hook availability through connectInterposed() and
+ * sslInterposed(). Because they call these functions, the linker also pulls
+ * this file out of a static tracker_mqtt.
+ *
+ * @note Internal to tracker_mqtt; handlers run on Paho's threads and must be thread-safe
+ */
+
+#pragma once
+
+#if defined(TRACKER_TLS_HOOKS)
+#include <openssl/ssl.h>
+#endif
+
+struct sockaddr;
+
+namespace tracker::hooks {
+
+/** @brief Whether connect() is interposed (Linux) */
+bool connectInterposed();
+
+/** @brief Whether the libssl functions are interposed (TRACKER_TLS_HOOKS) */
+bool sslInterposed();
+
+#if defined(__linux__)
+/** @brief Bind an unbound stream socket to a pool address before it connects */
+void bindSourceAddress(int fd, const sockaddr* destination);
+#endif
+
+#if defined(TRACKER_TLS_HOOKS)
+/** @brief Request kTLS on a new context (no-op unless KernelTls::enable() succeeded) */
+void kernelTlsContext(SSL_CTX* context);
+
+/** @brief Apply the lean profile to a new context (no-op when disabled) */
+void leanContext(SSL_CTX* context);
+
+/** @brief Attach the shared store for a CA file; false to load the file normally */
+bool sharedVerifyLocations(SSL_CTX* context, const char* caFile, const char* caPath);
+
+/** @brief Use a stored certificate chain; -1 when the path is not served from memory */
+int storedChain(SSL_CTX* context, const char* file);
+
+/** @brief Use a stored private key; -1 when the path is not served from memory */
+int storedKey(SSL_CTX* context, const char* file, int type);
+#endif
+
+} // namespace tracker::hooks
@@ -0,0 +1,124 @@
+/**
+ * @file CatalogWatcher.hpp
+ * @brief Background reload of [[route]] / [[geofences]] from the config file
+ *
+ * Polls the configuration file's modification time. On change it parses the
+ * route and geofence tables, builds a new Catalog (projection and fence grid)
+ * on its own thread and publishes it to the fleet's CatalogStore. The ticking
+ * thread never waits for a reload; retired catalogs are reclaimed on every
+ * poll once no tick can still see them.
+ *
+ * @note Polling (not inotify/ReadDirectoryChanges) keeps this portable
+ * @note Connection and simulation settings are not reloaded
+ */
+
+#pragma once
+
+#include "CatalogStore.hpp"
+#include "TomlConfig.hpp"
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <filesystem>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+
+namespace tracker {
+
+class CatalogWatcher {
+public:
+    /**
+     * @param filename Configuration file to watch
+     * @param store Store to publish reloaded catalogs to
+     * @param origin Frame origin (the fleet's start location)
+     * @param pollInterval Modification-time poll interval
+     */
+    CatalogWatcher(std::string filename, std::shared_ptr<CatalogStore> store, Location origin,
+                   std::chrono::milliseconds pollInterval = std::chrono::milliseconds(500))
+        : filename_(std::move(filename)), store_(std::move(store)), origin_(origin),
+          pollInterval_(pollInterval) {}
+
+    ~CatalogWatcher() { stop(); }
+
+    CatalogWatcher(const CatalogWatcher&) = delete;
+    CatalogWatcher& operator=(const CatalogWatcher&) = delete;
+
+    void start() {
+        if (thread_.joinable()) {
+            return;
+        }
+        lastWrite_ = writeTime();
+        stopping_ = false;
+        thread_ = std::thread([this]() { run(); });
+    }
+
+    void stop() {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stopping_ = true;
+        }
+        wake_.notify_all();
+        if (thread_.joinable()) {
+            thread_.join();
+        }
+    }
+
+    /** @brief Catalogs published since start() */
+    std::size_t reloads() const { return reloads_.load(std::memory_order_relaxed); }
+
+private:
+    void run() {
+        std::unique_lock<std::mutex> lock(mutex_);
+        while (!wake_.wait_for(lock, pollInterval_, [this]() { return stopping_; })) {
+            lock.unlock();
+            poll();
+            store_->reclaim();
+            lock.lock();
+        }
+    }
+
+    void poll() {
+        auto current = writeTime();
+        if (current == lastWrite_) {
+            return;
+        }
+        lastWrite_ = current;
+
+        std::vector<RoutePoint> route;
+        std::vector<Geofence> geofences;
+        if (!TomlConfig::loadCatalog(filename_, route, geofences)) {
+            std::cerr << "[Catalog] Could not reload " << filename_ << std::endl;
+            return;
+        }
+
+        std::size_t fenceCount = geofences.size();
+        std::size_t waypointCount = route.size();
+        auto version = store_->publish(Catalog::build(origin_, std::move(route), std::move(geofences)));
+        reloads_.fetch_add(1, std::memory_order_relaxed);
+        std::cout << "[Catalog] Reloaded v" << version << ": " << waypointCount << " waypoints, "
+                  << fenceCount << " geofences" << std::endl;
+    }
+
+    std::filesystem::file_time_type writeTime() const {
+        std::error_code ec;
+        auto time = std::filesystem::last_write_time(filename_, ec);
+        return ec ? std::filesystem::file_time_type{} : time;
+    }
+
+    std::string filename_;
+    std::shared_ptr<CatalogStore> store_;
+    Location origin_;
+    std::chrono::milliseconds pollInterval_;
+
+    std::thread thread_;
+    std::mutex mutex_;
+    std::condition_variable wake_;
+    bool stopping_ = false;
+    std::filesystem::file_time_type lastWrite_{};
+    std::atomic<std::size_t> reloads_{0};
+};
+
+} // namespace tracker
@@ -0,0 +1,72 @@
+/**
+ * @file EventRecorder.hpp
+ * @brief NDJSON log of every emitted event (--record), input for sim-verify
+ *
+ * Each event is appended as its serialized JSON followed by a newline,
+ * exactly as published. Writes go through a large stdio buffer under a
+ * mutex: devices emit from the tick thread, the interactive spike command
+ * from the input thread.
+ */
+
+#pragma once
+
+#include <cstdio>
+#include <mutex>
+#include <string>
+
+namespace tracker {
+
+class EventRecorder {
+public:
+    /// stdio buffer; large enough that fleet ticks rarely reach write(2)
+    static constexpr std::size_t kBufferBytes = 1 << 20;
+
+    EventRecorder() = default;
+    ~EventRecorder() { close(); }
+
+    EventRecorder(const EventRecorder&) = delete;
+    EventRecorder& operator=(const EventRecorder&) = delete;
+
+    /** @brief Create (truncate) the log file; false if it cannot be opened */
+    bool open(const std::string& path) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        file_ = std::fopen(path.c_str(), "wb");
+        if (!file_) {
+            return false;
+        }
+        std::setvbuf(file_, nullptr, _IOFBF, kBufferBytes);
+        return true;
+    }
+
+    /** @brief Append one serialized event */
+    void record(const std::string& json) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!file_) {
+            return;
+        }
+        std::fwrite(json.data(), 1, json.size(), file_);
+        std::fputc('\n', file_);
+        ++events_;
+    }
+
+    /** @brief Flush and close; further records are dropped */
+    void close() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (file_) {
+            std::fclose(file_);
+            file_ = nullptr;
+        }
+    }
+
+    std::size_t events() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return events_;
+    }
+
+private:
+    mutable std::mutex mutex_;
+    std::FILE* file_ = nullptr;
+    std::size_t events_ = 0;
+};
+
+} // namespace tracker
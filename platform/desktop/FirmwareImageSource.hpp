@@ -0,0 +1,70 @@
+/**
+ * @file FirmwareImageSource.hpp
+ * @brief Local stand-in for the firmware HTTP/blob server (--fota, [fota])
+ *
+ * Serves range reads of image files under one directory. Each image is
+ * mapped once on first request and shared by every download, so thousands
+ * of devices fetching the same image read it from one copy in the page
+ * cache. Names may not leave the directory.
+ */
+
+#pragma once
+
+#include "FirmwareUpdate.hpp"
+#include "MappedFile.hpp"
+#include <cstring>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+
+namespace tracker {
+
+class FirmwareImageSource : public IFirmwareSource {
+public:
+    /** @param directory Image directory (empty = names are paths) */
+    explicit FirmwareImageSource(std::string directory) : directory_(std::move(directory)) {
+        if (!directory_.empty() && directory_.back() != '/' && directory_.back() != '\\') {
+            directory_ += '/';
+        }
+    }
+
+    bool readRange(const std::string& source, std::uint64_t offset, std::uint8_t* buffer,
+                   std::size_t length, std::size_t& received, std::string& error) override {
+        const MappedFile* image = open(source, error);
+        if (!image) {
+            return false;
+        }
+        received = 0;
+        if (offset < image->size()) {
+            received = static_cast<std::size_t>(std::min<std::uint64_t>(length, image->size() - offset));
+            std::memcpy(buffer, image->data() + offset, received);
+        }
+        return true;
+    }
+
+private:
+    const MappedFile* open(const std::string& source, std::string& error) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = images_.find(source);
+        if (it != images_.end()) {
+            return it->second.get();
+        }
+        if (!directory_.empty() && source.find("..") != std::string::npos) {
+            error = source + ": outside the image directory";
+            return nullptr;
+        }
+        auto image = std::make_unique<MappedFile>(directory_ + source, MappedFile::Access::Random);
+        if (!image->ok()) {
+            error = directory_ + source + ": cannot open image";
+            return nullptr;
+        }
+        return (images_[source] = std::move(image)).get();
+    }
+
+    std::string directory_;
+    std::mutex mutex_;
+    std::map<std::string, std::unique_ptr<MappedFile>> images_;
+};
+
+} // namespace tracker
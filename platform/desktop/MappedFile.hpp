@@ -0,0 +1,115 @@
+/**
+ * @file MappedFile.hpp
+ * @brief Read-only memory mapping of a whole file (POSIX and Windows)
+ *
+ * Two access patterns:
+ * - Sequential (sim-verify): private mapping faulted in up front and read ahead.
+ * - Random (fence index): shared mapping paged in on demand, no read-ahead, so
+ *   every process mapping the same file shares one copy in the page cache and
+ *   only touched pages are read. prefetch() warms a range explicitly.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <string>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+class MappedFile {
+public:
+    enum class Access { Sequential, Random };
+
+    explicit MappedFile(const std::string& path, Access access = Access::Sequential) {
+#ifdef _WIN32
+        DWORD hint = access == Access::Sequential ? FILE_FLAG_SEQUENTIAL_SCAN : FILE_FLAG_RANDOM_ACCESS;
+        file_ = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, hint, nullptr);
+        if (file_ == INVALID_HANDLE_VALUE) return;
+        LARGE_INTEGER size;
+        if (!GetFileSizeEx(file_, &size)) return;
+        size_ = static_cast<std::size_t>(size.QuadPart);
+        ok_ = true;
+        if (size_ == 0) return;
+        mapping_ = CreateFileMappingA(file_, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        data_ = mapping_ ? static_cast<const char*>(MapViewOfFile(mapping_, FILE_MAP_READ, 0, 0, 0)) : nullptr;
+        ok_ = data_ != nullptr;
+#else
+        fd_ = open(path.c_str(), O_RDONLY);
+        if (fd_ < 0) return;
+        struct stat info;
+        if (fstat(fd_, &info) != 0) return;
+        size_ = static_cast<std::size_t>(info.st_size);
+        ok_ = true;
+        if (size_ == 0) return;
+#ifdef MAP_POPULATE
+        constexpr int kPrefault = MAP_POPULATE;   // Fault the file in with one call, not per page
+#else
+        constexpr int kPrefault = 0;
+#endif
+        int flags = access == Access::Sequential ? MAP_PRIVATE | kPrefault : MAP_SHARED;
+        void* mapped = mmap(nullptr, size_, PROT_READ, flags, fd_, 0);
+        if (mapped == MAP_FAILED) {
+            ok_ = false;
+            return;
+        }
+        data_ = static_cast<const char*>(mapped);
+        madvise(mapped, size_, access == Access::Sequential ? MADV_SEQUENTIAL | MADV_WILLNEED : MADV_RANDOM);
+#endif
+    }
+
+    ~MappedFile() {
+#ifdef _WIN32
+        if (data_) UnmapViewOfFile(data_);
+        if (mapping_) CloseHandle(mapping_);
+        if (file_ != INVALID_HANDLE_VALUE) CloseHandle(file_);
+#else
+        if (data_) munmap(const_cast<char*>(data_), size_);
+        if (fd_ >= 0) close(fd_);
+#endif
+    }
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    /**
+     * @brief Ask the OS to read a byte range ahead of use
+     * @note Asynchronous on POSIX (MADV_WILLNEED); touches each page on Windows
+     */
+    void prefetch(std::size_t offset, std::size_t length) const {
+        if (!data_ || offset >= size_) return;
+        length = (std::min)(length, size_ - offset);   // Parenthesized against the windows.h macro
+#ifdef _WIN32
+        volatile char sink = 0;
+        for (std::size_t at = offset; at < offset + length; at += 4096) {
+            sink = sink + data_[at];
+        }
+#else
+        long pageSize = sysconf(_SC_PAGESIZE);
+        std::size_t aligned = offset - offset % static_cast<std::size_t>(pageSize > 0 ? pageSize : 4096);
+        madvise(const_cast<char*>(data_) + aligned, length + (offset - aligned), MADV_WILLNEED);
+#endif
+    }
+
+    bool ok() const { return ok_; }
+    const char* data() const { return data_; }
+    std::size_t size() const { return size_; }
+
+private:
+#ifdef _WIN32
+    HANDLE file_ = INVALID_HANDLE_VALUE;
+    HANDLE mapping_ = nullptr;
+#else
+    int fd_ = -1;
+#endif
+    const char* data_ = nullptr;
+    std::size_t size_ = 0;
+    bool ok_ = false;
+};
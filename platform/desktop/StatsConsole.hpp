@@ -0,0 +1,177 @@
+/**
+ * @file StatsConsole.hpp
+ * @brief Live ANSI statistics panel for headless fleet runs (--stats)
+ *
+ * Redraws a compact summary in place once per interval: devices by state,
+ * connection health, event rates by type, publish outcomes, queue depths,
+ * PUBACK latency percentiles, fleet tick time and process CPU.
+ *
+ * Counters come from Stats snapshots (lock-free per-thread shards); rates and
+ * percentiles cover the last interval. Per-device gauges are sampled from the
+ * fleet on the calling thread, between ticks.
+ *
+ * @note Call render() from the thread that ticks the fleet
+ */
+
+#pragma once
+
+#include "Fleet.hpp"
+#include "Stats.hpp"
+#include <chrono>
+#include <cstdio>
+#include <iostream>
+#include <sstream>
+#include <string>
+
+#ifndef _WIN32
+#include <sys/resource.h>
+#endif
+
+namespace tracker {
+
+class StatsConsole {
+public:
+    explicit StatsConsole(Fleet& fleet, std::chrono::milliseconds interval = std::chrono::seconds(1))
+        : fleet_(fleet), interval_(interval),
+          started_(std::chrono::steady_clock::now()), lastRender_(started_),
+          last_(Stats::instance().snapshot()), lastCpuSeconds_(processCpuSeconds()) {}
+
+    /** @brief Redraw if the interval has elapsed since the last frame */
+    void renderIfDue() {
+        if (std::chrono::steady_clock::now() - lastRender_ >= interval_) {
+            render();
+        }
+    }
+
+    /** @brief Redraw the panel now */
+    void render() {
+        auto now = std::chrono::steady_clock::now();
+        double seconds = std::chrono::duration<double>(now - lastRender_).count();
+        if (seconds <= 0.0) {
+            return;
+        }
+
+        Stats::Snapshot current = Stats::instance().snapshot();
+        Stats::Snapshot window = current.since(last_);
+        double cpuSeconds = processCpuSeconds();
+        double cpuPercent = (cpuSeconds - lastCpuSeconds_) / seconds * 100.0;
+
+        // Per-device gauges
+        std::size_t byState[4] = {};
+        std::size_t connected = 0;
+        std::size_t reconnecting = 0;
+        std::size_t queued = 0;
+        std::size_t inflight = 0;
+        fleet_.forEach([&](Simulator& simulator) {
+            ++byState[static_cast<std::size_t>(simulator.getState())];
+            connected += simulator.isConnected() ? 1 : 0;
+            reconnecting += simulator.isReconnecting() ? 1 : 0;
+            if (auto client = simulator.getTelemetryClient()) {
+                queued += client->queuedMessages();
+                inflight += client->inflightMessages();
+            }
+        });
+
+        std::ostringstream out;
+        out << "\x1b[H\x1b[2J";  // Home and clear: redraw in place
+        out << "\x1b[1mMQTT Tracker Simulator\x1b[0m  " << fleet_.size() << " devices  up "
+            << formatUptime(now - started_) << "\n\n";
+
+        out << "Devices    Idle " << byState[static_cast<std::size_t>(DeviceState::Idle)]
+            << "  Driving " << byState[static_cast<std::size_t>(DeviceState::Driving)]
+            << "  Parked " << byState[static_cast<std::size_t>(DeviceState::Parked)]
+            << "  LowBattery " << byState[static_cast<std::size_t>(DeviceState::LowBattery)] << "\n";
+
+        out << "Link       connected \x1b[32m" << connected << "\x1b[0m  reconnecting "
+            << (reconnecting ? "\x1b[33m" : "") << reconnecting << "\x1b[0m\n";
+
+        out << "Events/s   total " << formatRate(window.totalEvents(), seconds);
+        for (std::size_t i = 0; i < Stats::kEventTypes; ++i) {
+            if (window.events[i] > 0) {
+                out << "  " << eventTypeToString(static_cast<EventType>(i)) << ' '
+                    << formatRate(window.events[i], seconds);
+            }
+        }
+        out << "\n";
+
+        out << "Publish    ok " << current.publishOk << " (" << formatRate(window.publishOk, seconds)
+            << "/s)  failed " << (current.publishFailed ? "\x1b[31m" : "") << current.publishFailed
+            << "\x1b[0m  queued " << current.publishQueued << "\n";
+
+        out << "Queues     offline " << queued << "  in-flight " << inflight << "\n";
+
+        out << "PUBACK     ";
+        if (window.publishOk > 0) {
+            out << "p50 " << formatMillis(window.latencyPercentileUs(50.0))
+                << "  p99 " << formatMillis(window.latencyPercentileUs(99.0)) << "\n";
+        } else {
+            out << "-\n";
+        }
+
+        out << "Tick       ";
+        if (window.ticks > 0) {
+            out << formatMillis(window.tickNanos / window.ticks / 1000) << " avg over "
+                << window.ticks << " frames\n";
+        } else {
+            out << "-\n";
+        }
+
+        out << "CPU        ";
+        if (cpuSeconds >= 0.0) {
+            char buffer[16];
+            std::snprintf(buffer, sizeof(buffer), "%.1f %%", cpuPercent);
+            out << buffer << "\n";
+        } else {
+            out << "n/a\n";
+        }
+
+        std::cout << out.str() << std::flush;
+
+        last_ = current;
+        lastCpuSeconds_ = cpuSeconds;
+        lastRender_ = now;
+    }
+
+private:
+    /** @brief User + system CPU time of this process, negative if unavailable */
+    static double processCpuSeconds() {
+#ifndef _WIN32
+        rusage usage{};
+        if (getrusage(RUSAGE_SELF, &usage) == 0) {
+            return static_cast<double>(usage.ru_utime.tv_sec + usage.ru_stime.tv_sec) +
+                   static_cast<double>(usage.ru_utime.tv_usec + usage.ru_stime.tv_usec) / 1e6;
+        }
+#endif
+        return -1.0;
+    }
+
+    static std::string formatRate(uint64_t count, double seconds) {
+        char buffer[32];
+        std::snprintf(buffer, sizeof(buffer), "%.1f", static_cast<double>(count) / seconds);
+        return buffer;
+    }
+
+    static std::string formatMillis(uint64_t micros) {
+        char buffer[32];
+        std::snprintf(buffer, sizeof(buffer), "%.1f ms", static_cast<double>(micros) / 1000.0);
+        return buffer;
+    }
+
+    static std::string formatUptime(std::chrono::steady_clock::duration elapsed) {
+        auto total = std::chrono::duration_cast<std::chrono::seconds>(elapsed).count();
+        char buffer[32];
+        std::snprintf(buffer, sizeof(buffer), "%02lld:%02lld:%02lld",
+                      static_cast<long long>(total / 3600), static_cast<long long>(total / 60 % 60),
+                      static_cast<long long>(total % 60));
+        return buffer;
+    }
+
+    Fleet& fleet_;
+    std::chrono::milliseconds interval_;
+    std::chrono::steady_clock::time_point started_;
+    std::chrono::steady_clock::time_point lastRender_;
+    Stats::Snapshot last_;
+    double lastCpuSeconds_;
+};
+
+} // namespace tracker
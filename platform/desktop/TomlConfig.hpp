@@ -12,6 +12,11 @@
  * - [simulation]: Simulation runtime parameters
  * - [[route]]: Route waypoints for movement simulation
  * - [[geofences]]: Geofence definitions for location events
+ * - [[fields]]: Custom telemetry fields (see FieldSchema.hpp)
+ * - [activity], [[activity.cohorts]]: Time-of-day trip schedule (see ActivityModel.hpp)
+ * - [fence_index]: Memory-mapped geofence index built by fence-index (see FenceTree.hpp)
+ * - [network]: Source addresses and the lean connection profile (see SourceAddressPool.hpp, LeanConnections.hpp)
+ * - [fota]: Firmware download campaign triggered by twin "ota" patches (see FirmwareUpdate.hpp)
  * 
  * @author Generated with Claude Code
  * @date 2025
@@ -30,6 +35,7 @@
 #include <iostream>
 #include <filesystem>
 #include "Simulator.hpp"
+#include "MappedFile.hpp"
 
 namespace tracker {
 
@@ -102,6 +108,11 @@ public:
             return config;
         }
         
+        std::vector<tracker::RoutePoint> route;
+        std::vector<tracker::Geofence> geofences;
+        std::vector<tracker::FieldSpec> fields;
+        std::string fenceIndexPath;
+        std::string fenceIndexPrefetch = "nodes";
         std::string currentSection;
         std::string line;
         while (std::getline(file, line)) {
@@ -120,10 +131,19 @@ public:
                 continue;
             }
             
-            // Handle section headers
+            // Handle section headers ([[name]] starts a new array-of-tables entry)
             if (line[0] == '[') {
                 if (line.back() == ']') {
                     currentSection = line.substr(1, line.length() - 2);
+                    if (currentSection == "[route]") {
+                        route.emplace_back();
+                    } else if (currentSection == "[geofences]") {
+                        geofences.emplace_back();
+                    } else if (currentSection == "[fields]") {
+                        fields.emplace_back();
+                    } else if (currentSection == "[activity.cohorts]") {
+                        config.activity.cohorts.emplace_back();
+                    }
                 }
                 continue;
             }
@@ -184,6 +204,10 @@ public:
                         config.rootCaPath = value;
                     } else if (key == "verify_server_cert") {
                         config.verifyServerCert = (value == "true" || value == "1");
+                    } else if (key == "enrollment_group_key") {
+                        config.enrollmentGroupKeyBase64 = value;
+                    } else if (key == "symmetric_key") {
+                        config.dpsDeviceKeyBase64 = value;
                     }
                 } else if (currentSection == "simulation") {
                     // Simulation parameters
@@ -191,6 +215,42 @@ public:
                         config.heartbeatSeconds = std::stoi(value);
                     } else if (key == "speed_limit_kph") {
                         config.speedLimitKph = std::stod(value);
+                    } else if (key == "phase_spreading") {
+                        config.phaseSpreading = (value == "true" || value == "1");
+                    } else if (key == "periodic_jitter") {
+                        config.periodicJitter = std::stod(value);
+                    } else if (key == "twin_refresh_seconds") {
+                        config.twinRefreshSeconds = std::stoi(value);
+                    } else if (key == "sas_token_ttl_seconds") {
+                        config.sasTokenTtlSeconds = std::stoi(value);
+                    }
+                } else if (currentSection == "[route]" || currentSection == "[geofences]") {
+                    parseCatalogKey(currentSection, key, value, route, geofences);
+                } else if (currentSection == "[fields]") {
+                    parseFieldKey(key, value, fields);
+                } else if (currentSection == "activity" || currentSection == "[activity.cohorts]") {
+                    parseActivityKey(currentSection, key, value, config.activity);
+                } else if (currentSection == "fence_index") {
+                    if (key == "path") {
+                        fenceIndexPath = value;
+                    } else if (key == "prefetch") {
+                        fenceIndexPrefetch = value;
+                    } else if (key == "max_query_pages") {
+                        config.fenceTreeMaxPages = static_cast<std::size_t>(std::max(1, std::stoi(value)));
+                    }
+                } else if (currentSection == "network") {
+                    if (key == "source_addresses") {
+                        config.sourceAddresses = parseStringList(value);
+                    } else if (key == "lean") {
+                        config.leanConnections = (value == "true" || value == "1");
+                    }
+                } else if (currentSection == "fota") {
+                    parseFotaKey(key, value, config.fota);
+                } else if (currentSection == "battery") {
+                    if (key == "ambient_c") {
+                        config.batteryAmbientC = std::stod(value);
+                    } else if (key == "spread_c") {
+                        config.batteryAmbientSpreadC = std::max(0.0, std::stod(value));
                     }
                 }
             }
@@ -204,28 +264,347 @@ public:
             config.deviceChainPath = basePath + config.imei + "/device.chain.pem";
         }
         
-        // Validate DPS configuration if present
-        if (config.hasDpsConfig()) {
+        // Validate DPS certificates if present (symmetric keys need no files)
+        if (config.hasDpsConfig() && !config.hasDpsSymmetricKey()) {
             validateCertificatePaths(config);
         }
         
-        // Set default route and geofences
-        config.route = {
+        // Use the file's route and geofences, or the default sample trip
+        config.route = route.empty() ? defaultRoute() : route;
+        config.geofences = geofences.empty() ? defaultGeofences() : geofences;
+        
+        if (!fields.empty()) {
+            config.fieldSchema = compileFields(fields, filename);
+        }
+        if (!fenceIndexPath.empty()) {
+            config.fenceTree = loadFenceTree(fenceIndexPath, fenceIndexPrefetch);
+        }
+        
+        return config;
+    }
+    
+    /**
+     * @brief Map a fence index built by fence-index
+     * @param filename Path to the index
+     * @param prefetch "nodes" warms the internal levels, "all" the whole file, "none" nothing
+     * @return Tree sharing the mapping, or nullptr if the file cannot be mapped or is not an index
+     * @note Pages are read on demand and shared with every process mapping the same file
+     */
+    static std::shared_ptr<const tracker::FenceTree> loadFenceTree(const std::string& filename,
+                                                                   const std::string& prefetch = "nodes") {
+        auto mapping = std::make_shared<MappedFile>(filename, MappedFile::Access::Random);
+        if (!mapping->ok()) {
+            std::cerr << "[Config] Could not map fence index: " << filename << std::endl;
+            return nullptr;
+        }
+        std::string error;
+        std::shared_ptr<const tracker::FenceTree> tree =
+            tracker::FenceTree::open(mapping, mapping->data(), mapping->size(), error);
+        if (!tree) {
+            std::cerr << "[Config] " << filename << ": " << error << "; fence index disabled" << std::endl;
+            return nullptr;
+        }
+        if (prefetch == "all") {
+            mapping->prefetch(0, mapping->size());
+        } else if (prefetch == "nodes") {
+            mapping->prefetch(tree->nodesOffset(), tree->nodesSize());
+        }
+        return tree;
+    }
+    
+    /**
+     * @brief Load a custom field schema file ([[fields]] tables only)
+     * @param filename Path to the schema file
+     * @return Compiled schema, or nullptr if the file cannot be read or a field is invalid
+     */
+    static std::shared_ptr<const tracker::FieldSchema> loadFieldSchema(const std::string& filename) {
+        std::ifstream file(filename);
+        if (!file.is_open()) {
+            std::cerr << "[Config] Could not open field schema: " << filename << std::endl;
+            return nullptr;
+        }
+        
+        std::vector<tracker::FieldSpec> fields;
+        std::string currentSection;
+        std::string line;
+        while (std::getline(file, line)) {
+            size_t commentPos = line.find('#');
+            if (commentPos != std::string::npos) {
+                line = line.substr(0, commentPos);
+            }
+            trim(line);
+            if (line.empty()) {
+                continue;
+            }
+            
+            if (line[0] == '[') {
+                if (line.back() == ']') {
+                    currentSection = line.substr(1, line.length() - 2);
+                    if (currentSection == "[fields]") {
+                        fields.emplace_back();
+                    }
+                }
+                continue;
+            }
+            
+            size_t equalPos = line.find('=');
+            if (equalPos != std::string::npos && currentSection == "[fields]") {
+                std::string key = line.substr(0, equalPos);
+                std::string value = line.substr(equalPos + 1);
+                trim(key);
+                trim(value);
+                unquote(value);
+                parseFieldKey(key, value, fields);
+            }
+        }
+        return compileFields(fields, filename);
+    }
+    
+    /**
+     * @brief Load only the [[route]] and [[geofences]] tables (catalog hot reload)
+     * @param filename Path to TOML configuration file
+     * @param route Parsed route (default sample trip if the file has none)
+     * @param geofences Parsed geofences (default sample fences if the file has none)
+     * @return false if the file cannot be read
+     */
+    static bool loadCatalog(const std::string& filename,
+                            std::vector<tracker::RoutePoint>& route,
+                            std::vector<tracker::Geofence>& geofences) {
+        std::ifstream file(filename);
+        if (!file.is_open()) {
+            return false;
+        }
+        
+        route.clear();
+        geofences.clear();
+        std::string currentSection;
+        std::string line;
+        while (std::getline(file, line)) {
+            size_t commentPos = line.find('#');
+            if (commentPos != std::string::npos) {
+                line = line.substr(0, commentPos);
+            }
+            trim(line);
+            if (line.empty()) {
+                continue;
+            }
+            
+            if (line[0] == '[') {
+                if (line.back() == ']') {
+                    currentSection = line.substr(1, line.length() - 2);
+                    if (currentSection == "[route]") {
+                        route.emplace_back();
+                    } else if (currentSection == "[geofences]") {
+                        geofences.emplace_back();
+                    }
+                }
+                continue;
+            }
+            
+            size_t equalPos = line.find('=');
+            if (equalPos != std::string::npos && (currentSection == "[route]" || currentSection == "[geofences]")) {
+                std::string key = line.substr(0, equalPos);
+                std::string value = line.substr(equalPos + 1);
+                trim(key);
+                trim(value);
+                unquote(value);
+                parseCatalogKey(currentSection, key, value, route, geofences);
+            }
+        }
+        
+        if (route.empty()) route = defaultRoute();
+        if (geofences.empty()) geofences = defaultGeofences();
+        return true;
+    }
+
+private:
+    /**
+     * @brief Apply one key of the current [[route]] or [[geofences]] entry
+     * @note Malformed numbers are reported and leave the field at its default
+     */
+    static void parseCatalogKey(const std::string& section, const std::string& key, const std::string& value,
+                                std::vector<tracker::RoutePoint>& route,
+                                std::vector<tracker::Geofence>& geofences) {
+        try {
+            if (section == "[route]" && !route.empty()) {
+                if (key == "lat") {
+                    route.back().lat = std::stod(value);
+                } else if (key == "lon") {
+                    route.back().lon = std::stod(value);
+                }
+            } else if (section == "[geofences]" && !geofences.empty()) {
+                if (key == "id") {
+                    geofences.back().id = value;
+                } else if (key == "lat") {
+                    geofences.back().lat = std::stod(value);
+                } else if (key == "lon") {
+                    geofences.back().lon = std::stod(value);
+                } else if (key == "radius_meters") {
+                    geofences.back().radiusMeters = std::stod(value);
+                }
+            }
+        } catch (const std::exception&) {
+            std::cerr << "[Config] Warning: Invalid value for " << key << ": " << value << std::endl;
+        }
+    }
+    
+    /**
+     * @brief Apply one key of the current [[fields]] entry
+     * @note values is a TOML array of strings on one line
+     */
+    static void parseFieldKey(const std::string& key, const std::string& value,
+                              std::vector<tracker::FieldSpec>& fields) {
+        if (fields.empty()) {
+            return;
+        }
+        auto& field = fields.back();
+        try {
+            if (key == "name") {
+                field.name = value;
+            } else if (key == "type") {
+                field.type = value;
+            } else if (key == "generator") {
+                field.generator = value;
+            } else if (key == "value") {
+                field.value = value;
+            } else if (key == "values") {
+                field.values = parseStringList(value);
+            } else if (key == "min") {
+                field.min = std::stod(value);
+            } else if (key == "max") {
+                field.max = std::stod(value);
+            } else if (key == "mean") {
+                field.mean = std::stod(value);
+            } else if (key == "stddev") {
+                field.stddev = std::stod(value);
+            } else if (key == "step") {
+                field.step = std::stod(value);
+            } else if (key == "probability") {
+                field.probability = std::stod(value);
+            }
+        } catch (const std::exception&) {
+            std::cerr << "[Config] Warning: Invalid value for " << key << ": " << value << std::endl;
+        }
+    }
+    
+    /**
+     * @brief Apply one key of [activity] or the current [[activity.cohorts]] entry
+     * @note hourly_trips is a TOML array of 24 numbers on one line
+     */
+    static void parseActivityKey(const std::string& section, const std::string& key, const std::string& value,
+                                 tracker::ActivityConfig& activity) {
+        try {
+            if (section == "activity") {
+                if (key == "start_hour") {
+                    activity.startHour = std::stod(value);
+                } else if (key == "time_scale") {
+                    activity.timeScale = std::stod(value);
+                }
+                return;
+            }
+            if (activity.cohorts.empty()) {
+                return;
+            }
+            auto& cohort = activity.cohorts.back();
+            if (key == "name") {
+                cohort.name = value;
+            } else if (key == "share") {
+                cohort.share = std::stod(value);
+            } else if (key == "hourly_trips") {
+                cohort.hourlyTrips.clear();
+                std::string list = value;
+                if (list.size() >= 2 && list.front() == '[' && list.back() == ']') {
+                    list = list.substr(1, list.size() - 2);
+                }
+                std::stringstream items(list);
+                std::string item;
+                while (std::getline(items, item, ',')) {
+                    trim(item);
+                    if (!item.empty()) cohort.hourlyTrips.push_back(std::stod(item));
+                }
+            } else if (key == "trip_minutes") {
+                cohort.tripMinutes = std::stod(value);
+            } else if (key == "trip_minutes_stddev") {
+                cohort.tripMinutesStddev = std::stod(value);
+            }
+        } catch (const std::exception&) {
+            std::cerr << "[Config] Warning: Invalid value for " << key << ": " << value << std::endl;
+        }
+    }
+    
+    /** @brief Apply one key of [fota]; sizes in KB and rates in MB/s */
+    static void parseFotaKey(const std::string& key, const std::string& value, tracker::FotaConfig& fota) {
+        try {
+            if (key == "image_dir") {
+                fota.imageDirectory = value;
+            } else if (key == "flash_dir") {
+                fota.flashDirectory = value;
+            } else if (key == "workers") {
+                fota.workers = static_cast<unsigned>(std::max(1, std::stoi(value)));
+            } else if (key == "chunk_kb") {
+                fota.chunkBytes = static_cast<std::size_t>(std::max(1, std::stoi(value))) * 1024;
+            } else if (key == "max_active") {
+                fota.maxActive = static_cast<std::size_t>(std::max(1, std::stoi(value)));
+            } else if (key == "rate_mbps") {
+                fota.bytesPerSecond = std::stod(value) * 1e6;
+            } else if (key == "burst_kb") {
+                fota.burstBytes = std::stod(value) * 1024.0;
+            } else if (key == "interrupt_rate") {
+                fota.interruptRate = std::stod(value);
+            } else if (key == "max_attempts") {
+                fota.maxAttempts = static_cast<unsigned>(std::max(1, std::stoi(value)));
+            }
+        } catch (const std::exception&) {
+            std::cerr << "[Config] Warning: Invalid value for " << key << ": " << value << std::endl;
+        }
+    }
+    
+    /** @brief Items of a one-line TOML array of strings (`["a", "b"]`) */
+    static std::vector<std::string> parseStringList(const std::string& value) {
+        std::vector<std::string> result;
+        std::string list = value;
+        if (list.size() >= 2 && list.front() == '[' && list.back() == ']') {
+            list = list.substr(1, list.size() - 2);
+        }
+        std::stringstream items(list);
+        std::string item;
+        while (std::getline(items, item, ',')) {
+            trim(item);
+            unquote(item);
+            if (!item.empty()) result.push_back(item);
+        }
+        return result;
+    }
+    
+    /** @brief Compile parsed fields, reporting the first invalid one */
+    static std::shared_ptr<const tracker::FieldSchema> compileFields(const std::vector<tracker::FieldSpec>& fields,
+                                                                     const std::string& filename) {
+        std::string error;
+        auto schema = tracker::FieldSchema::compile(fields, error);
+        if (!schema) {
+            std::cerr << "[Config] " << filename << ": " << error << "; custom fields disabled" << std::endl;
+        }
+        return schema;
+    }
+    
+    /** @brief Sample trip around Johannesburg used when the file defines no route */
+    static std::vector<tracker::RoutePoint> defaultRoute() {
+        return {
             {-26.2041, 28.0473}, // Start
             {-26.2000, 28.0500}, // Waypoint 1
             {-26.1950, 28.0520}, // Waypoint 2  
             {-26.1920, 28.0480}, // End
         };
-        
-        config.geofences = {
+    }
+    
+    /** @brief Sample fences used when the file defines none */
+    static std::vector<tracker::Geofence> defaultGeofences() {
+        return {
             {"office", -26.2041, 28.0473, 100.0},
             {"warehouse", -26.1920, 28.0480, 150.0}
         };
-        
-        return config;
     }
-
-private:
+    
     /**
      * @brief Validate certificate file paths exist and are readable
      * @param config Simulator configuration to validate
@@ -16,25 +16,45 @@
  */
 
 #include "Simulator.hpp"
+#include "Fleet.hpp"
+#include "PhaseSchedule.hpp"
+#include "CapacityPlanner.hpp"
 #include "PahoMqttClient.hpp"
+#include "KernelTls.hpp"
+#include "SourceAddressPool.hpp"
+#include "LeanConnections.hpp"
+#include "CredentialStore.hpp"
 #include "SasToken.hpp"
+#include "Sha256.hpp"
 #include "IClock.hpp"
 #include "IRng.hpp"
 #include "TomlConfig.hpp"
 #include "TwinHandler.hpp"
+#include "StatsConsole.hpp"
+#include "CatalogWatcher.hpp"
+#include "EventRecorder.hpp"
+#include "JsonCodec.hpp"
+#include "FirmwareImageSource.hpp"
+#include "StartupProfiler.hpp"
+#include "ActivityModel.hpp"
 #include <iostream>
 #include <thread>
 #include <chrono>
 #include <signal.h>
 #include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <vector>
+#include <array>
+#include <iomanip>
 
 using namespace tracker;
 
 /// Global flag for graceful shutdown coordination
 static volatile bool g_running = true;
 
-/// Global Device Twin handler for configuration management
-static std::shared_ptr<TwinHandler> g_twinHandler;
+/// Device Twin handlers for configuration management (one per device)
+static std::vector<std::shared_ptr<TwinHandler>> g_twinHandlers;
 
 /**
  * @brief Signal handler for graceful shutdown
@@ -70,6 +90,27 @@ void printUsage(const char* programName) {
               << "  --drive [minutes]  Start a driving simulation (default: 10 minutes)\n"
               << "  --spike [count]    Generate a spike of events (default: 10)\n"
               << "  --headless         Run without user interaction\n"
+              << "  --devices [count]  Simulate a fleet of devices with derived IDs (default: 1)\n"
+              << "  --tick-workers [n] Advance the fleet on n threads; --record order stays the same (default: 1)\n"
+              << "  --phase-report     Print modelled peak-to-average message rate and exit\n"
+              << "  --activity-report  Print one simulated day of [[activity.cohorts]] trip starts per hour and exit\n"
+              << "  --plan             Print modelled message rates, bytes/day and IoT Hub units and exit\n"
+              << "  --plan-trips [n]   Trips per device per day assumed by --plan (default: 2)\n"
+              << "  --plan-batch [n]   Events per publish assumed by --plan (default: 1)\n"
+              << "  --plan-compression [ratio]  Payload size after compression for --plan (default: 1.0)\n"
+              << "  --stats            Headless with a live statistics panel instead of per-event JSON\n"
+              << "  --watch            Reload [[route]]/[[geofences]] when the config file changes\n"
+              << "  --record [file]    Write every emitted event to an NDJSON file (check with sim-verify)\n"
+              << "  --trace [run]      Stamp events for end-to-end latency (sim-verify --latency on a --record file)\n"
+              << "  --fields [file]    Custom telemetry field schema ([[fields]] tables)\n"
+              << "  --fence-index [file]  Memory-mapped geofence index built with fence-index\n"
+              << "  --startup-report   Print per-phase cold-start times once every device has a PUBACK\n"
+              << "  --startup-json [file]  Also write the cold-start report as JSON\n"
+              << "  --ktls             Request kernel TLS offload (Linux; falls back to user-space TLS)\n"
+              << "  --source-address [addr]  Local address or interface for broker connections (repeatable, Linux)\n"
+              << "  --lean             Lean connection profile: idle TLS buffers released, one shared CA store\n"
+              << "  --memory-report    Print resident bytes per connection once every device is connected\n"
+              << "  --fota [image]     Download an image on every device as if a twin \"ota\" patch arrived\n"
               << "  --help             Show this help message\n"
               << "\nConfiguration file format (TOML):\n"
               << "  [connection]\n"
@@ -150,6 +191,170 @@ SimulatorConfig loadConfigFromEnv() {
     return config;
 }
 
+/**
+ * @brief Print analytical fleet load with and without phase spreading
+ * 
+ * Models heartbeats, keep-alives, token renewals and twin refreshes for the
+ * configured fleet over one hour without connecting anywhere.
+ * 
+ * @param config Base configuration
+ * @param deviceCount Number of devices in the fleet
+ */
+void printPhaseReport(const SimulatorConfig& config, std::size_t deviceCount) {
+    auto deviceIds = Fleet::deriveDeviceIds(config, deviceCount);
+    
+    std::vector<PhaseAnalyzer::Activity> activities;
+    activities.push_back({PeriodicActivity::Heartbeat, std::chrono::seconds(config.heartbeatSeconds)});
+    if (config.heartbeatSeconds >= 240) {
+        // PINGREQ is only sent when nothing else was sent within the keep-alive
+        activities.push_back({PeriodicActivity::KeepAlive, std::chrono::seconds(240)});
+    }
+    if (!config.hasDpsConfig() || config.hasDpsSymmetricKey()) {
+        activities.push_back({PeriodicActivity::TokenRenewal, std::chrono::seconds(config.sasTokenTtlSeconds * 6 / 10)});
+    }
+    if (config.twinRefreshSeconds > 0) {
+        activities.push_back({PeriodicActivity::TwinRefresh, std::chrono::seconds(config.twinRefreshSeconds)});
+    }
+    
+    PhaseAnalyzer::Options aligned;
+    aligned.phaseSpreading = false;
+    PhaseAnalyzer::Options spread;
+    spread.phaseSpreading = true;
+    spread.jitterFraction = config.periodicJitter;
+    
+    auto before = PhaseAnalyzer::analyze(deviceIds, activities, aligned);
+    auto after = PhaseAnalyzer::analyze(deviceIds, activities, spread);
+    
+    std::cout << "Phase report: " << deviceCount << " devices, 1 h horizon, 1 s buckets" << std::endl;
+    std::cout << "  Average rate:        " << after.averagePerSecond << " msg/s" << std::endl;
+    std::cout << "  Aligned peak:        " << before.peakPerSecond << " msg/s (peak/avg "
+              << before.peakToAverage << ")" << std::endl;
+    std::cout << "  Phase-spread peak:   " << after.peakPerSecond << " msg/s (peak/avg "
+              << after.peakToAverage << ")" << std::endl;
+}
+
+/**
+ * @brief Print the analytical capacity plan for a fleet
+ * 
+ * Sizes message rates, daily volume and IoT Hub units for the configured
+ * fleet without connecting anywhere (see CapacityPlanner.hpp).
+ * 
+ * @param config Base configuration
+ * @param inputs Device count and workload assumptions
+ */
+void printCapacityPlan(const SimulatorConfig& config, const CapacityPlanner::Inputs& inputs) {
+    auto started = std::chrono::steady_clock::now();
+    auto plan = CapacityPlanner::plan(config, inputs);
+    auto elapsedMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - started).count();
+    
+    std::cout << "Capacity plan: " << plan.deviceCount << " devices, heartbeat " << config.heartbeatSeconds
+              << " s, " << inputs.tripsPerDay << " trips/day, batch " << inputs.batchMessages
+              << ", phase spreading " << (plan.phaseSpreading ? "on" : "off") << std::endl;
+    std::cout << "  Events per trip:     " << plan.eventsPerTrip << " (" << plan.fenceTransitionsPerTrip
+              << " geofence transitions)" << std::endl;
+    std::cout << "  Events/device/day:   " << plan.eventsPerDeviceDay << std::endl;
+    std::cout << "  Payload:             " << plan.heartbeatBytes << " B heartbeat, "
+              << plan.meanEventBytes << " B mean event, " << plan.payloadBytesPerPublish
+              << " B per publish (" << plan.meteredPerPublish << " metered msg)" << std::endl;
+    std::cout << "  Average rate:        " << plan.averagePublishesPerSecond << " msg/s" << std::endl;
+    std::cout << "  Peak burst:          " << plan.peakPublishesPerSecond << " msg/s (busiest second of a day)" << std::endl;
+    if (plan.twinReadsPerSecond > 0.0) {
+        std::cout << "  Twin reads:          " << plan.twinReadsPerSecond << "/s average, "
+                  << plan.peakTwinReadsPerSecond << "/s peak" << std::endl;
+    }
+    if (plan.reconnectsPerSecond > 0.0) {
+        std::cout << "  Token reconnects:    " << plan.reconnectsPerSecond << "/s average, "
+                  << plan.peakReconnectsPerSecond << "/s peak" << std::endl;
+    }
+    std::cout << "  Metered msgs/day:    " << plan.meteredMessagesPerDay << std::endl;
+    std::cout << "  Payload bytes/day:   " << plan.payloadBytesPerDay / 1e6 << " MB ("
+              << plan.wireBytesPerDay / 1e6 << " MB with MQTT framing, excluding TLS)" << std::endl;
+    
+    std::cout << "  IoT Hub units:" << std::endl;
+    const auto* recommended = plan.recommended();
+    for (const auto& tier : plan.tiers) {
+        std::cout << "    " << tier.name << ": " << tier.units << " unit(s), limited by " << tier.limitedBy;
+        if (!tier.fits()) {
+            std::cout << " (exceeds " << tier.maxUnits << "-unit maximum)";
+        } else if (&tier == recommended) {
+            std::cout << " <- recommended";
+        }
+        std::cout << std::endl;
+    }
+    if (!recommended) {
+        std::cout << "    No single hub fits; shard the fleet across hubs" << std::endl;
+    }
+    std::cout << "  Planned in " << elapsedMs << " ms" << std::endl;
+}
+
+/**
+ * @brief Print one simulated day of scheduled trip starts per hour
+ * 
+ * Runs the fleet's activity model offline from midnight and compares the
+ * generated starts with the configured curves. Expected counts assume every
+ * vehicle is parked; vehicles still on a trip when a start falls due push the
+ * generated count below it in busy hours.
+ * 
+ * @param config Base configuration with [[activity.cohorts]]
+ * @param deviceCount Number of devices in the fleet
+ * @return false if the configuration has no valid activity model
+ */
+bool printActivityReport(const SimulatorConfig& config, std::size_t deviceCount) {
+    auto activity = config.activity;
+    activity.startHour = 0.0;
+    std::string error;
+    auto model = ActivityModel::create(activity, deviceCount, 1, error);
+    if (!model) {
+        std::cerr << "Activity report: " << (activity.enabled() ? error : "no [[activity.cohorts]] configured")
+                  << std::endl;
+        return false;
+    }
+    
+    auto started = std::chrono::steady_clock::now();
+    std::vector<ActivityModel::Trip> due;
+    std::array<std::uint64_t, ActivityModel::kHours> generated{};
+    for (std::size_t hour = 0; hour < ActivityModel::kHours; ++hour) {
+        // Fleet ticks at 1 Hz; the model only sees the clock at those instants
+        for (int second = 1; second <= 3600; ++second) {
+            model->advanceTo(static_cast<double>(hour * 3600 + second), due);
+            generated[hour] += due.size();
+        }
+    }
+    auto elapsedMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - started).count();
+    
+    std::uint64_t peak = 0;
+    std::size_t peakHour = 0;
+    for (std::size_t hour = 0; hour < ActivityModel::kHours; ++hour) {
+        if (generated[hour] > peak) {
+            peak = generated[hour];
+            peakHour = hour;
+        }
+    }
+    double average = static_cast<double>(model->tripsStarted()) / static_cast<double>(ActivityModel::kHours);
+    
+    std::cout << "Activity report: " << deviceCount << " devices, " << activity.cohorts.size()
+              << " cohort(s), 1 simulated day" << std::endl;
+    for (std::size_t i = 0; i < activity.cohorts.size(); ++i) {
+        std::size_t members = 0;
+        for (std::uint32_t vehicle = 0; vehicle < deviceCount; ++vehicle) {
+            members += model->cohortOf(vehicle) == i;
+        }
+        std::cout << "  Cohort " << activity.cohorts[i].name << ": " << members << " devices, "
+                  << activity.cohorts[i].tripMinutes << " min trips" << std::endl;
+    }
+    std::cout << "  Hour   Expected  Generated" << std::endl;
+    for (std::size_t hour = 0; hour < ActivityModel::kHours; ++hour) {
+        std::cout << "  " << std::setw(4) << hour << std::fixed << std::setprecision(1)
+                  << std::setw(11) << model->expectedTrips(hour) << std::defaultfloat
+                  << std::setw(11) << generated[hour] << std::endl;
+    }
+    std::cout << "  Trips/day:           " << model->tripsStarted() << std::endl;
+    std::cout << "  Peak hour:           " << peakHour << ":00 (" << peak << " starts, peak/avg "
+              << (average > 0.0 ? static_cast<double>(peak) / average : 0.0) << ")" << std::endl;
+    std::cout << "  Generated in " << elapsedMs << " ms" << std::endl;
+    return true;
+}
+
 /**
  * @brief Main application entry point
  * 
@@ -174,6 +379,25 @@ int main(int argc, char* argv[]) {
     bool headless = false;
     double driveDurationMinutes = 10.0;
     int spikeCount = 10;
+    bool phaseReport = false;
+    bool activityReport = false;
+    bool capacityPlan = false;
+    CapacityPlanner::Inputs planInputs;
+    bool statsMode = false;
+    bool watchCatalog = false;
+    std::string recordFile;
+    std::string traceRunId;
+    std::string fieldsFile;
+    std::string fenceIndexFile;
+    bool startupReport = false;
+    std::string startupJsonFile;
+    bool kernelTls = false;
+    std::vector<std::string> sourceAddresses;
+    bool leanConnections = false;
+    bool memoryReport = false;
+    std::string fotaImage;
+    std::size_t deviceCount = 1;
+    std::size_t tickWorkers = 1;
     
     // Parse command line arguments  
     std::string configFile = "simulator.toml";
@@ -199,6 +423,73 @@ int main(int argc, char* argv[]) {
             }
         } else if (arg == "--headless") {
             headless = true;
+        } else if (arg == "--devices") {
+            if (i + 1 < argc && argv[i + 1][0] != '-') {
+                deviceCount = std::max(1, std::stoi(argv[++i]));
+            }
+        } else if (arg == "--tick-workers") {
+            if (i + 1 < argc && argv[i + 1][0] != '-') {
+                tickWorkers = std::max(1, std::stoi(argv[++i]));
+            }
+        } else if (arg == "--phase-report") {
+            phaseReport = true;
+        } else if (arg == "--activity-report") {
+            activityReport = true;
+        } else if (arg == "--plan") {
+            capacityPlan = true;
+        } else if (arg == "--plan-trips") {
+            if (i + 1 < argc && argv[i + 1][0] != '-') {
+                planInputs.tripsPerDay = std::max(0.0, std::stod(argv[++i]));
+            }
+        } else if (arg == "--plan-batch") {
+            if (i + 1 < argc && argv[i + 1][0] != '-') {
+                planInputs.batchMessages = std::max(1, std::stoi(argv[++i]));
+            }
+        } else if (arg == "--plan-compression") {
+            if (i + 1 < argc && argv[i + 1][0] != '-') {
+                planInputs.compressionRatio = std::max(0.0, std::stod(argv[++i]));
+            }
+        } else if (arg == "--stats") {
+            statsMode = true;
+        } else if (arg == "--watch") {
+            watchCatalog = true;
+        } else if (arg == "--record") {
+            if (i + 1 < argc) {
+                recordFile = argv[++i];
+            }
+        } else if (arg == "--trace") {
+            if (i + 1 < argc) {
+                traceRunId = argv[++i];
+            }
+        } else if (arg == "--fields") {
+            if (i + 1 < argc) {
+                fieldsFile = argv[++i];
+            }
+        } else if (arg == "--fence-index") {
+            if (i + 1 < argc) {
+                fenceIndexFile = argv[++i];
+            }
+        } else if (arg == "--startup-report") {
+            startupReport = true;
+        } else if (arg == "--startup-json") {
+            startupReport = true;
+            if (i + 1 < argc) {
+                startupJsonFile = argv[++i];
+            }
+        } else if (arg == "--ktls") {
+            kernelTls = true;
+        } else if (arg == "--source-address") {
+            if (i + 1 < argc) {
+                sourceAddresses.push_back(argv[++i]);
+            }
+        } else if (arg == "--lean") {
+            leanConnections = true;
+        } else if (arg == "--memory-report") {
+            memoryReport = true;
+        } else if (arg == "--fota") {
+            if (i + 1 < argc) {
+                fotaImage = argv[++i];
+            }
         } else {
             std::cerr << "Unknown option: " << arg << std::endl;
             printUsage(argv[0]);
@@ -206,8 +497,66 @@ int main(int argc, char* argv[]) {
         }
     }
     
+    // Applies to the TLS contexts of every connection made from here on
+    if (kernelTls) {
+        auto ktls = KernelTls::enable();
+        if (ktls.available) {
+            std::cout << "[kTLS] Enabled; OpenSSL hands session keys to the kernel after each handshake" << std::endl;
+        } else {
+            std::cout << "[kTLS] Unavailable, using user-space TLS: " << ktls.reason << std::endl;
+            kernelTls = false;
+        }
+    }
+    
+    // Cold-start timelines begin before the configuration is parsed
+    std::shared_ptr<StartupProfiler> startupProfiler;
+    if (startupReport) {
+        startupProfiler = std::make_shared<StartupProfiler>();
+    }
+    
     // Load configuration from TOML file
     auto config = TomlConfig::loadFromFile(configFile);
+    if (!fieldsFile.empty()) {
+        config.fieldSchema = TomlConfig::loadFieldSchema(fieldsFile);
+        if (!config.fieldSchema) {
+            return 1;
+        }
+    }
+    if (!fenceIndexFile.empty()) {
+        config.fenceTree = TomlConfig::loadFenceTree(fenceIndexFile);
+        if (!config.fenceTree) {
+            return 1;
+        }
+        std::cout << "Fence index: " << config.fenceTree->fenceCount() << " fences, "
+                  << config.fenceTree->levels() << " levels, "
+                  << config.fenceTree->sizeBytes() / 1e6 << " MB mapped" << std::endl;
+    }
+    
+    // Offline analysis needs no credentials
+    if (phaseReport) {
+        printPhaseReport(config, deviceCount);
+        return 0;
+    }
+    if (activityReport) {
+        return printActivityReport(config, deviceCount) ? 0 : 1;
+    }
+    if (capacityPlan) {
+        planInputs.deviceCount = deviceCount;
+        printCapacityPlan(config, planInputs);
+        return 0;
+    }
+    
+    // The statistics panel replaces the per-event dump and implies headless
+    if (statsMode) {
+        config.logEvents = false;
+        if (!driveMode && !spikeMode) {
+            headless = true;
+        }
+    }
+    
+    if (!traceRunId.empty()) {
+        config.traceRunId = traceRunId;
+    }
     
     // Validate configuration (DPS or legacy)
     bool hasDpsConfig = config.hasDpsConfig();
@@ -216,13 +565,50 @@ int main(int argc, char* argv[]) {
     if (!hasDpsConfig && !hasLegacyConfig) {
         std::cerr << "Error: Missing required configuration in " << configFile << std::endl;
         std::cerr << "Required (DPS): id_scope, imei, device_cert_base_path, root_ca_path" << std::endl;
+        std::cerr << "OR Required (DPS symmetric key): id_scope, imei, enrollment_group_key" << std::endl;
         std::cerr << "OR Required (Legacy): iot_hub_host, device_id, device_key_base64" << std::endl;
         return 1;
     }
     
+    // Command-line addresses replace the [network] list
+    if (!sourceAddresses.empty()) {
+        config.sourceAddresses = sourceAddresses;
+    }
+    if (!config.sourceAddresses.empty()) {
+        std::string error;
+        if (!SourceAddressPool::configure(config.sourceAddresses, error)) {
+            std::cerr << "[Network] Invalid source addresses: " << error << std::endl;
+            return 1;
+        }
+        auto ports = SourceAddressPool::portsPerAddress();
+        std::cout << "[Network] Spreading connections over " << config.sourceAddresses.size() << " source addresses";
+        if (ports > 0) {
+            std::cout << " (up to " << ports * config.sourceAddresses.size() << " per broker endpoint)";
+        }
+        std::cout << std::endl;
+    }
+    
+    if (leanConnections) {
+        config.leanConnections = true;
+    }
+    if (config.leanConnections) {
+        auto lean = LeanConnections::enable();
+        if (lean.tlsHooks) {
+            std::cout << "[Lean] Idle TLS buffers released, 4 KB max fragment requested, one CA store per file"
+                      << std::endl;
+        } else {
+            std::cout << "[Lean] Lazy queues only: " << lean.reason << std::endl;
+        }
+    }
+    
     std::cout << "Starting MQTT Tracker Simulator" << std::endl;
     
-    if (hasDpsConfig) {
+    if (hasDpsConfig && config.hasDpsSymmetricKey()) {
+        std::cout << "Connection Mode: DPS (Symmetric Key"
+                  << (config.enrollmentGroupKeyBase64.empty() ? ")" : ", Group Enrollment)") << std::endl;
+        std::cout << "ID Scope: " << config.idScope << std::endl;
+        std::cout << "IMEI: " << config.imei << std::endl;
+    } else if (hasDpsConfig) {
         std::cout << "Connection Mode: DPS (X.509 Certificates)" << std::endl;
         std::cout << "ID Scope: " << config.idScope << std::endl;
         std::cout << "IMEI: " << config.imei << std::endl;
@@ -234,39 +620,236 @@ int main(int argc, char* argv[]) {
     }
     
     std::cout << "Heartbeat: " << config.heartbeatSeconds << "s" << std::endl;
+    std::cout << "Devices: " << deviceCount << std::endl;
+    if (tickWorkers > 1) {
+        std::cout << "Tick workers: " << tickWorkers << std::endl;
+    }
     
     // Create platform-specific dependencies using dependency injection pattern
     // This design enables easy porting to embedded platforms (STM32, etc.)
-    auto mqttClient = std::make_shared<PahoMqttClient>();  // Desktop MQTT implementation
     auto clock = std::make_shared<SystemClock>();          // System time abstraction
     auto rng = std::make_shared<StandardRng>();            // Standard C++ RNG
     
-    // Create and configure simulator with injected dependencies
-    Simulator simulator(mqttClient, clock, rng);
-    simulator.configure(config);
+    // Outlives the fleet, whose event callbacks write to it
+    EventRecorder recorder;
+    
+    // Firmware downloads requested by twin "ota" patches (or --fota); outlives the fleet's twin callbacks
+    if (!fotaImage.empty()) {
+        config.fota.imageDirectory.clear();   // The image is named by its path
+    }
+    FirmwareCampaign firmware(std::make_shared<FirmwareImageSource>(config.fota.imageDirectory), config.fota);
+    
+    // Create and configure the fleet; each device gets its own desktop MQTT client
+    Fleet fleet([]() { return std::make_shared<PahoMqttClient>(); }, clock, rng);
+    fleet.setStartupProfiler(startupProfiler);
+    fleet.setTickWorkers(tickWorkers);
+    fleet.configure(config, deviceCount);
     
-    // Create Device Twin configuration adapter (Hexagonal Architecture)
+    // Create Device Twin configuration adapters (Hexagonal Architecture)
     // Note: Actual MQTT client will be configured after DPS connection
-    const std::string deviceIdForTwin = hasDpsConfig ? config.imei : config.deviceId;
-    g_twinHandler = std::make_shared<TwinHandler>(mqttClient, deviceIdForTwin);
+    fleet.forEach([&](Simulator& simulator) {
+        const auto& deviceConfig = simulator.getConfig();
+        const std::string deviceIdForTwin = hasDpsConfig ? deviceConfig.imei : deviceConfig.deviceId;
+        auto twinHandler = std::make_shared<TwinHandler>(simulator.getMqttClient(), deviceIdForTwin);
+        
+        // Integrate Device Twin adapter with domain core (Observer pattern)
+        simulator.setTwinHandler(twinHandler);
+        g_twinHandlers.push_back(twinHandler);
+        
+        const std::size_t device = g_twinHandlers.size() - 1;
+        simulator.setFirmwareUpdateCallback([&firmware, &simulator, device](const nlohmann::json& ota) {
+            FirmwareJob job;
+            std::string error;
+            if (!FirmwareJob::fromDesired(ota, job, error)) {
+                std::cerr << "[FOTA] " << simulator.getConfig().deviceId << ": " << error << std::endl;
+                return;
+            }
+            firmware.start(device, simulator.getConfig().deviceId, job);
+        });
+    });
     
-    // Integrate Device Twin adapter with domain core (Observer pattern)
-    simulator.setTwinHandler(g_twinHandler);
+    // Report each finished download through the device's current twin (hub client under DPS)
+    firmware.setFinishedCallback([&fleet](std::size_t device, const FirmwareCampaign::Result& result) {
+        if (!fleet.device(device).isConnected()) {
+            return;
+        }
+        nlohmann::json ota = {
+            {"version", result.version},
+            {"status", result.state == FirmwareCampaign::State::Verified ? "verified" : "failed"},
+            {"bytes", result.bytes},
+            {"seconds", result.seconds}
+        };
+        if (!result.error.empty()) {
+            ota["error"] = result.error;
+        }
+        fleet.device(device).reportFirmware(ota);
+    });
     
-    // Start simulator
-    simulator.start();
+    // X.509 fleets: read and parse every device chain and key before the first connect
+    if (hasDpsConfig && !config.hasDpsSymmetricKey()) {
+        std::vector<std::string> chains{config.rootCaPath};
+        std::vector<std::string> keys;
+        fleet.forEach([&](Simulator& simulator) {
+            const auto& deviceConfig = simulator.getConfig();
+            chains.push_back(deviceConfig.deviceChainPath);  // Presented to both DPS and IoT Hub
+            keys.push_back(deviceConfig.deviceKeyPath);
+        });
+        auto keystore = CredentialStore::preload(chains, keys);
+        std::cout << "[Keystore] " << keystore.certificates << " certificates and " << keystore.keys << " keys from "
+                  << keystore.files << " files in " << keystore.seconds * 1000.0 << " ms ("
+                  << static_cast<std::uint64_t>(keystore.certificatesPerSecond()) << " certificates/s, "
+                  << keystore.threads << " threads"
+                  << (CredentialStore::servesTls() ? ", served to TLS from memory" : "") << ")" << std::endl;
+        if (keystore.failed > 0) {
+            std::cerr << "[Keystore] " << keystore.failed << " file(s) not loaded, first: " << keystore.firstError
+                      << std::endl;
+        }
+    }
+    
+    // Record exactly what is published (plus the receive stamp when tracing), for offline verification
+    if (!recordFile.empty()) {
+        if (!recorder.open(recordFile)) {
+            std::cerr << "Error: Cannot open record file " << recordFile << std::endl;
+            return 1;
+        }
+        // Merged by (tick, device, sequence): the same order for any --tick-workers
+        if (config.traceRunId.empty()) {
+            fleet.setOrderedEventSink([&recorder](const std::string& json) { recorder.record(json); });
+        } else {
+            // The recorder is the consumer: its write time ends the traced path
+            fleet.setOrderedEventSink([&recorder](const std::string& json) {
+                recorder.record(JsonCodec::stampReceived(json, traceClockUs()));
+            });
+        }
+        std::cout << "Recording events to " << recordFile << std::endl;
+    }
+    
+    // Report cold start once every device has a PUBACK (or at shutdown if some never do)
+    bool startupReported = false;
+    auto reportStartup = [&](bool final) {
+        if (!startupProfiler || startupReported || (!final && !startupProfiler->finished())) {
+            return;
+        }
+        startupReported = true;
+        std::cout << "\n";
+        startupProfiler->print(std::cout);
+        if (!startupJsonFile.empty()) {
+            std::ofstream json(startupJsonFile);
+            json << startupProfiler->toJson() << "\n";
+            std::cout << (json ? "Startup report written to " : "Error: Cannot write startup report to ")
+                      << startupJsonFile << std::endl;
+        }
+    };
+    
+    // Once every device is connected: trim the handshake peak (lean) and report bytes per connection
+    bool memorySettled = !config.leanConnections && !memoryReport;
+    std::size_t residentBeforeConnect = LeanConnections::residentBytes();
+    auto reportMemory = [&](bool final) {
+        if (memorySettled) {
+            return;
+        }
+        std::size_t connected = 0;
+        fleet.forEach([&](Simulator& simulator) { connected += simulator.isConnected() ? 1 : 0; });
+        if (!final && connected < fleet.size()) {
+            return;
+        }
+        memorySettled = true;
+        if (config.leanConnections) {
+            LeanConnections::releaseFreedMemory();
+        }
+        if (!memoryReport) {
+            return;
+        }
+        std::size_t resident = LeanConnections::residentBytes();
+        std::size_t growth = resident > residentBeforeConnect ? resident - residentBeforeConnect : 0;
+        std::cout << "[Memory] " << connected << "/" << fleet.size() << " devices connected, resident "
+                  << resident / 1e6 << " MB (+" << growth / 1e6 << " MB since connecting)";
+        if (connected > 0) {
+            std::cout << ", " << growth / connected << " bytes per connection";
+        }
+        if (config.leanConnections) {
+            std::cout << ", " << LeanConnections::sharedTrustStores() << " shared CA store(s)";
+        }
+        std::cout << std::endl;
+    };
+    
+    // Progress every 10 s while downloads run; summary once all have finished
+    auto lastFirmwareReport = std::chrono::steady_clock::now();
+    bool firmwareReported = false;
+    auto reportFirmware = [&](bool final) {
+        auto report = firmware.report();
+        if (report.started == 0 || firmwareReported) {
+            return;
+        }
+        auto now = std::chrono::steady_clock::now();
+        if (!report.done() && !final) {
+            if (now - lastFirmwareReport >= std::chrono::seconds(10)) {
+                lastFirmwareReport = now;
+                std::cout << "[FOTA] " << report.verified << "/" << report.started << " verified, "
+                          << report.active << " downloading, " << report.queued << " queued, "
+                          << report.bytesPerSecond() / 1e6 << " MB/s" << std::endl;
+            }
+            return;
+        }
+        firmwareReported = true;
+        std::cout << "[FOTA] " << report.verified << "/" << report.started << " verified in " << report.seconds
+                  << " s: " << report.bytesPerSecond() / 1e6 << " MB/s aggregate, time to complete p50 "
+                  << report.p50Seconds << " s, p95 " << report.p95Seconds << " s, max " << report.maxSeconds
+                  << " s, " << report.resumes << " resumed ranges" << std::endl;
+        if (report.failed > 0) {
+            std::cerr << "[FOTA] " << report.failed << " failed, first: " << report.firstError << std::endl;
+        }
+    };
+    
+    FirmwareJob localImage;
+    if (!fotaImage.empty()) {
+        std::error_code sizeError;
+        auto size = std::filesystem::file_size(fotaImage, sizeError);
+        localImage = {"local", fotaImage, Sha256::fileHex(fotaImage), sizeError ? 0 : size};
+        if (localImage.sha256.empty() || localImage.size == 0) {
+            std::cerr << "[FOTA] Cannot read image " << fotaImage << std::endl;
+            return 1;
+        }
+    }
+    
+    // Start simulators
+    fleet.start();
+    
+    if (!fotaImage.empty()) {
+        std::size_t device = 0;
+        fleet.forEach([&](Simulator& simulator) {
+            firmware.start(device++, simulator.getConfig().deviceId, localImage);
+        });
+        std::cout << "[FOTA] " << fleet.size() << " device(s) downloading " << fotaImage << " (" << localImage.size
+                  << " bytes, sha256 " << localImage.sha256.substr(0, 16) << "...)" << std::endl;
+    }
+    
+    std::unique_ptr<StatsConsole> statsConsole;
+    if (statsMode) {
+        statsConsole = std::make_unique<StatsConsole>(fleet);
+    }
+    
+    // Route/geofence edits are rebuilt off-thread and picked up by the next tick
+    std::unique_ptr<CatalogWatcher> catalogWatcher;
+    if (watchCatalog) {
+        catalogWatcher = std::make_unique<CatalogWatcher>(configFile, fleet.catalogs(), config.startLocation);
+        catalogWatcher->start();
+    }
     
     // Handle different modes
     if (spikeMode) {
         std::cout << "Generating spike of " << spikeCount << " events..." << std::endl;
-        simulator.generateSpike(spikeCount);
+        fleet.forEach([&](Simulator& simulator) { simulator.generateSpike(spikeCount); });
         
         // Wait a bit for messages to be sent
         std::this_thread::sleep_for(std::chrono::seconds(2));
+        if (statsConsole) {
+            statsConsole->render();
+        }
         
     } else if (driveMode) {
         std::cout << "Starting driving simulation for " << driveDurationMinutes << " minutes..." << std::endl;
-        simulator.startDriving(driveDurationMinutes);
+        fleet.forEach([&](Simulator& simulator) { simulator.startDriving(driveDurationMinutes); });
         
         // Run simulation
         auto endTime = std::chrono::steady_clock::now() + 
@@ -274,18 +857,32 @@ int main(int argc, char* argv[]) {
                           std::chrono::duration<double>(driveDurationMinutes * 60));
         
         while (g_running && std::chrono::steady_clock::now() < endTime) {
-            simulator.tick();
+            fleet.tick();
+            reportStartup(false);
+            reportMemory(false);
+            reportFirmware(false);
+            if (statsConsole) {
+                statsConsole->renderIfDue();
+            }
             std::this_thread::sleep_for(std::chrono::milliseconds(1000));
         }
         
-        simulator.setSpeed(0.0);
-        simulator.setIgnition(false);
+        fleet.forEach([](Simulator& simulator) {
+            simulator.setSpeed(0.0);
+            simulator.setIgnition(false);
+        });
         
     } else if (headless) {
         std::cout << "Running in headless mode. Press Ctrl+C to stop." << std::endl;
         
         while (g_running) {
-            simulator.tick();
+            fleet.tick();
+            reportStartup(false);
+            reportMemory(false);
+            reportFirmware(false);
+            if (statsConsole) {
+                statsConsole->renderIfDue();
+            }
             std::this_thread::sleep_for(std::chrono::milliseconds(1000));
         }
         
@@ -297,8 +894,24 @@ int main(int argc, char* argv[]) {
         std::cout << "  b - Set battery percentage" << std::endl;
         std::cout << "  d - Start driving" << std::endl;
         std::cout << "  p - Generate spike" << std::endl;
+        std::cout << "  n - Nearest devices to a point" << std::endl;
+        std::cout << "  r - Devices inside a lat/lon box" << std::endl;
+        std::cout << "  g - Devices inside a geofence" << std::endl;
         std::cout << "  q - Quit" << std::endl;
         
+        // Queries read per-tick snapshots and never hold up the tick loop
+        fleet.enableSpatialIndex();
+        auto printDevices = [](const FleetSnapshot& snapshot, const std::vector<std::uint32_t>& devices) {
+            std::cout << "[Query] " << devices.size() << " device(s) at tick " << snapshot.tick() << std::endl;
+            for (std::size_t i = 0; i < devices.size() && i < 20; ++i) {
+                auto location = snapshot.location(devices[i]);
+                std::cout << "  " << snapshot.deviceId(devices[i]) << " (" << location.lat << ", " << location.lon << ")" << std::endl;
+            }
+            if (devices.size() > 20) {
+                std::cout << "  ..." << std::endl;
+            }
+        };
+        
         bool ignitionOn = false;
         
         std::thread inputThread([&]() {
@@ -308,7 +921,7 @@ int main(int argc, char* argv[]) {
                 switch (cmd) {
                     case 'i':
                         ignitionOn = !ignitionOn;
-                        simulator.setIgnition(ignitionOn);
+                        fleet.forEach([&](Simulator& simulator) { simulator.setIgnition(ignitionOn); });
                         std::cout << "Ignition " << (ignitionOn ? "ON" : "OFF") << std::endl;
                         break;
                         
@@ -316,7 +929,7 @@ int main(int argc, char* argv[]) {
                         double speed;
                         std::cout << "Enter speed (km/h): ";
                         std::cin >> speed;
-                        simulator.setSpeed(speed);
+                        fleet.forEach([&](Simulator& simulator) { simulator.setSpeed(speed); });
                         std::cout << "Speed set to " << speed << " km/h" << std::endl;
                         break;
                     }
@@ -325,7 +938,7 @@ int main(int argc, char* argv[]) {
                         double battery;
                         std::cout << "Enter battery percentage: ";
                         std::cin >> battery;
-                        simulator.setBatteryPercentage(battery);
+                        fleet.forEach([&](Simulator& simulator) { simulator.setBatteryPercentage(battery); });
                         std::cout << "Battery set to " << battery << "%" << std::endl;
                         break;
                     }
@@ -334,7 +947,7 @@ int main(int argc, char* argv[]) {
                         double duration;
                         std::cout << "Enter drive duration (minutes): ";
                         std::cin >> duration;
-                        simulator.startDriving(duration);
+                        fleet.forEach([&](Simulator& simulator) { simulator.startDriving(duration); });
                         std::cout << "Started driving for " << duration << " minutes" << std::endl;
                         break;
                     }
@@ -343,11 +956,43 @@ int main(int argc, char* argv[]) {
                         int count;
                         std::cout << "Enter event count: ";
                         std::cin >> count;
-                        simulator.generateSpike(count);
+                        fleet.forEach([&](Simulator& simulator) { simulator.generateSpike(count); });
                         std::cout << "Generated " << count << " events" << std::endl;
                         break;
                     }
                     
+                    case 'n':
+                    case 'r':
+                    case 'g': {
+                        auto snapshot = fleet.spatialIndex()->snapshot();
+                        if (!snapshot) {
+                            std::cout << "No positions yet, try again after the next tick" << std::endl;
+                            break;
+                        }
+                        if (cmd == 'n') {
+                            Location point;
+                            std::size_t count;
+                            std::cout << "Enter lat lon count: ";
+                            std::cin >> point.lat >> point.lon >> count;
+                            std::vector<std::uint32_t> devices;
+                            for (const auto& hit : snapshot->nearest(point, count)) {
+                                devices.push_back(hit.device);
+                            }
+                            printDevices(*snapshot, devices);
+                        } else if (cmd == 'r') {
+                            Location southWest, northEast;
+                            std::cout << "Enter south_lat west_lon north_lat east_lon: ";
+                            std::cin >> southWest.lat >> southWest.lon >> northEast.lat >> northEast.lon;
+                            printDevices(*snapshot, snapshot->inBox(southWest, northEast));
+                        } else {
+                            std::string fenceId;
+                            std::cout << "Enter geofence id: ";
+                            std::cin >> fenceId;
+                            printDevices(*snapshot, snapshot->inFence(fenceId));
+                        }
+                        break;
+                    }
+                    
                     case 'q':
                         g_running = false;
                         break;
@@ -360,7 +1005,10 @@ int main(int argc, char* argv[]) {
         });
         
         while (g_running) {
-            simulator.tick();
+            fleet.tick();
+            reportStartup(false);
+            reportMemory(false);
+            reportFirmware(false);
             std::this_thread::sleep_for(std::chrono::milliseconds(1000));
         }
         
@@ -368,12 +1016,35 @@ int main(int argc, char* argv[]) {
     }
     
     std::cout << "Stopping simulator..." << std::endl;
-    simulator.stop();
+    reportStartup(true);
+    reportMemory(true);
+    reportFirmware(true);
+    firmware.stop();
+    if (kernelTls) {
+        // Sampled before disconnecting: the current counts drop as sessions close
+        auto counters = KernelTls::counters();
+        std::cout << "[kTLS] Sessions with kernel TX: " << counters.currentTxSoftware << " software, "
+                  << counters.currentTxDevice << " NIC offload (system-wide)" << std::endl;
+    }
+    for (const auto& count : SourceAddressPool::counts()) {
+        std::cout << "[Network] " << count.address << ": " << count.open << " open, " << count.total
+                  << " connected";
+        if (count.failures > 0) {
+            std::cout << ", " << count.failures << " bind failures";
+        }
+        std::cout << std::endl;
+    }
+    fleet.stop();
+    
+    if (!recordFile.empty()) {
+        std::cout << "Recorded " << recorder.events() << " events to " << recordFile << std::endl;
+        recorder.close();
+    }
     
-    // Clean up Device Twin handler
-    if (g_twinHandler) {
-        g_twinHandler.reset();
-        std::cout << "Device Twin handler stopped." << std::endl;
+    // Clean up Device Twin handlers
+    if (!g_twinHandlers.empty()) {
+        g_twinHandlers.clear();
+        std::cout << "Device Twin handlers stopped." << std::endl;
     }
     
     // Allow time for graceful shutdown and message transmission
@@ -0,0 +1,243 @@
+/**
+ * @file main_fence_index.cpp
+ * @brief fence-index: build the out-of-core geofence index from a CSV file
+ *
+ * Input is one fence per line, `id,lat,lon,radius_m`; blank lines, `#`
+ * comments and a leading `id,...` header are skipped. The input is mapped and
+ * parsed in parallel chunks, then FenceTree::build() keys, sorts and writes
+ * pages in parallel. The index is written next to the output and renamed over
+ * it, so processes still mapping the previous file keep a consistent copy.
+ *
+ * `--query LAT LON INDEX` prints the fences containing a point and the pages
+ * the lookup read.
+ */
+
+#include "FenceTree.hpp"
+#include "MappedFile.hpp"
+#include <algorithm>
+#include <charconv>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <functional>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+using namespace tracker;
+
+namespace {
+
+void printUsage(const char* programName) {
+    std::cout << "Usage: " << programName << " [options] INPUT.csv OUTPUT.idx\n"
+              << "       " << programName << " --query LAT LON INDEX\n"
+              << "Build a memory-mapped geofence index (sim-cli --fence-index) from id,lat,lon,radius_m lines.\n"
+              << "Options:\n"
+              << "  --threads [n]      Parse and build threads (default: all cores)\n"
+              << "  --help             Show this help message\n"
+              << "Exit codes: 0 success, 1 invalid input, 2 unreadable or unwritable file\n"
+              << std::endl;
+}
+
+/// Fences parsed from one chunk of the input
+struct ChunkResult {
+    std::vector<FenceRecord> fences;
+    std::size_t invalid = 0;
+    std::string firstInvalid;
+};
+
+bool parseNumber(std::string_view text, double& value) {
+    while (!text.empty() && (text.front() == ' ' || text.front() == '\t')) text.remove_prefix(1);
+    while (!text.empty() && (text.back() == ' ' || text.back() == '\t' || text.back() == '\r')) text.remove_suffix(1);
+    auto result = std::from_chars(text.data(), text.data() + text.size(), value);
+    return result.ec == std::errc() && result.ptr == text.data() + text.size();
+}
+
+void parseChunk(const char* begin, const char* end, bool skipHeader, ChunkResult& result) {
+    const char* p = begin;
+    while (p < end) {
+        auto newline = static_cast<const char*>(std::memchr(p, '\n', static_cast<std::size_t>(end - p)));
+        const char* lineEnd = newline ? newline : end;
+        std::string_view line(p, static_cast<std::size_t>(lineEnd - p));
+        p = lineEnd + 1;
+
+        std::string_view trimmed = line.substr(std::min(line.size(), line.find_first_not_of(" \t\r")));
+        if (trimmed.empty() || trimmed.front() == '#') {
+            continue;
+        }
+        if (skipHeader) {
+            skipHeader = false;
+            if (trimmed.substr(0, 3) == "id,") continue;
+        }
+
+        // id may contain anything but a comma; the last three fields are numbers
+        std::string_view fields[4];
+        std::size_t count = 0;
+        std::string_view rest = trimmed;
+        while (count < 3) {
+            auto comma = rest.find(',');
+            if (comma == std::string_view::npos) break;
+            fields[count++] = rest.substr(0, comma);
+            rest.remove_prefix(comma + 1);
+        }
+        fields[count++] = rest;
+
+        FenceRecord fence;
+        double radius = 0.0;
+        if (count != 4 || fields[0].empty() || !parseNumber(fields[1], fence.lat) ||
+            !parseNumber(fields[2], fence.lon) || !parseNumber(fields[3], radius)) {
+            if (result.invalid++ == 0) result.firstInvalid = std::string(line);
+            continue;
+        }
+        fence.id = std::string(fields[0]);
+        fence.radiusMeters = static_cast<float>(radius);
+        result.fences.push_back(std::move(fence));
+    }
+}
+
+int runQuery(double lat, double lon, const std::string& path) {
+    auto file = std::make_shared<MappedFile>(path, MappedFile::Access::Random);
+    if (!file->ok()) {
+        std::cerr << "[FenceIndex] Cannot read " << path << std::endl;
+        return 2;
+    }
+    std::string error;
+    auto tree = FenceTree::open(file, file->data(), file->size(), error);
+    if (!tree) {
+        std::cerr << "[FenceIndex] " << path << ": " << error << std::endl;
+        return 2;
+    }
+
+    std::vector<std::uint32_t> inside;
+    auto started = std::chrono::steady_clock::now();
+    auto lookup = tree->query(lat, lon, inside);
+    auto elapsedUs = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - started).count();
+
+    std::cout << path << ": " << tree->fenceCount() << " fences, " << tree->levels() << " levels" << std::endl;
+    std::cout << "  " << inside.size() << " fence(s) contain " << lat << ", " << lon << " (" << lookup.pages
+              << " pages, " << elapsedUs << " us" << (lookup.complete ? "" : ", page budget exhausted") << ")"
+              << std::endl;
+    for (auto fence : inside) {
+        std::cout << "    " << tree->id(fence) << std::endl;
+    }
+    return 0;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    FenceTree::BuildOptions options;
+    std::vector<std::string> files;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--help") {
+            printUsage(argv[0]);
+            return 0;
+        } else if (arg == "--threads") {
+            if (i + 1 < argc) {
+                options.threads = static_cast<unsigned>(std::max(1, std::stoi(argv[++i])));
+            }
+        } else if (arg == "--query") {
+            if (i + 3 >= argc) {
+                printUsage(argv[0]);
+                return 2;
+            }
+            return runQuery(std::stod(argv[i + 1]), std::stod(argv[i + 2]), argv[i + 3]);
+        } else if (!arg.empty() && arg[0] == '-') {
+            std::cerr << "Unknown option: " << arg << std::endl;
+            printUsage(argv[0]);
+            return 2;
+        } else {
+            files.push_back(arg);
+        }
+    }
+    if (files.size() != 2) {
+        printUsage(argv[0]);
+        return 2;
+    }
+
+    auto started = std::chrono::steady_clock::now();
+    MappedFile input(files[0]);
+    if (!input.ok()) {
+        std::cerr << "[FenceIndex] Cannot read " << files[0] << std::endl;
+        return 2;
+    }
+
+    // Parse one chunk per thread, split at line boundaries
+    unsigned threads = options.threads ? options.threads : std::max(1u, std::thread::hardware_concurrency());
+    threads = static_cast<unsigned>(std::clamp<std::size_t>(input.size() >> 20, 1, threads));
+    const char* data = input.data();
+    const std::size_t size = input.size();
+    std::vector<const char*> bounds{data};
+    for (unsigned i = 1; i < threads; ++i) {
+        const char* p = std::max(bounds.back(), data + size * i / threads);
+        auto newline = static_cast<const char*>(std::memchr(p, '\n', static_cast<std::size_t>(data + size - p)));
+        bounds.push_back(newline ? newline + 1 : data + size);
+    }
+    bounds.push_back(data + size);
+
+    std::vector<ChunkResult> chunks(threads);
+    std::vector<std::thread> workers;
+    for (unsigned i = 1; i < threads; ++i) {
+        workers.emplace_back(parseChunk, bounds[i], bounds[i + 1], false, std::ref(chunks[i]));
+    }
+    parseChunk(bounds[0], bounds[1], true, chunks[0]);
+    for (auto& worker : workers) worker.join();
+
+    std::vector<FenceRecord> fences;
+    std::size_t invalid = 0;
+    std::string firstInvalid;
+    std::size_t total = 0;
+    for (const auto& chunk : chunks) total += chunk.fences.size();
+    fences.reserve(total);
+    for (auto& chunk : chunks) {
+        std::move(chunk.fences.begin(), chunk.fences.end(), std::back_inserter(fences));
+        if (chunk.invalid && invalid == 0) firstInvalid = chunk.firstInvalid;
+        invalid += chunk.invalid;
+    }
+    if (invalid) {
+        std::cerr << "[FenceIndex] " << files[0] << ": " << invalid << " invalid line(s), first: " << firstInvalid
+                  << std::endl;
+        return 1;
+    }
+    double parseSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - started).count();
+
+    std::string error;
+    auto image = FenceTree::build(fences, options, error);
+    if (image.empty()) {
+        std::cerr << "[FenceIndex] " << files[0] << ": " << error << std::endl;
+        return 1;
+    }
+    double buildSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - started).count() - parseSeconds;
+
+    std::string temporary = files[1] + ".tmp";
+    {
+        std::ofstream out(temporary, std::ios::binary | std::ios::trunc);
+        out.write(image.data(), static_cast<std::streamsize>(image.size()));
+        if (!out) {
+            std::cerr << "[FenceIndex] Cannot write " << temporary << std::endl;
+            return 2;
+        }
+    }
+    std::error_code renameError;
+    std::filesystem::rename(temporary, files[1], renameError);
+    if (renameError) {
+        std::cerr << "[FenceIndex] Cannot replace " << files[1] << ": " << renameError.message() << std::endl;
+        return 2;
+    }
+
+    auto tree = FenceTree::open(nullptr, image.data(), image.size(), error);
+    std::cout << files[1] << ": " << fences.size() << " fences, " << tree->pageCount() << " pages, "
+              << tree->levels() << " levels, " << image.size() / 1e6 << " MB (nodes "
+              << tree->nodesSize() / 1e3 << " KB)" << std::endl;
+    std::cout << "  Parsed in " << parseSeconds * 1000.0 << " ms, built in " << buildSeconds * 1000.0 << " ms ("
+              << (options.threads ? options.threads : std::thread::hardware_concurrency()) << " threads)"
+              << std::endl;
+    return 0;
+}
@@ -0,0 +1,317 @@
+/**
+ * @file main_tls_bench.cpp
+ * @brief tls-bench: sender CPU per MB for user-space TLS versus kernel TLS (Linux)
+ *
+ * Streams a segment of pre-encoded telemetry over a loopback TLS 1.2
+ * connection and measures the user and system CPU of the sending thread. The
+ * segment is an NDJSON log from `sim-cli --record`, or synthetic events. The
+ * cipher is ECDHE-ECDSA-AES128-GCM-SHA256 with the same protocol version the
+ * MQTT client forces. A receiver thread in the same process decrypts and
+ * discards the data.
+ *
+ * | Mode          | Send path                                                  |
+ * |---------------|------------------------------------------------------------|
+ * | user          | SSL_write; records encrypted in user space (current path)  |
+ * | ktls          | SSL_write with SSL_OP_ENABLE_KTLS; encrypted in the kernel |
+ * | ktls-sendfile | SSL_sendfile straight from the segment file, no user copy  |
+ *
+ * kTLS modes are skipped with the reason when OpenSSL, the kernel or the
+ * negotiated cipher does not support the offload. The receiver's CPU is not
+ * included; it runs user-space TLS in every mode.
+ */
+
+#include "KernelTls.hpp"
+#include "MappedFile.hpp"
+#include <openssl/ec.h>
+#include <openssl/err.h>
+#include <openssl/evp.h>
+#include <openssl/ssl.h>
+#include <openssl/x509.h>
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <sys/resource.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace tracker;
+
+namespace {
+
+constexpr const char* kCipher = "ECDHE-ECDSA-AES128-GCM-SHA256";
+constexpr std::size_t kSyntheticBytes = 8u << 20;
+
+enum class Mode { User, Ktls, KtlsSendfile };
+
+struct Result {
+    bool ran = false;
+    std::string skipped;            ///< Reason a kTLS mode did not run
+    std::uint64_t bytes = 0;
+    double wallSeconds = 0.0;
+    double userSeconds = 0.0;
+    double systemSeconds = 0.0;
+};
+
+void printUsage(const char* programName) {
+    std::cout << "Usage: " << programName << " [options]\n"
+              << "Compare sender CPU per MB for user-space TLS and kernel TLS over loopback.\n"
+              << "Options:\n"
+              << "  --file [ndjson]    Segment to send (default: synthetic events)\n"
+              << "  --mb [n]           Megabytes sent per mode (default: 256)\n"
+              << "  --batch [bytes]    SSL_write size for the write modes (default: 16384)\n"
+              << "  --help             Show this help message\n"
+              << std::endl;
+}
+
+double seconds(const timeval& value) {
+    return static_cast<double>(value.tv_sec) + static_cast<double>(value.tv_usec) / 1e6;
+}
+
+/// Self-signed P-256 certificate for the loopback receiver
+bool makeCredentials(EVP_PKEY*& key, X509*& certificate) {
+    key = EVP_EC_gen("P-256");
+    certificate = X509_new();
+    if (!key || !certificate) return false;
+    X509_set_version(certificate, 2);
+    ASN1_INTEGER_set(X509_get_serialNumber(certificate), 1);
+    X509_gmtime_adj(X509_getm_notBefore(certificate), 0);
+    X509_gmtime_adj(X509_getm_notAfter(certificate), 3600);
+    X509_set_pubkey(certificate, key);
+    X509_NAME* name = X509_get_subject_name(certificate);
+    X509_NAME_add_entry_by_txt(name, "CN", MBSTRING_ASC, reinterpret_cast<const unsigned char*>("localhost"), -1, -1, 0);
+    X509_set_issuer_name(certificate, name);
+    return X509_sign(certificate, key, EVP_sha256()) > 0;
+}
+
+SSL_CTX* makeContext(bool server, bool kernelTls, EVP_PKEY* key, X509* certificate) {
+    SSL_CTX* context = SSL_CTX_new(server ? TLS_server_method() : TLS_client_method());
+    if (!context) return nullptr;
+    SSL_CTX_set_min_proto_version(context, TLS1_2_VERSION);
+    SSL_CTX_set_max_proto_version(context, TLS1_2_VERSION);
+    SSL_CTX_set_cipher_list(context, kCipher);
+    if (server) {
+        SSL_CTX_use_certificate(context, certificate);
+        SSL_CTX_use_PrivateKey(context, key);
+    } else {
+        SSL_CTX_set_verify(context, SSL_VERIFY_NONE, nullptr);
+    }
+    if (kernelTls) {
+        SSL_CTX_set_options(context, SSL_OP_ENABLE_KTLS);
+    }
+    return context;
+}
+
+/// Accept one connection and drain it; returns plaintext bytes received
+void receive(int listener, SSL_CTX* context, std::atomic<std::uint64_t>& received) {
+    int fd = accept(listener, nullptr, nullptr);
+    if (fd < 0) return;
+    SSL* ssl = SSL_new(context);
+    SSL_set_fd(ssl, fd);
+    if (SSL_accept(ssl) == 1) {
+        std::vector<char> buffer(1 << 16);
+        int n;
+        while ((n = SSL_read(ssl, buffer.data(), static_cast<int>(buffer.size()))) > 0) {
+            received.fetch_add(static_cast<std::uint64_t>(n), std::memory_order_relaxed);
+        }
+    }
+    SSL_free(ssl);
+    close(fd);
+}
+
+Result run(Mode mode, const MappedFile& segment, int segmentFd, std::uint64_t totalBytes, std::size_t batch,
+           EVP_PKEY* key, X509* certificate) {
+    Result result;
+    bool kernelTls = mode != Mode::User;
+
+    int listener = socket(AF_INET, SOCK_STREAM, 0);
+    sockaddr_in address{};
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    socklen_t length = sizeof(address);
+    if (bind(listener, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0 ||
+        listen(listener, 1) != 0 ||
+        getsockname(listener, reinterpret_cast<sockaddr*>(&address), &length) != 0) {
+        result.skipped = "loopback listener failed";
+        close(listener);
+        return result;
+    }
+
+    SSL_CTX* serverContext = makeContext(true, false, key, certificate);
+    SSL_CTX* clientContext = makeContext(false, kernelTls, key, certificate);
+    std::atomic<std::uint64_t> received{0};
+    std::thread receiver(receive, listener, serverContext, std::ref(received));
+
+    int fd = socket(AF_INET, SOCK_STREAM, 0);
+    SSL* ssl = nullptr;
+    if (connect(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) == 0) {
+        ssl = SSL_new(clientContext);
+        SSL_set_fd(ssl, fd);
+        if (SSL_connect(ssl) != 1) {
+            SSL_free(ssl);
+            ssl = nullptr;
+        }
+    }
+
+    if (!ssl) {
+        result.skipped = "handshake failed";
+    } else if (kernelTls && !BIO_get_ktls_send(SSL_get_wbio(ssl))) {
+        result.skipped = "kernel declined the offload";
+    } else {
+        rusage before{};
+        getrusage(RUSAGE_THREAD, &before);
+        auto started = std::chrono::steady_clock::now();
+
+        while (result.bytes < totalBytes) {
+            std::size_t offset = static_cast<std::size_t>(result.bytes % segment.size());
+            std::size_t chunk = std::min<std::size_t>(segment.size() - offset, totalBytes - result.bytes);
+            if (mode == Mode::KtlsSendfile) {
+                ossl_ssize_t sent = SSL_sendfile(ssl, segmentFd, static_cast<off_t>(offset), chunk, 0);
+                if (sent <= 0) break;
+                result.bytes += static_cast<std::uint64_t>(sent);
+            } else {
+                int n = SSL_write(ssl, segment.data() + offset, static_cast<int>(std::min(chunk, batch)));
+                if (n <= 0) break;
+                result.bytes += static_cast<std::uint64_t>(n);
+            }
+        }
+
+        result.wallSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - started).count();
+        rusage after{};
+        getrusage(RUSAGE_THREAD, &after);
+        result.userSeconds = seconds(after.ru_utime) - seconds(before.ru_utime);
+        result.systemSeconds = seconds(after.ru_stime) - seconds(before.ru_stime);
+        result.ran = result.bytes == totalBytes;
+        if (!result.ran) result.skipped = "send failed after " + std::to_string(result.bytes) + " bytes";
+    }
+
+    if (ssl) {
+        SSL_shutdown(ssl);
+        SSL_free(ssl);
+    }
+    shutdown(fd, SHUT_RDWR);
+    close(fd);
+    receiver.join();
+    close(listener);
+    SSL_CTX_free(clientContext);
+    SSL_CTX_free(serverContext);
+
+    if (result.ran && received.load() != result.bytes) {
+        result.ran = false;
+        result.skipped = "receiver got " + std::to_string(received.load()) + " bytes";
+    }
+    return result;
+}
+
+/// Synthetic heartbeat-sized events, as JsonCodec would encode them
+std::string writeSyntheticSegment() {
+    auto path = (std::filesystem::temp_directory_path() / "tls-bench-segment.ndjson").string();
+    std::ofstream out(path, std::ios::trunc);
+    std::size_t written = 0;
+    for (std::uint64_t seq = 1; written < kSyntheticBytes; ++seq) {
+        char line[384];
+        int n = std::snprintf(line, sizeof(line),
+            "{\"battery\":{\"pct\":87.5,\"voltage\":4.01},\"deviceId\":\"SIM-%06llu\",\"eventType\":\"heartbeat\","
+            "\"heading\":%llu,\"loc\":{\"accuracy\":5.0,\"alt\":1753.0,\"lat\":-26.2041,\"lon\":28.0473},"
+            "\"network\":{\"rat\":\"LTE\",\"rssi\":-71},\"seq\":%llu,\"speedKph\":42.0,\"ts\":\"2025-01-01T00:00:00.000Z\"}\n",
+            static_cast<unsigned long long>(seq % 100000), static_cast<unsigned long long>(seq % 360),
+            static_cast<unsigned long long>(seq));
+        out.write(line, n);
+        written += static_cast<std::size_t>(n);
+    }
+    return path;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    std::string file;
+    std::uint64_t megabytes = 256;
+    std::size_t batch = 16384;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--help") {
+            printUsage(argv[0]);
+            return 0;
+        } else if (arg == "--file") {
+            if (i + 1 < argc) file = argv[++i];
+        } else if (arg == "--mb") {
+            if (i + 1 < argc) megabytes = static_cast<std::uint64_t>(std::max(1, std::stoi(argv[++i])));
+        } else if (arg == "--batch") {
+            if (i + 1 < argc) batch = static_cast<std::size_t>(std::clamp(std::stoi(argv[++i]), 256, 1 << 20));
+        } else {
+            std::cerr << "Unknown option: " << arg << std::endl;
+            printUsage(argv[0]);
+            return 2;
+        }
+    }
+
+    bool synthetic = file.empty();
+    if (synthetic) file = writeSyntheticSegment();
+    MappedFile segment(file);
+    int segmentFd = ::open(file.c_str(), O_RDONLY);
+    if (!segment.ok() || segment.size() == 0 || segmentFd < 0) {
+        std::cerr << "[TlsBench] Cannot read " << file << std::endl;
+        return 2;
+    }
+
+    EVP_PKEY* key = nullptr;
+    X509* certificate = nullptr;
+    if (!makeCredentials(key, certificate)) {
+        std::cerr << "[TlsBench] Cannot create a test certificate" << std::endl;
+        return 2;
+    }
+
+    auto status = KernelTls::probe();
+    std::cout << "TLS bench: " << megabytes << " MB per mode, segment " << segment.size() / 1e6 << " MB ("
+              << (synthetic ? "synthetic" : file) << "), " << kCipher << ", " << OpenSSL_version(OPENSSL_VERSION)
+              << std::endl;
+    if (!status.available) {
+        std::cout << "  kTLS unavailable: " << status.reason << std::endl;
+    }
+
+    std::cout << "  " << std::left << std::setw(15) << "Mode" << std::right << std::setw(10) << "MB/s"
+              << std::setw(10) << "user ms" << std::setw(10) << "sys ms" << std::setw(12) << "CPU ms/MB" << std::endl;
+    const std::pair<Mode, const char*> modes[] = {
+        {Mode::User, "user"}, {Mode::Ktls, "ktls"}, {Mode::KtlsSendfile, "ktls-sendfile"}};
+    double baseline = 0.0;
+    for (const auto& [mode, name] : modes) {
+        if (mode != Mode::User && !status.available) {
+            continue;
+        }
+        auto result = run(mode, segment, segmentFd, megabytes << 20, batch, key, certificate);
+        std::cout << "  " << std::left << std::setw(15) << name << std::right;
+        if (!result.ran) {
+            std::cout << "skipped: " << result.skipped << std::endl;
+            continue;
+        }
+        double mb = static_cast<double>(result.bytes) / (1 << 20);
+        double cpuPerMb = (result.userSeconds + result.systemSeconds) * 1000.0 / mb;
+        if (mode == Mode::User) baseline = cpuPerMb;
+        std::cout << std::fixed << std::setprecision(1) << std::setw(10) << mb / result.wallSeconds
+                  << std::setw(10) << result.userSeconds * 1000.0 << std::setw(10) << result.systemSeconds * 1000.0
+                  << std::setprecision(3) << std::setw(12) << cpuPerMb;
+        if (mode != Mode::User && baseline > 0.0) {
+            std::cout << std::setprecision(0) << "  (" << (1.0 - cpuPerMb / baseline) * 100.0 << "% less CPU)";
+        }
+        std::cout << std::defaultfloat << std::endl;
+    }
+
+    close(segmentFd);
+    X509_free(certificate);
+    EVP_PKEY_free(key);
+    if (synthetic) std::filesystem::remove(file);
+    return 0;
+}
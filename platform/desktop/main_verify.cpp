@@ -0,0 +1,133 @@
+/**
+ * @file main_verify.cpp
+ * @brief sim-verify: check recorded telemetry for sequence, timestamp, schema and geofence invariants
+ *
+ * Memory-maps one or more NDJSON files (as written by `sim-cli --record`) and
+ * runs TelemetryVerifier over each. Exits 0 when every file is clean, 1 when
+ * any invariant is violated and 2 when a file cannot be read. With --latency,
+ * events recorded under `sim-cli --trace` are also replayed through
+ * LatencyConsumer; latency does not affect the exit code.
+ */
+
+#include "TelemetryVerifier.hpp"
+#include "LatencyConsumer.hpp"
+#include "MappedFile.hpp"
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <vector>
+
+using namespace tracker;
+
+namespace {
+
+void printUsage(const char* programName) {
+    std::cout << "Usage: " << programName << " [options] FILE...\n"
+              << "Verify NDJSON telemetry recorded with sim-cli --record.\n"
+              << "Options:\n"
+              << "  --threads [n]      Scan/check threads (default: all cores)\n"
+              << "  --samples [n]      Violations to print per file (default: 20)\n"
+              << "  --latency [run]    Per-stage latency of events traced with sim-cli --trace [run]\n"
+              << "  --help             Show this help message\n"
+              << "Exit codes: 0 clean, 1 invariant violations, 2 unreadable input\n"
+              << std::endl;
+}
+
+void printReport(const std::string& path, const TelemetryVerifier::Report& report, double seconds) {
+    std::cout << path << ": " << report.events << " events from " << report.devices << " devices, "
+              << report.lines << " lines, " << report.bytes / 1e6 << " MB in " << seconds * 1000.0 << " ms ("
+              << (seconds > 0.0 ? report.bytes / 1e9 / seconds : 0.0) << " GB/s, "
+              << report.threads << " threads)" << std::endl;
+    std::cout << "  Schema errors:          " << report.schemaErrors << std::endl;
+    std::cout << "  Sequence gaps:          " << report.sequenceGaps << " (" << report.missingEvents
+              << " events missing)" << std::endl;
+    std::cout << "  Duplicate sequences:    " << report.duplicates << std::endl;
+    std::cout << "  Timestamp regressions:  " << report.timestampRegressions << std::endl;
+    std::cout << "  Unpaired enter/exit:    " << report.unpairedEnters << " / " << report.unpairedExits << std::endl;
+    std::cout << "  Devices inside a fence at end: " << report.openFences << std::endl;
+    for (const auto& violation : report.samples) {
+        std::cout << "  line " << violation.line << ": " << TelemetryVerifier::kindName(violation.kind)
+                  << ": " << violation.detail << std::endl;
+    }
+    std::cout << "  Result: " << (report.ok() ? "OK" : "FAILED") << std::endl;
+}
+
+void printLatency(const char* data, std::size_t size, const std::string& runId) {
+    LatencyConsumer consumer(runId);
+    const char* end = data + size;
+    for (const char* line = data; line < end;) {
+        auto newline = static_cast<const char*>(std::memchr(line, '\n', static_cast<std::size_t>(end - line)));
+        const char* lineEnd = newline ? newline : end;
+        if (lineEnd > line) {
+            // A capture has no topics; events carry their own receive stamp
+            consumer.onMessage({}, std::string_view(line, static_cast<std::size_t>(lineEnd - line)), 0);
+        }
+        line = lineEnd + 1;
+    }
+    std::cout << "  Latency: ";
+    consumer.print(std::cout);
+}
+
+}
+
+int main(int argc, char* argv[]) {
+    TelemetryVerifier::Options options;
+    std::vector<std::string> files;
+    std::string latencyRunId;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--help") {
+            printUsage(argv[0]);
+            return 0;
+        } else if (arg == "--threads") {
+            if (i + 1 < argc) {
+                options.threads = static_cast<unsigned>(std::max(1, std::stoi(argv[++i])));
+            }
+        } else if (arg == "--samples") {
+            if (i + 1 < argc) {
+                options.maxSamples = static_cast<std::size_t>(std::max(0, std::stoi(argv[++i])));
+            }
+        } else if (arg == "--latency") {
+            if (i + 1 < argc) {
+                latencyRunId = argv[++i];
+            }
+        } else if (!arg.empty() && arg[0] == '-') {
+            std::cerr << "Unknown option: " << arg << std::endl;
+            printUsage(argv[0]);
+            return 2;
+        } else {
+            files.push_back(arg);
+        }
+    }
+
+    if (files.empty()) {
+        printUsage(argv[0]);
+        return 2;
+    }
+
+    int exitCode = 0;
+    for (const auto& path : files) {
+        MappedFile file(path);
+        if (!file.ok()) {
+            std::cerr << "[Verify] Cannot read " << path << std::endl;
+            exitCode = 2;
+            continue;
+        }
+
+        auto started = std::chrono::steady_clock::now();
+        auto report = TelemetryVerifier::verify(file.data(), file.size(), options);
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - started).count();
+
+        printReport(path, report, seconds);
+        if (!latencyRunId.empty()) {
+            printLatency(file.data(), file.size(), latencyRunId);
+        }
+        if (!report.ok() && exitCode == 0) {
+            exitCode = 1;
+        }
+    }
+    return exitCode;
+}
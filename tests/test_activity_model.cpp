@@ -0,0 +1,154 @@
+#include "../core/ActivityModel.hpp"
+#include <iostream>
+#include <cassert>
+#include <cmath>
+
+using namespace tracker;
+
+namespace {
+    /// Commuters: morning and evening peaks, nothing overnight
+    ActivityCohort commuters() {
+        ActivityCohort cohort;
+        cohort.name = "commuter";
+        cohort.hourlyTrips.assign(ActivityModel::kHours, 0.0);
+        cohort.hourlyTrips[7] = 0.6;
+        cohort.hourlyTrips[8] = 0.3;
+        cohort.hourlyTrips[17] = 0.5;
+        cohort.hourlyTrips[18] = 0.4;
+        cohort.tripMinutes = 2.0;
+        cohort.tripMinutesStddev = 0.0;
+        return cohort;
+    }
+
+    ActivityCohort flat(const std::string& name, double tripsPerHour) {
+        ActivityCohort cohort;
+        cohort.name = name;
+        cohort.hourlyTrips.assign(ActivityModel::kHours, tripsPerHour);
+        cohort.tripMinutes = 1.0;
+        cohort.tripMinutesStddev = 0.0;
+        return cohort;
+    }
+
+    /// Trip starts per hour over one day, advancing in 1 s steps like Fleet::tick
+    std::array<std::size_t, ActivityModel::kHours> runDay(ActivityModel& model) {
+        std::array<std::size_t, ActivityModel::kHours> perHour{};
+        std::vector<ActivityModel::Trip> due;
+        double last = 0.0;
+        for (int second = 1; second <= 86400; ++second) {
+            model.advanceTo(second, due);
+            for (const auto& trip : due) {
+                assert(trip.startSeconds >= last && trip.startSeconds <= second);
+                last = trip.startSeconds;
+                ++perHour[static_cast<std::size_t>(trip.startSeconds / 3600.0)];
+            }
+        }
+        return perHour;
+    }
+}
+
+void testValidation() {
+    std::cout << "Testing cohort validation..." << std::endl;
+
+    std::string error;
+    ActivityConfig config;
+    assert(!ActivityModel::create(config, 10, 1, error));
+    assert(error == "no cohorts");
+
+    config.cohorts.push_back(commuters());
+    config.cohorts[0].hourlyTrips.pop_back();
+    assert(!ActivityModel::create(config, 10, 1, error));
+    assert(error.find("24 values") != std::string::npos);
+
+    config.cohorts[0] = commuters();
+    config.cohorts[0].hourlyTrips[3] = -1.0;
+    assert(!ActivityModel::create(config, 10, 1, error));
+
+    config.cohorts[0] = commuters();
+    config.timeScale = 0.0;
+    assert(!ActivityModel::create(config, 10, 1, error));
+    config.timeScale = 60.0;
+    config.startHour = 24.0;
+    assert(!ActivityModel::create(config, 10, 1, error));
+    config.startHour = 6.5;
+    auto model = ActivityModel::create(config, 10, 1, error);
+    assert(model);
+    assert(model->now() == 6.5 * 3600.0);
+
+    std::cout << "Cohort validation tests passed!" << std::endl;
+}
+
+void testHourlyRatesFollowCurve() {
+    std::cout << "Testing hourly trip starts..." << std::endl;
+
+    ActivityConfig config;
+    config.cohorts.push_back(commuters());
+    std::string error;
+    const std::size_t vehicles = 20000;
+    auto model = ActivityModel::create(config, vehicles, 42, error);
+    assert(model);
+
+    auto perHour = runDay(*model);
+    for (std::size_t hour = 0; hour < ActivityModel::kHours; ++hour) {
+        double expected = model->expectedTrips(hour);
+        if (expected == 0.0) {
+            assert(perHour[hour] == 0);   // Quiet hours get no starts at all
+            continue;
+        }
+        // Short trips keep almost every vehicle parked: within 5 standard deviations
+        assert(std::fabs(static_cast<double>(perHour[hour]) - expected) < 5.0 * std::sqrt(expected) + 0.02 * expected);
+    }
+    assert(perHour[7] > perHour[8] && perHour[17] > perHour[18]);
+
+    // One heap entry per vehicle regardless of how many trips were generated
+    assert(model->tripsStarted() > vehicles);
+    assert(model->pendingVehicles() == vehicles);
+
+    std::cout << "Hourly trip start tests passed!" << std::endl;
+}
+
+void testCohortsAndDeterminism() {
+    std::cout << "Testing cohort mix and seeding..." << std::endl;
+
+    ActivityConfig config;
+    config.cohorts.push_back(flat("van", 1.0));
+    config.cohorts.push_back(flat("idle", 0.0));
+    config.cohorts[0].share = 3.0;
+    std::string error;
+    auto model = ActivityModel::create(config, 1000, 7, error);
+    assert(model);
+
+    // Shares hold in every index range, not just over the whole fleet
+    std::size_t vans = 0;
+    for (std::uint32_t vehicle = 0; vehicle < 100; ++vehicle) {
+        vans += model->cohortOf(vehicle) == 0;
+    }
+    assert(vans >= 73 && vans <= 77);
+    assert(model->pendingVehicles() == 750);   // Vehicles that never travel are not scheduled
+
+    std::vector<ActivityModel::Trip> due;
+    model->advanceTo(3 * 86400.0, due);   // Across day boundaries in one step
+    for (const auto& trip : due) {
+        assert(model->cohortOf(trip.vehicle) == 0);
+    }
+
+    auto again = ActivityModel::create(config, 1000, 7, error);
+    std::vector<ActivityModel::Trip> repeat;
+    again->advanceTo(3 * 86400.0, repeat);
+    assert(repeat.size() == due.size());
+    for (std::size_t i = 0; i < due.size(); ++i) {
+        assert(repeat[i].vehicle == due[i].vehicle && repeat[i].startSeconds == due[i].startSeconds);
+    }
+
+    std::cout << "Cohort mix and seeding tests passed!" << std::endl;
+}
+
+int main() {
+    std::cout << "Running Activity Model Tests..." << std::endl;
+
+    testValidation();
+    testHourlyRatesFollowCurve();
+    testCohortsAndDeterminism();
+
+    std::cout << "\nAll activity model tests passed!" << std::endl;
+    return 0;
+}
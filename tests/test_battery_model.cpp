@@ -0,0 +1,169 @@
+#include "../core/BatteryModel.hpp"
+#include "../core/Battery.hpp"
+#include <iostream>
+#include <cassert>
+#include <cmath>
+#include <memory>
+#include <vector>
+
+using namespace tracker;
+
+namespace {
+    /// Terminal voltage of one cell with no jitter
+    float cellVoltage(float soc, float currentA, float temperatureC) {
+        float noise = 0.0f;
+        float voltage = 0.0f;
+        BatteryBank::evaluateVoltage(&soc, &currentA, &temperatureC, &noise, &voltage, 1, 0.15f);
+        return voltage;
+    }
+
+    bool near(double a, double b, double tolerance) {
+        return std::fabs(a - b) <= tolerance;
+    }
+}
+
+void testOpenCircuitVoltage() {
+    std::cout << "Testing open-circuit voltage curve..." << std::endl;
+
+    for (std::size_t i = 1; i < BatteryBank::kOcvPoints; ++i) {
+        assert(BatteryBank::kOcvTable[i] > BatteryBank::kOcvTable[i - 1]);
+    }
+
+    // Interpolated curve rises with charge and meets the table at both ends
+    float previous = cellVoltage(0.0f, 0.0f, 25.0f);
+    assert(near(previous, 3.00, 1e-5));
+    for (int pct = 1; pct <= 100; ++pct) {
+        float voltage = cellVoltage(static_cast<float>(pct) / 100.0f, 0.0f, 25.0f);
+        assert(voltage > previous);
+        previous = voltage;
+    }
+    assert(near(previous, 4.20, 1e-5));
+    assert(near(cellVoltage(0.525f, 0.0f, 25.0f), (3.75 + 3.77) / 2.0, 1e-4));
+
+    std::cout << "Open-circuit voltage tests passed!" << std::endl;
+}
+
+void testLoadSag() {
+    std::cout << "Testing voltage under load..." << std::endl;
+
+    // I * R: 1 A through 0.15 ohm at 25 °C
+    float rest = cellVoltage(0.5f, 0.0f, 25.0f);
+    assert(near(rest - cellVoltage(0.5f, -1.0f, 25.0f), 0.15, 1e-4));
+    assert(cellVoltage(0.5f, 0.5f, 25.0f) > rest);
+
+    // Driving draws more than idle, ignition charges
+    BatteryBank bank;
+    std::size_t idle = bank.add(50.0);
+    std::size_t driving = bank.add(50.0);
+    std::size_t charging = bank.add(50.0);
+    bank.setLoad(driving, true, false);
+    bank.setLoad(charging, true, true);
+    bank.tick(1.0);
+    assert(bank.voltage(driving) < bank.voltage(idle));
+    assert(bank.voltage(charging) > bank.voltage(idle));
+
+    // One hour of coulomb counting at 25 °C: 10 mA and 40 mA of 2000 mAh
+    bank.tick(3599.0);
+    assert(near(bank.percentage(idle), 49.5, 1e-3));
+    assert(near(bank.percentage(driving), 48.0, 1e-3));
+    assert(bank.percentage(charging) > 50.0);
+
+    std::cout << "Voltage under load tests passed!" << std::endl;
+}
+
+void testColdDerating() {
+    std::cout << "Testing cold derating..." << std::endl;
+
+    // Same state and load: the cold cell sags further
+    assert(cellVoltage(0.5f, -0.04f, -10.0f) < cellVoltage(0.5f, -0.04f, 25.0f));
+    assert(cellVoltage(0.5f, -1.0f, 0.0f) < cellVoltage(0.5f, 0.0f, 0.0f) - 0.15f);
+
+    // Usable capacity drops 1 % per °C below 25, never under half
+    BatteryBank bank;
+    std::size_t warm = bank.add(80.0, 25.0);
+    std::size_t cold = bank.add(80.0, -15.0);
+    std::size_t frozen = bank.add(80.0, -60.0);
+    std::size_t hot = bank.add(80.0, 45.0);
+    for (std::size_t i = 0; i < bank.size(); ++i) {
+        bank.setLoad(i, true, false);
+    }
+    bank.tick(3600.0);
+    assert(near(80.0 - bank.percentage(warm), 40.0 / 2000.0 * 100.0, 1e-3));
+    assert(near(80.0 - bank.percentage(cold), 40.0 / 1200.0 * 100.0, 1e-3));
+    assert(near(80.0 - bank.percentage(frozen), 40.0 / 1000.0 * 100.0, 1e-3));
+    assert(near(bank.percentage(hot), bank.percentage(warm), 1e-4));
+
+    // A battery keeps its ambient temperature when it moves into a shared bank
+    Battery battery(std::make_shared<StandardRng>(7));
+    battery.setPercentage(60.0);
+    battery.setTemperature(-5.0);
+    auto shared = std::make_shared<BatteryBank>();
+    shared->add(100.0);
+    battery.attach(shared);
+    assert(shared->size() == 2);
+    assert(battery.getTemperature() == -5.0 && shared->temperature(1) == -5.0);
+    assert(near(battery.getPercentage(), 60.0, 1e-4));
+
+    std::cout << "Cold derating tests passed!" << std::endl;
+}
+
+void testBatchMatchesSingleCells() {
+    std::cout << "Testing batched evaluation..." << std::endl;
+
+    // Kernel over a whole column equals the kernel one cell at a time
+    StandardRng rng(42);
+    const std::size_t count = 257;
+    std::vector<float> soc(count), current(count), temperature(count), noise(count), batched(count);
+    for (std::size_t i = 0; i < count; ++i) {
+        soc[i] = static_cast<float>(rng.uniform(0.0, 1.0));
+        current[i] = static_cast<float>(rng.uniform(-0.5, 0.5));
+        temperature[i] = static_cast<float>(rng.uniform(-30.0, 50.0));
+        noise[i] = static_cast<float>(rng.uniform(-0.01, 0.01));
+    }
+    BatteryBank::evaluateVoltage(soc.data(), current.data(), temperature.data(), noise.data(),
+                                 batched.data(), count, 0.15f);
+    for (std::size_t i = 0; i < count; ++i) {
+        float single = 0.0f;
+        BatteryBank::evaluateVoltage(&soc[i], &current[i], &temperature[i], &noise[i], &single, 1, 0.15f);
+        assert(near(batched[i], single, 1e-6));   // Vectorised loops may contract differently
+        assert(batched[i] >= 2.5f && batched[i] <= 4.4f);
+    }
+
+    // A shared bank ticks every cell exactly as its own bank would
+    BatteryBank shared;
+    std::vector<BatteryBank> own(16);
+    for (std::size_t i = 0; i < own.size(); ++i) {
+        double pct = 5.0 + 6.0 * static_cast<double>(i);
+        double celsius = -20.0 + 4.0 * static_cast<double>(i);
+        bool driving = i % 2 == 0;
+        bool ignition = i % 3 == 0;
+        shared.add(pct, celsius);
+        shared.setLoad(i, driving, ignition);
+        own[i].add(pct, celsius);
+        own[i].setLoad(0, driving, ignition);
+    }
+    for (int step = 0; step < 10; ++step) {
+        shared.tick(600.0);
+        for (auto& bank : own) {
+            bank.tick(600.0);
+        }
+    }
+    for (std::size_t i = 0; i < own.size(); ++i) {
+        assert(near(shared.percentage(i), own[i].percentage(0), 1e-4));
+        assert(near(shared.voltage(i), own[i].voltage(0), 1e-6));
+    }
+
+    std::cout << "Batched evaluation tests passed!" << std::endl;
+}
+
+int main() {
+    std::cout << "Running Battery Model Tests..." << std::endl;
+
+    testOpenCircuitVoltage();
+    testLoadSag();
+    testColdDerating();
+    testBatchMatchesSingleCells();
+
+    std::cout << "\nAll battery model tests passed!" << std::endl;
+    return 0;
+}
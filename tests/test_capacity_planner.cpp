@@ -0,0 +1,131 @@
+#include "../core/CapacityPlanner.hpp"
+#include <iostream>
+#include <cassert>
+#include <cmath>
+#include <string>
+
+using namespace tracker;
+
+namespace {
+    /// Point north of the default start location by the given distance
+    RoutePoint north(const SimulatorConfig& config, double meters) {
+        RoutePoint point;
+        point.lat = config.startLocation.lat + meters / 111320.0;
+        point.lon = config.startLocation.lon;
+        return point;
+    }
+
+    Geofence fenceAt(const std::string& id, const RoutePoint& center, double radiusMeters) {
+        Geofence fence;
+        fence.id = id;
+        fence.lat = center.lat;
+        fence.lon = center.lon;
+        fence.radiusMeters = radiusMeters;
+        return fence;
+    }
+}
+
+void testMqttPublishBytes() {
+    std::cout << "Testing MQTT publish framing..." << std::endl;
+
+    // Fixed header + remaining length + (topic length, topic, packet id, payload) + PUBACK
+    auto bytes = [](std::size_t remaining) { return CapacityPlanner::mqttPublishBytes(3, remaining - 7); };
+    assert(bytes(127) == 1 + 1 + 127 + 4);
+    assert(bytes(128) == 1 + 2 + 128 + 4);
+    assert(bytes(16383) == 1 + 2 + 16383 + 4);
+    assert(bytes(16384) == 1 + 3 + 16384 + 4);
+    assert(bytes(2097151) == 1 + 3 + 2097151 + 4);
+    assert(bytes(2097152) == 1 + 4 + 2097152 + 4);
+    assert(CapacityPlanner::mqttPublishBytes(0, 0) == 1 + 1 + 4 + 4);
+
+    std::cout << "MQTT publish framing tests passed!" << std::endl;
+}
+
+void testExpectedMaxZ() {
+    std::cout << "Testing expected Gaussian maximum..." << std::endl;
+
+    assert(CapacityPlanner::expectedMaxZ(0.0) == 0.0 && CapacityPlanner::expectedMaxZ(1.0) == 0.0);
+    assert(std::fabs(CapacityPlanner::expectedMaxZ(1000.0) - 3.24) < 0.1);    // Tabulated E[max] = 3.241
+    assert(std::fabs(CapacityPlanner::expectedMaxZ(86400.0) - 4.4) < 0.15);   // One day of 1 s buckets
+    double previous = 0.0;
+    for (double n = 10.0; n <= 1e7; n *= 10.0) {
+        double z = CapacityPlanner::expectedMaxZ(n);
+        assert(z > previous);
+        previous = z;
+    }
+
+    std::cout << "Expected Gaussian maximum tests passed!" << std::endl;
+}
+
+void testTierSelection() {
+    std::cout << "Testing hub tier selection..." << std::endl;
+
+    // 10 000 devices with 60 s heartbeats only: 14.4 M messages a day
+    SimulatorConfig config;
+    CapacityPlanner::Inputs inputs;
+    inputs.deviceCount = 10000;
+    inputs.tripsPerDay = 0.0;
+    auto plan = CapacityPlanner::plan(config, inputs);
+    assert(plan.meteredPerPublish == 1);
+    assert(std::fabs(plan.meteredMessagesPerDay - 14.4e6) < 1.0);
+    assert(plan.tiers.size() == 3);
+
+    // Quota-bound: S1 needs 36 units (cost 36), S2 3 (cost 30), S3 1 (cost 100)
+    assert(plan.tiers[0].name == "S1" && plan.tiers[0].units == 36);
+    assert(plan.tiers[1].name == "S2" && plan.tiers[1].units == 3);
+    assert(plan.tiers[2].name == "S3" && plan.tiers[2].units == 1);
+    for (const auto& tier : plan.tiers) {
+        assert(tier.fits() && tier.limitedBy == "daily message quota");
+    }
+    assert(plan.recommended() && plan.recommended()->name == "S2");
+
+    // Lock-step heartbeats: 10 000 sends in one second outgrow S1 and make S3 cheapest
+    config.phaseSpreading = false;
+    auto lockstep = CapacityPlanner::plan(config, inputs);
+    assert(lockstep.peakPublishesPerSecond >= 10000.0);
+    assert(!lockstep.tiers[0].fits());
+    assert(lockstep.tiers[1].units == 84 && lockstep.tiers[1].limitedBy == "device-to-cloud send throttle");
+    assert(lockstep.tiers[2].units == 2);
+    assert(lockstep.recommended() && lockstep.recommended()->name == "S3");
+
+    std::cout << "Hub tier selection tests passed!" << std::endl;
+}
+
+void testFenceTransitions() {
+    std::cout << "Testing fence transition count..." << std::endl;
+
+    // 2 km drive north; the next trip starts back at the beginning
+    SimulatorConfig config;
+    config.route = {north(config, 0.0), north(config, 2000.0)};
+    assert(CapacityPlanner::countFenceTransitions(config) == 0);
+
+    config.geofences.push_back(fenceAt("middle", north(config, 1000.0), 200.0));    // Enter, exit
+    assert(CapacityPlanner::countFenceTransitions(config) == 2);
+    config.geofences.push_back(fenceAt("depot", north(config, 0.0), 200.0));        // Exit, re-enter on return
+    config.geofences.push_back(fenceAt("site", north(config, 2000.0), 200.0));      // Enter, exit on return
+    config.geofences.push_back(fenceAt("elsewhere", north(config, -5000.0), 200.0));
+    assert(CapacityPlanner::countFenceTransitions(config) == 6);
+
+    // A fence around the whole route is never crossed
+    config.geofences = {fenceAt("city", north(config, 1000.0), 5000.0)};
+    assert(CapacityPlanner::countFenceTransitions(config) == 0);
+
+    // The plan counts them per trip
+    config.geofences = {fenceAt("middle", north(config, 1000.0), 200.0)};
+    auto plan = CapacityPlanner::plan(config, CapacityPlanner::Inputs{});
+    assert(plan.fenceTransitionsPerTrip == 2.0);
+
+    std::cout << "Fence transition count tests passed!" << std::endl;
+}
+
+int main() {
+    std::cout << "Running Capacity Planner Tests..." << std::endl;
+
+    testMqttPublishBytes();
+    testExpectedMaxZ();
+    testTierSelection();
+    testFenceTransitions();
+
+    std::cout << "\nAll capacity planner tests passed!" << std::endl;
+    return 0;
+}
@@ -0,0 +1,209 @@
+#include "../core/Catalog.hpp"
+#include "../core/CatalogStore.hpp"
+#include <iostream>
+#include <cassert>
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <random>
+#include <thread>
+
+using namespace tracker;
+
+namespace {
+    const Location kOrigin{-26.2041, 28.0473, 0.0, 0.0};   // Johannesburg
+
+    std::vector<Geofence> randomFences(std::mt19937& gen, int count, const std::string& prefix) {
+        std::uniform_real_distribution<double> offset(-0.2, 0.2);   // ~±20 km
+        std::uniform_real_distribution<double> radius(20.0, 2000.0);
+        std::vector<Geofence> fences;
+        for (int i = 0; i < count; ++i) {
+            fences.push_back({prefix + std::to_string(i), kOrigin.lat + offset(gen),
+                              kOrigin.lon + offset(gen), radius(gen)});
+        }
+        return fences;
+    }
+}
+
+void testGridMatchesBruteForce() {
+    std::cout << "Testing fence grid against brute force..." << std::endl;
+
+    std::mt19937 gen(42);
+    auto catalog = Catalog::build(kOrigin, {}, randomFences(gen, 500, "f"));
+    std::vector<std::uint8_t> all(catalog->enuFences.size());
+    std::vector<std::uint8_t> cell(catalog->fenceIndex.maxCellSize());
+
+    std::uniform_real_distribution<float> coord(-25000.0f, 25000.0f);
+    for (int i = 0; i < 20000; ++i) {
+        EnuPoint p{coord(gen), coord(gen)};
+        LocalFrame::insideFences(p, catalog->enuFences.data(), catalog->enuFences.size(), all.data());
+
+        auto candidates = catalog->fenceIndex.query(p);
+        LocalFrame::insideFences(p, candidates.fences, candidates.count, cell.data());
+
+        std::vector<std::uint32_t> expected, actual;
+        for (std::uint32_t f = 0; f < all.size(); ++f) {
+            if (all[f]) expected.push_back(f);
+        }
+        for (std::size_t c = 0; c < candidates.count; ++c) {
+            if (cell[c]) actual.push_back(candidates.ids[c]);
+        }
+        assert(expected == actual);
+    }
+
+    std::cout << "Fence grid tests passed!" << std::endl;
+}
+
+void testReclamationWaitsForReaders() {
+    std::cout << "Testing epoch-based reclamation..." << std::endl;
+
+    CatalogStore store(Catalog::build(kOrigin, {}, {}));
+    std::size_t reader = store.registerReader();
+    assert(store.version() == 1);
+
+    {
+        CatalogStore::ReadGuard guard(store, reader);
+        assert(guard->version == 1);
+
+        store.publish(Catalog::build(kOrigin, {}, {}));
+        assert(store.version() == 2);
+        assert(guard->version == 1);            // Reader keeps its snapshot
+        assert(store.reclaim() == 0);           // ...and it is not freed under it
+    }
+    assert(store.reclaim() == 1);
+
+    {
+        CatalogStore::ReadGuard guard(store, reader);
+        assert(guard->version == 2);
+    }
+
+    std::cout << "Reclamation tests passed!" << std::endl;
+}
+
+void testConcurrentReload() {
+    std::cout << "Testing concurrent publish and read..." << std::endl;
+
+    std::mt19937 gen(7);
+    CatalogStore store(Catalog::build(kOrigin, {}, randomFences(gen, 50, "v1-")));
+    std::size_t reader = store.registerReader();
+    std::atomic<bool> done{false};
+
+    std::thread writer([&]() {
+        std::mt19937 wgen(11);
+        for (int i = 0; i < 200; ++i) {
+            store.publish(Catalog::build(kOrigin, {}, randomFences(wgen, 50, "v" + std::to_string(i + 2) + "-")));
+            store.reclaim();
+        }
+        done = true;
+    });
+
+    std::uint64_t lastVersion = 0;
+    while (!done) {
+        CatalogStore::ReadGuard guard(store, reader);
+        assert(guard->version >= lastVersion);  // Versions never go backwards
+        lastVersion = guard->version;
+        assert(guard->geofences.size() == 50);
+        assert(guard->fenceById.size() == 50);
+    }
+    writer.join();
+
+    store.reclaim();
+    assert(store.retiredCount() == 0);
+
+    std::cout << "Concurrent reload tests passed!" << std::endl;
+}
+
+void testRouteCrossingSchedule() {
+    std::cout << "Testing route crossing schedule..." << std::endl;
+
+    // Straight 1 km route east: starts inside "home", passes through "mid"
+    LocalFrame frame(kOrigin.lat, kOrigin.lon);
+    auto at = [&](float east, float north) {
+        Location l = frame.unproject(EnuPoint{east, north});
+        return RoutePoint{l.lat, l.lon};
+    };
+    auto fenceAt = [&](const std::string& id, float east, float north, double radius) {
+        Location l = frame.unproject(EnuPoint{east, north});
+        return Geofence{id, l.lat, l.lon, radius};
+    };
+    auto catalog = Catalog::build(kOrigin, {at(0, 0), at(500, 0), at(1000, 0)},
+                                  {fenceAt("home", 0, 0, 50), fenceAt("mid", 500, 0, 100),
+                                   fenceAt("off", 500, 300, 100)});
+
+    assert(catalog->routeStartFences == std::vector<std::uint32_t>{0});
+    assert(std::abs(catalog->routeLengthMeters - 1000.0) < 0.5);
+    const auto& crossings = catalog->routeCrossings;
+    assert(crossings.size() == 3);
+    assert(crossings[0].fence == 0 && !crossings[0].enter && std::abs(crossings[0].arcMeters - 50.0) < 0.5);
+    assert(crossings[1].fence == 1 && crossings[1].enter && std::abs(crossings[1].arcMeters - 400.0) < 0.5);
+    assert(crossings[2].fence == 1 && !crossings[2].enter && std::abs(crossings[2].arcMeters - 600.0) < 0.5);
+    assert(std::abs(crossings[1].progress - 0.4) < 1e-3);
+
+    std::cout << "Route crossing schedule tests passed!" << std::endl;
+}
+
+void testRouteCrossingsMatchSampling() {
+    std::cout << "Testing route crossings against dense sampling..." << std::endl;
+
+    std::mt19937 gen(7);
+    std::uniform_real_distribution<double> offset(-0.15, 0.15);
+    std::vector<RoutePoint> route;
+    for (int i = 0; i < 40; ++i) {
+        route.push_back({kOrigin.lat + offset(gen), kOrigin.lon + offset(gen)});
+    }
+    auto catalog = Catalog::build(kOrigin, route, randomFences(gen, 500, "f"));
+    const auto& enu = catalog->enuRoute;
+    const auto& crossings = catalog->routeCrossings;
+    assert(!crossings.empty());
+    for (std::size_t i = 1; i < crossings.size(); ++i) {
+        assert(crossings[i - 1].progress <= crossings[i].progress);
+    }
+
+    // Replay the schedule alongside brute-force containment at sampled points
+    std::vector<std::uint32_t> replayed = catalog->routeStartFences;
+    std::vector<std::uint8_t> all(catalog->enuFences.size());
+    std::size_t next = 0, compared = 0;
+    const int samples = 20000;
+    for (int i = 0; i <= samples; ++i) {
+        double progress = static_cast<double>(i) / samples;
+        for (; next < crossings.size() && crossings[next].progress <= progress; ++next) {
+            auto it = std::lower_bound(replayed.begin(), replayed.end(), crossings[next].fence);
+            if (crossings[next].enter) replayed.insert(it, crossings[next].fence);
+            else replayed.erase(it);
+        }
+
+        // Points within a metre of a boundary may round either way in float
+        EnuPoint p = LocalFrame::interpolateRoute(enu, progress);
+        bool nearBoundary = false;
+        for (std::size_t f = 0; f < catalog->enuFences.size(); ++f) {
+            const auto& fence = catalog->enuFences[f];
+            double d = std::hypot(p.east - fence.east, p.north - fence.north) - std::sqrt(fence.radiusSq);
+            nearBoundary |= std::abs(d) < 1.0;
+        }
+        if (nearBoundary) continue;
+
+        LocalFrame::insideFences(p, catalog->enuFences.data(), catalog->enuFences.size(), all.data());
+        std::vector<std::uint32_t> expected;
+        for (std::uint32_t f = 0; f < all.size(); ++f) {
+            if (all[f]) expected.push_back(f);
+        }
+        assert(expected == replayed);
+        ++compared;
+    }
+    assert(compared > samples / 2);
+
+    std::cout << "Route crossing sampling tests passed!" << std::endl;
+}
+
+int main() {
+    std::cout << "Running catalog tests..." << std::endl;
+
+    testGridMatchesBruteForce();
+    testReclamationWaitsForReaders();
+    testConcurrentReload();
+    testRouteCrossingSchedule();
+    testRouteCrossingsMatchSampling();
+
+    std::cout << "All catalog tests passed!" << std::endl;
+    return 0;
+}
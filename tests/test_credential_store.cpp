@@ -0,0 +1,165 @@
+#include "../net/mqtt/CredentialStore.hpp"
+#include <openssl/evp.h>
+#include <openssl/pem.h>
+#include <openssl/ssl.h>
+#include <openssl/x509.h>
+#include <iostream>
+#include <cassert>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+using namespace tracker;
+
+namespace {
+    namespace fs = std::filesystem;
+
+    constexpr int kDevices = 200;
+
+    X509* makeCertificate(EVP_PKEY* key, const char* commonName, X509* issuer, EVP_PKEY* issuerKey, long serial) {
+        X509* certificate = X509_new();
+        X509_set_version(certificate, 2);
+        ASN1_INTEGER_set(X509_get_serialNumber(certificate), serial);
+        X509_gmtime_adj(X509_getm_notBefore(certificate), 0);
+        X509_gmtime_adj(X509_getm_notAfter(certificate), 3600);
+        X509_set_pubkey(certificate, key);
+        X509_NAME_add_entry_by_txt(X509_get_subject_name(certificate), "CN", MBSTRING_ASC,
+                                   reinterpret_cast<const unsigned char*>(commonName), -1, -1, 0);
+        X509_set_issuer_name(certificate, X509_get_subject_name(issuer ? issuer : certificate));
+        X509_sign(certificate, issuerKey ? issuerKey : key, EVP_sha256());
+        return certificate;
+    }
+
+    void writePem(const fs::path& path, X509* first, X509* second, EVP_PKEY* key) {
+        FILE* file = std::fopen(path.string().c_str(), "w");
+        assert(file);
+        if (first) PEM_write_X509(file, first);
+        if (second) PEM_write_X509(file, second);
+        if (key) PEM_write_PrivateKey(file, key, nullptr, nullptr, 0, nullptr, nullptr);
+        std::fclose(file);
+    }
+
+    /// Device directories laid out like device_cert_base_path/<imei>/
+    struct Fixture {
+        fs::path root = fs::temp_directory_path() / "credential-store-test";
+        std::string caPath;
+        std::vector<std::string> chains;
+        std::vector<std::string> keys;
+
+        Fixture() {
+            fs::remove_all(root);
+            fs::create_directories(root);
+            EVP_PKEY* caKey = EVP_EC_gen("P-256");
+            X509* ca = makeCertificate(caKey, "Test Root", nullptr, nullptr, 1);
+            caPath = (root / "root.pem").string();
+            writePem(caPath, ca, nullptr, nullptr);
+
+            for (int i = 0; i < kDevices; ++i) {
+                auto directory = root / std::to_string(350000000000000 + i);
+                fs::create_directories(directory);
+                EVP_PKEY* key = EVP_EC_gen("P-256");
+                X509* leaf = makeCertificate(key, "device", ca, caKey, 100 + i);
+                chains.push_back((directory / "device.chain.pem").string());
+                keys.push_back((directory / "device.key.pem").string());
+                writePem(chains.back(), leaf, ca, nullptr);
+                writePem(keys.back(), nullptr, nullptr, key);
+                X509_free(leaf);
+                EVP_PKEY_free(key);
+            }
+            X509_free(ca);
+            EVP_PKEY_free(caKey);
+        }
+
+        ~Fixture() { fs::remove_all(root); }
+    };
+}
+
+void testPreloadAndServe(Fixture& fixture) {
+    std::cout << "Testing parallel preload..." << std::endl;
+
+    auto chains = fixture.chains;
+    chains.push_back(fixture.caPath);
+    chains.push_back(fixture.chains[0]);   // Listed twice, loaded once
+    auto report = CredentialStore::preload(chains, fixture.keys, 4);
+    assert(report.failed == 0);
+    assert(report.files == 2 * kDevices + 1);
+    assert(report.certificates == 2 * kDevices + 1 && report.keys == kDevices);
+    assert(report.threads == 4);
+    assert(CredentialStore::contains(fixture.keys[7]) && CredentialStore::contains(fixture.caPath));
+    std::cout << "  " << report.certificates << " certificates in " << report.seconds * 1000.0 << " ms ("
+              << report.certificatesPerSecond() << " certificates/s)" << std::endl;
+
+    // Served from memory: the files are gone
+    fs::remove(fixture.chains[0]);
+    fs::remove(fixture.keys[0]);
+    SSL_CTX* first = SSL_CTX_new(TLS_client_method());
+    SSL_CTX* second = SSL_CTX_new(TLS_client_method());
+    int ok = SSL_CTX_use_certificate_chain_file(first, fixture.chains[0].c_str());
+    ok += SSL_CTX_use_PrivateKey_file(first, fixture.keys[0].c_str(), SSL_FILETYPE_PEM);
+    ok += SSL_CTX_check_private_key(first);
+    ok += SSL_CTX_use_certificate_chain_file(second, fixture.chains[0].c_str());
+    assert(ok == 4);
+    STACK_OF(X509)* extra = nullptr;
+    SSL_CTX_get0_chain_certs(first, &extra);
+    assert(extra && sk_X509_num(extra) == 1);
+    // Shared by reference, not copied per context
+    assert(SSL_CTX_get0_certificate(first) == SSL_CTX_get0_certificate(second));
+
+    // A key from another device does not match
+    ok = SSL_CTX_use_PrivateKey_file(second, fixture.keys[1].c_str(), SSL_FILETYPE_PEM);
+    assert(ok == 0 || SSL_CTX_check_private_key(second) == 0);
+    SSL_CTX_free(first);
+    SSL_CTX_free(second);
+
+    std::cout << "Parallel preload tests passed!" << std::endl;
+}
+
+void testLazyLoadsAndFailures(Fixture& fixture) {
+    std::cout << "Testing lazy loads and failures..." << std::endl;
+
+    // Not preloaded: parsed on first use, then kept
+    EVP_PKEY* key = EVP_EC_gen("P-256");
+    X509* self = makeCertificate(key, "late", nullptr, nullptr, 9);
+    auto combined = (fixture.root / "combined.pem").string();
+    writePem(combined, self, nullptr, key);
+    assert(!CredentialStore::contains(combined));
+    SSL_CTX* context = SSL_CTX_new(TLS_client_method());
+    int ok = SSL_CTX_use_certificate_chain_file(context, combined.c_str());
+    assert(ok == 1 && CredentialStore::contains(combined));
+    // Same path as a key: the entry gains the key
+    ok = SSL_CTX_use_PrivateKey_file(context, combined.c_str(), SSL_FILETYPE_PEM);
+    assert(ok == 1 && SSL_CTX_check_private_key(context) == 1);
+    SSL_CTX_free(context);
+    X509_free(self);
+    EVP_PKEY_free(key);
+
+    auto garbage = (fixture.root / "garbage.pem").string();
+    std::ofstream(garbage) << "not a certificate\n";
+    auto missing = (fixture.root / "missing.pem").string();
+    auto report = CredentialStore::preload({garbage}, {missing, combined});
+    assert(report.files == 2 && report.failed == 2);
+    assert(report.firstError.find("garbage.pem") != std::string::npos);
+    assert(!CredentialStore::contains(garbage) && !CredentialStore::contains(missing));
+
+    // Failed files fall through to OpenSSL, which reports its own error
+    context = SSL_CTX_new(TLS_client_method());
+    ok = SSL_CTX_use_certificate_chain_file(context, garbage.c_str());
+    assert(ok == 0);
+    SSL_CTX_free(context);
+    assert(CredentialStore::servesTls());
+
+    std::cout << "Lazy load and failure tests passed!" << std::endl;
+}
+
+int main() {
+    std::cout << "Running Credential Store Tests..." << std::endl;
+
+    Fixture fixture;
+    testPreloadAndServe(fixture);
+    testLazyLoadsAndFailures(fixture);
+
+    std::cout << "\nAll credential store tests passed!" << std::endl;
+    return 0;
+}
@@ -0,0 +1,179 @@
+#include "../core/EventMerge.hpp"
+#include <iostream>
+#include <cassert>
+#include <algorithm>
+#include <atomic>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace tracker;
+
+namespace {
+    std::string payloadOf(const MergeKey& key) {
+        return std::to_string(key.time) + ":" + std::to_string(key.device) + ":" + std::to_string(key.sequence);
+    }
+
+    /// Events a device raises in one tick (0-3, fixed by device and tick)
+    std::uint32_t eventsAt(std::uint32_t device, std::uint64_t tick) {
+        std::uint64_t x = (device + 1) * 0x9E3779B97F4A7C15ull ^ (tick + 1) * 0xC2B2AE3D27D4EB4Full;
+        x ^= x >> 29;
+        return static_cast<std::uint32_t>(x % 4);
+    }
+
+    struct FleetRun {
+        std::vector<std::string> output;
+        std::size_t maxQueued = 0;
+    };
+
+    /**
+     * Ticks devices split into contiguous ranges, one producer thread per
+     * range, while a consumer drains concurrently
+     */
+    FleetRun runFleet(std::size_t workers, std::uint32_t devices, std::uint64_t ticks, std::size_t laneCapacity) {
+        EventMerge merge(workers, laneCapacity);
+        std::atomic<std::size_t> produced{0};
+        std::size_t consumed = 0;
+        FleetRun run;
+
+        std::vector<std::thread> producers;
+        for (std::size_t worker = 0; worker < workers; ++worker) {
+            producers.emplace_back([&, worker] {
+                auto begin = static_cast<std::uint32_t>(devices * worker / workers);
+                auto end = static_cast<std::uint32_t>(devices * (worker + 1) / workers);
+                std::vector<std::uint64_t> sequence(end - begin, 0);
+                for (std::uint64_t tick = 1; tick <= ticks; ++tick) {
+                    for (std::uint32_t device = begin; device < end; ++device) {
+                        for (std::uint32_t n = eventsAt(device, tick); n > 0; --n) {
+                            MergeKey key{tick, device, ++sequence[device - begin]};
+                            merge.append(worker, key, payloadOf(key));
+                            produced.fetch_add(1, std::memory_order_release);
+                        }
+                    }
+                    merge.advance(worker, tick + 1);
+                }
+                merge.close(worker);
+            });
+        }
+
+        MergeKey last;
+        auto sink = [&](const MergeKey& key, std::string& payload) {
+            assert(!(key < last));
+            last = key;
+            run.maxQueued = std::max(run.maxQueued, produced.load(std::memory_order_acquire) - consumed);
+            run.output.push_back(std::move(payload));
+            ++consumed;
+        };
+        while (!merge.finished()) {
+            if (merge.drain(sink) == 0) {
+                std::this_thread::yield();
+            }
+        }
+        for (auto& producer : producers) {
+            producer.join();
+        }
+        return run;
+    }
+}
+
+void testLoserTreeOrder() {
+    std::cout << "Testing loser tree order..." << std::endl;
+
+    std::mt19937 gen(7);
+    for (std::size_t lanes : {1, 2, 3, 5, 8, 13}) {
+        EventMerge merge(lanes, 1024);
+        std::vector<MergeKey> expected;
+        for (std::size_t lane = 0; lane < lanes; ++lane) {
+            std::vector<MergeKey> keys(gen() % 200);
+            for (auto& key : keys) {
+                key = {gen() % 50, static_cast<std::uint32_t>(gen() % 20), gen() % 1000};
+            }
+            std::sort(keys.begin(), keys.end());
+            for (const auto& key : keys) {
+                merge.append(lane, key, payloadOf(key));
+            }
+            merge.close(lane);
+            expected.insert(expected.end(), keys.begin(), keys.end());
+        }
+        std::stable_sort(expected.begin(), expected.end());
+
+        std::vector<MergeKey> output;
+        std::size_t emitted = merge.drain([&](const MergeKey& key, std::string& payload) {
+            assert(payload == payloadOf(key));
+            output.push_back(key);
+        });
+        assert(emitted == expected.size());
+        assert(output == expected);
+        assert(merge.finished());
+    }
+
+    std::cout << "Loser tree order tests passed!" << std::endl;
+}
+
+void testWatermarks() {
+    std::cout << "Testing watermarks..." << std::endl;
+
+    EventMerge merge(2, 16);
+    std::vector<std::string> output;
+    auto sink = [&](const MergeKey&, std::string& payload) { output.push_back(payload); };
+
+    merge.append(0, {1, 0, 1}, "a");
+    merge.append(0, {2, 0, 2}, "b");
+    assert(merge.drain(sink) == 0);     // Lane 1 may still produce tick 0
+
+    merge.advance(1, 2);
+    assert(merge.drain(sink) == 1);     // Tick 1 is settled; lane 1 may still produce (2, 0, 0)
+    assert(output == std::vector<std::string>{"a"});
+
+    merge.append(1, {2, 1, 1}, "c");
+    merge.advance(1, 3);
+    assert(merge.drain(sink) == 1);     // Lane 0 is empty again and still at watermark 0
+    merge.advance(0, 3);
+    assert(merge.drain(sink) == 1);
+    assert((output == std::vector<std::string>{"a", "b", "c"}));
+
+    assert(!merge.finished());
+    merge.close(0);
+    merge.close(1);
+    assert(merge.finished());
+
+    std::cout << "Watermark tests passed!" << std::endl;
+}
+
+void testIndependentOfThreadCount() {
+    std::cout << "Testing output across worker counts..." << std::endl;
+
+    const std::uint32_t devices = 97;
+    const std::uint64_t ticks = 60;
+    std::size_t expected = 0;
+    for (std::uint32_t device = 0; device < devices; ++device) {
+        for (std::uint64_t tick = 1; tick <= ticks; ++tick) {
+            expected += eventsAt(device, tick);
+        }
+    }
+
+    auto reference = runFleet(1, devices, ticks, 16);
+    assert(reference.output.size() == expected);
+    for (std::size_t workers : {2, 3, 4, 8}) {
+        auto run = runFleet(workers, devices, ticks, 16);
+        assert(run.output == reference.output);
+        // Producers wait on full lanes, so lookahead stays within the lane capacity
+        assert(run.maxQueued <= workers * 16);
+        std::cout << "  " << workers << " workers: " << run.output.size() << " events, at most "
+                  << run.maxQueued << " queued" << std::endl;
+    }
+
+    std::cout << "Worker count tests passed!" << std::endl;
+}
+
+int main() {
+    std::cout << "Running Event Merge Tests..." << std::endl;
+
+    testLoserTreeOrder();
+    testWatermarks();
+    testIndependentOfThreadCount();
+
+    std::cout << "\nAll event merge tests passed!" << std::endl;
+    return 0;
+}
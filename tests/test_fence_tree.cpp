@@ -0,0 +1,189 @@
+#include "../core/FenceTree.hpp"
+#include <algorithm>
+#include <iostream>
+#include <cassert>
+#include <cmath>
+#include <cstring>
+#include <random>
+#include <unordered_map>
+
+using namespace tracker;
+
+namespace {
+    constexpr double kMetersPerDegree = 6371000.0 * 3.14159265358979323846 / 180.0;
+
+    /// Fences scattered over roughly 60 x 60 km around Johannesburg
+    std::vector<FenceRecord> randomFences(std::size_t count, std::uint32_t seed) {
+        std::mt19937 rng(seed);
+        std::uniform_real_distribution<double> lat(-26.5, -25.95);
+        std::uniform_real_distribution<double> lon(27.75, 28.35);
+        std::uniform_real_distribution<float> radius(30.0f, 400.0f);
+        std::vector<FenceRecord> fences(count);
+        for (std::size_t i = 0; i < count; ++i) {
+            fences[i] = {"addr-" + std::to_string(i), lat(rng), lon(rng), radius(rng)};
+        }
+        return fences;
+    }
+
+    std::unique_ptr<FenceTree> openImage(const std::vector<char>& image) {
+        std::string error;
+        auto tree = FenceTree::open(nullptr, image.data(), image.size(), error);
+        assert(tree && error.empty());
+        return tree;
+    }
+
+    /// Brute force with the tree's containment rule (flattened at the query latitude)
+    std::vector<std::string> bruteForce(const std::vector<FenceRecord>& fences, double lat, double lon) {
+        double eastScale = kMetersPerDegree * std::cos(lat * 3.14159265358979323846 / 180.0);
+        std::vector<std::string> ids;
+        for (const auto& fence : fences) {
+            double north = (lat - fence.lat) * kMetersPerDegree;
+            double east = (lon - fence.lon) * eastScale;
+            double radius = fence.radiusMeters;
+            if (north * north + east * east <= radius * radius) ids.push_back(fence.id);
+        }
+        std::sort(ids.begin(), ids.end());
+        return ids;
+    }
+}
+
+void testQueriesMatchBruteForce() {
+    std::cout << "Testing point queries against brute force..." << std::endl;
+
+    auto fences = randomFences(60000, 1);
+    std::string error;
+    auto image = FenceTree::build(fences, {}, error);
+    assert(!image.empty());
+    auto tree = openImage(image);
+    assert(tree->fenceCount() == fences.size());
+    assert(tree->levels() == 3);   // 353 leaves, 2 internal pages, root
+    assert(tree->leafPages() == (fences.size() + FenceTree::kLeafCapacity - 1) / FenceTree::kLeafCapacity);
+
+    std::mt19937 rng(2);
+    std::uniform_real_distribution<double> lat(-26.5, -25.95);
+    std::uniform_real_distribution<double> lon(27.75, 28.35);
+    std::vector<std::uint32_t> inside;
+    std::size_t hits = 0;
+    std::size_t pages = 0;
+    for (int q = 0; q < 3000; ++q) {
+        double qlat = lat(rng), qlon = lon(rng);
+        auto lookup = tree->query(qlat, qlon, inside);
+        assert(lookup.complete);
+        pages += lookup.pages;
+        assert(std::is_sorted(inside.begin(), inside.end()));
+
+        std::vector<std::string> ids;
+        for (auto fence : inside) ids.emplace_back(tree->id(fence));
+        std::sort(ids.begin(), ids.end());
+        assert(ids == bruteForce(fences, qlat, qlon));
+        hits += ids.size();
+    }
+    assert(hits > 1000);
+    // Hilbert packing keeps leaf boxes tight: a handful of pages per lookup, not a scan
+    assert(static_cast<double>(pages) / 3000.0 < 12.0);
+
+    std::cout << "Point query tests passed!" << std::endl;
+}
+
+void testBuildIsThreadIndependent() {
+    std::cout << "Testing parallel build..." << std::endl;
+
+    auto fences = randomFences(300000, 3);
+    std::string error;
+    FenceTree::BuildOptions one;
+    one.threads = 1;
+    FenceTree::BuildOptions many;
+    many.threads = 5;
+    auto serial = FenceTree::build(fences, one, error);
+    auto parallel = FenceTree::build(fences, many, error);
+    assert(!serial.empty() && serial == parallel);
+
+    // Every id round-trips through the Hilbert-ordered id table
+    auto tree = openImage(parallel);
+    std::unordered_map<std::string_view, int> seen;
+    for (std::uint32_t fence = 0; fence < tree->fenceCount(); ++fence) {
+        ++seen[tree->id(fence)];
+    }
+    assert(seen.size() == fences.size());
+    assert(tree->id(static_cast<std::uint32_t>(fences.size())).empty());
+
+    std::cout << "Parallel build tests passed!" << std::endl;
+}
+
+void testPageBudget() {
+    std::cout << "Testing page budget..." << std::endl;
+
+    // 2000 fences stacked on one point: every leaf matches
+    std::vector<FenceRecord> fences;
+    for (int i = 0; i < 2000; ++i) {
+        fences.push_back({"stack-" + std::to_string(i), -26.2, 28.05, 100.0f + static_cast<float>(i % 7)});
+    }
+    std::string error;
+    auto image = FenceTree::build(fences, {}, error);
+    auto tree = openImage(image);
+
+    std::vector<std::uint32_t> inside;
+    auto full = tree->query(-26.2, 28.05, inside);
+    assert(full.complete && inside.size() == 2000);
+    assert(full.pages == tree->leafPages() + 1);
+
+    auto capped = tree->query(-26.2, 28.05, inside, 3);
+    assert(!capped.complete && capped.pages == 3);
+    assert(inside.size() == 2 * FenceTree::kLeafCapacity);
+
+    std::cout << "Page budget tests passed!" << std::endl;
+}
+
+void testRejectsInvalidInput() {
+    std::cout << "Testing invalid input..." << std::endl;
+
+    std::string error;
+    assert(FenceTree::build({}, {}, error).empty());
+    assert(FenceTree::build({{"far", 91.0, 0.0, 10.0f}}, {}, error).empty());
+    assert(error.find("far") != std::string::npos);
+    assert(FenceTree::build({{"flat", 0.0, 0.0, 0.0f}}, {}, error).empty());
+
+    auto image = FenceTree::build(randomFences(1000, 4), {}, error);
+    assert(FenceTree::open(nullptr, image.data(), FenceTree::kPageSize - 1, error) == nullptr);
+    assert(FenceTree::open(nullptr, image.data(), image.size() - 1, error) == nullptr);   // Id bytes cut off
+    auto corrupt = image;
+    corrupt[0] = 'X';
+    assert(FenceTree::open(nullptr, corrupt.data(), corrupt.size(), error) == nullptr);
+    assert(error.find("magic") != std::string::npos);
+
+    // Header offsets that would wrap 64-bit sums past the bounds checks
+    FenceTree::FileHeader header;
+    std::memcpy(&header, image.data(), sizeof(header));
+    auto withHeader = [&](auto change) {
+        auto bad = image;
+        FenceTree::FileHeader modified = header;
+        change(modified);
+        std::memcpy(bad.data(), &modified, sizeof(modified));
+        std::string reason;
+        bool rejected = FenceTree::open(nullptr, bad.data(), bad.size(), reason) == nullptr;
+        assert(!rejected || reason.find("corrupt") != std::string::npos);
+        return rejected;
+    };
+    assert(!withHeader([](FenceTree::FileHeader&) {}));
+    assert(withHeader([](FenceTree::FileHeader& h) { h.idOffsetsAt = ~std::uint64_t{0} - 7; }));
+    assert(withHeader([](FenceTree::FileHeader& h) { h.idOffsetsAt = ~std::uint64_t{0} - (h.fenceCount + 1) * 8 + 1 - 7; }));
+    assert(withHeader([](FenceTree::FileHeader& h) { h.fenceCount = ~std::uint64_t{0} / 8; }));
+    assert(withHeader([](FenceTree::FileHeader& h) { h.idBytesSize = ~std::uint64_t{0} - h.idBytesAt + 1; }));
+    assert(withHeader([](FenceTree::FileHeader& h) { h.idBytesAt = ~std::uint64_t{0}; }));
+    assert(withHeader([](FenceTree::FileHeader& h) { h.idBytesAt = h.idOffsetsAt; }));
+    assert(withHeader([&](FenceTree::FileHeader& h) { h.pageCount = static_cast<std::uint32_t>(image.size() / FenceTree::kPageSize + 1); }));
+
+    std::cout << "Invalid input tests passed!" << std::endl;
+}
+
+int main() {
+    std::cout << "Running Fence Tree Tests..." << std::endl;
+
+    testQueriesMatchBruteForce();
+    testBuildIsThreadIndependent();
+    testPageBudget();
+    testRejectsInvalidInput();
+
+    std::cout << "\nAll fence tree tests passed!" << std::endl;
+    return 0;
+}
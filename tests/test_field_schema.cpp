@@ -0,0 +1,172 @@
+#include "../core/FieldSchema.hpp"
+#include "../core/JsonCodec.hpp"
+#include "../core/IRng.hpp"
+#include <array>
+#include <iostream>
+#include <cassert>
+#include <random>
+
+using namespace tracker;
+
+namespace {
+    class SeededRng : public IRng {
+    public:
+        explicit SeededRng(unsigned seed) : gen_(seed) {}
+        double uniform(double min, double max) override { return std::uniform_real_distribution<double>(min, max)(gen_); }
+        int uniformInt(int min, int max) override { return std::uniform_int_distribution<int>(min, max)(gen_); }
+        double normal(double mean, double stddev) override { return std::normal_distribution<double>(mean, stddev)(gen_); }
+    private:
+        std::mt19937 gen_;
+    };
+
+    FieldSpec field(const std::string& name, const std::string& type, const std::string& generator) {
+        FieldSpec spec;
+        spec.name = name;
+        spec.type = type;
+        spec.generator = generator;
+        return spec;
+    }
+
+    std::vector<FieldSpec> sampleSpecs() {
+        auto door = field("doorOpen", "bool", "toggle");
+        door.probability = 0.5;
+        auto driver = field("driverId", "string", "choice");
+        driver.values = {"D-100", "D-200", "D-300"};
+        auto temp = field("probeTempC", "float", "random_walk");
+        temp.mean = 4.0;
+        temp.step = 0.5;
+        temp.min = 2.0;
+        temp.max = 8.0;
+        auto trips = field("tripCount", "int", "counter");
+        trips.min = 10;
+        trips.step = 1;
+        auto fw = field("firmware", "string", "constant");
+        fw.value = "1.4.2";
+        auto load = field("loadKg", "int", "uniform");
+        load.min = 0;
+        load.max = 3;
+        return {door, driver, temp, trips, fw, load};
+    }
+
+    const FieldSchema::Slot& slotNamed(const FieldSchema& schema, const std::string& name) {
+        for (const auto& slot : schema.plan()) {
+            if (slot.name == name) return slot;
+        }
+        assert(false);
+        return schema.plan().front();
+    }
+}
+
+void testCompileAndLayout() {
+    std::cout << "Testing schema compilation and layout..." << std::endl;
+
+    std::string error;
+    auto schema = FieldSchema::compile(sampleSpecs(), error);
+    assert(schema);
+    assert(schema->plan().size() == 6);
+
+    // 8-byte values, then 4-byte string indices, then bools: 3*8 + 2*4 + 1 -> 40
+    assert(schema->recordBytes() == 40);
+    assert(schema->recordWords() == 5);
+    for (const auto& slot : schema->plan()) {
+        std::size_t size = slot.type == FieldType::Bool ? 1 : slot.type == FieldType::String ? 4 : 8;
+        assert(slot.offset % size == 0);
+    }
+    assert(slotNamed(*schema, "doorOpen").offset == 32);
+
+    auto reject = [](std::vector<FieldSpec> specs) {
+        std::string reason;
+        bool rejected = FieldSchema::compile(specs, reason) == nullptr;
+        assert(!reason.empty() || !rejected);
+        return rejected;
+    };
+    assert(reject({field("seq", "int", "counter")}));                // Built-in name
+    assert(reject({field("a", "int", "counter"), field("a", "int", "counter")}));
+    assert(reject({field("a", "decimal", "constant")}));
+    assert(reject({field("a", "bool", "uniform")}));
+    assert(reject({field("a", "string", "choice")}));                // No values
+    assert(reject({field("a", "float", "constant")}));               // No value
+    assert(reject({field("a", "int", "uniform")}));                  // max <= min
+
+    std::cout << "Schema compilation tests passed!" << std::endl;
+}
+
+void testGeneratorsStayInRange() {
+    std::cout << "Testing field generators..." << std::endl;
+
+    std::string error;
+    auto schema = FieldSchema::compile(sampleSpecs(), error);
+    std::vector<std::uint64_t> storage(schema->recordWords());
+    auto* record = reinterpret_cast<std::uint8_t*>(storage.data());
+    schema->initialize(record);
+
+    const auto& temp = slotNamed(*schema, "probeTempC");
+    const auto& trips = slotNamed(*schema, "tripCount");
+    const auto& load = slotNamed(*schema, "loadKg");
+    const auto& driver = slotNamed(*schema, "driverId");
+    const auto& door = slotNamed(*schema, "doorOpen");
+    assert(schema->floatValue(record, temp) == 4.0);
+    assert(schema->intValue(record, trips) == 10);
+    assert(!schema->boolValue(record, door));
+
+    SeededRng rng(3);
+    std::array<int, 4> loads{};
+    int flips = 0;
+    bool lastDoor = false;
+    for (int i = 0; i < 4000; ++i) {
+        schema->advance(record, rng);
+        double t = schema->floatValue(record, temp);
+        assert(t >= 2.0 && t <= 8.0);
+        auto kg = schema->intValue(record, load);
+        assert(kg >= 0 && kg <= 3);
+        ++loads[static_cast<std::size_t>(kg)];
+        const auto& id = schema->stringValue(record, driver);
+        assert(id == "D-100" || id == "D-200" || id == "D-300");
+        flips += schema->boolValue(record, door) != lastDoor;
+        lastDoor = schema->boolValue(record, door);
+    }
+    assert(schema->intValue(record, trips) == 4010);
+    for (int count : loads) {
+        assert(count > 800);   // Every integer in min..max, max included
+    }
+    assert(flips > 1500 && flips < 2500);
+
+    std::cout << "Field generator tests passed!" << std::endl;
+}
+
+void testJsonEncoding() {
+    std::cout << "Testing custom field encoding..." << std::endl;
+
+    std::string error;
+    auto schema = FieldSchema::compile(sampleSpecs(), error);
+    std::vector<std::uint64_t> storage(schema->recordWords());
+    schema->initialize(reinterpret_cast<std::uint8_t*>(storage.data()));
+
+    Event event;
+    event.deviceId = "SIM-001";
+    event.eventType = EventType::Heartbeat;
+    event.fieldSchema = schema.get();
+    event.fieldRecord = reinterpret_cast<const std::uint8_t*>(storage.data());
+
+    auto json = nlohmann::json::parse(JsonCodec::serialize(event));
+    assert(json.at("doorOpen").is_boolean() && json.at("doorOpen") == false);
+    assert(json.at("driverId") == "D-100");
+    assert(json.at("probeTempC").is_number_float() && json.at("probeTempC") == 4.0);
+    assert(json.at("tripCount").is_number_integer() && json.at("tripCount") == 10);
+    assert(json.at("firmware") == "1.4.2");
+    assert(json.at("deviceId") == "SIM-001");
+    assert(!json.contains("extras"));
+
+    std::cout << "Custom field encoding tests passed!" << std::endl;
+}
+
+int main() {
+    std::cout << "Running Field Schema Tests..." << std::endl;
+
+    testCompileAndLayout();
+    testGeneratorsStayInRange();
+    testJsonEncoding();
+
+    std::cout << "\nAll field schema tests passed!" << std::endl;
+    return 0;
+}
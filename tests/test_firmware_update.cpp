@@ -0,0 +1,250 @@
+#include "../core/FirmwareUpdate.hpp"
+#include "../crypto/Sha256.hpp"
+#include <iostream>
+#include <cassert>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <thread>
+
+using namespace tracker;
+
+namespace {
+    namespace fs = std::filesystem;
+
+    /// In-memory blob store; fails every failEvery-th range request when set
+    class MemorySource : public IFirmwareSource {
+    public:
+        explicit MemorySource(std::vector<std::uint8_t> image) : image_(std::move(image)) {}
+
+        bool readRange(const std::string& source, std::uint64_t offset, std::uint8_t* buffer,
+                       std::size_t length, std::size_t& received, std::string& error) override {
+            ++requests;
+            if (source != "image.bin" || (failEvery && requests % failEvery == 0)) {
+                error = source + ": unavailable";
+                return false;
+            }
+            received = offset < image_.size() ? std::min<std::size_t>(length, image_.size() - offset) : 0;
+            std::memcpy(buffer, image_.data() + offset, received);
+            return true;
+        }
+
+        std::atomic<std::size_t> requests{0};
+        std::size_t failEvery = 0;
+
+    private:
+        std::vector<std::uint8_t> image_;
+    };
+
+    std::vector<std::uint8_t> makeImage(std::size_t size) {
+        std::vector<std::uint8_t> image(size);
+        std::uint32_t x = 12345;
+        for (auto& byte : image) {
+            x = x * 1664525u + 1013904223u;
+            byte = static_cast<std::uint8_t>(x >> 24);
+        }
+        return image;
+    }
+
+    FirmwareJob jobFor(const std::vector<std::uint8_t>& image, const std::string& version) {
+        Sha256 hash;
+        hash.update(image.data(), image.size());
+        return {version, "image.bin", hash.finalHex(), image.size()};
+    }
+
+    FirmwareCampaign::Report waitUntilDone(const FirmwareCampaign& campaign) {
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(60);
+        while (!campaign.report().done()) {
+            assert(std::chrono::steady_clock::now() < deadline);
+            std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        }
+        return campaign.report();
+    }
+
+    std::vector<std::uint8_t> readFile(const fs::path& path) {
+        std::ifstream file(path, std::ios::binary);
+        return {std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>()};
+    }
+}
+
+void testSha256() {
+    std::cout << "Testing SHA-256..." << std::endl;
+
+    Sha256 hash;
+    hash.update("abc", 3);
+    assert(hash.finalHex() == "ba7816bf8f01cfea414140de5dae2223b00361a396177a9cb410ff61f20015ad");
+
+    // Same digest in pieces as in one call
+    auto image = makeImage(100000);
+    hash.reset();
+    for (std::size_t at = 0; at < image.size(); at += 777) {
+        hash.update(image.data() + at, std::min<std::size_t>(777, image.size() - at));
+    }
+    auto pieces = hash.finalHex();
+    hash.reset();
+    hash.update(image.data(), image.size());
+    assert(pieces == hash.finalHex());
+    assert(Sha256::fileHex("/nonexistent/image.bin").empty());
+
+    std::cout << "SHA-256 tests passed!" << std::endl;
+}
+
+void testJobFromDesired() {
+    std::cout << "Testing ota desired properties..." << std::endl;
+
+    std::string digest(64, 'A');
+    FirmwareJob job;
+    std::string error;
+    bool ok = FirmwareJob::fromDesired({{"version", "2.4.1"}, {"url", "fw/2.4.1.bin"}, {"sha256", digest},
+                                        {"size", 4096}}, job, error);
+    assert(ok && job.version == "2.4.1" && job.source == "fw/2.4.1.bin" && job.size == 4096);
+    assert(job.sha256 == std::string(64, 'a'));
+
+    ok = FirmwareJob::fromDesired({{"version", 3}, {"source", "a.bin"}, {"sha256", "abc"}, {"size", 1}}, job, error);
+    assert(!ok && error.find("sha256") != std::string::npos);
+    ok = FirmwareJob::fromDesired({{"version", "1"}, {"source", "a.bin"}, {"sha256", digest}}, job, error);
+    assert(!ok && error.find("size") != std::string::npos);
+    ok = FirmwareJob::fromDesired("2.4.1", job, error);
+    assert(!ok);
+
+    std::cout << "Desired properties tests passed!" << std::endl;
+}
+
+void testCampaignWithInterruptions() {
+    std::cout << "Testing fleet download with interruptions..." << std::endl;
+
+    auto flash = fs::temp_directory_path() / "firmware-update-test";
+    fs::remove_all(flash);
+    fs::create_directories(flash);
+
+    auto image = makeImage(300 * 1024 + 17);
+    auto source = std::make_shared<MemorySource>(image);
+    FotaConfig config;
+    config.flashDirectory = flash.string();
+    config.workers = 4;
+    config.chunkBytes = 16 * 1024;
+    config.maxActive = 50;          // 200 devices: most wait for a slot
+    config.interruptRate = 0.2;
+    FirmwareCampaign campaign(source, config);
+
+    std::atomic<std::size_t> finished{0};
+    campaign.setFinishedCallback([&](std::size_t, const FirmwareCampaign::Result& result) {
+        if (result.state == FirmwareCampaign::State::Verified) ++finished;
+    });
+    auto job = jobFor(image, "2.0");
+    for (std::size_t device = 0; device < 200; ++device) {
+        bool queued = campaign.start(device, "dev" + std::to_string(device), job);
+        assert(queued);
+    }
+    // Repeated patches (twin refreshes) do not restart a download
+    bool again = campaign.start(0, "dev0", job);
+    assert(!again);
+
+    auto report = waitUntilDone(campaign);
+    assert(report.started == 200 && report.verified == 200 && report.failed == 0);
+    assert(finished == 200);
+    assert(report.bytes == 200 * image.size());
+    assert(report.resumes > 0);
+    assert(report.p50Seconds > 0.0 && report.p50Seconds <= report.p95Seconds && report.p95Seconds <= report.maxSeconds);
+    assert(readFile(flash / "dev123-2.0.bin") == image);
+    std::cout << "  " << report.bytesPerSecond() / 1e6 << " MB/s, p95 " << report.p95Seconds * 1000.0
+              << " ms, " << report.resumes << " resumed ranges" << std::endl;
+
+    auto device = campaign.result(7);
+    assert(device.state == FirmwareCampaign::State::Verified && device.bytes == image.size());
+    again = campaign.start(7, "dev7", job);
+    assert(!again);
+    fs::remove_all(flash);
+
+    std::cout << "Fleet download tests passed!" << std::endl;
+}
+
+void testResumeFromFlashAndFailures() {
+    std::cout << "Testing resume from flash and failures..." << std::endl;
+
+    auto flash = fs::temp_directory_path() / "firmware-update-resume-test";
+    fs::remove_all(flash);
+    fs::create_directories(flash);
+    auto image = makeImage(100 * 1024);
+    {
+        // An earlier run stopped after 40 KB
+        std::ofstream partial(flash / "dev0-3.0.bin", std::ios::binary);
+        partial.write(reinterpret_cast<const char*>(image.data()), 40 * 1024);
+    }
+
+    auto source = std::make_shared<MemorySource>(image);
+    FotaConfig config;
+    config.flashDirectory = flash.string();
+    config.chunkBytes = 8 * 1024;
+    FirmwareCampaign campaign(source, config);
+
+    auto job = jobFor(image, "3.0");
+    campaign.start(0, "dev0", job);
+    auto bad = job;
+    bad.sha256 = std::string(64, '0');
+    campaign.start(1, "dev1", bad);
+    auto missing = job;
+    missing.source = "other.bin";
+    campaign.start(2, "dev2", missing);
+    auto report = waitUntilDone(campaign);
+    assert(report.verified == 1 && report.failed == 2);
+
+    auto resumed = campaign.result(0);
+    assert(resumed.bytes == image.size() - 40 * 1024 && resumed.resumes == 1);
+    assert(readFile(flash / "dev0-3.0.bin") == image);
+
+    auto corrupt = campaign.result(1);
+    assert(corrupt.state == FirmwareCampaign::State::Failed);
+    assert(corrupt.error.find("SHA-256 mismatch") != std::string::npos);
+    assert(!fs::exists(flash / "dev1-3.0.bin"));   // Erased, a retry starts clean
+    assert(campaign.result(2).error.find("unavailable") != std::string::npos);
+
+    // Transient source errors are retried
+    source->failEvery = 3;
+    bool restarted = campaign.start(2, "dev2", job);
+    assert(restarted);
+    report = waitUntilDone(campaign);
+    assert(campaign.result(2).state == FirmwareCampaign::State::Verified && report.verified == 2);
+    fs::remove_all(flash);
+
+    std::cout << "Resume and failure tests passed!" << std::endl;
+}
+
+void testRateLimit() {
+    std::cout << "Testing aggregate rate limit..." << std::endl;
+
+    auto image = makeImage(256 * 1024);
+    FotaConfig config;
+    config.chunkBytes = 16 * 1024;
+    config.bytesPerSecond = 4.0 * 1024 * 1024;   // 1 MB in total: at least ~0.23 s past the burst
+    FirmwareCampaign campaign(std::make_shared<MemorySource>(image), config);
+
+    auto started = std::chrono::steady_clock::now();
+    auto job = jobFor(image, "1.0");
+    for (std::size_t device = 0; device < 4; ++device) {
+        campaign.start(device, "dev" + std::to_string(device), job);
+    }
+    auto report = waitUntilDone(campaign);
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - started).count();
+    assert(report.verified == 4);
+    assert(seconds >= 0.2);
+    assert(report.bytesPerSecond() < 4.0 * 1024 * 1024 * 1.3);
+
+    std::cout << "Rate limit tests passed!" << std::endl;
+}
+
+int main() {
+    std::cout << "Running Firmware Update Tests..." << std::endl;
+
+    testSha256();
+    testJobFromDesired();
+    testCampaignWithInterruptions();
+    testResumeFromFlashAndFailures();
+    testRateLimit();
+
+    std::cout << "\nAll firmware update tests passed!" << std::endl;
+    return 0;
+}
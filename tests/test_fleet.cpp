@@ -0,0 +1,106 @@
+#include "../core/Fleet.hpp"
+#include <nlohmann/json.hpp>
+#include <iostream>
+#include <cassert>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace tracker;
+
+namespace {
+    /// Client that accepts everything and never calls back
+    class NullClient : public IMqttClient {
+    public:
+        bool connect(const std::string&, std::uint16_t, const std::string&,
+                     const std::string&, const std::string&) override { return true; }
+        bool connectWithTls(const std::string&, std::uint16_t, const std::string&,
+                            const std::string&, const TlsConfig&) override { return true; }
+        void disconnect() override {}
+        bool isConnected() const override { return true; }
+        bool publish(const std::string&, const std::string&, int, bool) override { return true; }
+        bool subscribe(const std::string&, int) override { return true; }
+        bool unsubscribe(const std::string&) override { return true; }
+        void setMessageCallback(MessageCallback) override {}
+        void setConnectionCallback(ConnectionCallback) override {}
+        void setAckCallback(AckCallback) override {}
+        void processEvents() override {}
+    };
+
+    /// Clock frozen at one instant, so timestamps do not differ between runs
+    class FixedClock : public IClock {
+    public:
+        std::chrono::system_clock::time_point now() const override {
+            return std::chrono::system_clock::time_point(std::chrono::seconds(1750000000));
+        }
+        uint64_t epochSeconds() const override { return 1750000000; }
+        std::string iso8601() const override { return "2025-06-15T15:06:40Z"; }
+    };
+
+    /**
+     * Drives every device a few times through the real Fleet and records the
+     * ordered sink. Speeds are drawn off the tick; headings and the drive-end
+     * events (with the position they reached) come from inside the ticks.
+     * Battery drain follows wall time between ticks, so it is left out.
+     */
+    std::vector<std::string> runFleet(std::size_t workers, std::size_t devices) {
+        Fleet fleet([] { return std::make_shared<NullClient>(); },
+                    std::make_shared<FixedClock>(), std::make_shared<StandardRng>(42));
+        fleet.setTickWorkers(workers);
+
+        SimulatorConfig base;
+        base.heartbeatSeconds = 3600;
+        fleet.configure(base, devices);
+
+        std::mutex mutex;
+        std::vector<std::string> output;
+        fleet.setOrderedEventSink([&](const std::string& json) {
+            auto event = nlohmann::json::parse(json);
+            event.erase("battery");
+            std::lock_guard<std::mutex> lock(mutex);
+            output.push_back(event.dump());
+        });
+        fleet.start();
+        for (int round = 0; round < 4; ++round) {
+            // A drive that is over by the next tick: one heading draw, then motion_stop there
+            fleet.forEach([](Simulator& device) { device.startDriving(0.0001); });
+            std::this_thread::sleep_for(std::chrono::milliseconds(20));
+            fleet.tick();
+            fleet.tick();
+        }
+        fleet.stop();
+
+        std::lock_guard<std::mutex> lock(mutex);
+        return output;
+    }
+}
+
+void testOutputIndependentOfWorkers() {
+    std::cout << "Testing fleet output across worker counts..." << std::endl;
+
+    const std::size_t devices = 24;
+    auto reference = runFleet(1, devices);
+    assert(!reference.empty());
+    auto parallel = runFleet(4, devices);
+    assert(parallel.size() == reference.size());
+    for (std::size_t i = 0; i < reference.size(); ++i) {
+        if (parallel[i] != reference[i]) {
+            std::cout << "  event " << i << " differs:\n  " << reference[i] << "\n  " << parallel[i] << std::endl;
+        }
+        assert(parallel[i] == reference[i]);
+    }
+    std::cout << "  " << reference.size() << " events identical with 1 and 4 workers" << std::endl;
+
+    std::cout << "Worker count tests passed!" << std::endl;
+}
+
+int main() {
+    std::cout << "Running Fleet Tests..." << std::endl;
+
+    testOutputIndependentOfWorkers();
+
+    std::cout << "\nAll fleet tests passed!" << std::endl;
+    return 0;
+}
@@ -0,0 +1,163 @@
+#include "../core/FleetIndex.hpp"
+#include <iostream>
+#include <cassert>
+#include <algorithm>
+#include <atomic>
+#include <random>
+#include <thread>
+
+using namespace tracker;
+
+namespace {
+    const Location kOrigin{-26.2041, 28.0473, 0.0, 0.0};   // Johannesburg
+
+    std::vector<std::string> deviceIds(std::size_t count) {
+        std::vector<std::string> ids;
+        for (std::size_t i = 0; i < count; ++i) {
+            ids.push_back("SIM-" + std::to_string(i));
+        }
+        return ids;
+    }
+
+    std::vector<EnuPoint> scatter(std::mt19937& gen, std::size_t count, float extent) {
+        std::uniform_real_distribution<float> coord(-extent, extent);
+        std::vector<EnuPoint> points(count);
+        for (auto& p : points) {
+            p = {coord(gen), coord(gen)};
+        }
+        return points;
+    }
+}
+
+void testQueriesMatchBruteForce() {
+    std::cout << "Testing box, polygon and nearest queries against brute force..." << std::endl;
+
+    std::mt19937 gen(7);
+    auto catalog = Catalog::build(kOrigin, {}, {});
+    FleetIndex index(deviceIds(3000), 200.0f);
+    const std::vector<std::uint32_t> none;
+
+    // Two ticks so most devices change cells incrementally
+    std::vector<EnuPoint> points;
+    for (int tick = 0; tick < 2; ++tick) {
+        points = scatter(gen, index.size(), 5000.0f);
+        for (std::uint32_t i = 0; i < points.size(); ++i) {
+            index.update(i, points[i], none);
+        }
+        index.publish(*catalog);
+    }
+    assert(index.cellMoves() > index.size());
+
+    auto snapshot = index.snapshot();
+    assert(snapshot->tick() == 2);
+    assert(snapshot->size() == points.size());
+
+    std::uniform_real_distribution<float> coord(-6000.0f, 6000.0f);
+    for (int q = 0; q < 200; ++q) {
+        EnuPoint a{coord(gen), coord(gen)}, b{coord(gen), coord(gen)};
+        std::vector<std::uint32_t> expected;
+        for (std::uint32_t i = 0; i < points.size(); ++i) {
+            if (points[i].east >= std::min(a.east, b.east) && points[i].east <= std::max(a.east, b.east) &&
+                points[i].north >= std::min(a.north, b.north) && points[i].north <= std::max(a.north, b.north)) {
+                expected.push_back(i);
+            }
+        }
+        assert(snapshot->inBox(a, b) == expected);
+
+        // Same box as a polygon
+        std::vector<EnuPoint> square{{a.east, a.north}, {b.east, a.north}, {b.east, b.north}, {a.east, b.north}};
+        auto inside = snapshot->inPolygon(square);
+        assert(inside.size() <= expected.size() && inside.size() + 5 >= expected.size());  // Edges may differ
+
+        EnuPoint center{coord(gen), coord(gen)};
+        std::vector<float> distances;
+        for (const auto& p : points) {
+            distances.push_back(LocalFrame::distanceMeters(center, p));
+        }
+        std::sort(distances.begin(), distances.end());
+        auto hits = snapshot->nearest(center, 50);
+        assert(hits.size() == 50);
+        for (std::size_t i = 0; i < hits.size(); ++i) {
+            assert(hits[i].distanceMeters == distances[i]);
+        }
+    }
+
+    // Triangle: only the half of the box below the diagonal
+    auto triangle = snapshot->inPolygon(std::vector<EnuPoint>{{-5000.0f, -5000.0f}, {5000.0f, -5000.0f}, {5000.0f, 5000.0f}});
+    for (auto device : triangle) {
+        assert(points[device].north <= points[device].east + 1e-3f);
+    }
+
+    std::cout << "Query tests passed!" << std::endl;
+}
+
+void testFenceMembership() {
+    std::cout << "Testing fence membership lookup..." << std::endl;
+
+    auto catalog = Catalog::build(kOrigin, {}, {{"office", kOrigin.lat, kOrigin.lon, 100.0},
+                                                {"depot", kOrigin.lat + 0.01, kOrigin.lon, 100.0}});
+    FleetIndex index(deviceIds(4));
+    index.update(0, {0.0f, 0.0f}, {0});
+    index.update(1, {10.0f, 0.0f}, {0});
+    index.update(2, {0.0f, 1100.0f}, {1});
+    index.update(3, {5000.0f, 0.0f}, {});
+    index.publish(*catalog);
+
+    auto snapshot = index.snapshot();
+    assert((snapshot->inFence("office") == std::vector<std::uint32_t>{0, 1}));
+    assert((snapshot->inFence("depot") == std::vector<std::uint32_t>{2}));
+    assert(snapshot->inFence("unknown").empty());
+    assert(snapshot->deviceId(2) == "SIM-2");
+
+    // Lat/lon queries project through the catalog frame
+    auto nearby = snapshot->nearest(kOrigin, 2);
+    assert(nearby.size() == 2 && nearby[0].device == 0 && nearby[1].device == 1);
+
+    std::cout << "Fence membership tests passed!" << std::endl;
+}
+
+void testSnapshotsAreStable() {
+    std::cout << "Testing snapshot reads during publishing..." << std::endl;
+
+    auto catalog = Catalog::build(kOrigin, {}, {});
+    FleetIndex index(deviceIds(1000));
+    const std::vector<std::uint32_t> none;
+    index.publish(*catalog);
+
+    // Every device of tick t sits at east == t; readers must never see a mix
+    std::atomic<bool> done{false};
+    std::atomic<int> reads{0};
+    std::thread reader([&]() {
+        while (!done.load()) {
+            auto snapshot = index.snapshot();
+            float east = snapshot->position(0).east;
+            for (std::uint32_t i = 0; i < snapshot->size(); ++i) {
+                assert(snapshot->position(i).east == east);
+            }
+            assert(snapshot->inBox(EnuPoint{east - 1.0f, -1.0f}, EnuPoint{east + 1.0f, 1.0f}).size() == snapshot->size());
+            reads.fetch_add(1);
+        }
+    });
+
+    for (int tick = 1; tick <= 300 || reads.load() < 10; ++tick) {
+        for (std::uint32_t i = 0; i < index.size(); ++i) {
+            index.update(i, {static_cast<float>(tick), 0.0f}, none);
+        }
+        index.publish(*catalog);
+    }
+    done = true;
+    reader.join();
+
+    std::cout << "Snapshot tests passed!" << std::endl;
+}
+
+int main() {
+    std::cout << "Running Fleet Index Tests..." << std::endl;
+
+    testQueriesMatchBruteForce();
+    testFenceMembership();
+    testSnapshotsAreStable();
+
+    std::cout << "\nAll fleet index tests passed!" << std::endl;
+    return 0;
+}
@@ -0,0 +1,174 @@
+#include "../core/Simulator.hpp"
+#include "../core/PhaseSchedule.hpp"
+#include <nlohmann/json.hpp>
+#include <iostream>
+#include <atomic>
+#include <cassert>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+using namespace tracker;
+using namespace std::chrono_literals;
+
+namespace {
+    /// Always returns the same draw so jittered deadlines are predictable
+    class FixedRng : public IRng {
+    public:
+        explicit FixedRng(double value) : value_(value) {}
+        double uniform(double min, double max) override { return min + (max - min) * value_; }
+        int uniformInt(int min, int) override { return min; }
+        double normal(double mean, double) override { return mean; }
+
+    private:
+        double value_;
+    };
+
+    /// Accepts every publish and leaves acknowledgements to the test
+    class AckClient : public IMqttClient {
+    public:
+        bool connect(const std::string&, std::uint16_t, const std::string&,
+                     const std::string&, const std::string&) override { return true; }
+        bool connectWithTls(const std::string&, std::uint16_t, const std::string&,
+                            const std::string&, const TlsConfig&) override { return true; }
+        void disconnect() override {}
+        bool isConnected() const override { return true; }
+        bool publish(const std::string&, const std::string& payload, int, bool) override {
+            std::lock_guard<std::mutex> lock(mutex);
+            eventTypes.push_back(nlohmann::json::parse(payload).value("eventType", ""));
+            return true;
+        }
+        bool subscribe(const std::string&, int) override { return true; }
+        bool unsubscribe(const std::string&) override { return true; }
+        void setMessageCallback(MessageCallback) override {}
+        void setConnectionCallback(ConnectionCallback callback) override { connection = std::move(callback); }
+        void setAckCallback(AckCallback callback) override { ack = std::move(callback); }
+        void processEvents() override {}
+
+        std::size_t heartbeats() {
+            std::lock_guard<std::mutex> lock(mutex);
+            std::size_t count = 0;
+            for (const auto& type : eventTypes) {
+                count += type == "heartbeat" ? 1 : 0;
+            }
+            return count;
+        }
+
+        ConnectionCallback connection;
+        AckCallback ack;
+        std::mutex mutex;
+        std::vector<std::string> eventTypes;
+    };
+
+    using Clock = PeriodicDeadline::Clock;
+
+    /// Steady time that only moves when the test steps it
+    class SteppedClock : public SystemClock {
+    public:
+        Clock::time_point steadyNow() const override { return Clock::time_point(Clock::duration(now_.load())); }
+        void set(Clock::time_point at) { now_.store(at.time_since_epoch().count()); }
+
+    private:
+        std::atomic<Clock::rep> now_{Clock::now().time_since_epoch().count()};
+    };
+
+    /// Step to the given time after start and tick, then return the heartbeats published so far
+    std::size_t heartbeatsAt(Simulator& simulator, SteppedClock& clock, AckClient& client, Clock::time_point at) {
+        clock.set(at);
+        simulator.tick();
+        return client.heartbeats();
+    }
+}
+
+void testRestart() {
+    std::cout << "Testing deadline restart..." << std::endl;
+
+    Clock::time_point t0{};
+    PeriodicDeadline deadline;
+
+    // Not armed: nothing to restart
+    deadline.restart(t0 + 5s, nullptr, 0.0);
+    assert(!deadline.isArmed());
+
+    // Activity starts a full period from when it happened
+    deadline.arm(t0, 10s, 10s);
+    assert(deadline.deadline() == t0 + 10s);
+    deadline.restart(t0 + 4s, nullptr, 0.0);
+    assert(deadline.deadline() == t0 + 14s);
+    assert(!deadline.due(t0 + 13s) && deadline.due(t0 + 14s));
+
+    // Never moved earlier: older activity (e.g. a late PUBACK) keeps the later deadline
+    deadline.restart(t0 + 2s, nullptr, 0.0);
+    assert(deadline.deadline() == t0 + 14s);
+    deadline.restart(t0 + 4s, nullptr, 0.0);
+    assert(deadline.deadline() == t0 + 14s);
+
+    // Firing continues on the restarted grid
+    deadline.advance(t0 + 14s, nullptr, 0.0);
+    assert(deadline.deadline() == t0 + 24s);
+
+    // Jitter delays the restarted deadline, but an earlier jittered result is discarded
+    FixedRng half(0.5);
+    deadline.restart(t0 + 20s, &half, 0.2);
+    assert(deadline.deadline() == t0 + 31s);      // 20 s + 10 s + 0.5 * 0.2 * 10 s
+    FixedRng none(0.0);
+    deadline.restart(t0 + 20s, &none, 0.2);
+    assert(deadline.deadline() == t0 + 31s);
+
+    std::cout << "Deadline restart tests passed!" << std::endl;
+}
+
+void testHeartbeatElision() {
+    std::cout << "Testing heartbeat elision on PUBACK..." << std::endl;
+
+    auto client = std::make_shared<AckClient>();
+    auto clock = std::make_shared<SteppedClock>();
+    Simulator simulator(client, clock, std::make_shared<FixedRng>(0.5));
+    SimulatorConfig config;
+    config.iotHubHost = "test.azure-devices.net";
+    config.deviceKeyBase64 = "dGVzdGtleQ==";
+    config.heartbeatSeconds = 1;
+    config.phaseSpreading = false;
+    config.logEvents = false;
+    simulator.configure(config);
+
+    auto started = clock->steadyNow();
+    simulator.start();
+    assert(client->connection && client->ack);
+    client->connection(true, "test");
+
+    // Published at 0.5 s but not acknowledged: the heartbeat stays due at 1 s
+    assert(heartbeatsAt(simulator, *clock, *client, started + 500ms) == 0);
+    simulator.setIgnition(true);
+    assert(heartbeatsAt(simulator, *clock, *client, started + 1100ms) == 1);
+
+    // PUBACKs arrive in publish order: the event's failed, then the heartbeat's
+    client->ack(IMqttClient::Ack::Publish, 1, false);
+    client->ack(IMqttClient::Ack::Publish, 1, true);
+    assert(heartbeatsAt(simulator, *clock, *client, started + 1200ms) == 1);
+
+    // Acknowledged at 1.3 s: the 2 s heartbeat is elided until 2.3 s.
+    // A QoS 0 completion (twin traffic) before it does not settle the event
+    simulator.setIgnition(false);
+    clock->set(started + 1300ms);
+    client->ack(IMqttClient::Ack::Publish, 0, true);
+    client->ack(IMqttClient::Ack::Publish, 1, true);
+    assert(heartbeatsAt(simulator, *clock, *client, started + 2100ms) == 1);
+    assert(heartbeatsAt(simulator, *clock, *client, started + 2299ms) == 1);
+    assert(heartbeatsAt(simulator, *clock, *client, started + 2300ms) == 2);
+
+    simulator.stop();
+    std::cout << "Heartbeat elision tests passed!" << std::endl;
+}
+
+int main() {
+    std::cout << "Running Heartbeat Tests..." << std::endl;
+
+    testRestart();
+    testHeartbeatElision();
+
+    std::cout << "\nAll heartbeat tests passed!" << std::endl;
+    return 0;
+}
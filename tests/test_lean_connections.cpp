@@ -0,0 +1,107 @@
+#include "../net/mqtt/LeanConnections.hpp"
+#include <openssl/evp.h>
+#include <openssl/pem.h>
+#include <openssl/ssl.h>
+#include <openssl/x509.h>
+#include <iostream>
+#include <cassert>
+#include <cstdio>
+#include <filesystem>
+#include <string>
+
+using namespace tracker;
+
+namespace {
+    /// Self-signed root written as PEM, standing in for the configured root CA
+    std::string writeCaFile() {
+        EVP_PKEY* key = EVP_EC_gen("P-256");
+        X509* certificate = X509_new();
+        X509_set_version(certificate, 2);
+        ASN1_INTEGER_set(X509_get_serialNumber(certificate), 1);
+        X509_gmtime_adj(X509_getm_notBefore(certificate), 0);
+        X509_gmtime_adj(X509_getm_notAfter(certificate), 3600);
+        X509_set_pubkey(certificate, key);
+        X509_NAME* name = X509_get_subject_name(certificate);
+        X509_NAME_add_entry_by_txt(name, "CN", MBSTRING_ASC, reinterpret_cast<const unsigned char*>("Test Root"), -1, -1, 0);
+        X509_set_issuer_name(certificate, name);
+        X509_sign(certificate, key, EVP_sha256());
+
+        auto path = (std::filesystem::temp_directory_path() / "lean-connections-test-ca.pem").string();
+        FILE* file = std::fopen(path.c_str(), "w");
+        assert(file);
+        PEM_write_X509(file, certificate);
+        std::fclose(file);
+        X509_free(certificate);
+        EVP_PKEY_free(key);
+        return path;
+    }
+}
+
+void testContextsUnchangedUntilEnabled() {
+    std::cout << "Testing default TLS contexts..." << std::endl;
+
+    auto caFile = writeCaFile();
+    SSL_CTX* first = SSL_CTX_new(TLS_client_method());
+    SSL_CTX* second = SSL_CTX_new(TLS_client_method());
+    assert((SSL_CTX_get_mode(first) & SSL_MODE_RELEASE_BUFFERS) == 0);
+    int loaded = SSL_CTX_load_verify_locations(first, caFile.c_str(), nullptr);
+    loaded += SSL_CTX_load_verify_locations(second, caFile.c_str(), nullptr);
+    assert(loaded == 2);
+    assert(SSL_CTX_get_cert_store(first) != SSL_CTX_get_cert_store(second));
+    assert(LeanConnections::sharedTrustStores() == 0);
+    SSL_CTX_free(first);
+    SSL_CTX_free(second);
+
+    std::cout << "Default context tests passed!" << std::endl;
+}
+
+void testLeanContexts() {
+    std::cout << "Testing lean TLS contexts..." << std::endl;
+
+    auto caFile = writeCaFile();
+    auto status = LeanConnections::enable();
+    assert(status.tlsHooks && LeanConnections::enabled());
+
+    // What Paho does per connection
+    SSL_CTX* contexts[3];
+    for (auto& context : contexts) {
+        context = SSL_CTX_new(TLS_client_method());
+        assert(SSL_CTX_get_mode(context) & SSL_MODE_RELEASE_BUFFERS);
+        int loaded = SSL_CTX_load_verify_locations(context, caFile.c_str(), nullptr);
+        assert(loaded == 1);
+    }
+    X509_STORE* store = SSL_CTX_get_cert_store(contexts[0]);
+    assert(store == SSL_CTX_get_cert_store(contexts[1]) && store == SSL_CTX_get_cert_store(contexts[2]));
+    assert(sk_X509_OBJECT_num(X509_STORE_get0_objects(store)) == 1);
+    assert(LeanConnections::sharedTrustStores() == 1);
+
+    // The store outlives its contexts
+    for (auto* context : contexts) {
+        SSL_CTX_free(context);
+    }
+    SSL_CTX* later = SSL_CTX_new(TLS_client_method());
+    int loaded = SSL_CTX_load_verify_locations(later, caFile.c_str(), nullptr);
+    assert(loaded == 1 && SSL_CTX_get_cert_store(later) == store);
+
+    // Unreadable files take OpenSSL's own path and its error
+    loaded = SSL_CTX_load_verify_locations(later, "/nonexistent/ca.pem", nullptr);
+    assert(loaded == 0);
+    assert(LeanConnections::sharedTrustStores() == 1);
+    SSL_CTX_free(later);
+
+    assert(LeanConnections::residentBytes() > 0);
+    LeanConnections::releaseFreedMemory();
+    std::filesystem::remove(caFile);
+
+    std::cout << "Lean context tests passed!" << std::endl;
+}
+
+int main() {
+    std::cout << "Running Lean Connections Tests..." << std::endl;
+
+    testContextsUnchangedUntilEnabled();
+    testLeanContexts();
+
+    std::cout << "\nAll lean connections tests passed!" << std::endl;
+    return 0;
+}
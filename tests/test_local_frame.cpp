@@ -0,0 +1,104 @@
+#include "../core/LocalFrame.hpp"
+#include "../core/Geo.hpp"
+#include <iostream>
+#include <cassert>
+#include <cmath>
+
+using namespace tracker;
+
+namespace {
+    const double kOriginLat = -26.2041;   // Johannesburg
+    const double kOriginLon = 28.0473;
+}
+
+void testRoundTrip() {
+    std::cout << "Testing project/unproject round trip..." << std::endl;
+
+    LocalFrame frame(kOriginLat, kOriginLon);
+    EnuPoint origin = frame.project(kOriginLat, kOriginLon);
+    assert(origin.east == 0.0f && origin.north == 0.0f);
+
+    Location loc{-26.1500, 28.1000, 1700.0, 5.0};
+    Location back = frame.unproject(frame.project(loc), loc);
+    assert(std::abs(back.lat - loc.lat) < 1e-6);
+    assert(std::abs(back.lon - loc.lon) < 1e-6);
+    assert(back.alt == loc.alt && back.accuracy == loc.accuracy);
+
+    std::cout << "Round trip tests passed!" << std::endl;
+}
+
+void testDistanceErrorBound() {
+    std::cout << "Testing planar distance against haversine..." << std::endl;
+
+    LocalFrame frame(kOriginLat, kOriginLon);
+
+    // Pairs ~150 m apart, up to 50 km from the origin in every direction
+    double maxRelativeError = 0.0;
+    for (int bearing = 0; bearing < 360; bearing += 15) {
+        Location far = Geo::moveLocation({kOriginLat, kOriginLon, 0.0, 0.0}, bearing,
+                                         LocalFrame::kMaxRegionRadiusMeters);
+        Location near = Geo::moveLocation(far, bearing + 90.0, 150.0);
+
+        double reference = Geo::distanceMeters(far.lat, far.lon, near.lat, near.lon);
+        double planar = LocalFrame::distanceMeters(frame.project(far), frame.project(near));
+        maxRelativeError = std::max(maxRelativeError, std::abs(planar - reference) / reference);
+    }
+
+    // Documented bound: (r / R) * tan|lat0| plus float rounding
+    double bound = LocalFrame::kMaxRegionRadiusMeters / LocalFrame::kEarthRadiusMeters *
+                   std::tan(std::abs(kOriginLat) * M_PI / 180.0) + 1e-4;
+    std::cout << "Max relative error: " << maxRelativeError << " (bound " << bound << ")" << std::endl;
+    assert(maxRelativeError <= bound);
+
+    std::cout << "Distance error bound tests passed!" << std::endl;
+}
+
+void testFenceKernel() {
+    std::cout << "Testing batch fence containment..." << std::endl;
+
+    LocalFrame frame(kOriginLat, kOriginLon);
+    std::vector<Geofence> fences = {
+        {"near", -26.2041, 28.0473, 150.0},
+        {"far", -26.1076, 28.0567, 200.0}
+    };
+    EnuFence projected[2] = {frame.projectFence(fences[0]), frame.projectFence(fences[1])};
+
+    std::uint8_t inside[2] = {0, 0};
+    EnuPoint point = LocalFrame::move(EnuPoint{}, 45.0, 100.0);
+    LocalFrame::insideFences(point, projected, 2, inside);
+    assert(inside[0] == 1 && inside[1] == 0);
+
+    // Agreement with the haversine path
+    Location loc = frame.unproject(point);
+    auto ids = Geo::checkGeofences(loc, fences);
+    assert(ids.size() == 1 && ids[0] == "near");
+
+    std::cout << "Fence kernel tests passed!" << std::endl;
+}
+
+void testBatchAdvance() {
+    std::cout << "Testing batch movement kernel..." << std::endl;
+
+    float east[2] = {0.0f, 10.0f};
+    float north[2] = {0.0f, 10.0f};
+    const float speed[2] = {10.0f, 5.0f};
+    const float heading[2] = {0.0f, static_cast<float>(M_PI / 2.0)};
+    LocalFrame::advance(east, north, speed, heading, 2, 2.0f);
+
+    assert(std::abs(east[0]) < 1e-4f && std::abs(north[0] - 20.0f) < 1e-4f);
+    assert(std::abs(east[1] - 20.0f) < 1e-4f && std::abs(north[1] - 10.0f) < 1e-4f);
+
+    std::cout << "Batch movement tests passed!" << std::endl;
+}
+
+int main() {
+    std::cout << "Running LocalFrame tests..." << std::endl;
+
+    testRoundTrip();
+    testDistanceErrorBound();
+    testFenceKernel();
+    testBatchAdvance();
+
+    std::cout << "All tests passed!" << std::endl;
+    return 0;
+}
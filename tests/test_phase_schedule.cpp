@@ -0,0 +1,142 @@
+#include "../core/PhaseSchedule.hpp"
+#include <iostream>
+#include <cassert>
+#include <chrono>
+#include <string>
+#include <vector>
+
+using namespace tracker;
+using namespace std::chrono_literals;
+
+namespace {
+    using Clock = PeriodicDeadline::Clock;
+
+    /// Always returns the same draw so jittered deadlines are predictable
+    class FixedRng : public IRng {
+    public:
+        explicit FixedRng(double value) : value_(value) {}
+        double uniform(double min, double max) override { return min + (max - min) * value_; }
+        int uniformInt(int min, int) override { return min; }
+        double normal(double mean, double) override { return mean; }
+
+    private:
+        double value_;
+    };
+
+    std::vector<std::string> deviceIds(std::size_t count) {
+        std::vector<std::string> ids;
+        for (std::size_t i = 0; i < count; ++i) {
+            ids.push_back("SIM-" + std::to_string(i));
+        }
+        return ids;
+    }
+}
+
+void testPhaseOffsets() {
+    std::cout << "Testing phase offsets..." << std::endl;
+
+    // Stable per device, different per activity, always inside the period
+    auto offset = PhaseSchedule::phaseOffset("SIM-001", PeriodicActivity::Heartbeat, 60000ms);
+    assert(offset == PhaseSchedule::phaseOffset("SIM-001", PeriodicActivity::Heartbeat, 60000ms));
+    assert(offset != PhaseSchedule::phaseOffset("SIM-001", PeriodicActivity::TwinRefresh, 60000ms));
+    for (const auto& id : deviceIds(1000)) {
+        auto phase = PhaseSchedule::phaseOffset(id, PeriodicActivity::Heartbeat, 60000ms);
+        assert(phase >= 0ms && phase < 60000ms);
+    }
+    assert(PhaseSchedule::phaseOffset("SIM-001", PeriodicActivity::Heartbeat, 0ms) == 0ms);
+
+    // Spread periods never exceed the nominal one and never reach zero
+    for (const auto& id : deviceIds(100)) {
+        auto period = PhaseSchedule::spreadPeriod(id, PeriodicActivity::KeepAlive, 60s, 0.1);
+        assert(period <= 60s && period >= 54s);
+    }
+    assert(PhaseSchedule::spreadPeriod("SIM-001", PeriodicActivity::KeepAlive, 1s, 1.0) == 1s);
+
+    std::cout << "Phase offset tests passed!" << std::endl;
+}
+
+void testDeadline() {
+    std::cout << "Testing periodic deadline..." << std::endl;
+
+    Clock::time_point t0{};
+    PeriodicDeadline deadline;
+    assert(!deadline.due(t0 + 1000s));
+
+    deadline.arm(t0, 10s, 3s);
+    assert(deadline.isArmed() && !deadline.due(t0 + 2s) && deadline.due(t0 + 3s));
+
+    // Advances stay on the phase grid; slots missed entirely are skipped
+    deadline.advance(t0 + 3s, nullptr, 0.0);
+    assert(deadline.deadline() == t0 + 13s);
+    deadline.advance(t0 + 47s, nullptr, 0.0);
+    assert(deadline.deadline() == t0 + 53s);
+
+    // Jitter trails the slot without moving the grid
+    FixedRng half(0.5);
+    deadline.advance(t0 + 53s, &half, 0.2);
+    assert(deadline.deadline() == t0 + 64s);
+    deadline.advance(t0 + 64s, nullptr, 0.0);
+    assert(deadline.deadline() == t0 + 73s);
+
+    // A new period keeps the slot
+    deadline.setPeriod(5s);
+    deadline.advance(t0 + 73s, nullptr, 0.0);
+    assert(deadline.deadline() == t0 + 78s);
+
+    // A non-positive period disarms instead of dividing by zero on the next advance
+    deadline.setPeriod(0s);
+    assert(!deadline.isArmed() && !deadline.due(t0 + 1000s));
+    deadline.advance(t0 + 1000s, nullptr, 0.0);
+    deadline.restart(t0 + 1000s, nullptr, 0.0);
+    assert(!deadline.isArmed());
+    deadline.arm(t0, -5s, 0s);
+    assert(!deadline.isArmed());
+
+    std::cout << "Periodic deadline tests passed!" << std::endl;
+}
+
+void testAnalyzer() {
+    std::cout << "Testing phase analyzer..." << std::endl;
+
+    auto ids = deviceIds(1000);
+    std::vector<PhaseAnalyzer::Activity> heartbeat{{PeriodicActivity::Heartbeat, 60s}};
+    PhaseAnalyzer::Options options;
+
+    // Lock-step start: every device fires in the same second
+    options.phaseSpreading = false;
+    auto lockstep = PhaseAnalyzer::analyze(ids, heartbeat, options);
+    assert(lockstep.deviceCount == 1000);
+    assert(lockstep.totalMessages == 1000 * 60);
+    assert(lockstep.peakPerSecond == 1000.0);
+    assert(lockstep.peakToAverage > 59.9 && lockstep.peakToAverage < 60.1);
+
+    // Same traffic, spread over the period
+    options.phaseSpreading = true;
+    auto spread = PhaseAnalyzer::analyze(ids, heartbeat, options);
+    assert(spread.totalMessages == lockstep.totalMessages);
+    assert(spread.averagePerSecond == lockstep.averagePerSecond);
+    assert(spread.peakToAverage < 3.0);
+
+    // Jitter over several buckets flattens the lock-step burst
+    options.phaseSpreading = false;
+    options.jitterFraction = 0.5;
+    auto jittered = PhaseAnalyzer::analyze(ids, heartbeat, options);
+    assert(jittered.peakPerSecond < 40.0);
+
+    // Nothing to model
+    assert(PhaseAnalyzer::analyze({}, heartbeat, options).totalMessages == 0);
+    assert(PhaseAnalyzer::analyze(ids, {{PeriodicActivity::Heartbeat, 0s}}, options).totalMessages == 0);
+
+    std::cout << "Phase analyzer tests passed!" << std::endl;
+}
+
+int main() {
+    std::cout << "Running Phase Schedule Tests..." << std::endl;
+
+    testPhaseOffsets();
+    testDeadline();
+    testAnalyzer();
+
+    std::cout << "\nAll phase schedule tests passed!" << std::endl;
+    return 0;
+}
@@ -2,6 +2,7 @@
 #include <iostream>
 #include <cassert>
 #include <cstring>
+#include <vector>
 
 using namespace tracker;
 
@@ -73,6 +74,43 @@ void testSasTokenConfig() {
     std::cout << "SAS token config tests passed!" << std::endl;
 }
 
+void testDeviceKeyDerivation() {
+    std::cout << "Testing group enrollment key derivation..." << std::endl;
+    
+    std::string groupKey = "dGVzdGtleQ=="; // "testkey" in base64
+    
+    // Base64(HMAC-SHA256(groupKey, registrationId))
+    assert(SasToken::deriveDeviceKey(groupKey, "123456789101112") ==
+           "O8zQwGGWrkbizROKFgDkhEmX+c46wOoKoL7UassyN0w=");
+    
+    // Bulk derivation reuses one keyed context and must match one-by-one results
+    std::vector<std::string> ids = {"sim-0001", "123456789101112", "sim-0001", ""};
+    auto keys = SasToken::deriveDeviceKeys(groupKey, ids);
+    assert(keys.size() == ids.size());
+    assert(keys[0] == "vyMcUDwefXqfQ72Yx7j9/r3fahrUeBEWVB4zA5nMGA0=");
+    assert(keys[1] == "O8zQwGGWrkbizROKFgDkhEmX+c46wOoKoL7UassyN0w=");
+    assert(keys[2] == keys[0]);
+    assert(keys[3] == SasToken::deriveDeviceKey(groupKey, ""));
+    
+    // An undecodable group key yields no keys
+    assert(SasToken::deriveDeviceKeys("", ids).empty());
+    
+    std::cout << "Key derivation tests passed!" << std::endl;
+}
+
+void testDpsToken() {
+    std::cout << "Testing DPS registration token..." << std::endl;
+    
+    std::string deviceKey = SasToken::deriveDeviceKey("dGVzdGtleQ==", "123456789101112");
+    std::string token = SasToken::generateDps("0ne00000000", "123456789101112", deviceKey, 1234567890);
+    
+    assert(token == "SharedAccessSignature sr=0ne00000000%2Fregistrations%2F123456789101112"
+                    "&sig=jLtpfJWmN5Lr0uHUEJ0iuAoDM4%2FGKOuUQhCLkCAN2HI%3D"
+                    "&se=1234567890&skn=registration");
+    
+    std::cout << "DPS token tests passed!" << std::endl;
+}
+
 int main() {
     std::cout << "Running SAS Token Tests..." << std::endl;
     
@@ -81,6 +119,8 @@ int main() {
         testBase64();
         testSasTokenGeneration();
         testSasTokenConfig();
+        testDeviceKeyDerivation();
+        testDpsToken();
         
         std::cout << "\nAll tests passed successfully!" << std::endl;
         return 0;
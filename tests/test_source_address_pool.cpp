@@ -0,0 +1,152 @@
+#include "../net/mqtt/SourceAddressPool.hpp"
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <iostream>
+#include <cassert>
+#include <string>
+#include <vector>
+
+using namespace tracker;
+
+namespace {
+    /// Loopback listener on 127.0.0.1; returns its port
+    int listenOnLoopback(std::uint16_t& port) {
+        int listener = socket(AF_INET, SOCK_STREAM, 0);
+        sockaddr_in address{};
+        address.sin_family = AF_INET;
+        address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        socklen_t length = sizeof(address);
+        int rc = bind(listener, reinterpret_cast<sockaddr*>(&address), sizeof(address));
+        rc |= listen(listener, 64);
+        rc |= getsockname(listener, reinterpret_cast<sockaddr*>(&address), &length);
+        assert(rc == 0);
+        port = ntohs(address.sin_port);
+        return listener;
+    }
+
+    /// Connect like Paho does (plain socket + connect) and return the chosen source address
+    int connectTo(std::uint16_t port, std::string& source) {
+        int fd = socket(AF_INET, SOCK_STREAM, 0);
+        sockaddr_in address{};
+        address.sin_family = AF_INET;
+        address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        address.sin_port = htons(port);
+        int rc = connect(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address));
+
+        sockaddr_in local{};
+        socklen_t length = sizeof(local);
+        rc |= getsockname(fd, reinterpret_cast<sockaddr*>(&local), &length);
+        assert(rc == 0 && local.sin_port != 0);
+        char text[INET_ADDRSTRLEN] = {};
+        inet_ntop(AF_INET, &local.sin_addr, text, sizeof(text));
+        source = text;
+        return fd;
+    }
+}
+
+void testRejectsBadEntries() {
+    std::cout << "Testing invalid source addresses..." << std::endl;
+
+    std::string error;
+    bool ok = SourceAddressPool::configure({}, error);
+    assert(!ok);
+    ok = SourceAddressPool::configure({"127.0.0.2", "no-such-if0"}, error);
+    assert(!ok && error.find("no-such-if0") != std::string::npos);
+    // TEST-NET-3 is never assigned to a local interface
+    ok = SourceAddressPool::configure({"203.0.113.77"}, error);
+    assert(!ok && error.find("203.0.113.77") != std::string::npos);
+    assert(!SourceAddressPool::active());
+
+    std::cout << "Invalid source address tests passed!" << std::endl;
+}
+
+void testRoundRobinAndCounts() {
+    std::cout << "Testing per-destination round-robin binding..." << std::endl;
+
+    std::uint16_t port = 0;
+    int listener = listenOnLoopback(port);
+
+    // Every 127/8 address is local on Linux; "lo" resolves to 127.0.0.1
+    std::string error;
+    bool ok = SourceAddressPool::configure({"127.0.0.2", "127.0.0.3", "lo"}, error);
+    assert(ok && SourceAddressPool::active());
+    ok = SourceAddressPool::configure({"127.0.0.4"}, error);
+    assert(!ok);
+
+    // A second endpoint, connected in between, keeps its own rotation
+    std::uint16_t otherPort = 0;
+    int otherListener = listenOnLoopback(otherPort);
+
+    std::vector<int> sockets;
+    std::vector<std::string> sources;
+    std::vector<int> otherSockets;
+    std::vector<std::string> otherSources;
+    for (int i = 0; i < 9; ++i) {
+        std::string source;
+        sockets.push_back(connectTo(port, source));
+        sources.push_back(source);
+        if (i % 3 == 0) {
+            otherSockets.push_back(connectTo(otherPort, source));
+            otherSources.push_back(source);
+        }
+    }
+    const char* expected[] = {"127.0.0.2", "127.0.0.3", "127.0.0.1"};
+    for (std::size_t i = 0; i < sources.size(); ++i) {
+        assert(sources[i] == expected[i % 3]);
+    }
+    for (std::size_t i = 0; i < otherSources.size(); ++i) {
+        assert(otherSources[i] == expected[i % 3]);
+    }
+
+    // A socket bound by its owner keeps its address
+    int own = socket(AF_INET, SOCK_STREAM, 0);
+    sockaddr_in address{};
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(0x7f000009);
+    int rc = bind(own, reinterpret_cast<sockaddr*>(&address), sizeof(address));
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    address.sin_port = htons(port);
+    rc |= connect(own, reinterpret_cast<sockaddr*>(&address), sizeof(address));
+    assert(rc == 0);
+
+    auto counts = SourceAddressPool::counts();
+    assert(counts.size() == 3);
+    assert(counts[2].address == "127.0.0.1 (lo)");
+    for (const auto& count : counts) {
+        assert(count.open == 4 && count.total == 4 && count.failures == 0);
+    }
+    for (int fd : otherSockets) {
+        close(fd);
+    }
+    close(otherListener);
+
+    // Closed sockets drop out of the open count, totals stay
+    close(sockets[0]);
+    close(sockets[3]);
+    close(sockets[4]);
+    counts = SourceAddressPool::counts();
+    assert(counts[0].open == 1 && counts[1].open == 2 && counts[2].open == 3);
+    assert(counts[0].total == 4);
+
+    for (std::size_t i = 0; i < sockets.size(); ++i) {
+        if (i != 0 && i != 3 && i != 4) close(sockets[i]);
+    }
+    close(own);
+    close(listener);
+    assert(SourceAddressPool::counts()[1].open == 0);
+    assert(SourceAddressPool::portsPerAddress() > 0);
+
+    std::cout << "Round-robin binding tests passed!" << std::endl;
+}
+
+int main() {
+    std::cout << "Running Source Address Pool Tests..." << std::endl;
+
+    testRejectsBadEntries();
+    testRoundRobinAndCounts();
+
+    std::cout << "\nAll source address pool tests passed!" << std::endl;
+    return 0;
+}
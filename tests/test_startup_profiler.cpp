@@ -0,0 +1,183 @@
+#include "../core/StartupProfiler.hpp"
+#include <nlohmann/json.hpp>
+#include <iostream>
+#include <sstream>
+#include <cassert>
+
+using namespace tracker;
+
+namespace {
+    /// Client that only records the ack callback so tests can fire acknowledgements
+    class AckClient : public IMqttClient {
+    public:
+        bool connect(const std::string&, std::uint16_t, const std::string&,
+                     const std::string&, const std::string&) override { return true; }
+        bool connectWithTls(const std::string&, std::uint16_t, const std::string&,
+                            const std::string&, const TlsConfig&) override { return true; }
+        void disconnect() override {}
+        bool isConnected() const override { return true; }
+        bool publish(const std::string&, const std::string&, int, bool) override { return true; }
+        bool subscribe(const std::string&, int) override { return true; }
+        bool unsubscribe(const std::string&) override { return true; }
+        void setMessageCallback(MessageCallback) override {}
+        void setConnectionCallback(ConnectionCallback) override {}
+        void setAckCallback(AckCallback callback) override { ack = std::move(callback); }
+        void processEvents() override {}
+
+        AckCallback ack;
+    };
+
+    void stamp(StartupTimeline& timeline, StartupPhase phase, std::int64_t beginUs, std::int64_t endUs) {
+        timeline.begin(phase, beginUs);
+        timeline.end(phase, endUs);
+    }
+
+    /// DPS device: slow assignment, twin GET racing the subscription, late first heartbeat
+    void stampDpsDevice(StartupTimeline& timeline) {
+        timeline.end(StartupPhase::Config, 1000);
+        stamp(timeline, StartupPhase::Credentials, 5000, 5200);
+        stamp(timeline, StartupPhase::DpsConnect, 5200, 80000);
+        stamp(timeline, StartupPhase::Register, 80000, 120000);
+        stamp(timeline, StartupPhase::PollWait, 120000, 2120000);
+        stamp(timeline, StartupPhase::HubConnect, 2120000, 2200000);
+        stamp(timeline, StartupPhase::Subscribe, 2200000, 2230000);
+        stamp(timeline, StartupPhase::TwinGet, 2201000, 2260000);
+        stamp(timeline, StartupPhase::FirstPuback, 2500000, 2540000);
+    }
+}
+
+void testFirstStampWins() {
+    std::cout << "Testing phase stamping..." << std::endl;
+
+    StartupProfiler profiler;
+    auto* timeline = profiler.addDevice("SIM-001");
+    assert(timeline->beginUs(StartupPhase::Config) == 0);
+    assert(!timeline->completed(StartupPhase::Config));
+
+    // An end without a begin is ignored (e.g. a PUBACK for a queued message)
+    timeline->end(StartupPhase::FirstPuback, 50);
+    assert(timeline->endUs(StartupPhase::FirstPuback) == -1);
+
+    // Retries extend the phase they happen in instead of restarting it
+    timeline->begin(StartupPhase::HubConnect, 100);
+    timeline->begin(StartupPhase::HubConnect, 300);
+    timeline->end(StartupPhase::HubConnect, 400);
+    timeline->end(StartupPhase::HubConnect, 900);
+    assert(timeline->beginUs(StartupPhase::HubConnect) == 100);
+    assert(timeline->endUs(StartupPhase::HubConnect) == 400);
+
+    // Live stamps are relative to the profiler epoch
+    timeline->transition(StartupPhase::Config, StartupPhase::Credentials);
+    assert(timeline->completed(StartupPhase::Config));
+    assert(timeline->beginUs(StartupPhase::Credentials) == timeline->endUs(StartupPhase::Config));
+    assert(timeline->nowUs() >= timeline->endUs(StartupPhase::Config));
+
+    std::cout << "Phase stamping tests passed!" << std::endl;
+}
+
+void testAcknowledgementsEndPhases() {
+    std::cout << "Testing acknowledgement tracking..." << std::endl;
+
+    StartupProfiler profiler;
+    auto* timeline = profiler.addDevice("SIM-001");
+    AckClient client;
+    timeline->watch(client);
+    assert(client.ack);
+
+    timeline->begin(StartupPhase::Subscribe, 10);
+    timeline->begin(StartupPhase::FirstPuback, 20);
+    client.ack(IMqttClient::Ack::Subscribe, 1, false);
+    assert(!timeline->completed(StartupPhase::Subscribe));
+    client.ack(IMqttClient::Ack::Subscribe, 1, true);
+    assert(timeline->completed(StartupPhase::Subscribe));
+
+    // QoS 0 send completions (twin GET) are not PUBACKs
+    client.ack(IMqttClient::Ack::Publish, 0, true);
+    assert(!timeline->completed(StartupPhase::FirstPuback));
+    assert(!profiler.finished());
+    client.ack(IMqttClient::Ack::Publish, 1, true);
+    assert(timeline->completed(StartupPhase::FirstPuback));
+    assert(profiler.finished());
+
+    std::cout << "Acknowledgement tracking tests passed!" << std::endl;
+}
+
+void testCriticalPath() {
+    std::cout << "Testing critical path..." << std::endl;
+
+    StartupProfiler profiler;
+    stampDpsDevice(*profiler.addDevice("SIM-001"));
+
+    auto path = profiler.criticalPath(0);
+    const char* expected[] = {"config", "waiting", "credentials", "dps_connect", "register", "poll_wait",
+                              "hub_connect", "waiting", "twin_get", "waiting", "first_puback"};
+    assert(path.size() == std::size(expected));
+    std::int64_t total = 0;
+    std::int64_t cursor = 0;
+    for (std::size_t i = 0; i < path.size(); ++i) {
+        const char* name = path[i].wait ? "waiting" : StartupProfiler::phaseName(path[i].phase);
+        assert(std::string(name) == expected[i]);
+        assert(path[i].startUs == cursor);   // Steps tile the timeline without gaps or overlap
+        cursor += path[i].durationUs;
+        total += path[i].durationUs;
+    }
+    assert(total == 2540000);
+    assert(path[9].durationUs == 240000);   // Subscribed and twin done, first heartbeat not yet due
+
+    std::cout << "Critical path tests passed!" << std::endl;
+}
+
+void testSummaryAndExport() {
+    std::cout << "Testing summary and JSON export..." << std::endl;
+
+    StartupProfiler profiler;
+    stampDpsDevice(*profiler.addDevice("SIM-001"));
+    auto* stalled = profiler.addDevice("SIM-002");
+    stalled->end(StartupPhase::Config, 1500);
+    stamp(*stalled, StartupPhase::Credentials, 6000, 6100);
+    stalled->begin(StartupPhase::HubConnect, 6100);
+
+    assert(!profiler.finished());
+    auto summary = profiler.summarize();
+    assert(summary.devices == 2);
+    assert(summary.completed == 1);
+    assert(summary.phases[static_cast<std::size_t>(StartupPhase::Config)].count == 2);
+    assert(summary.phases[static_cast<std::size_t>(StartupPhase::HubConnect)].count == 1);
+    assert(summary.timeToFirstTelemetry.count == 1);
+    assert(summary.slowest == 0);
+    assert(summary.criticalTotalUs == 2540000);
+    assert(summary.criticalUs[static_cast<std::size_t>(StartupPhase::PollWait)] == 2000000);
+    assert(summary.criticalUs[static_cast<std::size_t>(StartupPhase::Subscribe)] == 0);   // Off the critical path
+    assert(summary.criticalWaitUs == 4000 + 1000 + 240000);
+
+    auto json = nlohmann::json::parse(profiler.toJson());
+    assert(json["devices"] == 2 && json["completed"] == 1);
+    assert(json["phases"]["poll_wait"]["count"] == 1);
+    assert(json["phases"]["poll_wait"]["criticalShare"].get<double>() > 0.78);
+    assert(json["criticalPath"]["slowestDevice"] == "SIM-001");
+    assert(json["criticalPath"]["slowestPath"].size() == 11);
+    assert(json["perDevice"][0]["ttftMs"] == 2540.0);
+    assert(!json["perDevice"][1].contains("ttftMs"));
+    assert(json["perDevice"][1]["phases"]["hub_connect"].contains("beginMs"));
+    assert(!json["perDevice"][1]["phases"]["hub_connect"].contains("endMs"));
+    assert(!json["perDevice"][1]["phases"].contains("dps_connect"));
+
+    std::ostringstream report;
+    profiler.print(report);
+    assert(report.str().find("1/2 devices") != std::string::npos);
+    assert(report.str().find("Slowest device SIM-001") != std::string::npos);
+
+    std::cout << "Summary and JSON export tests passed!" << std::endl;
+}
+
+int main() {
+    std::cout << "Running Startup Profiler Tests..." << std::endl;
+
+    testFirstStampWins();
+    testAcknowledgementsEndPhases();
+    testCriticalPath();
+    testSummaryAndExport();
+
+    std::cout << "\nAll startup profiler tests passed!" << std::endl;
+    return 0;
+}
@@ -0,0 +1,123 @@
+#include "../core/Stats.hpp"
+#include <iostream>
+#include <cassert>
+#include <bit>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+using namespace tracker;
+
+void testLatencyBuckets() {
+    std::cout << "Testing latency buckets..." << std::endl;
+
+    // Exact below 4 us, then four buckets per power of two
+    for (uint64_t us = 0; us < 8; ++us) {
+        assert(Stats::latencyBucket(us) == us);
+    }
+    assert(Stats::latencyBucket(8) == 8 && Stats::latencyBucket(9) == 8);
+    assert(Stats::latencyBucket(10) == 9 && Stats::latencyBucket(15) == 11);
+    assert(Stats::latencyBucket(16) == 12 && Stats::latencyBucket(1000) == 35);
+
+    // Buckets tile the range: each upper bound maps to its bucket, the next value to the next one
+    uint64_t lower = 0;
+    for (std::size_t bucket = 0; bucket < Stats::kLatencyBuckets; ++bucket) {
+        uint64_t upper = Stats::latencyBucketUpperUs(bucket);
+        assert(upper >= lower);
+        assert(Stats::latencyBucket(lower) == bucket && Stats::latencyBucket(upper) == bucket);
+        if (bucket >= 4) {
+            assert((upper - lower + 1) * 4 == std::bit_floor(lower));   // A quarter of its power of two
+        }
+        lower = upper + 1;
+    }
+
+    // About 33 s in the last bucket; anything slower lands there too
+    uint64_t last = Stats::latencyBucketUpperUs(Stats::kLatencyBuckets - 1);
+    assert(last == (uint64_t{1} << 25) - 1);
+    assert(Stats::latencyBucket(last + 1) == Stats::kLatencyBuckets - 1);
+    assert(Stats::latencyBucket(UINT64_MAX) == Stats::kLatencyBuckets - 1);
+
+    std::cout << "Latency bucket tests passed!" << std::endl;
+}
+
+void testPercentiles() {
+    std::cout << "Testing latency percentiles..." << std::endl;
+
+    Stats::Snapshot snapshot;
+    assert(snapshot.latencyPercentileUs(50.0) == 0);
+
+    // 90 fast samples and 10 slow ones
+    snapshot.pubackLatency[Stats::latencyBucket(100)] = 90;
+    snapshot.pubackLatency[Stats::latencyBucket(20000)] = 10;
+    assert(snapshot.latencyPercentileUs(50.0) == Stats::latencyBucketUpperUs(Stats::latencyBucket(100)));
+    assert(snapshot.latencyPercentileUs(90.0) == Stats::latencyBucketUpperUs(Stats::latencyBucket(100)));
+    assert(snapshot.latencyPercentileUs(95.0) == Stats::latencyBucketUpperUs(Stats::latencyBucket(20000)));
+    assert(snapshot.latencyPercentileUs(100.0) == Stats::latencyBucketUpperUs(Stats::latencyBucket(20000)));
+
+    std::cout << "Latency percentile tests passed!" << std::endl;
+}
+
+void testShardedCounters() {
+    std::cout << "Testing per-thread counters..." << std::endl;
+
+    Stats& stats = Stats::instance();
+    auto before = stats.snapshot();
+
+    // Each thread records into its own shard; the snapshot sums them
+    const int threads = 8;
+    const int perThread = 20000;
+    std::vector<std::thread> workers;
+    for (int t = 0; t < threads; ++t) {
+        workers.emplace_back([&stats, t] {
+            for (int i = 0; i < perThread; ++i) {
+                stats.recordEvent(i % 2 == 0 ? EventType::Heartbeat : EventType::GeofenceEnter);
+                stats.recordPublishOk(static_cast<uint64_t>(t) * 1000 + 1);
+                if (i % 10 == 0) {
+                    stats.recordPublishFailed();
+                }
+                stats.recordTick(3);
+            }
+            stats.recordPublishQueued();
+        });
+    }
+    for (auto& worker : workers) {
+        worker.join();
+    }
+
+    auto delta = stats.snapshot().since(before);
+    const uint64_t total = static_cast<uint64_t>(threads) * perThread;
+    assert(delta.totalEvents() == total);
+    assert(delta.events[static_cast<std::size_t>(EventType::Heartbeat)] == total / 2);
+    assert(delta.events[static_cast<std::size_t>(EventType::GeofenceEnter)] == total / 2);
+    assert(delta.publishOk == total);
+    assert(delta.publishFailed == total / 10);
+    assert(delta.publishQueued == static_cast<uint64_t>(threads));
+    assert(delta.ticks == total && delta.tickNanos == total * 3);
+
+    // Every thread's latencies landed in its own bucket
+    uint64_t samples = 0;
+    for (auto count : delta.pubackLatency) {
+        samples += count;
+    }
+    assert(samples == total);
+    for (int t = 0; t < threads; ++t) {
+        assert(delta.pubackLatency[Stats::latencyBucket(static_cast<uint64_t>(t) * 1000 + 1)] == perThread);
+    }
+
+    // Shards outlive their threads: totals never go backwards
+    auto after = stats.snapshot().since(before);
+    assert(after.totalEvents() == total && after.publishOk == total);
+
+    std::cout << "Per-thread counter tests passed!" << std::endl;
+}
+
+int main() {
+    std::cout << "Running Stats Tests..." << std::endl;
+
+    testLatencyBuckets();
+    testPercentiles();
+    testShardedCounters();
+
+    std::cout << "\nAll stats tests passed!" << std::endl;
+    return 0;
+}
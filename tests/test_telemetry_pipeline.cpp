@@ -0,0 +1,361 @@
+#include "../core/domain/TelemetryPipeline.hpp"
+#include "../core/domain/EventBus.hpp"
+#include "../core/adapters/DefaultPolicies.hpp"
+#include "../core/sim/MockTransport.hpp"
+#include "../core/LatencyConsumer.hpp"
+#include <nlohmann/json.hpp>
+#include <iostream>
+#include <cassert>
+#include <algorithm>
+#include <thread>
+
+using namespace tracker;
+using namespace tracker::domain;
+
+namespace {
+    struct Harness {
+        std::shared_ptr<sim::MockTransport> transport = std::make_shared<sim::MockTransport>();
+        std::shared_ptr<EventBus> bus = std::make_shared<EventBus>();
+        std::shared_ptr<adapters::DefaultPolicyEngine> policies = std::make_shared<adapters::DefaultPolicyEngine>();
+
+        Harness() { transport->setConnected(true); }
+
+        void publishEvents(int count) {
+            for (int i = 0; i < count; ++i) {
+                Event event;
+                event.eventType = EventType::GeofenceEnter;
+                event.deviceId = "SIM-001";
+                event.sequence = static_cast<uint64_t>(i);
+                bus->publish(event);
+            }
+            bus->processEvents();
+        }
+    };
+
+    uint64_t sequenceOf(const std::string& payload) {
+        return nlohmann::json::parse(payload).at("seq").get<uint64_t>();
+    }
+
+    /// Default policies with one-second heartbeats
+    class FastHeartbeatPolicies : public ports::IPolicyEngine {
+    public:
+        const ports::RetryPolicy& getRetryPolicy() const override { return retry_; }
+        const ports::ReportingPolicy& getReportingPolicy() const override { return reporting_; }
+        const ports::PowerPolicy& getPowerPolicy() const override { return power_; }
+
+    private:
+        adapters::ExponentialBackoffRetryPolicy retry_;
+        adapters::AdaptiveReportingPolicy reporting_{std::chrono::seconds(1), std::chrono::seconds(1)};
+        adapters::ConservativePowerPolicy power_;
+    };
+
+    std::size_t heartbeatsIn(const std::vector<sim::MockMessage>& sent) {
+        return static_cast<std::size_t>(std::count_if(sent.begin(), sent.end(), [](const auto& message) {
+            return nlohmann::json::parse(message.payload).at("eventType") == "heartbeat";
+        }));
+    }
+
+    /// Pump bus and pipeline for a while, publishing an event every `every` (0 = none)
+    void runFor(Harness& h, TelemetryPipeline& pipeline, std::chrono::milliseconds duration,
+                std::chrono::milliseconds every) {
+        auto started = std::chrono::steady_clock::now();
+        auto nextEvent = started;
+        while (std::chrono::steady_clock::now() - started < duration) {
+            if (every.count() > 0 && std::chrono::steady_clock::now() >= nextEvent) {
+                Event event;
+                event.eventType = EventType::GeofenceEnter;
+                event.deviceId = "SIM-001";
+                event.battery.percentage = 77.0;
+                event.network.rssi = -88;
+                h.bus->publish(event);
+                nextEvent += every;
+            }
+            h.bus->processEvents();
+            pipeline.processEvents();
+            std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        }
+    }
+}
+
+void testInlineStages() {
+    std::cout << "Testing inline pipeline..." << std::endl;
+
+    Harness h;
+    TelemetryPipeline pipeline(h.transport, h.bus, h.policies);
+    pipeline.start("SIM-001");
+
+    h.publishEvents(100);
+    pipeline.processEvents();
+
+    const auto& sent = h.transport->getPublishedMessages();
+    assert(sent.size() == 100);
+    assert(sent.front().topic == "devices/SIM-001/messages/events/");
+    for (std::size_t i = 0; i < sent.size(); ++i) {
+        assert(sequenceOf(sent[i].payload) == i);
+    }
+
+    auto encode = pipeline.metrics(PipelineStage::Encode);
+    assert(encode.processed == 100);
+    assert(encode.queueDepth == 0);
+    assert(encode.busyNs > 0);
+
+    pipeline.stop();
+    std::cout << "Inline pipeline tests passed!" << std::endl;
+}
+
+void testThreadedStagesKeepOrder() {
+    std::cout << "Testing threaded pipeline with backpressure..." << std::endl;
+
+    Harness h;
+    PipelineOptions options;
+    options.ringCapacity = 16;  // Small rings force the bus to wait on the stages
+    for (auto stage : {PipelineStage::Filter, PipelineStage::Encode, PipelineStage::Batch, PipelineStage::Publish}) {
+        options.setThreaded(stage);
+    }
+    TelemetryPipeline pipeline(h.transport, h.bus, h.policies, options);
+    pipeline.start("SIM-001");
+
+    const int count = 5000;
+    h.publishEvents(count);
+    while (pipeline.metrics(PipelineStage::Publish).processed < static_cast<uint64_t>(count)) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    pipeline.stop();
+
+    // Transport is only read once the publish thread has been joined
+    const auto& sent = h.transport->getPublishedMessages();
+    assert(sent.size() == static_cast<std::size_t>(count));
+    for (std::size_t i = 0; i < sent.size(); ++i) {
+        assert(sequenceOf(sent[i].payload) == i);
+    }
+    assert(pipeline.metrics(PipelineStage::Filter).queueCapacity == 16);
+
+    std::cout << "Threaded pipeline tests passed!" << std::endl;
+}
+
+void testBatchingAndCompression() {
+    std::cout << "Testing batch stage..." << std::endl;
+
+    Harness h;
+    PipelineOptions options;
+    options.maxBatchMessages = 10;
+    int compressed = 0;
+    options.compress = [&compressed](std::string&& payload) {
+        ++compressed;
+        return std::move(payload);
+    };
+    TelemetryPipeline pipeline(h.transport, h.bus, h.policies, options);
+    pipeline.start("SIM-001");
+
+    h.publishEvents(25);
+    pipeline.processEvents();
+
+    // 10 + 10, and the idle remainder of 5 flushes without a delay configured
+    const auto& sent = h.transport->getPublishedMessages();
+    assert(sent.size() == 3);
+    assert(compressed == 3);
+    uint64_t expected = 0;
+    for (const auto& message : sent) {
+        auto batch = nlohmann::json::parse(message.payload);
+        assert(batch.is_array());
+        for (const auto& event : batch) {
+            assert(event.at("seq").get<uint64_t>() == expected++);
+        }
+    }
+    assert(expected == 25);
+
+    pipeline.stop();
+    std::cout << "Batch stage tests passed!" << std::endl;
+}
+
+void testOfflineRetry() {
+    std::cout << "Testing retry queue while offline..." << std::endl;
+
+    Harness h;
+    TelemetryPipeline pipeline(h.transport, h.bus, h.policies);
+    pipeline.start("SIM-001");
+
+    h.transport->setConnected(false);
+    h.publishEvents(3);
+    pipeline.processEvents();
+    assert(h.transport->getPublishedMessages().empty());
+    assert(pipeline.retryQueueSize() == 3);
+
+    h.transport->setConnected(true);
+    pipeline.processEvents();
+    assert(h.transport->getPublishedMessages().size() == 3);
+    assert(pipeline.retryQueueSize() == 0);
+
+    pipeline.stop();
+    std::cout << "Retry queue tests passed!" << std::endl;
+}
+
+void testEndToEndLatencyTrace() {
+    std::cout << "Testing end-to-end latency trace..." << std::endl;
+
+    Harness h;
+    PipelineOptions options;
+    options.maxBatchMessages = 5;
+    options.traceRunId = "run-1";
+    TelemetryPipeline pipeline(h.transport, h.bus, h.policies, options);
+
+    // Broker stand-in delivers each accepted publish to the consumer
+    LatencyConsumer consumer("run-1");
+    h.transport->setPublishObserver([&consumer](std::string_view topic, std::string_view payload) {
+        consumer.onMessage(topic, payload);
+    });
+    pipeline.start("SIM-001");
+
+    // One full batch waits offline in the retry queue
+    h.transport->setConnected(false);
+    h.publishEvents(5);
+    pipeline.processEvents();
+    assert(consumer.messages() == 0);
+    std::this_thread::sleep_for(std::chrono::milliseconds(5));
+
+    h.transport->setConnected(true);
+    pipeline.processEvents();
+
+    const auto& sent = h.transport->getPublishedMessages();
+    assert(sent.size() == 1);
+    assert(sent[0].topic.rfind("devices/SIM-001/messages/events/lt.f=", 0) == 0);
+    auto first = nlohmann::json::parse(sent[0].payload).at(0).at("trace");
+    assert(first.at("run") == "run-1");
+    assert(first.at("gen").get<int64_t>() <= first.at("enc").get<int64_t>());
+
+    using Stage = LatencyConsumer::Stage;
+    assert(consumer.messages() == 1);
+    assert(consumer.events() == 5);
+    assert(consumer.retried() == 0);   // Offline queueing is not a failed attempt
+    for (std::size_t i = 0; i < LatencyConsumer::kStageCount; ++i) {
+        assert(consumer.stage(static_cast<Stage>(i)).count == 5);
+    }
+    assert(consumer.stage(Stage::Retry).meanUs() >= 5000.0);
+    assert(consumer.stage(Stage::Total).maxUs >= consumer.stage(Stage::Retry).maxUs);
+
+    // Other runs and untraced payloads are counted but not measured
+    Event other;
+    other.deviceId = "SIM-002";
+    other.trace.runId = "run-2";
+    other.trace.generatedUs = traceClockUs();
+    consumer.onMessage("devices/SIM-002/messages/events/", JsonCodec::serialize(other));
+    consumer.onMessage("devices/SIM-002/messages/events/", "{\"seq\":1}");
+    consumer.onMessage("devices/SIM-002/messages/events/", "not json");
+    assert(consumer.foreign() == 2);
+    assert(consumer.malformed() == 1);
+    assert(consumer.events() == 5);
+
+    pipeline.stop();
+    std::cout << "Latency trace tests passed!" << std::endl;
+}
+
+void testRecordedTraceReplay() {
+    std::cout << "Testing recorded trace replay..." << std::endl;
+
+    // Simulator path: generated and encoded in the payload, receive stamp added by the recorder
+    Event event;
+    event.deviceId = "SIM-001";
+    event.trace.runId = "run-1";
+    event.trace.generatedUs = 1000;
+    event.trace.encodedUs = 1250;
+    std::string line = JsonCodec::stampReceived(JsonCodec::serialize(event), 4250);
+    assert(JsonCodec::deserialize(line).trace.receivedUs == 4250);
+    assert(JsonCodec::deserialize(line).sequence == event.sequence);
+
+    Event untraced;
+    untraced.deviceId = "SIM-001";
+    std::string plain = JsonCodec::serialize(untraced);
+    assert(JsonCodec::stampReceived(plain, 4250) == plain);
+
+    // A capture line has no topic; the recorded stamp replaces the receive time
+    LatencyConsumer consumer("run-1");
+    consumer.onMessage({}, line, 0);
+    consumer.onMessage({}, plain, 0);
+    using Stage = LatencyConsumer::Stage;
+    assert(consumer.events() == 1);
+    assert(consumer.foreign() == 1);
+    assert(consumer.stage(Stage::Encode).count == 1 && consumer.stage(Stage::Encode).maxUs == 250);
+    assert(consumer.stage(Stage::Delivery).count == 1 && consumer.stage(Stage::Delivery).maxUs == 3000);
+    assert(consumer.stage(Stage::Total).count == 1 && consumer.stage(Stage::Total).maxUs == 3250);
+    for (Stage stage : {Stage::Ingress, Stage::Batch, Stage::Dispatch, Stage::Retry}) {
+        assert(consumer.stage(stage).count == 0);
+    }
+
+    std::cout << "Recorded trace replay tests passed!" << std::endl;
+}
+
+void testTrafficAwareHeartbeat() {
+    std::cout << "Testing traffic-aware heartbeats..." << std::endl;
+
+    Harness h;
+    auto policies = std::make_shared<FastHeartbeatPolicies>();
+    {
+        TelemetryPipeline pipeline(h.transport, h.bus, policies);
+        pipeline.start("SIM-001");
+
+        // Events every 200 ms keep the 1 s heartbeat from ever coming due
+        runFor(h, pipeline, std::chrono::milliseconds(2200), std::chrono::milliseconds(200));
+        std::size_t active = h.transport->getPublishedMessages().size();
+        assert(active >= 10);
+        assert(heartbeatsIn(h.transport->getPublishedMessages()) == 0);
+
+        // Once idle, one heartbeat a second after the last event, with its status
+        runFor(h, pipeline, std::chrono::milliseconds(1500), std::chrono::milliseconds(0));
+        const auto& sent = h.transport->getPublishedMessages();
+        assert(sent.size() == active + 1);
+        auto heartbeat = nlohmann::json::parse(sent.back().payload);
+        assert(heartbeat.at("eventType") == "heartbeat");
+        assert(heartbeat.at("battery").at("pct") == 77);
+        assert(heartbeat.at("network").at("rssi") == -88);
+        pipeline.stop();
+    }
+
+    // Publishes the broker has not acknowledged do not keep heartbeats back
+    h.transport->clearPublishedMessages();
+    h.transport->setAutoAck(false);
+    {
+        TelemetryPipeline pipeline(h.transport, h.bus, policies);
+        pipeline.start("SIM-001");
+        runFor(h, pipeline, std::chrono::milliseconds(1500), std::chrono::milliseconds(200));
+        assert(heartbeatsIn(h.transport->getPublishedMessages()) == 1);
+
+        // The PUBACKs arrive: the interval restarts from them
+        std::size_t before = h.transport->getPublishedMessages().size();
+        assert(h.transport->acknowledge() == before);
+        runFor(h, pipeline, std::chrono::milliseconds(800), std::chrono::milliseconds(0));
+        assert(h.transport->getPublishedMessages().size() == before);
+        pipeline.stop();
+    }
+    h.transport->setAutoAck(true);
+
+    // A due heartbeat is left out while an event waits in a partial batch
+    h.transport->clearPublishedMessages();
+    PipelineOptions options;
+    options.maxBatchMessages = 100;
+    options.maxBatchDelay = std::chrono::milliseconds(1500);
+    TelemetryPipeline pipeline(h.transport, h.bus, policies, options);
+    pipeline.start("SIM-001");
+    h.publishEvents(1);
+    runFor(h, pipeline, std::chrono::milliseconds(2200), std::chrono::milliseconds(0));
+    const auto& sent = h.transport->getPublishedMessages();
+    assert(sent.size() == 1);
+    assert(heartbeatsIn(sent) == 0);
+    pipeline.stop();
+
+    std::cout << "Traffic-aware heartbeat tests passed!" << std::endl;
+}
+
+int main() {
+    std::cout << "Running Telemetry Pipeline Tests..." << std::endl;
+
+    testInlineStages();
+    testThreadedStagesKeepOrder();
+    testBatchingAndCompression();
+    testOfflineRetry();
+    testEndToEndLatencyTrace();
+    testRecordedTraceReplay();
+    testTrafficAwareHeartbeat();
+
+    std::cout << "\nAll telemetry pipeline tests passed!" << std::endl;
+    return 0;
+}
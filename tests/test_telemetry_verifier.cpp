@@ -0,0 +1,139 @@
+#include "../core/TelemetryVerifier.hpp"
+#include "../core/JsonCodec.hpp"
+#include <iostream>
+#include <cassert>
+#include <string>
+
+using namespace tracker;
+
+namespace {
+    Event makeEvent(const std::string& deviceId, std::uint64_t seq, const std::string& ts,
+                    EventType type = EventType::Heartbeat, const std::string& fence = "") {
+        Event event;
+        event.deviceId = deviceId;
+        event.sequence = seq;
+        event.timestamp = ts;
+        event.eventType = type;
+        if (!fence.empty()) {
+            event.extras["geofenceId"] = fence;
+        }
+        return event;
+    }
+
+    std::string line(const Event& event) {
+        return JsonCodec::serialize(event) + "\n";
+    }
+
+    TelemetryVerifier::Report verify(const std::string& ndjson, unsigned threads) {
+        TelemetryVerifier::Options options;
+        options.threads = threads;
+        options.maxSamples = 100;
+        return TelemetryVerifier::verify(ndjson.data(), ndjson.size(), options);
+    }
+
+    bool hasSample(const TelemetryVerifier::Report& report, TelemetryVerifier::ViolationKind kind,
+                   std::uint64_t line) {
+        for (const auto& sample : report.samples) {
+            if (sample.kind == kind && sample.line == line) return true;
+        }
+        return false;
+    }
+}
+
+void testTimestampParsing() {
+    std::cout << "Testing timestamp parsing..." << std::endl;
+
+    std::int64_t ms = 0;
+    assert(TelemetryVerifier::parseTimestamp("1970-01-01T00:00:00.000Z", 24, ms) && ms == 0);
+    assert(TelemetryVerifier::parseTimestamp("2025-01-01T00:00:01.250Z", 24, ms) && ms == 1735689601250LL);
+    assert(TelemetryVerifier::parseTimestamp("2024-02-29T12:00:00.000Z", 24, ms) && ms == 1709208000000LL);
+    assert(!TelemetryVerifier::parseTimestamp("2025-01-01 00:00:00.000Z", 24, ms));
+    assert(!TelemetryVerifier::parseTimestamp("2025-13-01T00:00:00.000Z", 24, ms));
+    assert(!TelemetryVerifier::parseTimestamp("2025-01-01T00:00:00Z", 20, ms));
+
+    std::cout << "Timestamp tests passed!" << std::endl;
+}
+
+void testCleanLogAcrossThreadCounts() {
+    std::cout << "Testing clean log with 1-8 threads..." << std::endl;
+
+    // Interleaved devices with paired fence visits
+    std::string log;
+    for (int i = 0; i < 2000; ++i) {
+        std::string device = "SIM-" + std::to_string(i % 7);
+        std::uint64_t seq = static_cast<std::uint64_t>(i / 7 + 1);
+        std::string ts = "2025-01-01T00:" + std::string(i / 60 % 60 < 10 ? "0" : "") + std::to_string(i / 60 % 60) +
+                         ":" + std::string(i % 60 < 10 ? "0" : "") + std::to_string(i % 60) + ".000Z";
+        EventType type = seq % 4 == 1 ? EventType::GeofenceEnter : seq % 4 == 3 ? EventType::GeofenceExit : EventType::Heartbeat;
+        log += line(makeEvent(device, seq, ts, type, type == EventType::Heartbeat ? "" : "office"));
+    }
+    log += "\n";   // Blank lines are ignored
+
+    for (unsigned threads : {1u, 2u, 3u, 8u}) {
+        auto report = verify(log, threads);
+        assert(report.ok());
+        assert(report.lines == 2000);
+        assert(report.events == 2000);
+        assert(report.devices == 7);
+        assert(report.threads == threads);
+    }
+
+    std::cout << "Clean log tests passed!" << std::endl;
+}
+
+void testViolationsAreFound() {
+    std::cout << "Testing violation detection..." << std::endl;
+
+    std::string log;
+    log += line(makeEvent("A", 1, "2025-01-01T00:00:01.000Z"));
+    log += line(makeEvent("B", 1, "2025-01-01T00:00:01.000Z"));
+    log += line(makeEvent("A", 2, "2025-01-01T00:00:02.000Z", EventType::GeofenceEnter, "depot"));
+    log += line(makeEvent("A", 5, "2025-01-01T00:00:03.000Z"));                                     // 4: gap of 2
+    log += line(makeEvent("A", 5, "2025-01-01T00:00:04.000Z"));                                     // 5: duplicate
+    log += line(makeEvent("B", 2, "2025-01-01T00:00:00.500Z"));                                     // 6: ts regression
+    log += line(makeEvent("A", 6, "2025-01-01T00:00:05.000Z", EventType::GeofenceEnter, "depot"));  // 7: enter twice
+    log += line(makeEvent("B", 3, "2025-01-01T00:00:06.000Z", EventType::GeofenceExit, "depot"));   // 8: exit without enter
+    log += "{\"deviceId\":\"A\",\"seq\":7}\n";                                                      // 9: missing fields
+    log += "not json\n";                                                                            // 10
+    log += line(makeEvent("B", 4, "2025-01-01T00:00:07.000Z", EventType::GeofenceEnter));           // 11: no fence id
+
+    for (unsigned threads : {1u, 4u}) {
+        auto report = verify(log, threads);
+        assert(!report.ok());
+        assert(report.lines == 11);
+        assert(report.events == 8);
+        assert(report.schemaErrors == 3);
+        assert(report.sequenceGaps == 1 && report.missingEvents == 2);
+        assert(report.duplicates == 1);
+        assert(report.timestampRegressions == 1);
+        assert(report.unpairedEnters == 1);
+        assert(report.unpairedExits == 1);
+        assert(report.openFences == 1);   // A is still inside depot
+
+        using Kind = TelemetryVerifier::ViolationKind;
+        assert(hasSample(report, Kind::SequenceGap, 4));
+        assert(hasSample(report, Kind::DuplicateSequence, 5));
+        assert(hasSample(report, Kind::TimestampRegression, 6));
+        assert(hasSample(report, Kind::UnpairedEnter, 7));
+        assert(hasSample(report, Kind::UnpairedExit, 8));
+        assert(hasSample(report, Kind::Schema, 9));
+        assert(hasSample(report, Kind::Schema, 10));
+        assert(hasSample(report, Kind::Schema, 11));
+        for (std::size_t i = 1; i < report.samples.size(); ++i) {
+            assert(report.samples[i - 1].line <= report.samples[i].line);
+        }
+    }
+
+    std::cout << "Violation tests passed!" << std::endl;
+}
+
+int main() {
+    std::cout << "Running Telemetry Verifier Tests..." << std::endl;
+
+    testTimestampParsing();
+    testCleanLogAcrossThreadCounts();
+    testViolationsAreFound();
+
+    std::cout << "\nAll telemetry verifier tests passed!" << std::endl;
+    return 0;
+}
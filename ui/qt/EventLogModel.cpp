@@ -0,0 +1,279 @@
+#include "EventLogModel.hpp"
+
+#include <QDateTime>
+#include <algorithm>
+#include <iterator>
+
+namespace tracker {
+namespace qt {
+
+EventLogModel::EventLogModel(std::size_t capacity, QObject* parent)
+    : QAbstractListModel(parent)
+    , capacity_(std::max<std::size_t>(capacity, 1))
+    , ring_(capacity_)
+{
+}
+
+void EventLogModel::appendMessage(const QString& message) {
+    std::lock_guard<std::mutex> lock(pendingMutex_);
+    pending_.push_back({QDateTime::currentMSecsSinceEpoch(), {}, kNoEventType, 0, {}, message});
+}
+
+void EventLogModel::appendEvent(const Event& event, const std::string& json) {
+    std::lock_guard<std::mutex> lock(pendingMutex_);
+    pending_.push_back({QDateTime::currentMSecsSinceEpoch(), event.deviceId,
+                        static_cast<int>(event.eventType), event.sequence, json, {}});
+}
+
+void EventLogModel::flush() {
+    std::vector<Pending> batch;
+    {
+        std::lock_guard<std::mutex> lock(pendingMutex_);
+        batch.swap(pending_);
+    }
+    if (batch.empty()) {
+        return;
+    }
+
+    // Only the newest capacity_ entries can survive this batch
+    std::size_t skip = batch.size() > capacity_ ? batch.size() - capacity_ : 0;
+
+    // Intern first so new devices are known when computing matches
+    std::vector<Entry> incoming;
+    incoming.reserve(batch.size() - skip);
+    for (std::size_t i = skip; i < batch.size(); ++i) {
+        Pending& p = batch[i];
+        Entry e;
+        e.receivedMs = p.receivedMs;
+        e.device = p.deviceId.empty() ? kNoDevice : internDevice(p.deviceId);
+        e.eventType = p.eventType;
+        e.sequence = p.sequence;
+        e.payload = std::move(p.payload);
+        e.message = std::move(p.message);
+        incoming.push_back(std::move(e));
+    }
+
+    // The batch replaces everything: one reset is cheaper than row bookkeeping
+    if (incoming.size() == capacity_) {
+        beginResetModel();
+        while (firstId_ < nextId_) {
+            evictOldest();
+        }
+        for (auto& e : incoming) {
+            uint64_t id = nextId_++;
+            byType_[typeSlot(e.eventType)].push_back(id);
+            if (e.device != kNoDevice) {
+                byDevice_[e.device].push_back(id);
+            }
+            ring_[id % capacity_] = std::move(e);
+        }
+        rebuildVisible();
+        endResetModel();
+        return;
+    }
+
+    // Drop the oldest entries to make room; visible rows leave from the top
+    uint64_t retained = nextId_ - firstId_;
+    uint64_t overflow = retained + incoming.size() > capacity_ ? retained + incoming.size() - capacity_ : 0;
+    uint64_t newFirstId = firstId_ + overflow;
+    auto firstKept = std::lower_bound(visible_.begin(), visible_.end(), newFirstId);
+    int removedRows = static_cast<int>(firstKept - visible_.begin());
+    if (removedRows > 0) {
+        beginRemoveRows(QModelIndex(), 0, removedRows - 1);
+    }
+    while (firstId_ < newFirstId) {
+        evictOldest();
+    }
+    if (removedRows > 0) {
+        endRemoveRows();
+    }
+
+    int insertedRows = static_cast<int>(std::count_if(incoming.begin(), incoming.end(),
+                                                      [this](const Entry& e) { return matches(e); }));
+    int firstRow = static_cast<int>(visible_.size());
+    if (insertedRows > 0) {
+        beginInsertRows(QModelIndex(), firstRow, firstRow + insertedRows - 1);
+    }
+    for (auto& e : incoming) {
+        uint64_t id = nextId_++;
+        byType_[typeSlot(e.eventType)].push_back(id);
+        if (e.device != kNoDevice) {
+            byDevice_[e.device].push_back(id);
+        }
+        if (matches(e)) {
+            visible_.push_back(id);
+        }
+        ring_[id % capacity_] = std::move(e);
+    }
+    if (insertedRows > 0) {
+        endInsertRows();
+    }
+}
+
+void EventLogModel::clear() {
+    {
+        std::lock_guard<std::mutex> lock(pendingMutex_);
+        pending_.clear();
+    }
+
+    beginResetModel();
+    while (firstId_ < nextId_) {
+        evictOldest();
+    }
+    visible_.clear();
+    endResetModel();
+}
+
+void EventLogModel::setDeviceFilter(const QString& deviceId) {
+    beginResetModel();
+    deviceFilterName_ = deviceId;
+    auto it = deviceIndex_.find(deviceId.toStdString());
+    deviceFilter_ = it != deviceIndex_.end() ? it->second : kNoDevice;
+    rebuildVisible();
+    endResetModel();
+}
+
+void EventLogModel::setEventTypeFilter(int eventType) {
+    beginResetModel();
+    eventTypeFilter_ = (eventType >= 0 && typeSlot(eventType) < kTypeSlots) ? eventType : kNoEventType;
+    rebuildVisible();
+    endResetModel();
+}
+
+int EventLogModel::rowCount(const QModelIndex& parent) const {
+    return parent.isValid() ? 0 : static_cast<int>(visible_.size());
+}
+
+QVariant EventLogModel::data(const QModelIndex& index, int role) const {
+    if (!index.isValid() || index.row() < 0 || static_cast<std::size_t>(index.row()) >= visible_.size()) {
+        return {};
+    }
+
+    const Entry& e = entry(visible_[static_cast<std::size_t>(index.row())]);
+    QString device = e.device != kNoDevice ? devices_[static_cast<int>(e.device)] : QString();
+
+    switch (role) {
+    case Qt::DisplayRole: {
+        QString time = QDateTime::fromMSecsSinceEpoch(e.receivedMs).toString("hh:mm:ss");
+        if (e.eventType == kNoEventType) {
+            return QString("[%1] %2").arg(time, e.message);
+        }
+        QString type = QString::fromStdString(eventTypeToString(static_cast<EventType>(e.eventType)));
+        return QString("[%1] %2  %3  #%4").arg(time, device, type).arg(e.sequence);
+    }
+    case DeviceRole:
+        return device;
+    case EventTypeRole:
+        return e.eventType;
+    case PayloadRole:
+        return QString::fromStdString(e.payload);
+    default:
+        return {};
+    }
+}
+
+QHash<int, QByteArray> EventLogModel::roleNames() const {
+    QHash<int, QByteArray> roles = QAbstractListModel::roleNames();
+    roles[DeviceRole] = "device";
+    roles[EventTypeRole] = "eventType";
+    roles[PayloadRole] = "payload";
+    return roles;
+}
+
+uint32_t EventLogModel::internDevice(const std::string& deviceId) {
+    auto it = deviceIndex_.find(deviceId);
+    if (it != deviceIndex_.end()) {
+        return it->second;
+    }
+
+    uint32_t index = static_cast<uint32_t>(byDevice_.size());
+    deviceIndex_.emplace(deviceId, index);
+    byDevice_.emplace_back();
+    devices_.append(QString::fromStdString(deviceId));
+
+    // A filter set before the device's first event starts matching now
+    if (!deviceFilterName_.isEmpty() && deviceFilter_ == kNoDevice && devices_.back() == deviceFilterName_) {
+        deviceFilter_ = index;
+    }
+
+    emit devicesChanged();
+    return index;
+}
+
+bool EventLogModel::matches(const Entry& e) const {
+    if (eventTypeFilter_ != kNoEventType && e.eventType != eventTypeFilter_) {
+        return false;
+    }
+    if (!deviceFilterName_.isEmpty()) {
+        // Status lines stay visible under a device filter
+        return e.device == kNoDevice || (deviceFilter_ != kNoDevice && e.device == deviceFilter_);
+    }
+    return true;
+}
+
+void EventLogModel::evictOldest() {
+    uint64_t id = firstId_++;
+    Entry& e = ring_[id % capacity_];
+
+    // Postings are ascending, so the evicted id is at the front of each list
+    byType_[typeSlot(e.eventType)].pop_front();
+    if (e.device != kNoDevice) {
+        byDevice_[e.device].pop_front();
+    }
+    if (!visible_.empty() && visible_.front() == id) {
+        visible_.pop_front();
+    }
+
+    e.payload.clear();
+    e.payload.shrink_to_fit();
+    e.message.clear();
+}
+
+void EventLogModel::rebuildVisible() {
+    visible_.clear();
+
+    bool byDevice = !deviceFilterName_.isEmpty();
+    bool byType = eventTypeFilter_ != kNoEventType;
+
+    if (!byDevice && !byType) {
+        for (uint64_t id = firstId_; id < nextId_; ++id) {
+            visible_.push_back(id);
+        }
+        return;
+    }
+
+    if (!byDevice) {
+        visible_ = byType_[typeSlot(eventTypeFilter_)];
+        return;
+    }
+
+    // Device postings merged with status lines (both ascending)
+    static const std::deque<uint64_t> kEmpty;
+    const auto& devicePosts = deviceFilter_ != kNoDevice ? byDevice_[deviceFilter_] : kEmpty;
+    const auto& statusPosts = byType_[typeSlot(kNoEventType)];
+
+    if (byType) {
+        // Intersect by probing the shorter list's entries
+        const auto& typePosts = byType_[typeSlot(eventTypeFilter_)];
+        if (devicePosts.size() <= typePosts.size()) {
+            for (uint64_t id : devicePosts) {
+                if (entry(id).eventType == eventTypeFilter_) {
+                    visible_.push_back(id);
+                }
+            }
+        } else {
+            for (uint64_t id : typePosts) {
+                if (entry(id).device == deviceFilter_) {
+                    visible_.push_back(id);
+                }
+            }
+        }
+        return;
+    }
+
+    std::merge(devicePosts.begin(), devicePosts.end(), statusPosts.begin(), statusPosts.end(),
+               std::back_inserter(visible_));
+}
+
+} // namespace qt
+} // namespace tracker
@@ -0,0 +1,140 @@
+/**
+ * @file EventLogModel.hpp
+ * @brief Bounded, filterable event log backing the Events tab
+ *
+ * Entries live in a fixed-capacity ring; the oldest entry is dropped when a
+ * new one arrives at capacity, so memory stays flat however long a fleet or
+ * spike run lasts. Rows are stored raw (timestamp, interned device, event
+ * type, payload) and only formatted in data(), i.e. for the rows a view
+ * actually paints.
+ *
+ * Filters are index lookups: every entry is recorded in a per-device and a
+ * per-event-type posting list, so changing a filter copies (or intersects)
+ * a posting list instead of rescanning the log.
+ *
+ * appendEvent()/appendMessage() only queue; flush() applies the queue with at
+ * most one remove and one insert notification, and is meant to be driven once
+ * per frame by a timer.
+ *
+ * @note appendEvent()/appendMessage() are thread-safe; everything else is GUI-thread only
+ */
+
+#pragma once
+
+#include <QAbstractListModel>
+#include <QStringList>
+
+#include "../../core/Event.hpp"
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace tracker {
+namespace qt {
+
+class EventLogModel : public QAbstractListModel {
+    Q_OBJECT
+
+public:
+    enum Roles {
+        DeviceRole = Qt::UserRole + 1,  ///< Device ID (empty for status lines)
+        EventTypeRole,                  ///< EventType as int, kNoEventType for status lines
+        PayloadRole                     ///< Serialized JSON payload
+    };
+
+    /// Event type of status lines and "no type filter"
+    static constexpr int kNoEventType = -1;
+
+    static constexpr std::size_t kDefaultCapacity = 10000;
+
+    explicit EventLogModel(std::size_t capacity = kDefaultCapacity, QObject* parent = nullptr);
+
+    /** @brief Queue a status line (shown for every device filter) */
+    void appendMessage(const QString& message);
+
+    /** @brief Queue an emitted event with its serialized payload */
+    void appendEvent(const Event& event, const std::string& json);
+
+    /** @brief Apply queued entries to the model (one batch of row notifications) */
+    void flush();
+
+    /** @brief Drop every entry, including queued ones */
+    void clear();
+
+    /** @brief Show only one device (empty string shows all) */
+    void setDeviceFilter(const QString& deviceId);
+
+    /** @brief Show only one event type (kNoEventType shows all) */
+    void setEventTypeFilter(int eventType);
+
+    /** @brief Device IDs seen so far, in arrival order */
+    QStringList devices() const { return devices_; }
+
+    std::size_t capacity() const { return capacity_; }
+
+    int rowCount(const QModelIndex& parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex& index, int role = Qt::DisplayRole) const override;
+    QHash<int, QByteArray> roleNames() const override;
+
+signals:
+    /** @brief A new device ID appeared (for filter pickers) */
+    void devicesChanged();
+
+private:
+    static constexpr uint32_t kNoDevice = UINT32_MAX;
+    static constexpr std::size_t kTypeSlots = static_cast<std::size_t>(EventType::LowBattery) + 2;
+
+    struct Pending {
+        qint64 receivedMs;
+        std::string deviceId;
+        int eventType;
+        uint64_t sequence;
+        std::string payload;
+        QString message;
+    };
+
+    struct Entry {
+        qint64 receivedMs = 0;
+        uint32_t device = kNoDevice;
+        int eventType = kNoEventType;
+        uint64_t sequence = 0;
+        std::string payload;    ///< Raw JSON, formatted lazily
+        QString message;        ///< Status text (status lines only)
+    };
+
+    const Entry& entry(uint64_t id) const { return ring_[id % capacity_]; }
+    static std::size_t typeSlot(int eventType) { return static_cast<std::size_t>(eventType + 1); }
+
+    uint32_t internDevice(const std::string& deviceId);
+    bool matches(const Entry& e) const;
+    void evictOldest();
+    void rebuildVisible();
+
+    const std::size_t capacity_;
+    std::vector<Entry> ring_;           ///< Slot = absolute id % capacity
+    uint64_t firstId_ = 0;              ///< Oldest retained absolute id
+    uint64_t nextId_ = 0;               ///< Absolute id of the next entry
+
+    // Posting lists of absolute ids, ascending
+    std::vector<std::deque<uint64_t>> byDevice_;
+    std::array<std::deque<uint64_t>, kTypeSlots> byType_;
+    std::deque<uint64_t> visible_;      ///< Rows of the current filter
+
+    QStringList devices_;
+    std::unordered_map<std::string, uint32_t> deviceIndex_;
+
+    QString deviceFilterName_;
+    uint32_t deviceFilter_ = kNoDevice; ///< kNoDevice with a non-empty name = unseen device
+    int eventTypeFilter_ = kNoEventType;
+
+    std::mutex pendingMutex_;
+    std::vector<Pending> pending_;
+};
+
+} // namespace qt
+} // namespace tracker
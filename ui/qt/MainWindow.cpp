@@ -13,6 +13,8 @@
 #include <QJsonDocument>
 #include <QJsonObject>
 #include <QDateTime>
+#include <QScrollBar>
+#include <QItemSelectionModel>
 
 namespace tracker {
 namespace qt {
@@ -24,12 +26,22 @@ MainWindow::MainWindow(QWidget *parent)
     , m_rng(std::make_shared<StandardRng>())
     , m_simulator(std::make_unique<Simulator>(m_mqttClient, m_clock, m_rng))
     , m_simulatorTimer(new QTimer(this))
+    , m_eventLogTimer(new QTimer(this))
 {
     setupUI();
     loadConfiguration();
     
     connect(m_simulatorTimer, &QTimer::timeout, this, &MainWindow::onSimulatorTick);
     m_simulatorTimer->setInterval(1000); // 1 second
+    
+    // Batch log updates to the display frame rate instead of one per event
+    connect(m_eventLogTimer, &QTimer::timeout, this, &MainWindow::onEventLogFlush);
+    m_eventLogTimer->setInterval(16);
+    m_eventLogTimer->start();
+    
+    m_simulator->setEventCallback([this](const Event& event, const std::string& json) {
+        m_eventLogModel->appendEvent(event, json);
+    });
 }
 
 MainWindow::~MainWindow() {
@@ -180,11 +192,31 @@ void MainWindow::setupUI() {
     
     auto* eventsLayout = new QVBoxLayout(m_eventsTab);
     
+    auto* filterLayout = new QHBoxLayout;
+    m_deviceFilter = new QComboBox;
+    m_deviceFilter->addItem("All devices", QString());
+    filterLayout->addWidget(new QLabel("Device:"));
+    filterLayout->addWidget(m_deviceFilter);
+    
+    m_eventTypeFilter = new QComboBox;
+    m_eventTypeFilter->addItem("All events", EventLogModel::kNoEventType);
+    for (int type = static_cast<int>(EventType::Heartbeat); type <= static_cast<int>(EventType::LowBattery); ++type) {
+        m_eventTypeFilter->addItem(QString::fromStdString(eventTypeToString(static_cast<EventType>(type))), type);
+    }
+    filterLayout->addWidget(new QLabel("Event:"));
+    filterLayout->addWidget(m_eventTypeFilter);
+    filterLayout->addStretch();
+    eventsLayout->addLayout(filterLayout);
+    
     auto* eventsSplitter = new QSplitter(Qt::Horizontal);
     
-    m_eventLog = new QTextEdit;
-    m_eventLog->setReadOnly(true);
-    m_eventLog->setMaximumBlockCount(1000);
+    // Virtualized: the view only asks the model for rows it paints
+    m_eventLogModel = new EventLogModel(EventLogModel::kDefaultCapacity, this);
+    m_eventLog = new QListView;
+    m_eventLog->setModel(m_eventLogModel);
+    m_eventLog->setUniformItemSizes(true);
+    m_eventLog->setSelectionMode(QAbstractItemView::SingleSelection);
+    m_eventLog->setEditTriggers(QAbstractItemView::NoEditTriggers);
     eventsSplitter->addWidget(m_eventLog);
     
     m_jsonPreview = new QTextEdit;
@@ -195,6 +227,11 @@ void MainWindow::setupUI() {
     eventsSplitter->setSizes({400, 400});
     eventsLayout->addWidget(eventsSplitter);
     
+    connect(m_deviceFilter, QOverload<int>::of(&QComboBox::currentIndexChanged), this, &MainWindow::onEventFilterChanged);
+    connect(m_eventTypeFilter, QOverload<int>::of(&QComboBox::currentIndexChanged), this, &MainWindow::onEventFilterChanged);
+    connect(m_eventLog->selectionModel(), &QItemSelectionModel::currentChanged, this, &MainWindow::onEventSelected);
+    connect(m_eventLogModel, &EventLogModel::devicesChanged, this, &MainWindow::onEventDevicesChanged);
+    
     // Status bar
     statusBar()->showMessage("Ready");
 }
@@ -310,6 +347,42 @@ void MainWindow::onSimulatorTick() {
     }
 }
 
+void MainWindow::onEventLogFlush() {
+    // Follow the tail only when the user has not scrolled up
+    auto* scrollBar = m_eventLog->verticalScrollBar();
+    bool atBottom = scrollBar->value() == scrollBar->maximum();
+    
+    m_eventLogModel->flush();
+    
+    if (atBottom) {
+        m_eventLog->scrollToBottom();
+    }
+}
+
+void MainWindow::onEventFilterChanged() {
+    m_eventLogModel->setDeviceFilter(m_deviceFilter->currentData().toString());
+    m_eventLogModel->setEventTypeFilter(m_eventTypeFilter->currentData().toInt());
+    m_eventLog->scrollToBottom();
+}
+
+void MainWindow::onEventSelected(const QModelIndex& index) {
+    QString payload = index.data(EventLogModel::PayloadRole).toString();
+    if (payload.isEmpty()) {
+        m_jsonPreview->clear();
+        return;
+    }
+    
+    QJsonDocument doc = QJsonDocument::fromJson(payload.toUtf8());
+    m_jsonPreview->setPlainText(doc.isNull() ? payload : QString::fromUtf8(doc.toJson(QJsonDocument::Indented)));
+}
+
+void MainWindow::onEventDevicesChanged() {
+    const QStringList devices = m_eventLogModel->devices();
+    for (int i = m_deviceFilter->count() - 1; i < devices.size(); ++i) {
+        m_deviceFilter->addItem(devices[i], devices[i]);
+    }
+}
+
 void MainWindow::updateConnectionStatus(bool connected) {
     m_connected = connected;
     m_connectionStatus->setText(connected ? "Connected" : "Disconnected");
@@ -337,8 +410,7 @@ void MainWindow::updateSimulationStatus() {
 }
 
 void MainWindow::appendEventLog(const QString& message) {
-    QString timestamp = QDateTime::currentDateTime().toString("hh:mm:ss");
-    m_eventLog->append(QString("[%1] %2").arg(timestamp, message));
+    m_eventLogModel->appendMessage(message);
 }
 
 void MainWindow::loadConfiguration() {
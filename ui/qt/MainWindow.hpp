@@ -15,9 +15,12 @@
 #include <QFormLayout>
 #include <QGroupBox>
 #include <QCheckBox>
+#include <QComboBox>
+#include <QListView>
 
 #include "../../core/Simulator.hpp"
 #include "../../net/mqtt/PahoMqttClient.hpp"
+#include "EventLogModel.hpp"
 #include <memory>
 
 namespace tracker {
@@ -41,6 +44,10 @@ private slots:
     void onDriveClicked();
     void onSpikeClicked();
     void onSimulatorTick();
+    void onEventLogFlush();
+    void onEventFilterChanged();
+    void onEventSelected(const QModelIndex& index);
+    void onEventDevicesChanged();
     
 private:
     void setupUI();
@@ -78,7 +85,10 @@ private:
     
     // Events tab
     QWidget* m_eventsTab;
-    QTextEdit* m_eventLog;
+    QComboBox* m_deviceFilter;
+    QComboBox* m_eventTypeFilter;
+    QListView* m_eventLog;
+    EventLogModel* m_eventLogModel;
     QTextEdit* m_jsonPreview;
     
     // Simulator components
@@ -88,6 +98,7 @@ private:
     std::unique_ptr<Simulator> m_simulator;
     
     QTimer* m_simulatorTimer;
+    QTimer* m_eventLogTimer;    ///< Applies queued log entries once per frame
     bool m_connected = false;
     bool m_simulating = false;
 };